@@ -0,0 +1,261 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file json_performance_main.c
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <json/cJSON.h>
+
+#define PERF_ITERATIONS   CONFIG_EXAMPLES_JSON_PERFORMANCE_ITERATIONS
+#define PERF_ARENA_SIZE   CONFIG_EXAMPLES_JSON_PERFORMANCE_ARENA_SIZE
+#define PERF_PRINT_BUFFER CONFIG_EXAMPLES_JSON_PERFORMANCE_PRINT_BUFFER
+#define PERF_SCRATCH_SIZE 2048
+
+struct perf_payload_s {
+	const char *name;
+	const char *json;
+};
+
+/* Shapes of the documents st_things and the cloud clients parse */
+
+static const struct perf_payload_s g_payloads[] = {
+	{
+		"device def", "{\"device\":[{\"specification\":{\"device\":{\"deviceType\":\"x.com.st.d.sensor.light\","
+		"\"deviceName\":\"Light\",\"specVersion\":\"core.1.1.0\",\"dataModelVersion\":\"res.1.1.0\"},"
+		"\"platform\":{\"manufacturerName\":\"xxxx\",\"manufacturerUrl\":\"http://www.samsung.com/sec/\","
+		"\"manufacturingDate\":\"2017-08-31\",\"modelNumber\":\"NWSP-01\",\"platformVersion\":\"1.0\","
+		"\"osVersion\":\"1.0\",\"hardwareVersion\":\"1.0\",\"firmwareVersion\":\"1.0\",\"vendorId\":\"TizenRT\"}},"
+		"\"resources\":{\"single\":[{\"uri\":\"/capability/switch/main/0\",\"types\":[\"x.com.st.powerswitch\"],"
+		"\"interfaces\":[\"oic.if.a\",\"oic.if.baseline\"],\"policy\":3},{\"uri\":\"/capability/colorTemperature/main/0\","
+		"\"types\":[\"x.com.st.color.temperature\"],\"interfaces\":[\"oic.if.a\",\"oic.if.baseline\"],\"policy\":3}]}}],"
+		"\"resourceTypes\":[{\"type\":\"x.com.st.powerswitch\",\"properties\":[{\"key\":\"power\",\"type\":3,"
+		"\"mandatory\":true,\"rw\":3}]},{\"type\":\"x.com.st.color.temperature\",\"properties\":[{\"key\":\"ct\","
+		"\"type\":1,\"mandatory\":true,\"rw\":3},{\"key\":\"range\",\"type\":6,\"mandatory\":false,\"rw\":1}]}]}"
+	},
+	{
+		"shadow delta", "{\"version\":2319,\"timestamp\":1557308764,\"state\":{\"reported\":{\"power\":\"on\","
+		"\"brightness\":75,\"color\":{\"r\":255,\"g\":180,\"b\":107},\"firmware\":\"1.0.3\"},\"desired\":{\"power\":"
+		"\"off\",\"brightness\":40}},\"metadata\":{\"reported\":{\"power\":{\"timestamp\":1557308760},\"brightness\":"
+		"{\"timestamp\":1557308760}},\"desired\":{\"power\":{\"timestamp\":1557308764}}},\"clientToken\":\"token-17\"}"
+	},
+	{
+		"sensor batch", "[{\"t\":1557308700,\"temp\":23.5,\"hum\":41.2,\"ok\":true},{\"t\":1557308710,\"temp\":23.6,"
+		"\"hum\":41.0,\"ok\":true},{\"t\":1557308720,\"temp\":23.6,\"hum\":40.9,\"ok\":true},{\"t\":1557308730,"
+		"\"temp\":23.7,\"hum\":40.7,\"ok\":false},{\"t\":1557308740,\"temp\":23.9,\"hum\":40.6,\"ok\":true},"
+		"{\"t\":1557308750,\"temp\":24.0,\"hum\":40.4,\"ok\":true},{\"t\":1557308760,\"temp\":24.1,\"hum\":40.1,"
+		"\"ok\":null}]"
+	},
+};
+
+static unsigned long g_allocs;
+static unsigned long g_alloc_bytes;
+static char g_scratch[PERF_SCRATCH_SIZE];
+static unsigned char g_arena[PERF_ARENA_SIZE];
+static char g_print_buffer[PERF_PRINT_BUFFER];
+static size_t g_printed;
+
+static void *perf_malloc(size_t size)
+{
+	g_allocs++;
+	g_alloc_bytes += size;
+	return malloc(size);
+}
+
+static unsigned long perf_elapsed_us(struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_REALTIME, &end);
+	return (end.tv_sec - start->tv_sec) * 1000000UL + (end.tv_nsec - start->tv_nsec) / 1000;
+}
+
+static void perf_report(const char *payload, const char *parser, unsigned long us, unsigned long extra)
+{
+	printf("%-12s %-8s: %6lu us/op, %4lu allocs, %6lu bytes alloc, %5lu bytes arena\n", payload, parser, us / PERF_ITERATIONS, g_allocs / PERF_ITERATIONS, g_alloc_bytes / PERF_ITERATIONS, extra);
+}
+
+/****************************************************************************
+ * Parsers
+ ****************************************************************************/
+
+static int perf_tree(const char *json)
+{
+	cJSON *root = cJSON_Parse(json);
+
+	if (root == NULL) {
+		return -1;
+	}
+	cJSON_Delete(root);
+	return 0;
+}
+
+/* The input is overwritten, so each parse starts from a fresh copy */
+
+static int perf_insitu(const char *json, size_t length, size_t *arena_used)
+{
+	cJSON_Arena arena;
+
+	memcpy(g_scratch, json, length);
+	cJSON_InitArena(&arena, g_arena, sizeof(g_arena));
+	if (cJSON_ParseInSitu(g_scratch, length, &arena) == NULL) {
+		return -1;
+	}
+	*arena_used = arena.used;
+	return 0;
+}
+
+/* Visit every value as a consumer would, unescaping strings into a local buffer */
+
+static int perf_pull(const char *json, size_t length)
+{
+	cJSON_Pull pull;
+	char value[128];
+	double sum = 0;
+	int token;
+
+	cJSON_InitPull(&pull, json, length, 1);
+	while ((token = cJSON_NextPull(&pull)) != cJSON_Invalid) {
+		if (token == cJSON_PullError || token == cJSON_PullMore) {
+			return -1;
+		}
+		if (token == cJSON_Number) {
+			sum += pull.number;
+		} else if (token == cJSON_String && pull.string_length < sizeof(value)) {
+			cJSON_UnescapeString(pull.string, pull.string_length, value, sizeof(value));
+		}
+	}
+	return (sum >= 0) ? 0 : -1;
+}
+
+/****************************************************************************
+ * Printers
+ ****************************************************************************/
+
+static int perf_print(const cJSON *root)
+{
+	char *text = cJSON_PrintUnformatted(root);
+
+	if (text == NULL) {
+		return -1;
+	}
+	g_printed = strlen(text);
+	cJSON_free(text);
+	return 0;
+}
+
+/* Stands for send(), only counting what would go out */
+
+static cJSON_bool perf_flush(void *context, const char *data, size_t length)
+{
+	*(size_t *)context += length;
+	return 1;
+}
+
+static int perf_streamed(const cJSON *root)
+{
+	size_t sent = 0;
+
+	if (!cJSON_PrintStreamed(root, g_print_buffer, sizeof(g_print_buffer), 0, perf_flush, &sent)) {
+		return -1;
+	}
+	return (sent == g_printed) ? 0 : -1;
+}
+
+/****************************************************************************
+ * Name: json_performance_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int json_performance_main(int argc, char *argv[])
+#endif
+{
+	cJSON_Hooks hooks = { perf_malloc, free };
+	struct timespec start;
+	cJSON *root;
+	size_t arena_used = 0;
+	size_t length;
+	unsigned int p;
+	int ret = 0;
+	int i;
+
+	printf("cJSON performance, %d parses and prints per payload\n", PERF_ITERATIONS);
+	cJSON_InitHooks(&hooks);
+
+	for (p = 0; p < sizeof(g_payloads) / sizeof(g_payloads[0]); p++) {
+		length = strlen(g_payloads[p].json);
+		printf("%-12s %u bytes\n", g_payloads[p].name, (unsigned int)length);
+		if (length > sizeof(g_scratch)) {
+			continue;
+		}
+
+		g_allocs = g_alloc_bytes = 0;
+		clock_gettime(CLOCK_REALTIME, &start);
+		for (i = 0; i < PERF_ITERATIONS && ret == 0; i++) {
+			ret = perf_tree(g_payloads[p].json);
+		}
+		perf_report(g_payloads[p].name, "tree", perf_elapsed_us(&start), 0);
+
+		g_allocs = g_alloc_bytes = 0;
+		clock_gettime(CLOCK_REALTIME, &start);
+		for (i = 0; i < PERF_ITERATIONS && ret == 0; i++) {
+			ret = perf_insitu(g_payloads[p].json, length, &arena_used);
+		}
+		perf_report(g_payloads[p].name, "in situ", perf_elapsed_us(&start), arena_used);
+
+		g_allocs = g_alloc_bytes = 0;
+		clock_gettime(CLOCK_REALTIME, &start);
+		for (i = 0; i < PERF_ITERATIONS && ret == 0; i++) {
+			ret = perf_pull(g_payloads[p].json, length);
+		}
+		perf_report(g_payloads[p].name, "pull", perf_elapsed_us(&start), 0);
+
+		root = cJSON_Parse(g_payloads[p].json);
+		if (root == NULL) {
+			ret = -1;
+		}
+
+		g_allocs = g_alloc_bytes = 0;
+		clock_gettime(CLOCK_REALTIME, &start);
+		for (i = 0; i < PERF_ITERATIONS && ret == 0; i++) {
+			ret = perf_print(root);
+		}
+		perf_report(g_payloads[p].name, "print", perf_elapsed_us(&start), 0);
+
+		g_allocs = g_alloc_bytes = 0;
+		clock_gettime(CLOCK_REALTIME, &start);
+		for (i = 0; i < PERF_ITERATIONS && ret == 0; i++) {
+			ret = perf_streamed(root);
+		}
+		perf_report(g_payloads[p].name, "streamed", perf_elapsed_us(&start), 0);
+		cJSON_Delete(root);
+
+		if (ret != 0) {
+			printf("%-12s : fail\n", g_payloads[p].name);
+			break;
+		}
+	}
+
+	cJSON_InitHooks(NULL);
+	return ret;
+}
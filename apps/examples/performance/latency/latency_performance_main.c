@@ -0,0 +1,553 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file latency_performance_main.c
+
+#include <tinyara/config.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <time.h>
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/irq.h>
+#include <tinyara/semaphore.h>
+
+#define LAT_LOOPS     CONFIG_EXAMPLES_LATENCY_PERFORMANCE_LOOPS
+#define LAT_PERIOD    CONFIG_EXAMPLES_LATENCY_PERFORMANCE_PERIOD
+#define LAT_PRIORITY  CONFIG_EXAMPLES_LATENCY_PERFORMANCE_PRIORITY
+#ifdef CONFIG_EXAMPLES_LATENCY_PERFORMANCE_IRQ
+#define LAT_IRQ       CONFIG_EXAMPLES_LATENCY_PERFORMANCE_IRQ
+#else
+#define LAT_IRQ       0
+#endif
+#define LAT_SIGNO     SIGUSR1
+#define LAT_MQ_PING   "lat_ping"
+#define LAT_MQ_PONG   "lat_pong"
+#define LAT_MQ_WAIT   1		/* Seconds to wait for the pong */
+
+/* Bucket 0 holds samples below 1 us, bucket n the ones from 2^(n-1) us to
+ * 2^n us, the last one everything above.
+ */
+
+#define LAT_NBUCKETS  16
+
+struct lat_stat_s {
+	const char *name;
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t sum;
+	uint32_t hist[LAT_NBUCKETS];
+};
+
+/* The periodic thread reports its latency and its jitter */
+
+struct lat_cyclic_s {
+	struct lat_stat_s latency;
+	struct lat_stat_s jitter;
+};
+
+/* The queues of the ping-pong, all opened by the main task */
+
+struct lat_mq_s {
+	struct lat_stat_s *stat;
+	mqd_t ping;
+	mqd_t pong;
+};
+
+/* A thread woken by the main task, with the time it was woken at */
+
+struct lat_wakeup_s {
+	struct lat_stat_s *stat;
+	volatile uint32_t *stamp;
+};
+
+static uint32_t g_freq;
+static sem_t g_ping;
+static sem_t g_pong;
+static volatile uint32_t g_stamp;
+static volatile uint32_t g_irq_stamp;
+
+static void lat_init(struct lat_stat_s *stat, const char *name)
+{
+	memset(stat, 0, sizeof(struct lat_stat_s));
+	stat->name = name;
+	stat->min = UINT32_MAX;
+}
+
+/* Latencies are kept in nanoseconds */
+
+static void lat_add(struct lat_stat_s *stat, uint32_t cycles)
+{
+	uint32_t ns = (uint32_t)((uint64_t)cycles * 1000000000 / g_freq);
+	uint32_t us = ns / 1000;
+	int bucket = 0;
+
+	while (us != 0 && bucket < LAT_NBUCKETS - 1) {
+		us >>= 1;
+		bucket++;
+	}
+
+	stat->count++;
+	stat->sum += ns;
+	if (ns < stat->min) {
+		stat->min = ns;
+	}
+	if (ns > stat->max) {
+		stat->max = ns;
+	}
+	stat->hist[bucket]++;
+}
+
+static void lat_report(struct lat_stat_s *stat)
+{
+	uint32_t avg;
+	int i;
+
+	if (stat->count == 0) {
+		printf("%-10s: no samples\n", stat->name);
+		return;
+	}
+
+	avg = (uint32_t)(stat->sum / stat->count);
+	printf("%-10s: min %u.%03u avg %u.%03u max %u.%03u us, %u samples\n", stat->name, stat->min / 1000, stat->min % 1000, avg / 1000, avg % 1000, stat->max / 1000, stat->max % 1000, stat->count);
+	for (i = 0; i < LAT_NBUCKETS; i++) {
+		if (stat->hist[i] == 0) {
+			continue;
+		}
+		if (i == LAT_NBUCKETS - 1) {
+			printf("  %6lu -        us: %u\n", 1UL << (i - 1), stat->hist[i]);
+		} else {
+			printf("  %6lu - %6lu us: %u\n", i ? 1UL << (i - 1) : 0UL, 1UL << i, stat->hist[i]);
+		}
+	}
+}
+
+static int lat_thread_create(pthread_t *thread, int priority, pthread_startroutine_t entry, void *arg)
+{
+	pthread_attr_t attr;
+	struct sched_param param;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+	pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+	param.sched_priority = priority;
+	pthread_attr_setschedparam(&attr, &param);
+
+	return pthread_create(thread, &attr, entry, arg);
+}
+
+/****************************************************************************
+ * Periodic thread latency and jitter, as cyclictest
+ *
+ * The thread waits for a periodic POSIX timer, armed right after a tick
+ * so that expiry n is due n periods of whole ticks after that tick, on
+ * the counter too.  The latency is the time from the expiry to the
+ * wakeup.  The tick is seen once its interrupt is done, so the latency
+ * leaves out that part of the tick interrupt.
+ *
+ * The timer does not drift, so for the jitter wakeup n is due at the
+ * first wakeup plus n times the mean period.  The time after it is
+ * reported, less the smallest one, as the wakeup of the first cycle is
+ * itself late.  A constant rise of the latency does not show in it.
+ ****************************************************************************/
+
+static pthread_addr_t lat_cyclic_thread(pthread_addr_t arg)
+{
+	struct lat_cyclic_s *cyclic = (struct lat_cyclic_s *)arg;
+	struct sigevent ev;
+	struct itimerspec its;
+	sigset_t set;
+	timer_t timer;
+	clock_t tick;
+	uint32_t *periods;
+	uint32_t start;
+	uint32_t due;
+	uint32_t last;
+	uint32_t now;
+	uint64_t period;
+	uint64_t elapsed;
+	uint64_t total;
+	int64_t offset;
+	int64_t min;
+	int i;
+
+	periods = (uint32_t *)malloc(LAT_LOOPS * sizeof(uint32_t));
+	if (periods == NULL) {
+		printf("cyclic: out of memory\n");
+		return NULL;
+	}
+
+	sigemptyset(&set);
+	sigaddset(&set, LAT_SIGNO);
+	sigprocmask(SIG_BLOCK, &set, NULL);
+
+	ev.sigev_notify = SIGEV_SIGNAL;
+	ev.sigev_signo = LAT_SIGNO;
+	ev.sigev_value.sival_ptr = NULL;
+	if (timer_create(CLOCK_REALTIME, &ev, &timer) != OK) {
+		printf("cyclic: timer_create failed\n");
+		free(periods);
+		return NULL;
+	}
+
+	/* The timer rounds the period up to whole ticks */
+
+	period = (LAT_PERIOD + USEC_PER_TICK - 1) / USEC_PER_TICK * USEC_PER_TICK;
+	its.it_value.tv_sec = period / USEC_PER_SEC;
+	its.it_value.tv_nsec = (period % USEC_PER_SEC) * NSEC_PER_USEC;
+	its.it_interval = its.it_value;
+	period = period * g_freq / USEC_PER_SEC;
+
+	/* Arm the timer in the tick just started, again if it was missed */
+
+	do {
+		tick = clock_systimer();
+		while (clock_systimer() == tick) {
+		}
+		tick = clock_systimer();
+		start = up_perf_gettime();
+		timer_settime(timer, 0, &its, NULL);
+	} while (clock_systimer() != tick);
+
+	/* periods[0] is unused, the first wakeup is the reference */
+
+	total = 0;
+	last = 0;
+	for (i = 0; i < LAT_LOOPS; i++) {
+		sigwaitinfo(&set, NULL);
+		now = up_perf_gettime();
+		due = start + (uint32_t)((i + 1) * period);
+		lat_add(&cyclic->latency, (int32_t)(now - due) > 0 ? now - due : 0);
+		if (i > 0) {
+			periods[i] = now - last;
+			total += periods[i];
+		}
+		last = now;
+	}
+
+	timer_delete(timer);
+
+	min = 0;
+	elapsed = 0;
+	for (i = 1; i < LAT_LOOPS; i++) {
+		elapsed += periods[i];
+		offset = (int64_t)elapsed - (int64_t)(total * i / (LAT_LOOPS - 1));
+		if (offset < min) {
+			min = offset;
+		}
+		periods[i] = (uint32_t)offset;
+	}
+
+	lat_add(&cyclic->jitter, (uint32_t)-min);
+	for (i = 1; i < LAT_LOOPS; i++) {
+		lat_add(&cyclic->jitter, (uint32_t)((int32_t)periods[i] - min));
+	}
+
+	free(periods);
+	return NULL;
+}
+
+static void lat_cyclic_test(void)
+{
+	struct lat_cyclic_s cyclic;
+	pthread_t thread;
+
+	lat_init(&cyclic.latency, "cyclic");
+	lat_init(&cyclic.jitter, "cyclic-jit");
+	if (LAT_LOOPS < 2 || lat_thread_create(&thread, LAT_PRIORITY + 1, lat_cyclic_thread, &cyclic) != 0) {
+		printf("cyclic: not run\n");
+		return;
+	}
+	pthread_join(thread, NULL);
+	lat_report(&cyclic.latency);
+	lat_report(&cyclic.jitter);
+}
+
+/****************************************************************************
+ * Semaphore ping-pong
+ *
+ * The main task posts g_ping and waits for g_pong, the woken thread runs
+ * one priority above it and reports the time from the post to its wakeup.
+ ****************************************************************************/
+
+static pthread_addr_t lat_wakeup_thread(pthread_addr_t arg)
+{
+	struct lat_wakeup_s *wakeup = (struct lat_wakeup_s *)arg;
+	int i;
+
+	for (i = 0; i < LAT_LOOPS; i++) {
+		while (sem_wait(&g_ping) != OK) {
+		}
+		lat_add(wakeup->stat, up_perf_gettime() - *wakeup->stamp);
+		sem_post(&g_pong);
+	}
+
+	return NULL;
+}
+
+static void lat_sem_test(void)
+{
+	struct lat_stat_s stat;
+	struct lat_wakeup_s wakeup;
+	pthread_t thread;
+	int i;
+
+	lat_init(&stat, "sem");
+	wakeup.stat = &stat;
+	wakeup.stamp = &g_stamp;
+	if (lat_thread_create(&thread, LAT_PRIORITY + 1, lat_wakeup_thread, &wakeup) != 0) {
+		printf("sem: not run\n");
+		return;
+	}
+
+	for (i = 0; i < LAT_LOOPS; i++) {
+		g_stamp = up_perf_gettime();
+		sem_post(&g_ping);
+		while (sem_wait(&g_pong) != OK) {
+		}
+	}
+
+	pthread_join(thread, NULL);
+	lat_report(&stat);
+}
+
+/****************************************************************************
+ * Message queue ping-pong
+ *
+ * As the semaphore one, the message carries the time it was sent at.  The
+ * main task opens the queues of both sides, the thread shares them, and
+ * waits for each pong a bounded time in case the thread stopped early.
+ ****************************************************************************/
+
+static pthread_addr_t lat_mq_thread(pthread_addr_t arg)
+{
+	struct lat_mq_s *mq = (struct lat_mq_s *)arg;
+	uint32_t stamp;
+	int i;
+
+	for (i = 0; i < LAT_LOOPS; i++) {
+		if (mq_receive(mq->ping, (char *)&stamp, sizeof(stamp), NULL) != sizeof(stamp)) {
+			break;
+		}
+		lat_add(mq->stat, up_perf_gettime() - stamp);
+		if (mq_send(mq->pong, (char *)&stamp, sizeof(stamp), 0) != OK) {
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static void lat_mq_test(void)
+{
+	struct lat_stat_s stat;
+	struct lat_mq_s mq;
+	struct mq_attr attr;
+	struct timespec abstime;
+	pthread_t thread;
+	mqd_t ping;
+	mqd_t pong;
+	uint32_t stamp;
+	int i;
+
+	lat_init(&stat, "mq");
+	attr.mq_maxmsg = 1;
+	attr.mq_msgsize = sizeof(uint32_t);
+	attr.mq_flags = 0;
+	ping = mq_open(LAT_MQ_PING, O_WRONLY | O_CREAT, 0666, &attr);
+	pong = mq_open(LAT_MQ_PONG, O_RDONLY | O_CREAT, 0666, &attr);
+	mq.stat = &stat;
+	mq.ping = mq_open(LAT_MQ_PING, O_RDONLY);
+	mq.pong = mq_open(LAT_MQ_PONG, O_WRONLY);
+	if (ping == (mqd_t)-1 || pong == (mqd_t)-1 || mq.ping == (mqd_t)-1 || mq.pong == (mqd_t)-1) {
+		printf("mq: mq_open failed\n");
+		goto errout;
+	}
+
+	if (lat_thread_create(&thread, LAT_PRIORITY + 1, lat_mq_thread, &mq) != 0) {
+		printf("mq: not run\n");
+		goto errout;
+	}
+
+	for (i = 0; i < LAT_LOOPS; i++) {
+		clock_gettime(CLOCK_REALTIME, &abstime);
+		abstime.tv_sec += LAT_MQ_WAIT;
+		stamp = up_perf_gettime();
+		if (mq_send(ping, (char *)&stamp, sizeof(stamp), 0) != OK || mq_timedreceive(pong, (char *)&stamp, sizeof(stamp), NULL, &abstime) != sizeof(stamp)) {
+			printf("mq: stopped after %d samples\n", i);
+			break;
+		}
+	}
+
+	pthread_join(thread, NULL);
+	lat_report(&stat);
+
+errout:
+	if (ping != (mqd_t)-1) {
+		mq_close(ping);
+	}
+	if (pong != (mqd_t)-1) {
+		mq_close(pong);
+	}
+	if (mq.ping != (mqd_t)-1) {
+		mq_close(mq.ping);
+	}
+	if (mq.pong != (mqd_t)-1) {
+		mq_close(mq.pong);
+	}
+	mq_unlink(LAT_MQ_PING);
+	mq_unlink(LAT_MQ_PONG);
+}
+
+/****************************************************************************
+ * IRQ latency
+ *
+ * The main task triggers LAT_IRQ in software.  Its handler takes the time
+ * and posts g_ping, to the thread one priority above the main task.  The
+ * time from the trigger to the handler and from the handler to the thread
+ * are reported.
+ ****************************************************************************/
+
+static int lat_irq_handler(int irq, FAR void *context, FAR void *arg)
+{
+	g_irq_stamp = up_perf_gettime();
+	sem_post(&g_ping);
+	return OK;
+}
+
+static void lat_irq_test(void)
+{
+#if defined(CONFIG_ARCH_HAVE_IRQTRIGGER) && LAT_IRQ > 0
+	struct lat_stat_s entry;
+	struct lat_stat_s stat;
+	struct lat_wakeup_s wakeup;
+	pthread_t thread;
+	int i;
+
+	lat_init(&entry, "irq");
+	lat_init(&stat, "irq-thread");
+	wakeup.stat = &stat;
+	wakeup.stamp = &g_irq_stamp;
+	if (irq_attach(LAT_IRQ, lat_irq_handler, NULL) != OK) {
+		printf("irq: irq_attach failed\n");
+		return;
+	}
+	up_enable_irq(LAT_IRQ);
+
+	if (lat_thread_create(&thread, LAT_PRIORITY + 1, lat_wakeup_thread, &wakeup) != 0) {
+		printf("irq: not run\n");
+		goto errout;
+	}
+
+	for (i = 0; i < LAT_LOOPS; i++) {
+		g_stamp = up_perf_gettime();
+		up_trigger_irq(LAT_IRQ);
+		while (sem_wait(&g_pong) != OK) {
+		}
+		lat_add(&entry, g_irq_stamp - g_stamp);
+	}
+
+	pthread_join(thread, NULL);
+	lat_report(&entry);
+	lat_report(&stat);
+
+errout:
+	up_disable_irq(LAT_IRQ);
+	irq_detach(LAT_IRQ);
+#else
+	printf("irq: not supported\n");
+#endif
+}
+
+static bool lat_selected(int argc, char *argv[], const char *test)
+{
+	int i;
+
+	if (argc < 2) {
+		return true;
+	}
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], test) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/****************************************************************************
+ * Name: latency_performance_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int latency_performance_main(int argc, char *argv[])
+#endif
+{
+	struct sched_param param;
+	struct sched_param saved;
+
+	g_freq = up_perf_getfreq();
+	if (g_freq == 0) {
+		printf("No performance counter\n");
+		return ERROR;
+	}
+
+	printf("Latency performance, %d loops, %u Hz counter\n", LAT_LOOPS, g_freq);
+
+	/* The main task drives the tests right below the woken threads */
+
+	sched_getparam(0, &saved);
+	param.sched_priority = LAT_PRIORITY;
+	sched_setparam(0, &param);
+
+	sem_init(&g_ping, 0, 0);
+	sem_init(&g_pong, 0, 0);
+	sem_setprotocol(&g_ping, SEM_PRIO_NONE);
+	sem_setprotocol(&g_pong, SEM_PRIO_NONE);
+
+	if (lat_selected(argc, argv, "cyclic")) {
+		lat_cyclic_test();
+	}
+	if (lat_selected(argc, argv, "sem")) {
+		lat_sem_test();
+	}
+	if (lat_selected(argc, argv, "mq")) {
+		lat_mq_test();
+	}
+	if (lat_selected(argc, argv, "irq")) {
+		lat_irq_test();
+	}
+
+	sem_destroy(&g_ping);
+	sem_destroy(&g_pong);
+	sched_setparam(0, &saved);
+
+	return OK;
+}
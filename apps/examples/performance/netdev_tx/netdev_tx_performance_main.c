@@ -0,0 +1,196 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file netdev_tx_performance_main.c
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netutils/netlib.h>
+
+#define PERF_IFNAME    CONFIG_EXAMPLES_NETDEV_TX_PERFORMANCE_IFNAME
+#define PERF_COUNT     CONFIG_EXAMPLES_NETDEV_TX_PERFORMANCE_COUNT
+#define PERF_PORT      CONFIG_EXAMPLES_NETDEV_TX_PERFORMANCE_PORT
+#define PERF_ADDR      "10.250.0.1"
+#define PERF_NETMASK   "255.255.255.0"
+#define PERF_BROADCAST "10.250.0.255"
+#define PERF_MAXSIZE   1472
+
+static const int g_sizes[] = {64, 512, 1024, PERF_MAXSIZE};
+
+static char g_txbuf[PERF_MAXSIZE];
+
+static volatile int g_stop;
+static volatile unsigned int g_rxcount;
+
+static void *perf_receiver(void *arg)
+{
+	int fd = *(int *)arg;
+	char buf[PERF_MAXSIZE];
+
+	while (!g_stop) {
+		if (recv(fd, buf, sizeof(buf), 0) > 0) {
+			g_rxcount++;
+		}
+	}
+
+	return NULL;
+}
+
+static int perf_setup_netdev(void)
+{
+	struct in_addr addr;
+
+	addr.s_addr = inet_addr(PERF_ADDR);
+	if (netlib_set_ipv4addr(PERF_IFNAME, &addr) < 0) {
+		return -1;
+	}
+
+	addr.s_addr = inet_addr(PERF_NETMASK);
+	if (netlib_set_ipv4netmask(PERF_IFNAME, &addr) < 0) {
+		return -1;
+	}
+
+	return netlib_ifup(PERF_IFNAME);
+}
+
+static void perf_run(int fd, int size)
+{
+	struct sockaddr_in to;
+	struct timespec start;
+	struct timespec end;
+	unsigned long us;
+	unsigned int rx;
+	int sent = 0;
+	int i;
+
+	memset(&to, 0, sizeof(to));
+	to.sin_family = AF_INET;
+	to.sin_port = htons(PERF_PORT);
+	to.sin_addr.s_addr = inet_addr(PERF_BROADCAST);
+
+	rx = g_rxcount;
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < PERF_COUNT; i++) {
+		if (sendto(fd, g_txbuf, size, 0, (struct sockaddr *)&to, sizeof(to)) == size) {
+			sent++;
+		}
+	}
+	clock_gettime(CLOCK_REALTIME, &end);
+
+	/* Let the receiver drain the loopback */
+
+	usleep(200000);
+
+	us = (end.tv_sec - start.tv_sec) * 1000000UL + (end.tv_nsec - start.tv_nsec) / 1000;
+	if (us == 0) {
+		us = 1;
+	}
+
+	printf("%5d bytes : sent %5d/%d in %8lu us, %6lu KB/s, looped back %u\n", size, sent, PERF_COUNT, us,
+		   (unsigned long)(((unsigned long long)sent * size * 1000000 / us) >> 10), g_rxcount - rx);
+}
+
+/****************************************************************************
+ * Name: netdev_tx_performance_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int netdev_tx_performance_main(int argc, char *argv[])
+#endif
+{
+	struct sockaddr_in addr;
+	struct timeval tv;
+	pthread_t tid;
+	int txfd;
+	int rxfd;
+	int on = 1;
+	unsigned int i;
+
+	if (perf_setup_netdev() < 0) {
+		printf("cannot configure %s, errno %d\n", PERF_IFNAME, errno);
+		return -1;
+	}
+
+	rxfd = socket(AF_INET, SOCK_DGRAM, 0);
+	txfd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (rxfd < 0 || txfd < 0) {
+		printf("socket fail, errno %d\n", errno);
+		goto errout;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(PERF_PORT);
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	if (bind(rxfd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printf("bind fail, errno %d\n", errno);
+		goto errout;
+	}
+
+	/* The timeout lets the receiver notice g_stop */
+
+	tv.tv_sec = 0;
+	tv.tv_usec = 100000;
+	setsockopt(rxfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+	setsockopt(txfd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+
+	g_stop = 0;
+	g_rxcount = 0;
+	if (pthread_create(&tid, NULL, perf_receiver, &rxfd) != 0) {
+		printf("pthread_create fail\n");
+		goto errout;
+	}
+
+	memset(g_txbuf, 0x5a, sizeof(g_txbuf));
+
+#ifdef CONFIG_NETDEV_TX_SG
+	printf("netdev TX on %s: scatter-gather\n", PERF_IFNAME);
+#else
+	printf("netdev TX on %s: linearized copy\n", PERF_IFNAME);
+#endif
+	for (i = 0; i < sizeof(g_sizes) / sizeof(g_sizes[0]); i++) {
+		perf_run(txfd, g_sizes[i]);
+	}
+
+	g_stop = 1;
+	pthread_join(tid, NULL);
+
+	close(txfd);
+	close(rxfd);
+	return 0;
+
+errout:
+	if (txfd >= 0) {
+		close(txfd);
+	}
+	if (rxfd >= 0) {
+		close(rxfd);
+	}
+	return -1;
+}
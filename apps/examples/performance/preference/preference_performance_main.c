@@ -0,0 +1,155 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file preference_performance_main.c
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <preference/preference.h>
+
+#define PERF_KEYS      CONFIG_EXAMPLES_PREFERENCE_PERFORMANCE_KEYS
+#define PERF_UPDATES   CONFIG_EXAMPLES_PREFERENCE_PERFORMANCE_UPDATES
+#define PERF_READS     CONFIG_EXAMPLES_PREFERENCE_PERFORMANCE_READS
+#define PERF_DIR       "perf"
+#define PERF_PROC_PATH "/proc/fs/smartfs"
+
+#ifdef CONFIG_PREFERENCE_LOG_STORE
+#define PERF_STORE "log"
+#else
+#define PERF_STORE "file per key"
+#endif
+
+struct perf_sectors_s {
+	long free;
+	long released;
+};
+
+/* Sum the sector counters of the smartfs mounts, zero without procfs */
+
+static void perf_get_sectors(struct perf_sectors_s *sectors)
+{
+	DIR *dir;
+	FILE *fp;
+	struct dirent *entry;
+	char path[64];
+	char line[64];
+	long value;
+
+	sectors->free = 0;
+	sectors->released = 0;
+
+	dir = opendir(PERF_PROC_PATH);
+	if (dir == NULL) {
+		return;
+	}
+	while ((entry = readdir(dir)) != NULL) {
+		snprintf(path, sizeof(path), "%s/%s/status", PERF_PROC_PATH, entry->d_name);
+		fp = fopen(path, "r");
+		if (fp == NULL) {
+			continue;
+		}
+		while (fgets(line, sizeof(line), fp) != NULL) {
+			if (sscanf(line, "Free Sectors %ld", &value) == 1) {
+				sectors->free += value;
+			} else if (sscanf(line, "Released Sectors %ld", &value) == 1) {
+				sectors->released += value;
+			}
+		}
+		fclose(fp);
+	}
+	closedir(dir);
+}
+
+static unsigned long perf_elapsed_us(struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_REALTIME, &end);
+	return (end.tv_sec - start->tv_sec) * 1000000UL + (end.tv_nsec - start->tv_nsec) / 1000;
+}
+
+/* Sectors are reported in tenths per operation */
+
+static void perf_report(const char *phase, int ops, unsigned long us, struct perf_sectors_s *before)
+{
+	struct perf_sectors_s after;
+	long taken;
+	long released;
+
+	perf_get_sectors(&after);
+	taken = (before->free - after.free) * 10 / ops;
+	released = (after.released - before->released) * 10 / ops;
+	printf("%-8s: %5d ops, %6lu us/op, sectors/op taken %ld.%ld released %ld.%ld\n", phase, ops, us / ops, taken / 10, labs(taken % 10), released / 10, labs(released % 10));
+}
+
+/****************************************************************************
+ * Name: preference_performance_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int preference_performance_main(int argc, char *argv[])
+#endif
+{
+	struct perf_sectors_s sectors;
+	struct timespec start;
+	char key[32];
+	int value;
+	int ret = 0;
+	int i;
+
+	printf("Preference performance, %s store, %d keys\n", PERF_STORE, PERF_KEYS);
+
+	/* Settings written once, as at the first boot */
+	perf_get_sectors(&sectors);
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < PERF_KEYS && ret == 0; i++) {
+		snprintf(key, sizeof(key), PERF_DIR "/key%d", i);
+		ret = preference_shared_set_int(key, i);
+	}
+	perf_report("create", PERF_KEYS, perf_elapsed_us(&start), &sectors);
+
+	/* The same keys updated over and over */
+	perf_get_sectors(&sectors);
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < PERF_UPDATES && ret == 0; i++) {
+		snprintf(key, sizeof(key), PERF_DIR "/key%d", i % PERF_KEYS);
+		ret = preference_shared_set_int(key, i);
+	}
+	perf_report("update", PERF_UPDATES, perf_elapsed_us(&start), &sectors);
+
+	perf_get_sectors(&sectors);
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < PERF_READS && ret == 0; i++) {
+		snprintf(key, sizeof(key), PERF_DIR "/key%d", i % PERF_KEYS);
+		ret = preference_shared_get_int(key, &value);
+	}
+	perf_report("read", PERF_READS, perf_elapsed_us(&start), &sectors);
+
+	if (ret != 0) {
+		printf("fail, %d\n", ret);
+	}
+	preference_shared_remove_all(PERF_DIR);
+
+	return ret;
+}
@@ -0,0 +1,372 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file splice_performance_main.c
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+#ifdef CONFIG_NET
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+#define PERF_BUFSIZE	512
+#define PERF_SCRATCH	CONFIG_EXAMPLES_SPLICE_PERFORMANCE_FILE ".out"
+
+/* Copies up to 'len' bytes from infd to outfd, returns bytes or -1 */
+
+typedef ssize_t (*perf_copy_t)(int outfd, int infd, size_t len);
+
+static unsigned long perf_elapsed_us(struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_REALTIME, &end);
+	return (end.tv_sec - start->tv_sec) * 1000000UL + (end.tv_nsec - start->tv_nsec) / 1000;
+}
+
+static void perf_report(const char *name, ssize_t bytes, unsigned long us)
+{
+	if (bytes < 0) {
+		printf("%-24s : failed, errno %d\n", name, errno);
+		return;
+	}
+
+	if (us == 0) {
+		us = 1;
+	}
+
+	printf("%-24s : %8ld bytes in %8lu us, %6lu KB/s\n", name, (long)bytes, us, (unsigned long)(((unsigned long long)bytes * 1000000 / us) >> 10));
+}
+
+static ssize_t perf_copy_rw(int outfd, int infd, size_t len)
+{
+	char buf[PERF_BUFSIZE];
+	ssize_t total = 0;
+	ssize_t nread;
+	ssize_t nwritten;
+
+	while ((size_t)total < len) {
+		nread = read(infd, buf, sizeof(buf));
+		if (nread <= 0) {
+			return nread < 0 ? -1 : total;
+		}
+
+		nwritten = write(outfd, buf, nread);
+		if (nwritten != nread) {
+			return -1;
+		}
+		total += nwritten;
+	}
+
+	return total;
+}
+
+static ssize_t perf_copy_sendfile(int outfd, int infd, size_t len)
+{
+	return sendfile(outfd, infd, NULL, len);
+}
+
+static ssize_t perf_copy_splice(int outfd, int infd, size_t len)
+{
+	ssize_t total = 0;
+	ssize_t ret;
+
+	/* Pipe sources return what is buffered, loop until 'len' or EOF */
+
+	while ((size_t)total < len) {
+		ret = splice(infd, NULL, outfd, NULL, len - total, SPLICE_F_MOVE);
+		if (ret <= 0) {
+			return ret < 0 ? -1 : total;
+		}
+		total += ret;
+	}
+
+	return total;
+}
+
+static int perf_make_file(const char *path, size_t size)
+{
+	char buf[PERF_BUFSIZE];
+	size_t i;
+	int fd;
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0) {
+		return -1;
+	}
+
+	for (i = 0; i < PERF_BUFSIZE; i++) {
+		buf[i] = (char)i;
+	}
+
+	for (i = 0; i < size; i += PERF_BUFSIZE) {
+		if (write(fd, buf, PERF_BUFSIZE) != PERF_BUFSIZE) {
+			close(fd);
+			return -1;
+		}
+	}
+
+	close(fd);
+	return 0;
+}
+
+/****************************************************************************
+ * file -> file
+ ****************************************************************************/
+
+static void perf_file_to_file(const char *name, const char *src, size_t size, perf_copy_t copy)
+{
+	struct timespec start;
+	ssize_t ret = -1;
+	int infd;
+	int outfd;
+
+	infd = open(src, O_RDONLY);
+	outfd = open(PERF_SCRATCH, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (infd >= 0 && outfd >= 0) {
+		clock_gettime(CLOCK_REALTIME, &start);
+		ret = copy(outfd, infd, size);
+		perf_report(name, ret, perf_elapsed_us(&start));
+	} else {
+		perf_report(name, -1, 0);
+	}
+
+	if (infd >= 0) {
+		close(infd);
+	}
+	if (outfd >= 0) {
+		close(outfd);
+	}
+	unlink(PERF_SCRATCH);
+}
+
+/****************************************************************************
+ * file -> pipe -> file
+ ****************************************************************************/
+
+struct perf_pipe_s {
+	const char *path;
+	int fd;
+	perf_copy_t copy;
+	size_t size;
+	ssize_t result;
+};
+
+static void *perf_pipe_writer(void *arg)
+{
+	struct perf_pipe_s *p = (struct perf_pipe_s *)arg;
+	int infd = open(p->path, O_RDONLY);
+
+	p->result = infd < 0 ? -1 : p->copy(p->fd, infd, p->size);
+	if (infd >= 0) {
+		close(infd);
+	}
+
+	/* Closing the write end gives the reader its end of file */
+
+	close(p->fd);
+	return NULL;
+}
+
+static void perf_file_pipe_file(const char *name, const char *src, size_t size, perf_copy_t copy)
+{
+	struct perf_pipe_s writer;
+	struct timespec start;
+	pthread_t tid;
+	ssize_t ret;
+	int pipefd[2];
+	int outfd;
+
+	if (pipe(pipefd) < 0) {
+		perf_report(name, -1, 0);
+		return;
+	}
+
+	outfd = open(PERF_SCRATCH, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (outfd < 0) {
+		close(pipefd[0]);
+		close(pipefd[1]);
+		perf_report(name, -1, 0);
+		return;
+	}
+
+	writer.path = src;
+	writer.fd = pipefd[1];
+	writer.copy = copy;
+	writer.size = size;
+	writer.result = -1;
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	if (pthread_create(&tid, NULL, perf_pipe_writer, &writer) != 0) {
+		close(pipefd[1]);
+		ret = -1;
+	} else {
+		ret = copy(outfd, pipefd[0], size);
+		pthread_join(tid, NULL);
+		if (writer.result < 0) {
+			ret = -1;
+		}
+	}
+	perf_report(name, ret, perf_elapsed_us(&start));
+
+	close(pipefd[0]);
+	close(outfd);
+	unlink(PERF_SCRATCH);
+}
+
+#ifdef CONFIG_NET
+/****************************************************************************
+ * file -> TCP loopback
+ ****************************************************************************/
+
+static void *perf_tcp_sink(void *arg)
+{
+	int listenfd = *(int *)arg;
+	char buf[PERF_BUFSIZE];
+	int fd;
+
+	fd = accept(listenfd, NULL, NULL);
+	if (fd >= 0) {
+		while (recv(fd, buf, sizeof(buf), 0) > 0) {
+		}
+		close(fd);
+	}
+
+	return NULL;
+}
+
+static void perf_file_to_tcp(const char *name, const char *src, size_t size, perf_copy_t copy)
+{
+	struct sockaddr_in addr;
+	struct timespec start;
+	pthread_t tid;
+	ssize_t ret = -1;
+	int listenfd;
+	int sockfd = -1;
+	int infd;
+	int on = 1;
+
+	listenfd = socket(AF_INET, SOCK_STREAM, 0);
+	if (listenfd < 0) {
+		perf_report(name, -1, 0);
+		return;
+	}
+
+	setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(CONFIG_EXAMPLES_SPLICE_PERFORMANCE_PORT);
+	addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+	if (bind(listenfd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listenfd, 1) < 0) {
+		close(listenfd);
+		perf_report(name, -1, 0);
+		return;
+	}
+
+	if (pthread_create(&tid, NULL, perf_tcp_sink, &listenfd) != 0) {
+		close(listenfd);
+		perf_report(name, -1, 0);
+		return;
+	}
+
+	infd = open(src, O_RDONLY);
+	sockfd = socket(AF_INET, SOCK_STREAM, 0);
+	if (infd >= 0 && sockfd >= 0 && connect(sockfd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+		clock_gettime(CLOCK_REALTIME, &start);
+		ret = copy(sockfd, infd, size);
+		perf_report(name, ret, perf_elapsed_us(&start));
+	} else {
+		perf_report(name, -1, 0);
+	}
+
+	if (sockfd >= 0) {
+		close(sockfd);
+	}
+	if (infd >= 0) {
+		close(infd);
+	}
+
+	/* Closing the listener also wakes the sink if connect() failed */
+
+	close(listenfd);
+	pthread_join(tid, NULL);
+}
+#endif
+
+/****************************************************************************
+ * Name: splice_performance_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int splice_performance_main(int argc, char *argv[])
+#endif
+{
+	const char *src = CONFIG_EXAMPLES_SPLICE_PERFORMANCE_FILE;
+	size_t size = CONFIG_EXAMPLES_SPLICE_PERFORMANCE_SIZE;
+	struct stat st;
+
+	if (argc > 1) {
+		/* Use an existing file, e.g. on an XIP ROMFS, as the source */
+
+		src = argv[1];
+		if (stat(src, &st) < 0) {
+			printf("cannot stat %s, errno %d\n", src, errno);
+			return -1;
+		}
+		size = st.st_size;
+	} else if (perf_make_file(src, size) < 0) {
+		printf("cannot create %s, errno %d\n", src, errno);
+		return -1;
+	}
+
+	printf("splice performance, source %s (%u bytes)\n", src, (unsigned int)size);
+
+	perf_file_to_file("file->file read/write", src, size, perf_copy_rw);
+	perf_file_to_file("file->file sendfile", src, size, perf_copy_sendfile);
+
+#ifdef CONFIG_PIPES
+	perf_file_pipe_file("file->pipe->file rw", src, size, perf_copy_rw);
+	perf_file_pipe_file("file->pipe->file splice", src, size, perf_copy_splice);
+#endif
+
+#ifdef CONFIG_NET
+	perf_file_to_tcp("file->tcp read/send", src, size, perf_copy_rw);
+	perf_file_to_tcp("file->tcp sendfile", src, size, perf_copy_sendfile);
+#endif
+
+	if (argc <= 1) {
+		unlink(src);
+	}
+
+	return 0;
+}
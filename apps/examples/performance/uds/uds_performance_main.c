@@ -0,0 +1,272 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file uds_performance_main.c
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define PERF_PATH       CONFIG_EXAMPLES_UDS_PERFORMANCE_PATH
+#define PERF_PINGSIZE   CONFIG_EXAMPLES_UDS_PERFORMANCE_PING_SIZE
+#define PERF_BUFSIZE    CONFIG_EXAMPLES_UDS_PERFORMANCE_BUFSIZE
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+#define PERF_TRANSPORT  "ring"
+#else
+#define PERF_TRANSPORT  "fifo"
+#endif
+
+struct perf_server_s {
+	int listenfd;					/* closed by the main task after the join */
+	int result;
+	unsigned long bytes;
+	unsigned long us;				/* time until the end of file */
+	struct timespec start;
+	sem_t ready;
+};
+
+static unsigned long perf_elapsed_us(struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_REALTIME, &end);
+	return (end.tv_sec - start->tv_sec) * 1000000UL + (end.tv_nsec - start->tv_nsec) / 1000;
+}
+
+static unsigned long perf_rate(unsigned long count, unsigned long us)
+{
+	return (unsigned long)((unsigned long long)count * 1000000 / (us ? us : 1));
+}
+
+static void perf_addr(struct sockaddr_un *addr)
+{
+	memset(addr, 0, sizeof(*addr));
+	addr->sun_family = AF_UNIX;
+	strncpy(addr->sun_path, PERF_PATH, sizeof(addr->sun_path) - 1);
+}
+
+/* A stream may return less than asked for, read until the whole message is in */
+
+static int perf_recv_all(int fd, char *buf, size_t len)
+{
+	ssize_t ret;
+	size_t nread = 0;
+
+	while (nread < len) {
+		ret = recv(fd, buf + nread, len - nread, 0);
+		if (ret <= 0) {
+			return -1;
+		}
+		nread += ret;
+	}
+
+	return 0;
+}
+
+/****************************************************************************
+ * Server: echoes the pings, then drains the stream until end of file
+ ****************************************************************************/
+
+static void *perf_server(void *arg)
+{
+	struct perf_server_s *srv = (struct perf_server_s *)arg;
+	struct sockaddr_un addr;
+	char buf[PERF_BUFSIZE > PERF_PINGSIZE ? PERF_BUFSIZE : PERF_PINGSIZE];
+	ssize_t ret;
+	int fd;
+	int i;
+
+	srv->result = -1;
+	srv->listenfd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (srv->listenfd < 0) {
+		sem_post(&srv->ready);
+		return NULL;
+	}
+
+	perf_addr(&addr);
+	if (bind(srv->listenfd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(srv->listenfd, 1) < 0) {
+		sem_post(&srv->ready);
+		return NULL;
+	}
+
+	srv->result = 0;
+	sem_post(&srv->ready);
+
+	fd = accept(srv->listenfd, NULL, NULL);
+	if (fd < 0) {
+		srv->result = -1;
+		return NULL;
+	}
+
+	for (i = 0; i < CONFIG_EXAMPLES_UDS_PERFORMANCE_PING_COUNT; i++) {
+		if (perf_recv_all(fd, buf, PERF_PINGSIZE) < 0 || send(fd, buf, PERF_PINGSIZE, 0) != PERF_PINGSIZE) {
+			break;
+		}
+	}
+
+	/* The client starts the clock right before streaming */
+
+	while ((ret = recv(fd, buf, PERF_BUFSIZE, 0)) > 0) {
+		srv->bytes += ret;
+	}
+	srv->us = perf_elapsed_us(&srv->start);
+
+	close(fd);
+	return NULL;
+}
+
+/****************************************************************************
+ * Ping-pong latency
+ ****************************************************************************/
+
+static void perf_latency(int fd)
+{
+	struct timespec start;
+	char buf[PERF_PINGSIZE];
+	unsigned long min = (unsigned long)-1;
+	unsigned long max = 0;
+	unsigned long sum = 0;
+	unsigned long replies = 0;
+	unsigned long us;
+	int i;
+
+	memset(buf, 0x5a, sizeof(buf));
+	for (i = 0; i < CONFIG_EXAMPLES_UDS_PERFORMANCE_PING_COUNT; i++) {
+		clock_gettime(CLOCK_REALTIME, &start);
+		if (send(fd, buf, sizeof(buf), 0) != sizeof(buf) || perf_recv_all(fd, buf, sizeof(buf)) < 0) {
+			break;
+		}
+
+		us = perf_elapsed_us(&start);
+		replies++;
+		sum += us;
+		if (us < min) {
+			min = us;
+		}
+		if (us > max) {
+			max = us;
+		}
+	}
+
+	if (replies == 0) {
+		printf("uds latency    : no echo, errno %d\n", errno);
+		return;
+	}
+
+	printf("uds latency    : %8lu/%d round trips of %d bytes, rtt min/avg/max %lu/%lu/%lu us\n", replies, CONFIG_EXAMPLES_UDS_PERFORMANCE_PING_COUNT, PERF_PINGSIZE, min, sum / replies, max);
+}
+
+/****************************************************************************
+ * Stream throughput
+ ****************************************************************************/
+
+static unsigned long perf_throughput(int fd, struct perf_server_s *srv)
+{
+	char buf[PERF_BUFSIZE];
+	unsigned long sent = 0;
+	ssize_t ret;
+
+	memset(buf, 0x5a, sizeof(buf));
+	clock_gettime(CLOCK_REALTIME, &srv->start);
+	while (sent < CONFIG_EXAMPLES_UDS_PERFORMANCE_STREAM_SIZE) {
+		ret = send(fd, buf, sizeof(buf), 0);
+		if (ret <= 0) {
+			break;
+		}
+		sent += ret;
+	}
+
+	return sent;
+}
+
+/****************************************************************************
+ * Name: uds_performance_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int uds_performance_main(int argc, char *argv[])
+#endif
+{
+	struct perf_server_s srv;
+	struct sockaddr_un addr;
+	unsigned long sent = 0;
+	pthread_t tid;
+	int fd;
+
+	printf("uds performance, %s, transport %s\n", PERF_PATH, PERF_TRANSPORT);
+
+	memset(&srv, 0, sizeof(srv));
+	srv.listenfd = -1;
+	sem_init(&srv.ready, 0, 0);
+	unlink(PERF_PATH);
+
+	if (pthread_create(&tid, NULL, perf_server, &srv) != 0) {
+		printf("uds            : server fail, errno %d\n", errno);
+		sem_destroy(&srv.ready);
+		return -1;
+	}
+
+	sem_wait(&srv.ready);
+	if (srv.result < 0) {
+		printf("uds            : bind/listen fail\n");
+		pthread_join(tid, NULL);
+		if (srv.listenfd >= 0) {
+			close(srv.listenfd);
+		}
+		sem_destroy(&srv.ready);
+		return -1;
+	}
+
+	perf_addr(&addr);
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd >= 0 && connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+		perf_latency(fd);
+		sent = perf_throughput(fd, &srv);
+	} else {
+		/* Closing a listening socket does not wake accept(), cancel it */
+
+		printf("uds            : connect fail, errno %d\n", errno);
+		pthread_cancel(tid);
+	}
+
+	/* Closing the connection gives the server its end of file */
+
+	if (fd >= 0) {
+		close(fd);
+	}
+	pthread_join(tid, NULL);
+	close(srv.listenfd);
+
+	if (sent > 0) {
+		printf("uds throughput : %8lu/%lu bytes in %8lu us, %6lu KB/s\n", srv.bytes, sent, srv.us, perf_rate(srv.bytes, srv.us) >> 10);
+	}
+
+	sem_destroy(&srv.ready);
+	unlink(PERF_PATH);
+	return 0;
+}
@@ -0,0 +1,443 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file vnetpair_performance_main.c
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netutils/netlib.h>
+
+#define PERF_SERVER_ADDR "10.251.0.1"
+#define PERF_CLIENT_ADDR "10.251.0.2"
+#define PERF_NETMASK     "255.255.255.0"
+
+#define PERF_TCP_PORT    (CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_PORT)
+#define PERF_UDP_PORT    (CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_PORT + 1)
+#define PERF_CONN_PORT   (CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_PORT + 2)
+#define PERF_PING_PORT   (CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_PORT + 3)
+
+#define PERF_BUFSIZE     1024
+#define PERF_PINGSIZE    64
+
+/* Receive timeout of the server threads, in msec */
+
+#define PERF_TIMEOUT     500
+
+struct perf_server_s {
+	int fd;
+	unsigned long count;			/* datagrams or connections */
+	unsigned long bytes;
+	unsigned long us;				/* time until the last one arrived */
+	struct timespec start;
+};
+
+static volatile int g_stop;
+
+static unsigned long perf_elapsed_us(struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_REALTIME, &end);
+	return (end.tv_sec - start->tv_sec) * 1000000UL + (end.tv_nsec - start->tv_nsec) / 1000;
+}
+
+static unsigned long perf_rate(unsigned long count, unsigned long us)
+{
+	return (unsigned long)((unsigned long long)count * 1000000 / (us ? us : 1));
+}
+
+static int perf_setup_end(const char *ifname, const char *ipaddr)
+{
+	struct in_addr addr;
+
+	addr.s_addr = inet_addr(ipaddr);
+	if (netlib_set_ipv4addr(ifname, &addr) < 0) {
+		return -1;
+	}
+
+	addr.s_addr = inet_addr(PERF_NETMASK);
+	if (netlib_set_ipv4netmask(ifname, &addr) < 0) {
+		return -1;
+	}
+
+	return netlib_ifup(ifname);
+}
+
+static void perf_addr(struct sockaddr_in *addr, const char *ipaddr, int port)
+{
+	memset(addr, 0, sizeof(*addr));
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	addr->sin_addr.s_addr = inet_addr(ipaddr);
+}
+
+/* Sockets are bound to their end so the traffic crosses the pair */
+
+static int perf_socket(int type, const char *ipaddr, int port)
+{
+	struct sockaddr_in addr;
+	struct timeval tv;
+	int on = 1;
+	int fd;
+
+	fd = socket(AF_INET, type, 0);
+	if (fd < 0) {
+		return -1;
+	}
+
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	perf_addr(&addr, ipaddr, port);
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		close(fd);
+		return -1;
+	}
+
+	tv.tv_sec = PERF_TIMEOUT / 1000;
+	tv.tv_usec = (PERF_TIMEOUT % 1000) * 1000;
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+	if (type == SOCK_STREAM && port != 0 && listen(fd, 4) < 0) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static int perf_start_server(pthread_t *tid, void *(*server)(void *), struct perf_server_s *srv, int type, int port)
+{
+	memset(srv, 0, sizeof(*srv));
+	srv->fd = perf_socket(type, PERF_SERVER_ADDR, port);
+	if (srv->fd < 0) {
+		return -1;
+	}
+
+	g_stop = 0;
+	clock_gettime(CLOCK_REALTIME, &srv->start);
+	if (pthread_create(tid, NULL, server, srv) != 0) {
+		close(srv->fd);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void perf_stop_server(pthread_t tid, struct perf_server_s *srv)
+{
+	g_stop = 1;
+	pthread_join(tid, NULL);
+	close(srv->fd);
+}
+
+/****************************************************************************
+ * TCP throughput
+ ****************************************************************************/
+
+static void *perf_tcp_server(void *arg)
+{
+	struct perf_server_s *srv = (struct perf_server_s *)arg;
+	char buf[PERF_BUFSIZE];
+	ssize_t ret;
+	int fd;
+
+	/* accept() times out, keep waiting until the client gives up */
+
+	while ((fd = accept(srv->fd, NULL, NULL)) < 0) {
+		if (g_stop) {
+			return NULL;
+		}
+	}
+
+	while ((ret = recv(fd, buf, sizeof(buf), 0)) > 0 || (ret < 0 && errno == EAGAIN && !g_stop)) {
+		if (ret > 0) {
+			srv->bytes += ret;
+		}
+	}
+	srv->us = perf_elapsed_us(&srv->start);
+
+	close(fd);
+	return NULL;
+}
+
+static void perf_tcp_throughput(void)
+{
+	struct perf_server_s srv;
+	struct sockaddr_in to;
+	char buf[PERF_BUFSIZE];
+	unsigned long sent = 0;
+	pthread_t tid;
+	ssize_t ret;
+	int fd;
+
+	if (perf_start_server(&tid, perf_tcp_server, &srv, SOCK_STREAM, PERF_TCP_PORT) < 0) {
+		printf("tcp throughput : server fail, errno %d\n", errno);
+		return;
+	}
+
+	memset(buf, 0x5a, sizeof(buf));
+	perf_addr(&to, PERF_SERVER_ADDR, PERF_TCP_PORT);
+	fd = perf_socket(SOCK_STREAM, PERF_CLIENT_ADDR, 0);
+	if (fd >= 0 && connect(fd, (struct sockaddr *)&to, sizeof(to)) == 0) {
+		clock_gettime(CLOCK_REALTIME, &srv.start);
+		while (sent < CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_TCP_SIZE) {
+			ret = send(fd, buf, sizeof(buf), 0);
+			if (ret <= 0) {
+				break;
+			}
+			sent += ret;
+		}
+	}
+
+	/* Closing the connection gives the server its end of file */
+
+	if (fd >= 0) {
+		close(fd);
+	}
+	perf_stop_server(tid, &srv);
+
+	printf("tcp throughput : %8lu/%lu bytes in %8lu us, %6lu KB/s\n", srv.bytes, sent, srv.us, perf_rate(srv.bytes, srv.us) >> 10);
+}
+
+/****************************************************************************
+ * UDP throughput
+ ****************************************************************************/
+
+static void *perf_udp_server(void *arg)
+{
+	struct perf_server_s *srv = (struct perf_server_s *)arg;
+	char buf[PERF_BUFSIZE];
+	ssize_t ret;
+
+	while ((ret = recv(srv->fd, buf, sizeof(buf), 0)) > 0 || !g_stop) {
+		if (ret > 0) {
+			srv->count++;
+			srv->bytes += ret;
+			srv->us = perf_elapsed_us(&srv->start);
+		}
+	}
+
+	return NULL;
+}
+
+static void perf_udp_throughput(void)
+{
+	struct perf_server_s srv;
+	struct sockaddr_in to;
+	char buf[PERF_BUFSIZE];
+	unsigned long sent = 0;
+	pthread_t tid;
+	int fd;
+	int i;
+
+	if (perf_start_server(&tid, perf_udp_server, &srv, SOCK_DGRAM, PERF_UDP_PORT) < 0) {
+		printf("udp throughput : server fail, errno %d\n", errno);
+		return;
+	}
+
+	memset(buf, 0x5a, sizeof(buf));
+	perf_addr(&to, PERF_SERVER_ADDR, PERF_UDP_PORT);
+	fd = perf_socket(SOCK_DGRAM, PERF_CLIENT_ADDR, 0);
+	if (fd >= 0) {
+		clock_gettime(CLOCK_REALTIME, &srv.start);
+		for (i = 0; i < CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_UDP_COUNT; i++) {
+			if (sendto(fd, buf, sizeof(buf), 0, (struct sockaddr *)&to, sizeof(to)) == sizeof(buf)) {
+				sent++;
+			}
+		}
+		close(fd);
+	}
+
+	/* The server stops once it times out with nothing left in flight */
+
+	perf_stop_server(tid, &srv);
+
+	printf("udp throughput : %8lu/%lu datagrams in %8lu us, %6lu KB/s, lost %lu\n", srv.count, sent, srv.us, perf_rate(srv.bytes, srv.us) >> 10, sent - srv.count);
+}
+
+/****************************************************************************
+ * TCP connection setup rate
+ ****************************************************************************/
+
+static void *perf_conn_server(void *arg)
+{
+	struct perf_server_s *srv = (struct perf_server_s *)arg;
+	int fd;
+
+	while (!g_stop || srv->count < CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_CONN_COUNT) {
+		fd = accept(srv->fd, NULL, NULL);
+		if (fd >= 0) {
+			srv->count++;
+			close(fd);
+		} else if (g_stop) {
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static void perf_conn_rate(void)
+{
+	struct perf_server_s srv;
+	struct sockaddr_in to;
+	struct timespec start;
+	unsigned long conns = 0;
+	unsigned long us;
+	pthread_t tid;
+	int fd;
+	int i;
+
+	if (perf_start_server(&tid, perf_conn_server, &srv, SOCK_STREAM, PERF_CONN_PORT) < 0) {
+		printf("tcp connection : server fail, errno %d\n", errno);
+		return;
+	}
+
+	perf_addr(&to, PERF_SERVER_ADDR, PERF_CONN_PORT);
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_CONN_COUNT; i++) {
+		fd = perf_socket(SOCK_STREAM, PERF_CLIENT_ADDR, 0);
+		if (fd < 0) {
+			break;
+		}
+		if (connect(fd, (struct sockaddr *)&to, sizeof(to)) == 0) {
+			conns++;
+		}
+		close(fd);
+	}
+	us = perf_elapsed_us(&start);
+
+	perf_stop_server(tid, &srv);
+
+	printf("tcp connection : %8lu/%d connects in %8lu us, %6lu conn/s, accepted %lu\n", conns, CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_CONN_COUNT, us, perf_rate(conns, us), srv.count);
+}
+
+/****************************************************************************
+ * UDP round trip latency
+ ****************************************************************************/
+
+static void *perf_ping_server(void *arg)
+{
+	struct perf_server_s *srv = (struct perf_server_s *)arg;
+	struct sockaddr_in from;
+	socklen_t fromlen;
+	char buf[PERF_PINGSIZE];
+	ssize_t ret;
+
+	while (!g_stop) {
+		fromlen = sizeof(from);
+		ret = recvfrom(srv->fd, buf, sizeof(buf), 0, (struct sockaddr *)&from, &fromlen);
+		if (ret > 0) {
+			sendto(srv->fd, buf, ret, 0, (struct sockaddr *)&from, fromlen);
+		}
+	}
+
+	return NULL;
+}
+
+static void perf_udp_latency(void)
+{
+	struct perf_server_s srv;
+	struct sockaddr_in to;
+	struct timespec start;
+	char buf[PERF_PINGSIZE];
+	unsigned long min = (unsigned long)-1;
+	unsigned long max = 0;
+	unsigned long sum = 0;
+	unsigned long replies = 0;
+	unsigned long us;
+	pthread_t tid;
+	int fd;
+	int i;
+
+	if (perf_start_server(&tid, perf_ping_server, &srv, SOCK_DGRAM, PERF_PING_PORT) < 0) {
+		printf("udp latency    : server fail, errno %d\n", errno);
+		return;
+	}
+
+	memset(buf, 0x5a, sizeof(buf));
+	perf_addr(&to, PERF_SERVER_ADDR, PERF_PING_PORT);
+	fd = perf_socket(SOCK_DGRAM, PERF_CLIENT_ADDR, 0);
+	for (i = 0; fd >= 0 && i < CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_PING_COUNT; i++) {
+		clock_gettime(CLOCK_REALTIME, &start);
+		if (sendto(fd, buf, sizeof(buf), 0, (struct sockaddr *)&to, sizeof(to)) != sizeof(buf)) {
+			continue;
+		}
+
+		/* A lost echo times out after PERF_TIMEOUT */
+
+		if (recv(fd, buf, sizeof(buf), 0) != sizeof(buf)) {
+			continue;
+		}
+
+		us = perf_elapsed_us(&start);
+		replies++;
+		sum += us;
+		if (us < min) {
+			min = us;
+		}
+		if (us > max) {
+			max = us;
+		}
+	}
+
+	if (fd >= 0) {
+		close(fd);
+	}
+	perf_stop_server(tid, &srv);
+
+	if (replies == 0) {
+		printf("udp latency    : no echo\n");
+		return;
+	}
+
+	printf("udp latency    : %8lu/%d echoes, rtt min/avg/max %lu/%lu/%lu us\n", replies, CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_PING_COUNT, min, sum / replies, max);
+}
+
+/****************************************************************************
+ * Name: vnetpair_performance_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int vnetpair_performance_main(int argc, char *argv[])
+#endif
+{
+	if (perf_setup_end(CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_IFNAME0, PERF_SERVER_ADDR) < 0 || perf_setup_end(CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_IFNAME1, PERF_CLIENT_ADDR) < 0) {
+		printf("cannot configure the pair, errno %d\n", errno);
+		return -1;
+	}
+
+	printf("vnetpair performance, %s %s <-> %s %s\n", CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_IFNAME1, PERF_CLIENT_ADDR, CONFIG_EXAMPLES_VNETPAIR_PERFORMANCE_IFNAME0, PERF_SERVER_ADDR);
+
+	perf_tcp_throughput();
+	perf_udp_throughput();
+	perf_conn_rate();
+	perf_udp_latency();
+
+	return 0;
+}
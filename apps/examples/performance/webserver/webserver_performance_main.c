@@ -0,0 +1,367 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file webserver_performance_main.c
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <protocols/webserver/http_err.h>
+#include <protocols/webserver/http_server.h>
+#include <protocols/webserver/http_keyvalue_list.h>
+
+#define PERF_PORT       CONFIG_EXAMPLES_WEBSERVER_PERFORMANCE_PORT
+#define PERF_COUNT      CONFIG_EXAMPLES_WEBSERVER_PERFORMANCE_REQUEST_COUNT
+#define PERF_DEPTH      CONFIG_EXAMPLES_WEBSERVER_PERFORMANCE_PIPELINE_DEPTH
+#define PERF_FILE       CONFIG_EXAMPLES_WEBSERVER_PERFORMANCE_FILE_PATH
+#define PERF_FILESIZE   CONFIG_EXAMPLES_WEBSERVER_PERFORMANCE_FILE_SIZE
+#define PERF_BUFSIZE    (PERF_FILESIZE + 1024)
+#define PERF_ETAGSIZE   32
+
+#ifdef CONFIG_NETUTILS_WEBSERVER_EVENT_LOOP
+#define PERF_MODEL      "event loop"
+#else
+#define PERF_MODEL      "handler threads"
+#endif
+
+/* One client connection, with the bytes read past the last response */
+
+struct perf_conn_s {
+	int fd;
+	int len;
+	int closed;					/* the server announced Connection: close */
+	int connects;
+	char etag[PERF_ETAGSIZE];
+	char buf[PERF_BUFSIZE + 1];
+};
+
+static struct perf_conn_s g_conn;
+
+static unsigned long perf_elapsed_us(struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_REALTIME, &end);
+	return (end.tv_sec - start->tv_sec) * 1000000UL + (end.tv_nsec - start->tv_nsec) / 1000;
+}
+
+static unsigned long perf_rate(unsigned long count, unsigned long us)
+{
+	return (unsigned long)((unsigned long long)count * 1000000 / (us ? us : 1));
+}
+
+/****************************************************************************
+ * Server callbacks
+ ****************************************************************************/
+
+static void perf_get_small(struct http_client_t *client, struct http_req_message *req)
+{
+	http_send_response(client, 200, "ok", NULL);
+}
+
+static void perf_get_file(struct http_client_t *client, struct http_req_message *req)
+{
+	http_send_file(client, req, PERF_FILE, "text/html");
+}
+
+static int perf_make_file(void)
+{
+	char buf[64];
+	int left = PERF_FILESIZE;
+	int fd;
+
+	fd = open(PERF_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0) {
+		return -1;
+	}
+	memset(buf, 'w', sizeof(buf));
+	while (left > 0) {
+		if (write(fd, buf, left < sizeof(buf) ? left : sizeof(buf)) <= 0) {
+			break;
+		}
+		left -= sizeof(buf);
+	}
+	close(fd);
+	return 0;
+}
+
+/****************************************************************************
+ * Client
+ ****************************************************************************/
+
+static int perf_connect(struct perf_conn_s *conn)
+{
+	struct sockaddr_in addr;
+
+	if (conn->fd >= 0) {
+		close(conn->fd);
+	}
+	conn->len = 0;
+	conn->closed = 0;
+
+	conn->fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (conn->fd < 0) {
+		return -1;
+	}
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(PERF_PORT);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (connect(conn->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		close(conn->fd);
+		conn->fd = -1;
+		return -1;
+	}
+	conn->connects++;
+	return 0;
+}
+
+static int perf_send(struct perf_conn_s *conn, const char *req)
+{
+	int len = strlen(req);
+
+	return (send(conn->fd, req, len, 0) == len) ? 0 : -1;
+}
+
+static const char *perf_header(const char *buf, const char *key)
+{
+	const char *p = strstr(buf, key);
+
+	return p ? p + strlen(key) : NULL;
+}
+
+/* Reads one response, returns its status or -1 */
+
+static int perf_recv_response(struct perf_conn_s *conn)
+{
+	const char *value;
+	char *end;
+	int hdrlen = 0;
+	int content_len = -1;
+	int status = -1;
+	int ret;
+
+	for (;;) {
+		if (hdrlen == 0) {
+			conn->buf[conn->len] = '\0';
+			end = strstr(conn->buf, "\r\n\r\n");
+			if (end) {
+				hdrlen = end - conn->buf + 4;
+				*end = '\0';
+				if (strncmp(conn->buf, "HTTP/1.1 ", 9) == 0) {
+					status = atoi(conn->buf + 9);
+				}
+				value = perf_header(conn->buf, "Content-Length: ");
+				content_len = value ? atoi(value) : (status == 304) ? 0 : -1;
+				conn->closed = perf_header(conn->buf, "Connection: close") != NULL;
+				value = perf_header(conn->buf, "ETag: ");
+				if (value) {
+					strncpy(conn->etag, value, sizeof(conn->etag) - 1);
+					conn->etag[strcspn(conn->etag, "\r")] = '\0';
+				}
+			}
+		}
+		if (hdrlen > 0 && content_len >= 0 && conn->len >= hdrlen + content_len) {
+			break;
+		}
+		if (conn->len >= PERF_BUFSIZE) {
+			return -1;
+		}
+
+		ret = recv(conn->fd, conn->buf + conn->len, PERF_BUFSIZE - conn->len, 0);
+		if (ret <= 0) {
+			/* A response without length ends with the connection */
+			if (hdrlen > 0 && content_len < 0) {
+				content_len = conn->len - hdrlen;
+				conn->closed = 1;
+				break;
+			}
+			return -1;
+		}
+		conn->len += ret;
+	}
+
+	conn->len -= hdrlen + content_len;
+	memmove(conn->buf, conn->buf + hdrlen + content_len, conn->len);
+	return status;
+}
+
+/* Sends req on the open connection, opening a new one if the last response closed it */
+
+static int perf_request(struct perf_conn_s *conn, const char *req)
+{
+	if ((conn->fd < 0 || conn->closed) && perf_connect(conn) < 0) {
+		return -1;
+	}
+	if (perf_send(conn, req) < 0) {
+		return -1;
+	}
+	return perf_recv_response(conn);
+}
+
+/****************************************************************************
+ * Measurements
+ ****************************************************************************/
+
+static void perf_report(const char *name, unsigned long done, unsigned long us, int connects)
+{
+	printf("%-16s: %5lu/%d requests in %8lu us, %5lu req/s, %3lu us/req, %d new connections\n", name, done, PERF_COUNT, us, perf_rate(done, us), done ? us / done : 0, connects);
+}
+
+/* A new connection per request */
+
+static void perf_close(void)
+{
+	struct timespec start;
+	unsigned long done = 0;
+	int i;
+
+	g_conn.connects = 0;
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < PERF_COUNT; i++) {
+		if (perf_connect(&g_conn) < 0) {
+			break;
+		}
+		if (perf_send(&g_conn, "GET /perf HTTP/1.1\r\nConnection: close\r\n\r\n") < 0 || perf_recv_response(&g_conn) != 200) {
+			break;
+		}
+		done++;
+	}
+	perf_report("close", done, perf_elapsed_us(&start), g_conn.connects);
+}
+
+/* Requests one after another on one connection, as long as the server keeps it */
+
+static void perf_keepalive(const char *name, const char *req, int expect)
+{
+	struct timespec start;
+	unsigned long done = 0;
+	int i;
+
+	g_conn.connects = 0;
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < PERF_COUNT; i++) {
+		if (perf_request(&g_conn, req) != expect) {
+			break;
+		}
+		done++;
+	}
+	perf_report(name, done, perf_elapsed_us(&start), g_conn.connects);
+}
+
+/* PERF_DEPTH requests sent in one write before reading the responses */
+
+static void perf_pipeline(void)
+{
+	static const char req[] = "GET /perf HTTP/1.1\r\n\r\n";
+	char batch[sizeof(req) * PERF_DEPTH];
+	struct timespec start;
+	unsigned long done = 0;
+	int i;
+
+	for (i = 0; i < PERF_DEPTH; i++) {
+		memcpy(batch + i * (sizeof(req) - 1), req, sizeof(req));
+	}
+
+	g_conn.connects = 0;
+	clock_gettime(CLOCK_REALTIME, &start);
+	while (done < PERF_COUNT) {
+		if ((g_conn.fd < 0 || g_conn.closed) && perf_connect(&g_conn) < 0) {
+			break;
+		}
+		if (perf_send(&g_conn, batch) < 0) {
+			break;
+		}
+		/* A server without pipelining answers the first request and closes */
+		for (i = 0; i < PERF_DEPTH; i++) {
+			if (perf_recv_response(&g_conn) != 200) {
+				break;
+			}
+			done++;
+			if (g_conn.closed) {
+				break;
+			}
+		}
+		if (i == 0) {
+			break;
+		}
+	}
+	perf_report("pipelined", done, perf_elapsed_us(&start), g_conn.connects);
+}
+
+/****************************************************************************
+ * Name: webserver_performance_main
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int webserver_performance_main(int argc, char *argv[])
+#endif
+{
+	struct http_server_t *server;
+	char req[128];
+
+	printf("webserver performance, port %d, %s\n", PERF_PORT, PERF_MODEL);
+
+	if (perf_make_file() < 0) {
+		printf("webserver       : cannot create %s, errno %d\n", PERF_FILE, errno);
+		return -1;
+	}
+
+	server = http_server_init(PERF_PORT);
+	if (server == NULL) {
+		printf("webserver       : init fail\n");
+		return -1;
+	}
+	http_server_register_cb(server, HTTP_METHOD_GET, "/perf", perf_get_small);
+	http_server_register_cb(server, HTTP_METHOD_GET, "/file", perf_get_file);
+	if (http_server_start(server) != HTTP_OK) {
+		printf("webserver       : start fail\n");
+		http_server_release(&server);
+		return -1;
+	}
+
+	memset(&g_conn, 0, sizeof(g_conn));
+	g_conn.fd = -1;
+
+	perf_close();
+	perf_keepalive("keep-alive", "GET /perf HTTP/1.1\r\n\r\n", 200);
+	perf_pipeline();
+	perf_keepalive("file", "GET /file HTTP/1.1\r\n\r\n", 200);
+
+	/* The last file response left its ETag in g_conn */
+	snprintf(req, sizeof(req), "GET /file HTTP/1.1\r\nIf-None-Match: %s\r\n\r\n", g_conn.etag);
+	perf_keepalive("file 304", req, 304);
+
+	if (g_conn.fd >= 0) {
+		close(g_conn.fd);
+	}
+	http_server_stop(server);
+	http_server_release(&server);
+	unlink(PERF_FILE);
+	return 0;
+}
@@ -0,0 +1,362 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <tinyara/seclink.h>
+#include <tinyara/seclink_drv.h>
+#include <stress_tool/st_perf.h>
+#include "sl_test.h"
+
+/*  Common */
+#define SL_TEST_ASYNC_MEM_SIZE 256
+#define SL_TEST_ASYNC_TRIAL 1
+#define SL_TEST_ASYNC_LIMIT_TIME 1000000
+
+#define SL_TEST_ASYNC_HASH_SLOT 0
+#define SL_TEST_ASYNC_CHUNKS 8
+#define SL_TEST_ASYNC_CHUNK_SIZE 64
+#define SL_TEST_ASYNC_RAND_OPS 16
+#define SL_TEST_ASYNC_RAND_LEN 32
+#define SL_TEST_ASYNC_ECC_KEY_SLOT 32
+#define SL_TEST_ASYNC_ECC_OPS 4
+#define SL_TEST_ASYNC_ECC_HASH_LEN 32
+
+static sl_ctx g_hnd;
+static sl_async_ctx g_actx;
+
+static unsigned char g_input[SL_TEST_ASYNC_CHUNKS * SL_TEST_ASYNC_CHUNK_SIZE];
+static hal_data g_chunks[SL_TEST_ASYNC_CHUNKS];
+static hal_data g_hash;
+static hal_data g_hash_ref;
+static hal_data g_out[SL_TEST_ASYNC_RAND_OPS];
+static hal_data g_ecdsa_hash;
+static hal_ecdsa_mode g_ecdsa_mode;
+static struct sl_async_op g_ops[SL_TEST_ASYNC_CHUNKS + 2];
+
+static void _sl_test_async_latency(struct sl_async_op *ops, int count, const char *message)
+{
+	uint32_t queue_us = 0;
+	uint32_t exec_us = 0;
+	uint32_t batch_len = 0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		queue_us += ops[i].queue_us;
+		exec_us += ops[i].exec_us;
+		batch_len += ops[i].batch_len;
+	}
+	printf("%s: %d ops, queue %u us, exec %u us, batch %u (average)\n", message, count,
+		   queue_us / count, exec_us / count, batch_len / count);
+}
+
+static void _sl_test_async_count(struct sl_async_op *op, void *arg)
+{
+	(*(int *)arg)++;
+}
+
+/*  The input is hashed at once and in chunks */
+static void _sl_test_async_input(void)
+{
+	int i;
+
+	for (i = 0; i < sizeof(g_input); i++) {
+		g_input[i] = (unsigned char)i;
+	}
+	for (i = 0; i < SL_TEST_ASYNC_CHUNKS; i++) {
+		sl_test_init_buffer(&g_chunks[i]);
+		g_chunks[i].data = g_input + i * SL_TEST_ASYNC_CHUNK_SIZE;
+		g_chunks[i].data_len = SL_TEST_ASYNC_CHUNK_SIZE;
+	}
+}
+
+static int _sl_test_async_alloc(hal_data *data, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (sl_test_malloc_buffer(&data[i], SL_TEST_ASYNC_MEM_SIZE) != 0) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void _sl_test_async_free(hal_data *data, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		sl_test_free_buffer(&data[i]);
+	}
+}
+
+/*
+ * Desc: Streamed hash
+ */
+TEST_SETUP(hash_stream)
+{
+	ST_START_TEST;
+
+	_sl_test_async_input();
+	ST_EXPECT_EQ(0, sl_test_malloc_buffer(&g_hash, SL_TEST_ASYNC_MEM_SIZE));
+	ST_EXPECT_EQ(0, sl_test_malloc_buffer(&g_hash_ref, SL_TEST_ASYNC_MEM_SIZE));
+	ST_EXPECT_EQ(SECLINK_OK, sl_init(&g_hnd));
+
+	ST_END_TEST;
+}
+
+TEST_TEARDOWN(hash_stream)
+{
+	ST_START_TEST;
+
+	ST_EXPECT_EQ(SECLINK_OK, sl_deinit(g_hnd));
+
+	sl_test_free_buffer(&g_hash);
+	sl_test_free_buffer(&g_hash_ref);
+
+	ST_END_TEST;
+}
+
+TEST_F(hash_stream)
+{
+	ST_START_TEST;
+
+	hal_result_e hres = HAL_FAIL;
+	hal_data input = {g_input, sizeof(g_input), NULL, 0};
+	int i;
+
+	ST_EXPECT_EQ(SECLINK_OK, sl_get_hash(g_hnd, HAL_HASH_SHA256, &input, &g_hash_ref, &hres));
+	ST_EXPECT_EQ(HAL_SUCCESS, hres);
+
+	ST_EXPECT_EQ(SECLINK_OK, sl_hash_init(g_hnd, HAL_HASH_SHA256, SL_TEST_ASYNC_HASH_SLOT, &hres));
+	ST_EXPECT_EQ(HAL_SUCCESS, hres);
+	for (i = 0; i < SL_TEST_ASYNC_CHUNKS; i++) {
+		ST_EXPECT_EQ(SECLINK_OK, sl_hash_update(g_hnd, SL_TEST_ASYNC_HASH_SLOT, &g_chunks[i], &hres));
+		ST_EXPECT_EQ(HAL_SUCCESS, hres);
+	}
+	ST_EXPECT_EQ(SECLINK_OK, sl_hash_final(g_hnd, SL_TEST_ASYNC_HASH_SLOT, &g_hash, &hres));
+	ST_EXPECT_EQ(HAL_SUCCESS, hres);
+
+	ST_EXPECT_EQ(g_hash_ref.data_len, g_hash.data_len);
+	ST_EXPECT_EQ(0, memcmp(g_hash_ref.data, g_hash.data, g_hash.data_len));
+
+	ST_END_TEST;
+}
+
+/*
+ * Desc: Streamed hash queued at once, it completes in batches
+ */
+TEST_SETUP(async_hash)
+{
+	ST_START_TEST;
+
+	_sl_test_async_input();
+	ST_EXPECT_EQ(0, sl_test_malloc_buffer(&g_hash, SL_TEST_ASYNC_MEM_SIZE));
+	ST_EXPECT_EQ(0, sl_test_malloc_buffer(&g_hash_ref, SL_TEST_ASYNC_MEM_SIZE));
+	ST_EXPECT_EQ(SECLINK_OK, sl_init(&g_hnd));
+	ST_EXPECT_EQ(SECLINK_OK, sl_async_init(&g_actx));
+
+	ST_END_TEST;
+}
+
+TEST_TEARDOWN(async_hash)
+{
+	ST_START_TEST;
+
+	ST_EXPECT_EQ(SECLINK_OK, sl_async_deinit(g_actx));
+	ST_EXPECT_EQ(SECLINK_OK, sl_deinit(g_hnd));
+
+	sl_test_free_buffer(&g_hash);
+	sl_test_free_buffer(&g_hash_ref);
+
+	ST_END_TEST;
+}
+
+TEST_F(async_hash)
+{
+	ST_START_TEST;
+
+	hal_result_e hres = HAL_FAIL;
+	hal_data input = {g_input, sizeof(g_input), NULL, 0};
+	int count = SL_TEST_ASYNC_CHUNKS + 2;
+	int completed = 0;
+	int i;
+
+	ST_EXPECT_EQ(SECLINK_OK, sl_get_hash(g_hnd, HAL_HASH_SHA256, &input, &g_hash_ref, &hres));
+	ST_EXPECT_EQ(HAL_SUCCESS, hres);
+
+	sl_async_prep_hash_init(&g_ops[0], HAL_HASH_SHA256, SL_TEST_ASYNC_HASH_SLOT);
+	for (i = 0; i < SL_TEST_ASYNC_CHUNKS; i++) {
+		sl_async_prep_hash_update(&g_ops[i + 1], SL_TEST_ASYNC_HASH_SLOT, &g_chunks[i]);
+	}
+	sl_async_prep_hash_final(&g_ops[count - 1], SL_TEST_ASYNC_HASH_SLOT, &g_hash);
+
+	for (i = 0; i < count; i++) {
+		ST_EXPECT_EQ(SECLINK_OK, sl_async_submit(g_actx, &g_ops[i], _sl_test_async_count, &completed));
+	}
+	ST_EXPECT_EQ(SECLINK_OK, sl_async_flush(g_actx));
+	ST_EXPECT_EQ(count, completed);
+
+	for (i = 0; i < count; i++) {
+		ST_EXPECT_EQ(SECLINK_OK, g_ops[i].ret);
+		ST_EXPECT_EQ(HAL_SUCCESS, g_ops[i].hres);
+	}
+	ST_EXPECT_EQ(g_hash_ref.data_len, g_hash.data_len);
+	ST_EXPECT_EQ(0, memcmp(g_hash_ref.data, g_hash.data, g_hash.data_len));
+
+	_sl_test_async_latency(g_ops, count, "async hash");
+
+	ST_END_TEST;
+}
+
+/*
+ * Desc: Random numbers queued at once
+ */
+TEST_SETUP(async_random)
+{
+	ST_START_TEST;
+
+	ST_EXPECT_EQ(0, _sl_test_async_alloc(g_out, SL_TEST_ASYNC_RAND_OPS));
+	ST_EXPECT_EQ(SECLINK_OK, sl_async_init(&g_actx));
+
+	ST_END_TEST;
+}
+
+TEST_TEARDOWN(async_random)
+{
+	ST_START_TEST;
+
+	ST_EXPECT_EQ(SECLINK_OK, sl_async_deinit(g_actx));
+	_sl_test_async_free(g_out, SL_TEST_ASYNC_RAND_OPS);
+
+	ST_END_TEST;
+}
+
+TEST_F(async_random)
+{
+	ST_START_TEST;
+
+	static struct sl_async_op ops[SL_TEST_ASYNC_RAND_OPS];
+	int i;
+
+	for (i = 0; i < SL_TEST_ASYNC_RAND_OPS; i++) {
+		sl_async_prep_generate_random(&ops[i], SL_TEST_ASYNC_RAND_LEN, &g_out[i]);
+		ST_EXPECT_EQ(SECLINK_OK, sl_async_submit(g_actx, &ops[i], NULL, NULL));
+	}
+	for (i = 0; i < SL_TEST_ASYNC_RAND_OPS; i++) {
+		ST_EXPECT_EQ(SECLINK_OK, sl_async_wait(g_actx, &ops[i]));
+		ST_EXPECT_EQ(HAL_SUCCESS, ops[i].hres);
+	}
+
+	_sl_test_async_latency(ops, SL_TEST_ASYNC_RAND_OPS, "async random");
+
+	ST_END_TEST;
+}
+
+/*
+ * Desc: ECDSA signatures queued at once, then verified
+ */
+TEST_SETUP(async_ecdsa)
+{
+	ST_START_TEST;
+
+	ST_EXPECT_EQ(SECLINK_OK, sl_init(&g_hnd));
+
+	hal_result_e hres = HAL_FAIL;
+	ST_EXPECT_EQ(SECLINK_OK, sl_generate_key(g_hnd, HAL_KEY_ECC_SEC_P256R1, SL_TEST_ASYNC_ECC_KEY_SLOT, &hres));
+	ST_EXPECT_EQ(HAL_SUCCESS, hres);
+
+	ST_EXPECT_EQ(0, _sl_test_async_alloc(g_out, SL_TEST_ASYNC_ECC_OPS));
+	ST_EXPECT_EQ(0, sl_test_malloc_buffer(&g_ecdsa_hash, SL_TEST_ASYNC_ECC_HASH_LEN));
+	memset(g_ecdsa_hash.data, 0xa5, SL_TEST_ASYNC_ECC_HASH_LEN);
+
+	g_ecdsa_mode.curve = HAL_ECDSA_SEC_P256R1;
+	g_ecdsa_mode.hash_t = HAL_HASH_SHA256;
+
+	ST_EXPECT_EQ(SECLINK_OK, sl_async_init(&g_actx));
+
+	ST_END_TEST;
+}
+
+TEST_TEARDOWN(async_ecdsa)
+{
+	ST_START_TEST;
+
+	ST_EXPECT_EQ(SECLINK_OK, sl_async_deinit(g_actx));
+
+	hal_result_e hres = HAL_FAIL;
+	ST_EXPECT_EQ(SECLINK_OK, sl_remove_key(g_hnd, HAL_KEY_ECC_SEC_P256R1, SL_TEST_ASYNC_ECC_KEY_SLOT, &hres));
+	ST_EXPECT_EQ(HAL_SUCCESS, hres);
+
+	ST_EXPECT_EQ(SECLINK_OK, sl_deinit(g_hnd));
+
+	_sl_test_async_free(g_out, SL_TEST_ASYNC_ECC_OPS);
+	sl_test_free_buffer(&g_ecdsa_hash);
+
+	ST_END_TEST;
+}
+
+TEST_F(async_ecdsa)
+{
+	ST_START_TEST;
+
+	static struct sl_async_op sign[SL_TEST_ASYNC_ECC_OPS];
+	static struct sl_async_op verify[SL_TEST_ASYNC_ECC_OPS];
+	int i;
+
+	for (i = 0; i < SL_TEST_ASYNC_ECC_OPS; i++) {
+		sl_async_prep_ecdsa_sign_md(&sign[i], g_ecdsa_mode, &g_ecdsa_hash, SL_TEST_ASYNC_ECC_KEY_SLOT, &g_out[i]);
+		ST_EXPECT_EQ(SECLINK_OK, sl_async_submit(g_actx, &sign[i], NULL, NULL));
+	}
+	ST_EXPECT_EQ(SECLINK_OK, sl_async_flush(g_actx));
+
+	for (i = 0; i < SL_TEST_ASYNC_ECC_OPS; i++) {
+		ST_EXPECT_EQ(SECLINK_OK, sign[i].ret);
+		ST_EXPECT_EQ(HAL_SUCCESS, sign[i].hres);
+		sl_async_prep_ecdsa_verify_md(&verify[i], g_ecdsa_mode, &g_ecdsa_hash, &g_out[i], SL_TEST_ASYNC_ECC_KEY_SLOT);
+		ST_EXPECT_EQ(SECLINK_OK, sl_async_submit(g_actx, &verify[i], NULL, NULL));
+	}
+	ST_EXPECT_EQ(SECLINK_OK, sl_async_flush(g_actx));
+
+	for (i = 0; i < SL_TEST_ASYNC_ECC_OPS; i++) {
+		ST_EXPECT_EQ(SECLINK_OK, verify[i].ret);
+		ST_EXPECT_EQ(HAL_SUCCESS, verify[i].hres);
+	}
+
+	_sl_test_async_latency(sign, SL_TEST_ASYNC_ECC_OPS, "async ecdsa sign");
+	_sl_test_async_latency(verify, SL_TEST_ASYNC_ECC_OPS, "async ecdsa verify");
+
+	ST_END_TEST;
+}
+
+void sl_async_test(void)
+{
+	ST_SET_PACK(sl_async);
+	ST_SET_SMOKE(sl_async, SL_TEST_ASYNC_TRIAL, SL_TEST_ASYNC_LIMIT_TIME, "Streamed hash", hash_stream);
+	ST_SET_SMOKE(sl_async, SL_TEST_ASYNC_TRIAL, SL_TEST_ASYNC_LIMIT_TIME, "Async streamed hash", async_hash);
+	ST_SET_SMOKE(sl_async, SL_TEST_ASYNC_TRIAL, SL_TEST_ASYNC_LIMIT_TIME, "Async random", async_random);
+	ST_SET_SMOKE(sl_async, SL_TEST_ASYNC_TRIAL, SL_TEST_ASYNC_LIMIT_TIME, "Async ECDSA", async_ecdsa);
+
+	ST_RUN_TEST(sl_async);
+	ST_RESULT_TEST(sl_async);
+}
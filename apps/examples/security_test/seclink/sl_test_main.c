@@ -29,6 +29,9 @@ extern void sl_ss_test(void);
 extern void sl_auth_test(void);
 extern void sl_keymgr_test(void);
 extern void sl_simple_test(void);
+#ifdef CONFIG_SECURITY_LINK_ASYNC
+extern void sl_async_test(void);
+#endif
 
 #ifdef CONFIG_BUILD_KERNEL
 int main(int argc, FAR char *argv[])
@@ -40,5 +43,8 @@ int sl_test_main(int argc, char *argv[])
 	sl_auth_test();
 	sl_ss_test();
 	sl_simple_test();
+#ifdef CONFIG_SECURITY_LINK_ASYNC
+	sl_async_test();
+#endif
 	return 0;
 }
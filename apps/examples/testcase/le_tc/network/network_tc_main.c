@@ -106,6 +106,9 @@ int tc_network_main(int argc, char *argv[])
 #ifdef CONFIG_TC_NET_RECVFROM
 	net_recvfrom_main();
 #endif
+#ifdef CONFIG_TC_NET_RECVREF
+	net_recvref_main();
+#endif
 #ifdef CONFIG_TC_NET_SHUTDOWN
 	net_shutdown_main();
 #endif
@@ -79,6 +79,9 @@ int net_sendto_main(void);
 #ifdef CONFIG_TC_NET_RECVFROM
 int net_recvfrom_main(void);
 #endif
+#ifdef CONFIG_TC_NET_RECVREF
+int net_recvref_main(void);
+#endif
 #ifdef CONFIG_TC_NET_SHUTDOWN
 int net_shutdown_main(void);
 #endif
@@ -0,0 +1,270 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+// @file tc_net_recvref.c
+// @brief Test Case Example for recvref() API
+#include <tinyara/config.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "tc_internal.h"
+
+#define PORTNUM 1112
+#define MSG "Hello World !\n"
+#define MSGLEN (sizeof(MSG) - 1)
+#define MSGCNT 4
+
+static sem_t g_ready;
+
+/**
+   * @testcase		   :tc_net_recvref_udp_p
+   * @brief		   :receive a datagram in place and release it
+   * @scenario		   :
+   * @apicovered	   :recvref(), recvref_release()
+   * @precondition	   :
+   * @postcondition	   :
+   */
+static void tc_net_recvref_udp_p(int fd)
+{
+	struct recvref ref;
+	struct sockaddr_in from;
+	socklen_t fromlen = sizeof(from);
+
+	int ret = recvref(fd, &ref, MSGLEN, 0, (struct sockaddr *)&from, &fromlen);
+
+	TC_ASSERT_EQ("recvref", ret, MSGLEN);
+	TC_ASSERT_EQ_CLEANUP("recvref", ref.len, MSGLEN, recvref_release(fd, &ref));
+	TC_ASSERT_EQ_CLEANUP("recvref", memcmp(ref.data, MSG, MSGLEN), 0, recvref_release(fd, &ref));
+	TC_ASSERT_EQ_CLEANUP("recvref", from.sin_addr.s_addr, inet_addr("127.0.0.1"), recvref_release(fd, &ref));
+
+	recvref_release(fd, &ref);
+	TC_ASSERT("recvref_release", ref.priv == NULL);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+   * @testcase		   :tc_net_recvref_n
+   * @brief		   :recvref on an invalid socket
+   * @scenario		   :
+   * @apicovered	   :recvref()
+   * @precondition	   :
+   * @postcondition	   :
+   */
+static void tc_net_recvref_n(void)
+{
+	struct recvref ref;
+
+	int ret = recvref(-1, &ref, MSGLEN, 0, NULL, NULL);
+
+	TC_ASSERT_EQ("recvref", ret, -1);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+   * @testcase		   :tc_net_recvref_tcp_p
+   * @brief		   :receive a stream in place, piece by piece
+   * @scenario		   :the stream is received in buffers of at most 5 bytes
+   *			    and compared with what the peer sent
+   * @apicovered	   :recvref(), recvref_release()
+   * @precondition	   :
+   * @postcondition	   :
+   */
+static void tc_net_recvref_tcp_p(int fd)
+{
+	char expect[MSGLEN * MSGCNT];
+	struct recvref ref;
+	size_t total = 0;
+	int ret;
+	int i;
+
+	for (i = 0; i < MSGCNT; i++) {
+		memcpy(expect + i * MSGLEN, MSG, MSGLEN);
+	}
+
+	while (total < sizeof(expect)) {
+		ret = recvref(fd, &ref, 5, 0, NULL, NULL);
+		TC_ASSERT_GT("recvref", ret, 0);
+		TC_ASSERT_LEQ_CLEANUP("recvref", ret, 5, recvref_release(fd, &ref));
+		TC_ASSERT_LEQ_CLEANUP("recvref", total + ret, sizeof(expect), recvref_release(fd, &ref));
+		TC_ASSERT_EQ_CLEANUP("recvref", memcmp(ref.data, expect + total, ret), 0, recvref_release(fd, &ref));
+		total += ret;
+		recvref_release(fd, &ref);
+	}
+
+	/* the peer closed the connection */
+	ret = recvref(fd, &ref, 5, 0, NULL, NULL);
+	TC_ASSERT_EQ("recvref", ret, 0);
+	TC_SUCCESS_RESULT();
+}
+
+static void *recvref_udpserver(void *args)
+{
+	struct sockaddr_in sa;
+	int fd = socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (fd < 0) {
+		printf("socket fail %s:%d\n", __FUNCTION__, __LINE__);
+		sem_post(&g_ready);
+		return 0;
+	}
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sin_family = PF_INET;
+	sa.sin_port = htons(PORTNUM);
+	sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+	if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0) {
+		printf("bind fail %s:%d\n", __FUNCTION__, __LINE__);
+		close(fd);
+		sem_post(&g_ready);
+		return 0;
+	}
+
+	sem_post(&g_ready);
+	tc_net_recvref_udp_p(fd);
+	close(fd);
+	return 0;
+}
+
+static void *recvref_udpclient(void *args)
+{
+	struct sockaddr_in dest;
+	int fd;
+
+	sem_wait(&g_ready);
+	fd = socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (fd < 0) {
+		printf("socket fail %s:%d\n", __FUNCTION__, __LINE__);
+		return 0;
+	}
+
+	memset(&dest, 0, sizeof(dest));
+	dest.sin_family = PF_INET;
+	dest.sin_port = htons(PORTNUM);
+	dest.sin_addr.s_addr = inet_addr("127.0.0.1");
+	if (sendto(fd, MSG, MSGLEN, 0, (struct sockaddr *)&dest, sizeof(dest)) < 0) {
+		printf("sendto fail %s:%d\n", __FUNCTION__, __LINE__);
+	}
+
+	close(fd);
+	return 0;
+}
+
+static void *recvref_tcpserver(void *args)
+{
+	struct sockaddr_in sa;
+	int connfd;
+	int fd;
+	int i;
+
+	fd = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0) {
+		printf("socket fail %s:%d\n", __FUNCTION__, __LINE__);
+		sem_post(&g_ready);
+		return 0;
+	}
+
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &(int){ 1 }, sizeof(int));
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sin_family = PF_INET;
+	sa.sin_port = htons(PORTNUM);
+	sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+	if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0 || listen(fd, 1) < 0) {
+		printf("bind/listen fail %s:%d\n", __FUNCTION__, __LINE__);
+		close(fd);
+		sem_post(&g_ready);
+		return 0;
+	}
+
+	sem_post(&g_ready);
+	connfd = accept(fd, NULL, NULL);
+	if (connfd < 0) {
+		printf("accept fail %s:%d\n", __FUNCTION__, __LINE__);
+		close(fd);
+		return 0;
+	}
+
+	for (i = 0; i < MSGCNT; i++) {
+		if (send(connfd, MSG, MSGLEN, 0) != MSGLEN) {
+			printf("send fail %s:%d\n", __FUNCTION__, __LINE__);
+		}
+	}
+
+	close(connfd);
+	close(fd);
+	return 0;
+}
+
+static void *recvref_tcpclient(void *args)
+{
+	struct sockaddr_in dest;
+	int fd;
+
+	sem_wait(&g_ready);
+	fd = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0) {
+		printf("socket fail %s:%d\n", __FUNCTION__, __LINE__);
+		return 0;
+	}
+
+	memset(&dest, 0, sizeof(dest));
+	dest.sin_family = PF_INET;
+	dest.sin_port = htons(PORTNUM);
+	dest.sin_addr.s_addr = inet_addr("127.0.0.1");
+	if (connect(fd, (struct sockaddr *)&dest, sizeof(dest)) < 0) {
+		printf("connect fail %s:%d\n", __FUNCTION__, __LINE__);
+		close(fd);
+		return 0;
+	}
+
+	tc_net_recvref_tcp_p(fd);
+	close(fd);
+	return 0;
+}
+
+/****************************************************************************
+ * Name: recvref()
+ ****************************************************************************/
+int net_recvref_main(void)
+{
+	pthread_t server;
+	pthread_t client;
+
+	sem_init(&g_ready, 0, 0);
+
+	pthread_create(&server, NULL, recvref_udpserver, NULL);
+	pthread_create(&client, NULL, recvref_udpclient, NULL);
+	pthread_join(server, NULL);
+	pthread_join(client, NULL);
+
+	pthread_create(&server, NULL, recvref_tcpserver, NULL);
+	pthread_create(&client, NULL, recvref_tcpclient, NULL);
+	pthread_join(server, NULL);
+	pthread_join(client, NULL);
+
+	tc_net_recvref_n();
+
+	sem_destroy(&g_ready);
+	return 0;
+}
@@ -69,6 +69,11 @@
 #include "mbedtls/pkcs5.h"
 #include "mbedtls/ecp.h"
 #include "mbedtls/timing.h"
+#if defined(CONFIG_EXAMPLES_TLS_SELFTEST_ECC_BENCH)
+#include <time.h>
+#include "mbedtls/ecdsa.h"
+#include "mbedtls/ecdh.h"
+#endif
 
 #define mbedtls_printf     printf
 /*
@@ -85,6 +90,148 @@ if ((ret = func(v)) != 0) { \
 	fail_cnt++; \
 }
 
+#if defined(CONFIG_EXAMPLES_TLS_SELFTEST_ECC_BENCH) && defined(MBEDTLS_ECDSA_C) && defined(MBEDTLS_ECDH_C)
+#define TLS_ECC_BENCH_ITERATIONS CONFIG_EXAMPLES_TLS_SELFTEST_ECC_BENCH_ITERATIONS
+
+/*
+ * ECC costs of a handshake. Every operation loads its group as the contexts
+ * of a new handshake do, so the comb table of the generator is computed
+ * again each time unless it is in ROM (CONFIG_TLS_ECP_COMB_TABLES).
+ */
+
+/* Not a random source, only something to draw the keys and nonces from */
+static int tls_ecc_bench_rng(void *ctx, unsigned char *buf, size_t len)
+{
+	unsigned int *state = (unsigned int *)ctx;
+
+	while (len--) {
+		*state = *state * 1103515245 + 12345;
+		*buf++ = (unsigned char)(*state >> 16);
+	}
+	return 0;
+}
+
+static unsigned long tls_ecc_bench_elapsed_us(struct timespec *start)
+{
+	struct timespec end;
+
+	clock_gettime(CLOCK_REALTIME, &end);
+	return (end.tv_sec - start->tv_sec) * 1000000UL + (end.tv_nsec - start->tv_nsec) / 1000;
+}
+
+static int tls_ecc_bench_curve(mbedtls_ecp_group_id id, int verbose)
+{
+	mbedtls_ecp_group grp;
+	mbedtls_ecp_point Q;
+	mbedtls_ecp_point peer_Q;
+	mbedtls_ecp_point eph_Q;
+	mbedtls_mpi d;
+	mbedtls_mpi peer_d;
+	mbedtls_mpi eph_d;
+	mbedtls_mpi r;
+	mbedtls_mpi s;
+	mbedtls_mpi z;
+	struct timespec start;
+	unsigned long sign_us;
+	unsigned long verify_us;
+	unsigned long ecdh_us;
+	unsigned char hash[32];
+	unsigned int state = 1;
+	int ret;
+	int i;
+
+	mbedtls_ecp_group_init(&grp);
+	mbedtls_ecp_point_init(&Q);
+	mbedtls_ecp_point_init(&peer_Q);
+	mbedtls_ecp_point_init(&eph_Q);
+	mbedtls_mpi_init(&d);
+	mbedtls_mpi_init(&peer_d);
+	mbedtls_mpi_init(&eph_d);
+	mbedtls_mpi_init(&r);
+	mbedtls_mpi_init(&s);
+	mbedtls_mpi_init(&z);
+	memset(hash, 0x5a, sizeof(hash));
+
+	/* Long term keys of both ends */
+	if ((ret = mbedtls_ecp_group_load(&grp, id)) != 0 ||
+		(ret = mbedtls_ecdh_gen_public(&grp, &d, &Q, tls_ecc_bench_rng, &state)) != 0 ||
+		(ret = mbedtls_ecdh_gen_public(&grp, &peer_d, &peer_Q, tls_ecc_bench_rng, &state)) != 0) {
+		goto cleanup;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < TLS_ECC_BENCH_ITERATIONS; i++) {
+		if ((ret = mbedtls_ecp_group_load(&grp, id)) != 0 ||
+			(ret = mbedtls_ecdsa_sign(&grp, &r, &s, &d, hash, sizeof(hash), tls_ecc_bench_rng, &state)) != 0) {
+			goto cleanup;
+		}
+	}
+	sign_us = tls_ecc_bench_elapsed_us(&start);
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < TLS_ECC_BENCH_ITERATIONS; i++) {
+		if ((ret = mbedtls_ecp_group_load(&grp, id)) != 0 ||
+			(ret = mbedtls_ecdsa_verify(&grp, hash, sizeof(hash), &Q, &r, &s)) != 0) {
+			goto cleanup;
+		}
+	}
+	verify_us = tls_ecc_bench_elapsed_us(&start);
+
+	/* Ephemeral key pair and shared secret, as in an ECDHE key exchange */
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < TLS_ECC_BENCH_ITERATIONS; i++) {
+		if ((ret = mbedtls_ecp_group_load(&grp, id)) != 0 ||
+			(ret = mbedtls_ecdh_gen_public(&grp, &eph_d, &eph_Q, tls_ecc_bench_rng, &state)) != 0 ||
+			(ret = mbedtls_ecdh_compute_shared(&grp, &z, &peer_Q, &eph_d, tls_ecc_bench_rng, &state)) != 0) {
+			goto cleanup;
+		}
+	}
+	ecdh_us = tls_ecc_bench_elapsed_us(&start);
+
+	if (verbose != 0) {
+			printf("  %-10s : sign %6lu us, verify %6lu us, ecdhe %6lu us\n", mbedtls_ecp_curve_info_from_grp_id(id)->name,
+			   sign_us / TLS_ECC_BENCH_ITERATIONS, verify_us / TLS_ECC_BENCH_ITERATIONS, ecdh_us / TLS_ECC_BENCH_ITERATIONS);
+	}
+
+cleanup:
+	mbedtls_ecp_group_free(&grp);
+	mbedtls_ecp_point_free(&Q);
+	mbedtls_ecp_point_free(&peer_Q);
+	mbedtls_ecp_point_free(&eph_Q);
+	mbedtls_mpi_free(&d);
+	mbedtls_mpi_free(&peer_d);
+	mbedtls_mpi_free(&eph_d);
+	mbedtls_mpi_free(&r);
+	mbedtls_mpi_free(&s);
+	mbedtls_mpi_free(&z);
+	return ret;
+}
+
+static int tls_ecc_bench(int verbose)
+{
+	int ret = 0;
+
+	if (verbose != 0) {
+#if defined(CONFIG_TLS_ECP_COMB_TABLES)
+		printf("  ECC benchmark, %d runs, generator tables in ROM (window %d)\n", TLS_ECC_BENCH_ITERATIONS, CONFIG_TLS_ECP_COMB_TABLES_WINDOW);
+#else
+		printf("  ECC benchmark, %d runs, generator tables in RAM\n", TLS_ECC_BENCH_ITERATIONS);
+#endif
+	}
+#if defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+	if (ret == 0) {
+		ret = tls_ecc_bench_curve(MBEDTLS_ECP_DP_SECP256R1, verbose);
+	}
+#endif
+#if defined(MBEDTLS_ECP_DP_SECP384R1_ENABLED)
+	if (ret == 0) {
+		ret = tls_ecc_bench_curve(MBEDTLS_ECP_DP_SECP384R1, verbose);
+	}
+#endif
+	return ret;
+}
+#endif
+
 pthread_addr_t tls_selftest_cb(void *args)
 {
 	int fail_cnt = 0;
@@ -187,6 +334,9 @@ pthread_addr_t tls_selftest_cb(void *args)
 #if defined(MBEDTLS_PKCS5_C)
 	DO_TLS_TEST(mbedtls_pkcs5_self_test, v);
 #endif
+#if defined(TLS_ECC_BENCH_ITERATIONS)
+	DO_TLS_TEST(tls_ecc_bench, v);
+#endif
 
 	if (v != 0) {
 #if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
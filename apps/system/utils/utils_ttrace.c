@@ -43,6 +43,7 @@ static const struct tag_list ttrace_tags[] = {
 	{"lock",    "Lock",          TTRACE_TAG_LOCK},
 	{"task",    "TASK",          TTRACE_TAG_TASK},
 	{"ipc",     "IPC",           TTRACE_TAG_IPC},
+	{"irq",     "Interrupts",    TTRACE_TAG_IRQ},
 };
 
 int param = 0;
@@ -88,13 +89,31 @@ static int print_sched_packet(struct trace_packet *packet)
 	return sizeof(struct trace_packet);
 }
 
+static int print_arg_packet(struct trace_packet *packet)
+{
+	if (packet->event_type == TTRACE_EVENT_TYPE_IRQ_ENTER || packet->event_type == TTRACE_EVENT_TYPE_IRQ_EXIT) {
+		printf("[%06d:%06d] %03d: %c|%u\r\n",
+			   packet->ts.tv_sec, packet->ts.tv_usec,
+			   packet->pid,
+			   packet->event_type, packet->msg.arg);
+	} else {
+		printf("[%06d:%06d] %03d: %c|0x%08x\r\n",
+			   packet->ts.tv_sec, packet->ts.tv_usec,
+			   packet->pid,
+			   packet->event_type, packet->msg.arg);
+	}
+	return sizeof(struct trace_packet) - TTRACE_MSG_BYTES + TTRACE_ARG_BYTES;
+}
+
 static int print_packet(struct trace_packet *packet)
 {
-	int isSched = (packet->event_type == 's') ? 1 : 0;
+	int isSched = (packet->event_type == TTRACE_EVENT_TYPE_SCHED || packet->event_type == TTRACE_EVENT_TYPE_WAKEUP) ? 1 : 0;
 	int isUnique = packet->codelen & TTRACE_CODE_UNIQUE;
 
 	if (isSched) {
 		return print_sched_packet(packet);
+	} else if (TTRACE_IS_ARG_EVENT(packet->event_type)) {
+		return print_arg_packet(packet);
 	} else if (isUnique) {
 		return print_uid_packet(packet);
 	} else {
@@ -277,6 +296,7 @@ static int send_cmds(FILE *file, int cmd)
 		ret = run_cmd(file, TTRACE_OVERWRITE, is_overwritable);
 		ret = run_cmd(file, TTRACE_SET_BUFSIZE, (unsigned long)sizeof(struct trace_packet));
 	} else if (cmd == TTRACE_FINISH) {
+		trace_flush_all();
 		ret = run_cmd(file, TTRACE_OVERWRITE, 0);
 		bufsize = run_cmd(file, TTRACE_USED_BUFSIZE, param);
 	} else if (cmd == TTRACE_PRINT) {
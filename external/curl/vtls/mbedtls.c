@@ -49,6 +49,9 @@
 #include <mbedtls/entropy.h>
 #include <mbedtls/ctr_drbg.h>
 #include <mbedtls/sha256.h>
+#ifdef CONFIG_TLS_SESSION_STORE
+#include <mbedtls/tls_session_store.h>
+#endif
 
 #include "urldata.h"
 #include "sendf.h"
@@ -467,6 +470,11 @@ mbed_connect_step1(struct connectdata *conn,
       }
       infof(data, "mbedTLS re-using session\n");
     }
+#ifdef CONFIG_TLS_SESSION_STORE
+    /* a session kept from before the last reboot */
+    else if(!tls_session_store_load(&BACKEND->ssl, hostname, (int)port))
+      infof(data, "mbedTLS re-using stored session\n");
+#endif
     Curl_ssl_sessionid_unlock(conn);
   }
 
@@ -710,9 +718,18 @@ mbed_connect_step3(struct connectdata *conn,
 
   if(SSL_SET_OPTION(primary.sessionid)) {
     int ret;
+#ifdef CONFIG_TLS_SESSION_STORE
+    const char * const hostname = SSL_IS_PROXY() ?
+      conn->http_proxy.host.name : conn->host.name;
+    const long int port = SSL_IS_PROXY() ? conn->port : conn->remote_port;
+#endif
     mbedtls_ssl_session *our_ssl_sessionid;
     void *old_ssl_sessionid = NULL;
 
+#ifdef CONFIG_TLS_SESSION_STORE
+    tls_session_store_save(&BACKEND->ssl, hostname, (int)port);
+#endif
+
     our_ssl_sessionid = malloc(sizeof(mbedtls_ssl_session));
     if(!our_ssl_sessionid)
       return CURLE_OUT_OF_MEMORY;
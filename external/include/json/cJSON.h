@@ -116,6 +116,9 @@ typedef struct cJSON_Hooks
 
 typedef int cJSON_bool;
 
+/* Receives the text printed by cJSON_PrintStreamed, length bytes at a time. Returns 0 to stop the print. */
+typedef cJSON_bool (*cJSON_Flush)(void *context, const char *data, size_t length);
+
 #if !defined(__WINDOWS__) && (defined(WIN32) || defined(WIN64) || defined(_MSC_VER) || defined(_WIN32))
 #define __WINDOWS__
 #endif
@@ -165,6 +168,46 @@ then using the CJSON_API_VISIBILITY flag to "export" the same symbols the way CJ
 #define CJSON_NESTING_LIMIT 1000
 #endif
 
+/* Limits how deeply nested arrays/objects can be for the pull parser, which keeps them in cJSON_Pull. */
+#ifndef CJSON_PULL_NESTING_LIMIT
+#define CJSON_PULL_NESTING_LIMIT 32
+#endif
+
+/* Memory the in situ parser takes its items from. */
+typedef struct cJSON_Arena
+{
+    unsigned char *buffer;
+    size_t size;
+    size_t used;
+} cJSON_Arena;
+
+/* Tokens returned by cJSON_NextPull besides the cJSON types of the values: */
+#define cJSON_PullError (-1)      /* invalid JSON */
+#define cJSON_PullEnd   (1 << 10) /* or'ed with cJSON_Array or cJSON_Object at the end of one */
+#define cJSON_PullMore  (1 << 11) /* the buffer ends within a token, feed the rest */
+
+/* State of the pull parser. Read the current token from name, string and number. */
+typedef struct cJSON_Pull
+{
+    const char *content;
+    size_t length;
+    size_t offset; /* bytes of content consumed */
+    cJSON_bool final;
+    int state;
+    size_t depth;
+    unsigned char stack[CJSON_PULL_NESTING_LIMIT];
+
+    /* The member name of the token inside an object, NULL otherwise. Escaped, not terminated. */
+    const char *name;
+    size_t name_length;
+    /* The value of a cJSON_String token. Escaped, not terminated. */
+    const char *string;
+    size_t string_length;
+    /* The value of a cJSON_Number token. */
+    double number;
+    int valueint;
+} cJSON_Pull;
+
 /* returns the version of cJSON as a string */
 CJSON_PUBLIC(const char*) cJSON_Version(void);
 
@@ -178,6 +221,24 @@ CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value);
 /* If you supply a ptr in return_parse_end and parsing fails, then return_parse_end will contain a pointer to the error. If not, then cJSON_GetErrorPtr() does the job. */
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
 
+/* Parse without allocating: items are taken from the arena and strings are unescaped within value, which is overwritten.
+ * value does not need to be null terminated. The result lives as long as value and the arena, never cJSON_Delete it.
+ * Returns NULL if the JSON is invalid or the arena is too small. */
+CJSON_PUBLIC(void) cJSON_InitArena(cJSON_Arena *arena, void *buffer, size_t size);
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(char *value, size_t length, cJSON_Arena *arena);
+
+/* Pull parser: walks the JSON one value at a time without building a tree or allocating.
+ * cJSON_NextPull returns the cJSON type of the next value (cJSON_Array/cJSON_Object when one starts),
+ * cJSON_Array/cJSON_Object | cJSON_PullEnd when one ends, cJSON_Invalid when the document is complete,
+ * cJSON_PullMore or cJSON_PullError.
+ * The input may come in pieces: on cJSON_PullMore, keep the bytes from pull->offset on and pass them
+ * followed by the next piece to cJSON_FeedPull. final tells there is nothing after the buffer. */
+CJSON_PUBLIC(void) cJSON_InitPull(cJSON_Pull *pull, const char *buffer, size_t length, cJSON_bool final);
+CJSON_PUBLIC(void) cJSON_FeedPull(cJSON_Pull *pull, const char *buffer, size_t length, cJSON_bool final);
+CJSON_PUBLIC(int) cJSON_NextPull(cJSON_Pull *pull);
+/* Unescape a name or string of the pull parser into buffer, which needs length + 1 bytes. buffer may be string itself. */
+CJSON_PUBLIC(char *) cJSON_UnescapeString(const char *string, size_t length, char *buffer, size_t size);
+
 /* Render a cJSON entity to text for transfer/storage. */
 CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item);
 /* Render a cJSON entity to text for transfer/storage without any formatting. */
@@ -187,6 +248,10 @@ CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON
 /* Render a cJSON entity to text using a buffer already allocated in memory with given length. Returns 1 on success and 0 on failure. */
 /* NOTE: cJSON is not always 100% accurate in estimating how much memory it will use, so to be safe allocate 5 bytes more than you actually need */
 CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const cJSON_bool format);
+/* Render a cJSON entity to text through a fixed buffer: whenever it is full, its contents are handed to flush and it is reused.
+ * The text is never NUL terminated. Numbers and formatted indentation have to fit whole, so give at least 64 bytes.
+ * Returns 1 on success and 0 on failure, including when flush returned 0. */
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintStreamed(const cJSON *item, char *buffer, const int length, const cJSON_bool format, cJSON_Flush flush, void *context);
 /* Delete a cJSON entity and all subentities. */
 CJSON_PUBLIC(void) cJSON_Delete(cJSON *c);
 
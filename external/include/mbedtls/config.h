@@ -2808,6 +2808,10 @@
 //#define MBEDTLS_ECP_MAX_BITS             521 /**< Maximum bit size of groups */
 #define MBEDTLS_ECP_WINDOW_SIZE            7 /**< Maximum window size used */
 #define MBEDTLS_ECP_FIXED_POINT_OPTIM      1 /**< Enable fixed-point speed-up */
+#if defined(CONFIG_TLS_ECP_COMB_TABLES)
+#define MBEDTLS_ECP_COMB_TABLES                  /**< Keep the generator tables in ROM */
+#define MBEDTLS_ECP_COMB_TABLES_WINDOW     CONFIG_TLS_ECP_COMB_TABLES_WINDOW /**< Window size of the ROM tables */
+#endif
 
 /* Entropy options */
 //#define MBEDTLS_ENTROPY_MAX_SOURCES                20 /**< Maximum number of sources supported */
@@ -2853,6 +2857,13 @@
 
 /* SSL options */
 //#define MBEDTLS_SSL_MAX_CONTENT_LEN             16384 /**< Maxium fragment length in bytes, determines the size of each of the two internal I/O buffers */
+#if defined(CONFIG_TLS_VARIABLE_BUFFER_LENGTH)
+#define MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH        /**< Size the I/O buffers to the records instead of MBEDTLS_SSL_MAX_CONTENT_LEN */
+#define MBEDTLS_SSL_IDLE_CONTENT_LEN       CONFIG_TLS_IDLE_CONTENT_LEN /**< Content length the I/O buffers shrink to when the connection is idle */
+#endif
+#if defined(CONFIG_TLS_AEAD_ENCRYPT_FROM_USER)
+#define MBEDTLS_SSL_AEAD_ENCRYPT_FROM_USER        /**< Encrypt AEAD records straight from the buffer given to mbedtls_ssl_write() */
+#endif
 //#define MBEDTLS_SSL_DEFAULT_TICKET_LIFETIME     86400 /**< Lifetime of session tickets (if enabled) */
 //#define MBEDTLS_PSK_MAX_LEN               32 /**< Max size of TLS pre-shared keys, in bytes (default 256 bits) */
 //#define MBEDTLS_SSL_COOKIE_TIMEOUT        60 /**< Default expiration delay of DTLS cookies, in seconds if HAVE_TIME, or in number of cookies issued */
@@ -0,0 +1,84 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __TLS_SESSION_STORE_H
+#define __TLS_SESSION_STORE_H
+
+#include "mbedtls/config.h"
+#include "mbedtls/ssl.h"
+
+/*
+ * Client sessions kept in a file, so a TLS client can resume its session
+ * with a server after a reboot instead of doing a full handshake.
+ * Sessions are stored per host and port, newest first, and at most
+ * CONFIG_TLS_SESSION_STORE_ENTRIES of them are kept.
+ *
+ * A client calls tls_session_store_load() between mbedtls_ssl_setup() and
+ * mbedtls_ssl_handshake(), and tls_session_store_save() once the handshake
+ * is done. If the server does not accept the session, the handshake falls
+ * back to a full one by itself.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief tls_session_store_load() sets the stored session of host:port on ssl
+ *        so that the next handshake tries to resume it.
+ *
+ * @param[in] ssl	ssl context after mbedtls_ssl_setup().
+ * @param[in] host	host name of the server.
+ * @param[in] port	port of the server.
+ * @return On success,	0 will be returned.
+ *         On failure,	-1 will be returned. There is no usable session,
+ *			the handshake will be a full one.
+ *
+ */
+int tls_session_store_load(mbedtls_ssl_context *ssl, const char *host, int port);
+
+/**
+ * @brief tls_session_store_save() stores the session of ssl for host:port.
+ *        Nothing is written when the stored session is already the same.
+ *
+ * @param[in] ssl	ssl context after a successful handshake.
+ * @param[in] host	host name of the server.
+ * @param[in] port	port of the server.
+ * @return On success,	0 will be returned.
+ *         On failure,	-1 will be returned.
+ *
+ */
+int tls_session_store_save(const mbedtls_ssl_context *ssl, const char *host, int port);
+
+/**
+ * @brief tls_session_store_remove() forgets the session of host:port, e.g.
+ *        when a handshake resuming it failed.
+ *
+ * @param[in] host	host name of the server.
+ * @param[in] port	port of the server.
+ * @return On success,	0 will be returned.
+ *         On failure,	-1 will be returned.
+ *
+ */
+int tls_session_store_remove(const char *host, int port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* __TLS_SESSION_STORE_H */
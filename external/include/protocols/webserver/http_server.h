@@ -75,6 +75,24 @@
 #define HTTP_CONF_MAX_CLIENT_HANDLE		1
 #endif
 
+#if defined(CONFIG_NETUTILS_WEBSERVER_MAX_CONNECTION)
+#define HTTP_CONF_MAX_CONNECTION		(CONFIG_NETUTILS_WEBSERVER_MAX_CONNECTION)
+#else
+#define HTTP_CONF_MAX_CONNECTION		8
+#endif
+
+#if defined(CONFIG_NETUTILS_WEBSERVER_KEEPALIVE_TIMEOUT)
+#define HTTP_CONF_KEEPALIVE_TIMEOUT_MSEC	(CONFIG_NETUTILS_WEBSERVER_KEEPALIVE_TIMEOUT)
+#else
+#define HTTP_CONF_KEEPALIVE_TIMEOUT_MSEC	10000
+#endif
+
+#if defined(CONFIG_NETUTILS_WEBSERVER_SEND_TIMEOUT)
+#define HTTP_CONF_SEND_TIMEOUT_MSEC		(CONFIG_NETUTILS_WEBSERVER_SEND_TIMEOUT)
+#else
+#define HTTP_CONF_SEND_TIMEOUT_MSEC		2000
+#endif
+
 #define HTTP_METHOD_UNKNOWN -1
 #define HTTP_METHOD_GET     0
 #define HTTP_METHOD_PUT     1
@@ -294,6 +312,22 @@ int http_server_deregister_cb(struct http_server_t *server, int method, const ch
  */
 int http_send_response(struct http_client_t *client, int status, const char *body, struct http_keyvalue_list_t *headers);
 
+/**
+ * @brief http_send_file() sends a file as the response.
+ *        The response carries an ETag made of the modification time and
+ *        the size of the file. If the If-None-Match header of the request
+ *        matches it, 304 is sent without the file.
+ *
+ * @param[in] client a pointer of HTTP client.
+ * @param[in] req the request to answer.
+ * @param[in] path path of the file.
+ * @param[in] content_type value of the Content-Type header.
+ * @return On success, HTTP_OK(0) is returned.
+ *         On failure, HTTP_ERROR(-1) is returned.
+ * @since TizenRT v2.0
+ */
+int http_send_file(struct http_client_t *client, struct http_req_message *req, const char *path, const char *content_type);
+
 #ifdef CONFIG_NET_SECURITY_TLS
 /**
  * @brief http_tls_init() initializes the TLS configuere for webserver.
@@ -223,8 +223,41 @@ typedef struct
     size_t offset;
     size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
     internal_hooks hooks;
+    cJSON_Arena *arena; /* in situ parsing: items come from here, strings stay in the input */
 } parse_buffer;
 
+/* Allocate an item for the parser, from the arena when parsing in situ */
+static cJSON *parse_new_item(parse_buffer * const input_buffer)
+{
+    cJSON_Arena *arena = input_buffer->arena;
+    size_t offset = 0;
+
+    if (arena == NULL)
+    {
+        return cJSON_New_Item(&(input_buffer->hooks));
+    }
+
+    /* keep the items aligned for the double they hold */
+    offset = (arena->used + sizeof(double) - 1) & ~(sizeof(double) - 1);
+    if ((offset > arena->size) || ((arena->size - offset) < sizeof(cJSON)))
+    {
+        return NULL;
+    }
+    arena->used = offset + sizeof(cJSON);
+
+    memset(arena->buffer + offset, '\0', sizeof(cJSON));
+    return (cJSON*)(arena->buffer + offset);
+}
+
+/* Free what the parser allocated, nothing when parsing in situ */
+static void parse_delete(parse_buffer * const input_buffer, cJSON *item)
+{
+    if (input_buffer->arena == NULL)
+    {
+        cJSON_Delete(item);
+    }
+}
+
 /* check if the given size is left to read in a given parse buffer (starting with 1) */
 #define can_read(buffer, size) ((buffer != NULL) && (((buffer)->offset + size) <= (buffer)->length))
 #define cannot_read(buffer, size) (!can_read(buffer, size))
@@ -339,8 +372,24 @@ typedef struct
     cJSON_bool noalloc;
     cJSON_bool format; /* is this print a formatted print */
     internal_hooks hooks;
+    cJSON_Flush flush; /* empties a full buffer instead of growing it */
+    void *context;
 } printbuffer;
 
+/* hand the printed text over to the flush callback and start again at the beginning of the buffer */
+static cJSON_bool flush_printbuffer(printbuffer * const p)
+{
+    if ((p->offset > 0) && !p->flush(p->context, (const char*)p->buffer, p->offset))
+    {
+        /* the output is gone, make every further print fail */
+        p->buffer = NULL;
+        return false;
+    }
+    p->offset = 0;
+
+    return true;
+}
+
 /* realloc printbuffer if necessary to have at least "needed" bytes more */
 static unsigned char* ensure(printbuffer * const p, size_t needed)
 {
@@ -364,6 +413,11 @@ static unsigned char* ensure(printbuffer * const p, size_t needed)
         return NULL;
     }
 
+    if ((p->flush != NULL) && ((needed + p->offset + 1) > p->length) && !flush_printbuffer(p))
+    {
+        return NULL;
+    }
+
     needed += p->offset + 1;
     if (needed <= p->length)
     {
@@ -666,55 +720,11 @@ fail:
     return 0;
 }
 
-/* Parse the input text into an unescaped cinput, and populate item. */
-static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_buffer)
+/* Unescape the string literal between input_pointer and input_end into output_pointer.
+ * The output is never longer than the input, so it may overwrite the input in place.
+ * Returns the end of the output or NULL for an invalid escape sequence. */
+static unsigned char *unescape_string(const unsigned char *input_pointer, const unsigned char * const input_end, unsigned char *output_pointer)
 {
-    const unsigned char *input_pointer = buffer_at_offset(input_buffer) + 1;
-    const unsigned char *input_end = buffer_at_offset(input_buffer) + 1;
-    unsigned char *output_pointer = NULL;
-    unsigned char *output = NULL;
-
-    /* not a string */
-    if (buffer_at_offset(input_buffer)[0] != '\"')
-    {
-        goto fail;
-    }
-
-    {
-        /* calculate approximate size of the output (overestimate) */
-        size_t allocation_length = 0;
-        size_t skipped_bytes = 0;
-        while (((size_t)(input_end - input_buffer->content) < input_buffer->length) && (*input_end != '\"'))
-        {
-            /* is escape sequence */
-            if (input_end[0] == '\\')
-            {
-                if ((size_t)(input_end + 1 - input_buffer->content) >= input_buffer->length)
-                {
-                    /* prevent buffer overflow when last input character is a backslash */
-                    goto fail;
-                }
-                skipped_bytes++;
-                input_end++;
-            }
-            input_end++;
-        }
-        if (((size_t)(input_end - input_buffer->content) >= input_buffer->length) || (*input_end != '\"'))
-        {
-            goto fail; /* string ended unexpectedly */
-        }
-
-        /* This is at most how much we need for the output */
-        allocation_length = (size_t) (input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
-        output = (unsigned char*)input_buffer->hooks.allocate(allocation_length + sizeof(""));
-        if (output == NULL)
-        {
-            goto fail; /* allocation failure */
-        }
-    }
-
-    output_pointer = output;
-    /* loop through the string literal */
     while (input_pointer < input_end)
     {
         if (*input_pointer != '\\')
@@ -727,7 +737,7 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
             unsigned char sequence_length = 2;
             if ((input_end - input_pointer) < 1)
             {
-                goto fail;
+                return NULL;
             }
 
             switch (input_pointer[1])
@@ -759,17 +769,82 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
                     if (sequence_length == 0)
                     {
                         /* failed to convert UTF16-literal to UTF-8 */
-                        goto fail;
+                        return NULL;
                     }
                     break;
 
                 default:
-                    goto fail;
+                    return NULL;
             }
             input_pointer += sequence_length;
         }
     }
 
+    return output_pointer;
+}
+
+/* Parse the input text into an unescaped cinput, and populate item. */
+static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_buffer)
+{
+    const unsigned char *input_pointer = buffer_at_offset(input_buffer) + 1;
+    const unsigned char *input_end = buffer_at_offset(input_buffer) + 1;
+    unsigned char *output_pointer = NULL;
+    unsigned char *output = NULL;
+
+    /* not a string */
+    if (buffer_at_offset(input_buffer)[0] != '\"')
+    {
+        goto fail;
+    }
+
+    {
+        /* calculate approximate size of the output (overestimate) */
+        size_t allocation_length = 0;
+        size_t skipped_bytes = 0;
+        while (((size_t)(input_end - input_buffer->content) < input_buffer->length) && (*input_end != '\"'))
+        {
+            /* is escape sequence */
+            if (input_end[0] == '\\')
+            {
+                if ((size_t)(input_end + 1 - input_buffer->content) >= input_buffer->length)
+                {
+                    /* prevent buffer overflow when last input character is a backslash */
+                    goto fail;
+                }
+                skipped_bytes++;
+                input_end++;
+            }
+            input_end++;
+        }
+        if (((size_t)(input_end - input_buffer->content) >= input_buffer->length) || (*input_end != '\"'))
+        {
+            goto fail; /* string ended unexpectedly */
+        }
+
+        if (input_buffer->arena != NULL)
+        {
+            /* in situ: unescape over the input, the closing quote leaves room for '\0' */
+            output = (unsigned char*)input_pointer;
+        }
+        else
+        {
+            /* This is at most how much we need for the output */
+            allocation_length = (size_t) (input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
+            output = (unsigned char*)input_buffer->hooks.allocate(allocation_length + sizeof(""));
+            if (output == NULL)
+            {
+                goto fail; /* allocation failure */
+            }
+        }
+    }
+
+    /* loop through the string literal */
+    output_pointer = unescape_string(input_pointer, input_end, output);
+    if (output_pointer == NULL)
+    {
+        goto fail;
+    }
+
     /* zero terminate the output */
     *output_pointer = '\0';
 
@@ -782,7 +857,7 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     return true;
 
 fail:
-    if (output != NULL)
+    if ((output != NULL) && (input_buffer->arena == NULL))
     {
         input_buffer->hooks.deallocate(output);
     }
@@ -795,6 +870,87 @@ fail:
     return false;
 }
 
+/* Render one character of a string, escaped if needed. Returns the end of the output. */
+static unsigned char *escape_character(const unsigned char character, unsigned char *output_pointer)
+{
+    if ((character > 31) && (character != '\"') && (character != '\\'))
+    {
+        /* normal character, copy */
+        *output_pointer = character;
+        return output_pointer + 1;
+    }
+
+    /* character needs to be escaped */
+    *output_pointer++ = '\\';
+    switch (character)
+    {
+        case '\\':
+            *output_pointer = '\\';
+            break;
+        case '\"':
+            *output_pointer = '\"';
+            break;
+        case '\b':
+            *output_pointer = 'b';
+            break;
+        case '\f':
+            *output_pointer = 'f';
+            break;
+        case '\n':
+            *output_pointer = 'n';
+            break;
+        case '\r':
+            *output_pointer = 'r';
+            break;
+        case '\t':
+            *output_pointer = 't';
+            break;
+        default:
+            /* escape and print as unicode codepoint */
+            sprintf((char*)output_pointer, "u%04x", character);
+            output_pointer += 4;
+            break;
+    }
+
+    return output_pointer + 1;
+}
+
+/* Render a string longer than the buffer of a streamed print, flushing as it goes. */
+static cJSON_bool print_string_streamed(const unsigned char * const input, printbuffer * const output_buffer)
+{
+    const unsigned char *input_pointer = NULL;
+    unsigned char *output_pointer = NULL;
+
+    output_pointer = ensure(output_buffer, 1);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    *output_pointer = '\"';
+    output_buffer->offset++;
+
+    for (input_pointer = input; *input_pointer != '\0'; input_pointer++)
+    {
+        /* room for the longest escape sequence \uXXXX */
+        output_pointer = ensure(output_buffer, 6);
+        if (output_pointer == NULL)
+        {
+            return false;
+        }
+        output_buffer->offset += (size_t)(escape_character(*input_pointer, output_pointer) - output_pointer);
+    }
+
+    output_pointer = ensure(output_buffer, 1);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    output_pointer[0] = '\"';
+    output_pointer[1] = '\0';
+
+    return true;
+}
+
 /* Render the cstring provided to an escaped version that can be printed. */
 static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffer * const output_buffer)
 {
@@ -852,6 +1008,10 @@ static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffe
     output = ensure(output_buffer, output_length + sizeof("\"\""));
     if (output == NULL)
     {
+        if ((output_buffer->flush != NULL) && (output_buffer->buffer != NULL))
+        {
+            return print_string_streamed(input, output_buffer);
+        }
         return false;
     }
 
@@ -869,47 +1029,9 @@ static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffe
     output[0] = '\"';
     output_pointer = output + 1;
     /* copy the string */
-    for (input_pointer = input; *input_pointer != '\0'; (void)input_pointer++, output_pointer++)
+    for (input_pointer = input; *input_pointer != '\0'; input_pointer++)
     {
-        if ((*input_pointer > 31) && (*input_pointer != '\"') && (*input_pointer != '\\'))
-        {
-            /* normal character, copy */
-            *output_pointer = *input_pointer;
-        }
-        else
-        {
-            /* character needs to be escaped */
-            *output_pointer++ = '\\';
-            switch (*input_pointer)
-            {
-                case '\\':
-                    *output_pointer = '\\';
-                    break;
-                case '\"':
-                    *output_pointer = '\"';
-                    break;
-                case '\b':
-                    *output_pointer = 'b';
-                    break;
-                case '\f':
-                    *output_pointer = 'f';
-                    break;
-                case '\n':
-                    *output_pointer = 'n';
-                    break;
-                case '\r':
-                    *output_pointer = 'r';
-                    break;
-                case '\t':
-                    *output_pointer = 't';
-                    break;
-                default:
-                    /* escape and print as unicode codepoint */
-                    sprintf((char*)output_pointer, "u%04x", *input_pointer);
-                    output_pointer += 4;
-                    break;
-            }
-        }
+        output_pointer = escape_character(*input_pointer, output_pointer);
     }
     output[output_length + 1] = '\"';
     output[output_length + 2] = '\0';
@@ -955,7 +1077,7 @@ static parse_buffer *buffer_skip_whitespace(parse_buffer * const buffer)
 /* Parse an object - create a new root, and populate. */
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 }, NULL };
     cJSON *item = NULL;
 
     /* reset error position */
@@ -1040,6 +1162,287 @@ CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value)
     return cJSON_ParseWithOpts(value, 0, 0);
 }
 
+CJSON_PUBLIC(void) cJSON_InitArena(cJSON_Arena *arena, void *buffer, size_t size)
+{
+    arena->buffer = (unsigned char*)buffer;
+    arena->size = size;
+    arena->used = 0;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(char *value, size_t length, cJSON_Arena *arena)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 }, NULL };
+    cJSON *item = NULL;
+
+    global_error.json = NULL;
+    global_error.position = 0;
+
+    if ((value == NULL) || (length == 0) || (arena == NULL))
+    {
+        return NULL;
+    }
+
+    buffer.content = (const unsigned char*)value;
+    buffer.length = length;
+    buffer.hooks = global_hooks;
+    buffer.arena = arena;
+
+    item = parse_new_item(&buffer);
+    if ((item == NULL) || !parse_value(item, buffer_skip_whitespace(&buffer)))
+    {
+        global_error.json = (const unsigned char*)value;
+        global_error.position = (buffer.offset < buffer.length) ? buffer.offset : buffer.length - 1;
+        return NULL;
+    }
+
+    return item;
+}
+
+/* Pull parser states */
+#define PULL_VALUE 0 /* a value is expected */
+#define PULL_FIRST 1 /* after '[' or '{': the first value or the end of the container */
+#define PULL_NEXT  2 /* after a value inside a container: ',' or the end of the container */
+#define PULL_DONE  3 /* the document is complete */
+
+CJSON_PUBLIC(void) cJSON_InitPull(cJSON_Pull *pull, const char *buffer, size_t length, cJSON_bool final)
+{
+    memset(pull, '\0', sizeof(cJSON_Pull));
+    pull->content = buffer;
+    pull->length = length;
+    pull->final = final;
+    pull->state = PULL_VALUE;
+}
+
+CJSON_PUBLIC(void) cJSON_FeedPull(cJSON_Pull *pull, const char *buffer, size_t length, cJSON_bool final)
+{
+    pull->content = buffer;
+    pull->length = length;
+    pull->offset = 0;
+    pull->final = final;
+}
+
+static size_t pull_skip_whitespace(const cJSON_Pull * const pull, size_t offset)
+{
+    while ((offset < pull->length) && ((const unsigned char*)pull->content)[offset] <= 32)
+    {
+        offset++;
+    }
+
+    return offset;
+}
+
+/* Find the closing quote of the string starting at offset, 0 if the buffer ends first */
+static size_t pull_string_end(const cJSON_Pull * const pull, size_t offset)
+{
+    for (offset++; offset < pull->length; offset++)
+    {
+        if (pull->content[offset] == '\\')
+        {
+            offset++;
+        }
+        else if (pull->content[offset] == '\"')
+        {
+            return offset;
+        }
+    }
+
+    return 0;
+}
+
+CJSON_PUBLIC(int) cJSON_NextPull(cJSON_Pull *pull)
+{
+    const char *content = pull->content;
+    size_t offset = pull_skip_whitespace(pull, pull->offset);
+    int state = pull->state;
+    int token = cJSON_Invalid;
+    size_t end = 0;
+
+    pull->name = NULL;
+    pull->name_length = 0;
+    pull->string = NULL;
+    pull->string_length = 0;
+
+    if (state == PULL_DONE)
+    {
+        pull->offset = offset;
+        return cJSON_Invalid;
+    }
+    if (offset >= pull->length)
+    {
+        goto more;
+    }
+
+    if ((state == PULL_FIRST) || (state == PULL_NEXT))
+    {
+        unsigned char container = pull->stack[pull->depth - 1];
+
+        if (content[offset] == ((container == '{') ? '}' : ']'))
+        {
+            pull->depth--;
+            pull->state = (pull->depth > 0) ? PULL_NEXT : PULL_DONE;
+            pull->offset = offset + 1;
+            return ((container == '{') ? cJSON_Object : cJSON_Array) | cJSON_PullEnd;
+        }
+        if (state == PULL_NEXT)
+        {
+            if (content[offset] != ',')
+            {
+                goto fail;
+            }
+            offset = pull_skip_whitespace(pull, offset + 1);
+        }
+
+        /* members of an object have their name in front */
+        if (container == '{')
+        {
+            if (offset >= pull->length)
+            {
+                goto more;
+            }
+            if (content[offset] != '\"')
+            {
+                goto fail;
+            }
+            end = pull_string_end(pull, offset);
+            if (end == 0)
+            {
+                goto more;
+            }
+            pull->name = content + offset + 1;
+            pull->name_length = end - offset - 1;
+
+            offset = pull_skip_whitespace(pull, end + 1);
+            if (offset >= pull->length)
+            {
+                goto more;
+            }
+            if (content[offset] != ':')
+            {
+                goto fail;
+            }
+            offset = pull_skip_whitespace(pull, offset + 1);
+        }
+        if (offset >= pull->length)
+        {
+            goto more;
+        }
+    }
+
+    switch (content[offset])
+    {
+        case '\"':
+            end = pull_string_end(pull, offset);
+            if (end == 0)
+            {
+                goto more;
+            }
+            pull->string = content + offset + 1;
+            pull->string_length = end - offset - 1;
+            offset = end + 1;
+            token = cJSON_String;
+            break;
+
+        case '[':
+        case '{':
+            if (pull->depth >= CJSON_PULL_NESTING_LIMIT)
+            {
+                goto fail;
+            }
+            pull->stack[pull->depth++] = (unsigned char)content[offset];
+            pull->offset = offset + 1;
+            pull->state = PULL_FIRST;
+            return (content[offset] == '{') ? cJSON_Object : cJSON_Array;
+
+        case 't':
+        case 'f':
+        case 'n':
+        {
+            const char *literal = (content[offset] == 't') ? "true" : (content[offset] == 'f') ? "false" : "null";
+            size_t literal_length = strlen(literal);
+
+            if ((pull->length - offset) < literal_length)
+            {
+                if (strncmp(content + offset, literal, pull->length - offset) == 0)
+                {
+                    goto more;
+                }
+                goto fail;
+            }
+            if (strncmp(content + offset, literal, literal_length) != 0)
+            {
+                goto fail;
+            }
+            offset += literal_length;
+            token = (literal[0] == 't') ? cJSON_True : (literal[0] == 'f') ? cJSON_False : cJSON_NULL;
+            break;
+        }
+
+        default:
+        {
+            parse_buffer number_buffer = { 0, 0, 0, 0, { 0, 0, 0 }, NULL };
+            cJSON number;
+
+            /* a number may go on in the next buffer */
+            for (end = offset; (end < pull->length) && (strchr("0123456789+-.eE", content[end]) != NULL) && (content[end] != '\0'); end++)
+            {
+            }
+            if ((end == pull->length) && !pull->final)
+            {
+                goto more;
+            }
+
+            number_buffer.content = (const unsigned char*)content + offset;
+            number_buffer.length = end - offset;
+            if ((end == offset) || !parse_number(&number, &number_buffer) || (number_buffer.offset != number_buffer.length))
+            {
+                goto fail;
+            }
+            pull->number = number.valuedouble;
+            pull->valueint = number.valueint;
+            offset = end;
+            token = cJSON_Number;
+            break;
+        }
+    }
+
+    pull->offset = offset;
+    pull->state = (pull->depth > 0) ? PULL_NEXT : PULL_DONE;
+    return token;
+
+more:
+    pull->name = NULL;
+    pull->name_length = 0;
+    if (!pull->final)
+    {
+        /* pull->offset stays in front of the incomplete token */
+        return cJSON_PullMore;
+    }
+
+fail:
+    pull->offset = offset;
+    return cJSON_PullError;
+}
+
+CJSON_PUBLIC(char *) cJSON_UnescapeString(const char *string, size_t length, char *buffer, size_t size)
+{
+    unsigned char *end = NULL;
+
+    /* the unescaped string is never longer than the escaped one */
+    if ((string == NULL) || (buffer == NULL) || (size <= length))
+    {
+        return NULL;
+    }
+
+    end = unescape_string((const unsigned char*)string, (const unsigned char*)string + length, (unsigned char*)buffer);
+    if (end == NULL)
+    {
+        return NULL;
+    }
+    *end = '\0';
+
+    return buffer;
+}
+
 #define cjson_min(a, b) ((a < b) ? a : b)
 
 static unsigned char *print(const cJSON * const item, cJSON_bool format, const internal_hooks * const hooks)
@@ -1117,7 +1520,7 @@ CJSON_PUBLIC(char *) cJSON_PrintUnformatted(const cJSON *item)
 
 CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON_bool fmt)
 {
-    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 }, NULL, NULL };
 
     if (prebuffer < 0)
     {
@@ -1147,7 +1550,7 @@ CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON
 
 CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buf, const int len, const cJSON_bool fmt)
 {
-    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 }, NULL, NULL };
 
     if ((len < 0) || (buf == NULL))
     {
@@ -1164,6 +1567,34 @@ CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buf, const i
     return print_value(item, &p);
 }
 
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintStreamed(const cJSON *item, char *buffer, const int length, const cJSON_bool format, cJSON_Flush flush, void *context)
+{
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 }, NULL, NULL };
+
+    if ((length <= 0) || (buffer == NULL) || (flush == NULL))
+    {
+        return false;
+    }
+
+    p.buffer = (unsigned char*)buffer;
+    p.length = (size_t)length;
+    p.offset = 0;
+    p.noalloc = true;
+    p.format = format;
+    p.hooks = global_hooks;
+    p.flush = flush;
+    p.context = context;
+
+    if (!print_value(item, &p))
+    {
+        return false;
+    }
+    update_offset(&p);
+
+    /* hand over the rest */
+    return flush_printbuffer(&p);
+}
+
 /* Parser core - when encountering text, process appropriately. */
 static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buffer)
 {
@@ -1220,6 +1651,41 @@ static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buf
     return false;
 }
 
+/* Copy raw text longer than the buffer of a streamed print, flushing as it goes. */
+static cJSON_bool print_raw_streamed(const unsigned char *input, size_t length, printbuffer * const output_buffer)
+{
+    unsigned char *output = NULL;
+    size_t chunk = 0;
+
+    while (length > 0)
+    {
+        /* flush if not even one byte fits, then fill what is left */
+        if (ensure(output_buffer, 1) == NULL)
+        {
+            return false;
+        }
+        chunk = cjson_min(length, output_buffer->length - output_buffer->offset - 1);
+        output = ensure(output_buffer, chunk);
+        if (output == NULL)
+        {
+            return false;
+        }
+        memcpy(output, input, chunk);
+        output_buffer->offset += chunk;
+        input += chunk;
+        length -= chunk;
+    }
+
+    output = ensure(output_buffer, 0);
+    if (output == NULL)
+    {
+        return false;
+    }
+    *output = '\0';
+
+    return true;
+}
+
 /* Render a value to text. */
 static cJSON_bool print_value(const cJSON * const item, printbuffer * const output_buffer)
 {
@@ -1278,6 +1744,10 @@ static cJSON_bool print_value(const cJSON * const item, printbuffer * const outp
             output = ensure(output_buffer, raw_length);
             if (output == NULL)
             {
+                if ((output_buffer->flush != NULL) && (output_buffer->buffer != NULL))
+                {
+                    return print_raw_streamed((const unsigned char*)item->valuestring, raw_length - 1, output_buffer);
+                }
                 return false;
             }
             memcpy(output, item->valuestring, raw_length);
@@ -1337,7 +1807,7 @@ static cJSON_bool parse_array(cJSON * const item, parse_buffer * const input_buf
     do
     {
         /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
+        cJSON *new_item = parse_new_item(input_buffer);
         if (new_item == NULL)
         {
             goto fail; /* allocation failure */
@@ -1386,7 +1856,7 @@ success:
 fail:
     if (head != NULL)
     {
-        cJSON_Delete(head);
+        parse_delete(input_buffer, head);
     }
 
     return false;
@@ -1491,7 +1961,7 @@ static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_bu
     do
     {
         /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
+        cJSON *new_item = parse_new_item(input_buffer);
         if (new_item == NULL)
         {
             goto fail; /* allocation failure */
@@ -1557,7 +2027,7 @@ success:
 fail:
     if (head != NULL)
     {
-        cJSON_Delete(head);
+        parse_delete(input_buffer, head);
     }
 
     return false;
@@ -25,6 +25,11 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 
+#if defined(CONFIG_TLS_SESSION_STORE)
+#include <arpa/inet.h>
+#include <mbedtls/tls_session_store.h>
+#endif
+
 #if defined(CONFIG_TLS_WITH_HW_ACCEL)
 #include <mbedtls/see_cert.h>
 #include <mbedtls/see_api.h>
@@ -549,6 +554,26 @@ int TLSCtx_free(tls_ctx *ctx)
 	return TLS_SUCCESS;
 }
 
+#if defined(CONFIG_TLS_SESSION_STORE)
+/* Stored sessions are kept per host and port, take the port from the socket */
+
+static int tls_peer_port(int fd)
+{
+	struct sockaddr_storage addr;
+	socklen_t len = (socklen_t)sizeof(addr);
+
+	if (getpeername(fd, (struct sockaddr *)&addr, &len) != 0) {
+		return -1;
+	}
+
+	if (addr.ss_family == AF_INET) {
+		return ntohs(((struct sockaddr_in *)&addr)->sin_port);
+	}
+
+	return ntohs(((struct sockaddr_in6 *)&addr)->sin6_port);
+}
+#endif
+
 tls_session *TLSSession(int fd, tls_ctx *ctx, tls_opt *opt)
 {
 	int ret;
@@ -687,6 +712,12 @@ reset:
 		mbedtls_ssl_set_bio(session->ssl, &session->net, mbedtls_net_send, mbedtls_net_recv, NULL);
 	}
 
+#if defined(CONFIG_TLS_SESSION_STORE)
+	if (opt->server == MBEDTLS_SSL_IS_CLIENT && opt->host_name) {
+		tls_session_store_load(session->ssl, opt->host_name, tls_peer_port(session->net.fd));
+	}
+#endif
+
 	EASY_TLS_DEBUG("Handshake start ....\n");
 
 	while ((ret = mbedtls_ssl_handshake(session->ssl)) != 0) {
@@ -704,6 +735,12 @@ reset:
 
 	}
 
+#if defined(CONFIG_TLS_SESSION_STORE)
+	if (opt->server == MBEDTLS_SSL_IS_CLIENT && opt->host_name) {
+		tls_session_store_save(session->ssl, opt->host_name, tls_peer_port(session->net.fd));
+	}
+#endif
+
 	EASY_TLS_DEBUG("Success !!\n");
 	return session;
 
@@ -364,7 +364,8 @@ void mbedtls_ecp_group_free( mbedtls_ecp_group *grp )
         mbedtls_mpi_free( &grp->N );
     }
 
-    if( grp->T != NULL )
+    /* T_size is 0 when T is a table in ROM */
+    if( grp->T != NULL && grp->T_size != 0 )
     {
         for( i = 0; i < grp->T_size; i++ )
             mbedtls_ecp_point_free( &grp->T[i] );
@@ -1191,6 +1192,15 @@ cleanup:
 #error "MBEDTLS_ECP_WINDOW_SIZE out of bounds"
 #endif
 
+#if defined(MBEDTLS_ECP_COMB_TABLES)
+#if MBEDTLS_ECP_COMB_TABLES_WINDOW < 2 || MBEDTLS_ECP_COMB_TABLES_WINDOW > 7
+#error "MBEDTLS_ECP_COMB_TABLES_WINDOW out of bounds"
+#endif
+#if MBEDTLS_ECP_FIXED_POINT_OPTIM != 1
+#error "MBEDTLS_ECP_COMB_TABLES requires MBEDTLS_ECP_FIXED_POINT_OPTIM"
+#endif
+#endif
+
 /* d = ceil( n / w ) */
 #define COMB_MAX_D      ( MBEDTLS_ECP_MAX_BITS + 1 ) / 2
 
@@ -1426,6 +1436,15 @@ static int ecp_mul_comb( mbedtls_ecp_group *grp, mbedtls_ecp_point *R,
     if( w >= grp->nbits )
         w = 2;
 
+#if defined(MBEDTLS_ECP_COMB_TABLES)
+    /*
+     * The table of G is in ROM for some curves (see ecp_curves.c), it was
+     * computed for its own window size, which does not cost any RAM.
+     */
+    if( p_eq_g && grp->T != NULL && grp->T_size == 0 )
+        w = MBEDTLS_ECP_COMB_TABLES_WINDOW;
+#endif
+
     /* Other sizes that depend on w */
     pre_len = 1U << ( w - 1 );
     d = ( grp->nbits + w - 1 ) / w;
@@ -0,0 +1,129 @@
+#!/usr/bin/env python
+############################################################################
+#
+# Copyright 2019 Samsung Electronics All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific
+# language governing permissions and limitations under the License.
+#
+############################################################################
+import sys
+############################################################################
+#
+# This script generates the comb tables of the generators of secp256r1
+# and secp384r1, which ecp_curves.c keeps in ROM instead of computing
+# them in RAM on the first multiplication by G of every group.
+#
+# The points are the ones ecp_precompute_comb() would compute, in affine
+# coordinates: T[i] = G + sum of 2^(d * (l + 1)) * G for each bit l set in i,
+# for i < 2^(w - 1) and d = ceil(nbits / w).
+#
+# parameter information :
+#
+# argv[1] is the window size w, from 2 to 7.
+#
+############################################################################
+
+CURVES = [
+    ("secp256r1", "MBEDTLS_ECP_DP_SECP256R1_ENABLED", 32,
+     0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF,
+     0xFFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551,
+     0x6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296,
+     0x4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5),
+    ("secp384r1", "MBEDTLS_ECP_DP_SECP384R1_ENABLED", 48,
+     0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFF0000000000000000FFFFFFFF,
+     0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFC7634D81F4372DDF581A0DB248B0A77AECEC196ACCC52973,
+     0xAA87CA22BE8B05378EB1C71EF320AD746E1D3B628BA79B9859F741E082542A385502F25DBF55296C3A545E3872760AB7,
+     0x3617DE4A96262C6F5D9E98BF9292DC29F8F41DBD289A147CE9DA3113B5F0B8C00A60B1CE1D7E819D7A431D7C90EA0E5F),
+]
+
+
+def inverse(x, p):
+    return pow(x, p - 2, p)
+
+
+def add(P, Q, p):
+    # Curves with a = -3, the points met here are never equal or opposite
+    (x1, y1), (x2, y2) = P, Q
+    if P == Q:
+        l = (3 * x1 * x1 - 3) * inverse(2 * y1, p) % p
+    else:
+        l = (y2 - y1) * inverse(x2 - x1, p) % p
+    x3 = (l * l - x1 - x2) % p
+    return (x3, (l * (x1 - x3) - y1) % p)
+
+
+def double_n(P, n, p):
+    for _ in range(n):
+        P = add(P, P, p)
+    return P
+
+
+def limbs(name, value, size):
+    data = [(value >> (8 * i)) & 0xFF for i in range(size)]
+    lines = ["static const mbedtls_mpi_uint %s[] = {" % name]
+    for i in range(0, size, 8):
+        lines.append("    BYTES_TO_T_UINT_8( %s )," %
+                     ", ".join("0x%02X" % b for b in data[i:i + 8]))
+    lines.append("};")
+    return lines
+
+
+def curve_table(name, size, p, n, gx, gy, w):
+    nbits = n.bit_length()
+    d = (nbits + w - 1) // w
+    G = (gx, gy)
+    # base[l] = 2^(d * (l + 1)) * G
+    base = []
+    P = G
+    for l in range(w - 1):
+        P = double_n(P, d, p)
+        base.append(P)
+
+    lines = []
+    points = []
+    for i in range(1 << (w - 1)):
+        T = G
+        for l in range(w - 1):
+            if i & (1 << l):
+                T = add(T, base[l], p)
+        lines += limbs("%s_T_%d_X" % (name, i), T[0], size)
+        lines += limbs("%s_T_%d_Y" % (name, i), T[1], size)
+        points.append("    ECP_POINT_INIT_XY_Z1( %s_T_%d_X, %s_T_%d_Y )," % (name, i, name, i))
+
+    lines.append("static const mbedtls_ecp_point %s_T[%d] = {" % (name, len(points)))
+    lines += points
+    lines.append("};")
+    return lines
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.stderr.write("usage: %s window\n" % sys.argv[0])
+        return 1
+    w = int(sys.argv[1])
+    if w < 2 or w > 7:
+        sys.stderr.write("window %d out of bounds\n" % w)
+        return 1
+
+    out = ["/* Generated by ecp_comb_gen.py %d, do not edit */" % w, "",
+           "#define ECP_COMB_TABLES_WINDOW %d" % w]
+    for (name, enabled, size, p, n, gx, gy) in CURVES:
+        out += ["", "#if defined(%s)" % enabled]
+        out += curve_table(name, size, p, n, gx, gy, w)
+        out.append("#endif /* %s */" % enabled)
+    sys.stdout.write("\n".join(out) + "\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -567,6 +567,26 @@ static const mbedtls_mpi_uint brainpoolP512r1_n[] = {
 };
 #endif /* MBEDTLS_ECP_DP_BP512R1_ENABLED */
 
+#if defined(MBEDTLS_ECP_COMB_TABLES)
+/*
+ * Comb tables of the generators of secp256r1 and secp384r1 (see
+ * ecp_mul_comb()), generated at build time by ecp_comb_gen.py for
+ * MBEDTLS_ECP_COMB_TABLES_WINDOW. The group only points to them.
+ */
+static const mbedtls_mpi_uint ecp_comb_one[] = { 1 };
+
+#define ECP_POINT_INIT_XY_Z1( x, y ) {                                  \
+    { 1, sizeof( x ) / sizeof( mbedtls_mpi_uint ), (mbedtls_mpi_uint *) x },  \
+    { 1, sizeof( y ) / sizeof( mbedtls_mpi_uint ), (mbedtls_mpi_uint *) y },  \
+    { 1, 1, (mbedtls_mpi_uint *) ecp_comb_one } }
+
+#include "ecp_comb_tables.h"
+
+#if ECP_COMB_TABLES_WINDOW != MBEDTLS_ECP_COMB_TABLES_WINDOW
+#error "ecp_comb_tables.h was generated for another window size"
+#endif
+#endif /* MBEDTLS_ECP_COMB_TABLES */
+
 /*
  * Create an MPI from embedded constants
  * (assumes len is an exact multiple of sizeof mbedtls_mpi_uint)
@@ -671,6 +691,10 @@ static int ecp_mod_p256k1( mbedtls_mpi * );
                             G ## _gy, sizeof( G ## _gy ),   \
                             G ## _n,  sizeof( G ## _n  ) )
 
+/* T_size = 0 tells mbedtls_ecp_group_free() not to free the table */
+#define LOAD_COMB_TABLE( G )    ( grp->T = (mbedtls_ecp_point *) G ## _T,   \
+                                  grp->T_size = 0 )
+
 #if defined(MBEDTLS_ECP_DP_CURVE25519_ENABLED)
 /*
  * Specialized function for creating the Curve25519 group
@@ -731,12 +755,18 @@ int mbedtls_ecp_group_load( mbedtls_ecp_group *grp, mbedtls_ecp_group_id id )
 #if defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
         case MBEDTLS_ECP_DP_SECP256R1:
             NIST_MODP( p256 );
+#if defined(MBEDTLS_ECP_COMB_TABLES)
+            LOAD_COMB_TABLE( secp256r1 );
+#endif
             return( LOAD_GROUP( secp256r1 ) );
 #endif /* MBEDTLS_ECP_DP_SECP256R1_ENABLED */
 
 #if defined(MBEDTLS_ECP_DP_SECP384R1_ENABLED)
         case MBEDTLS_ECP_DP_SECP384R1:
             NIST_MODP( p384 );
+#if defined(MBEDTLS_ECP_COMB_TABLES)
+            LOAD_COMB_TABLE( secp384r1 );
+#endif
             return( LOAD_GROUP( secp384r1 ) );
 #endif /* MBEDTLS_ECP_DP_SECP384R1_ENABLED */
 
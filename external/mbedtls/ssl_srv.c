@@ -1126,6 +1126,9 @@ static int ssl_parse_client_hello_v2( mbedtls_ssl_context *ssl )
         return( ret );
     }
 
+    /* The input buffer may have moved if it had to grow */
+    buf = ssl->in_hdr;
+
     ssl->handshake->update_checksum( ssl, buf + 2, n );
 
     buf = ssl->in_msg;
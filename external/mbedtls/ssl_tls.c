@@ -83,6 +83,23 @@ static void mbedtls_zeroize( void *v, size_t n ) {
     volatile unsigned char *p = v; while( n-- ) *p++ = 0;
 }
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+#if defined(MBEDTLS_ZLIB_SUPPORT)
+#error "MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH cannot be used with MBEDTLS_ZLIB_SUPPORT"
+#endif
+#if MBEDTLS_SSL_IDLE_CONTENT_LEN > MBEDTLS_SSL_MAX_CONTENT_LEN
+#error "MBEDTLS_SSL_IDLE_CONTENT_LEN larger than MBEDTLS_SSL_MAX_CONTENT_LEN"
+#endif
+/* Buffer length for records of up to content bytes */
+#define SSL_BUFFER_LEN_FOR( content )                                   \
+    ( MBEDTLS_SSL_BUFFER_LEN - MBEDTLS_SSL_MAX_CONTENT_LEN + ( content ) )
+#define SSL_IN_BUF_LEN( ssl )   ( ( ssl )->in_buf_len )
+#define SSL_OUT_BUF_LEN( ssl )  ( ( ssl )->out_buf_len )
+#else
+#define SSL_IN_BUF_LEN( ssl )   MBEDTLS_SSL_BUFFER_LEN
+#define SSL_OUT_BUF_LEN( ssl )  MBEDTLS_SSL_BUFFER_LEN
+#endif /* MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH */
+
 /* Length of the "epoch" field in the record header */
 static inline size_t ssl_ep_len( const mbedtls_ssl_context *ssl )
 {
@@ -1345,6 +1362,21 @@ static int ssl_encrypt_buf( mbedtls_ssl_context *ssl )
 
     mode = mbedtls_cipher_get_cipher_mode( &ssl->transform_out->cipher_ctx_enc );
 
+#if defined(MBEDTLS_SSL_AEAD_ENCRYPT_FROM_USER)
+    /* The plaintext is still in the buffer given to mbedtls_ssl_write() */
+    if( ssl->out_src != NULL )
+    {
+        if( mode != MBEDTLS_MODE_GCM && mode != MBEDTLS_MODE_CCM )
+        {
+            MBEDTLS_SSL_DEBUG_MSG( 1, ( "should never happen" ) );
+            return( MBEDTLS_ERR_SSL_INTERNAL_ERROR );
+        }
+
+        MBEDTLS_SSL_DEBUG_BUF( 4, "before encrypt: output payload",
+                          ssl->out_src, ssl->out_msglen );
+    }
+    else
+#endif
     MBEDTLS_SSL_DEBUG_BUF( 4, "before encrypt: output payload",
                       ssl->out_msg, ssl->out_msglen );
 
@@ -1452,6 +1484,7 @@ static int ssl_encrypt_buf( mbedtls_ssl_context *ssl )
         int ret;
         size_t enc_msglen, olen;
         unsigned char *enc_msg;
+        const unsigned char *plain_msg;
         unsigned char add_data[13];
         unsigned char taglen = ssl->transform_out->ciphersuite_info->flags &
                                MBEDTLS_CIPHERSUITE_SHORT_TAG ? 8 : 16;
@@ -1503,6 +1536,12 @@ static int ssl_encrypt_buf( mbedtls_ssl_context *ssl )
         ssl->out_msglen += ssl->transform_out->ivlen -
                            ssl->transform_out->fixed_ivlen;
 
+        plain_msg = enc_msg;
+#if defined(MBEDTLS_SSL_AEAD_ENCRYPT_FROM_USER)
+        if( ssl->out_src != NULL )
+            plain_msg = ssl->out_src;
+#endif
+
         MBEDTLS_SSL_DEBUG_MSG( 3, ( "before encrypt: msglen = %d, "
                             "including %d bytes of padding",
                        ssl->out_msglen, 0 ) );
@@ -1514,7 +1553,7 @@ static int ssl_encrypt_buf( mbedtls_ssl_context *ssl )
                                          ssl->transform_out->iv_enc,
                                          ssl->transform_out->ivlen,
                                          add_data, 13,
-                                         enc_msg, enc_msglen,
+                                         plain_msg, enc_msglen,
                                          enc_msg, &olen,
                                          enc_msg + enc_msglen, taglen ) ) != 0 )
         {
@@ -2384,6 +2423,127 @@ static int ssl_resend_hello_request( mbedtls_ssl_context *ssl )
 #endif
 #endif /* MBEDTLS_SSL_SRV_C && MBEDTLS_SSL_RENEGOTIATION */
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+/*
+ * Record buffers sized to the records instead of MBEDTLS_SSL_BUFFER_LEN.
+ *
+ * The output buffer is full during the handshake, whose messages are
+ * written in place up to MBEDTLS_SSL_MAX_CONTENT_LEN. Once it is over both
+ * buffers shrink to MBEDTLS_SSL_IDLE_CONTENT_LEN, the input buffer grows to
+ * the length of each incoming record and the output buffer to the length
+ * of each application data record. They keep the grown length while data
+ * flows, to not reallocate for every record, and shrink back when the
+ * connection goes idle, that is when the transport has nothing to read and
+ * nothing is left to write, or at the end of a renegotiation. Records
+ * never exceed the negotiated max fragment length, so neither do the
+ * buffers.
+ *
+ * DTLS reads whole datagrams into the input buffer, so both buffers stay
+ * full with datagram transport.
+ */
+static int ssl_realloc_buffer( unsigned char **buf, size_t *buf_len,
+                               size_t len, size_t used,
+                               unsigned char **ptrs[], size_t nb_ptrs )
+{
+    unsigned char *new_buf;
+    size_t i;
+
+    if( len < used )
+        len = used;
+
+    if( len == *buf_len )
+        return( 0 );
+
+    if( ( new_buf = mbedtls_calloc( 1, len ) ) == NULL )
+        return( MBEDTLS_ERR_SSL_ALLOC_FAILED );
+
+    memcpy( new_buf, *buf, len < *buf_len ? len : *buf_len );
+
+    for( i = 0; i < nb_ptrs; i++ )
+    {
+        if( *ptrs[i] != NULL )
+            *ptrs[i] = new_buf + ( *ptrs[i] - *buf );
+    }
+
+    mbedtls_zeroize( *buf, *buf_len );
+    mbedtls_free( *buf );
+
+    *buf = new_buf;
+    *buf_len = len;
+
+    return( 0 );
+}
+
+/*
+ * Resize the input buffer to len bytes, or to the data not yet processed
+ * if longer: a partly read record or the rest of the current message.
+ */
+static int ssl_resize_in_buf( mbedtls_ssl_context *ssl, size_t len )
+{
+    unsigned char **ptrs[] = { &ssl->in_ctr, &ssl->in_hdr, &ssl->in_len,
+                               &ssl->in_iv, &ssl->in_msg, &ssl->in_offt };
+    size_t used, msg_end;
+
+    if( ssl->conf->transport != MBEDTLS_SSL_TRANSPORT_STREAM )
+        return( 0 );
+
+    used = ( ssl->in_hdr - ssl->in_buf ) + ssl->in_left;
+    msg_end = ( ( ssl->in_offt != NULL ? ssl->in_offt : ssl->in_msg ) -
+                ssl->in_buf ) + ssl->in_msglen;
+    if( msg_end > used )
+        used = msg_end;
+
+    return( ssl_realloc_buffer( &ssl->in_buf, &ssl->in_buf_len, len, used,
+                                ptrs, sizeof( ptrs ) / sizeof( ptrs[0] ) ) );
+}
+
+/*
+ * Resize the output buffer to len bytes, or to the data not yet written
+ * if longer.
+ */
+static int ssl_resize_out_buf( mbedtls_ssl_context *ssl, size_t len )
+{
+    unsigned char **ptrs[] = { &ssl->out_ctr, &ssl->out_hdr, &ssl->out_len,
+                               &ssl->out_iv, &ssl->out_msg };
+    size_t used, left_end;
+
+    if( ssl->conf->transport != MBEDTLS_SSL_TRANSPORT_STREAM )
+        return( 0 );
+
+    used = ssl->out_msg - ssl->out_buf;
+    left_end = ( ssl->out_hdr - ssl->out_buf ) + ssl->out_left;
+    if( left_end > used )
+        used = left_end;
+
+    return( ssl_realloc_buffer( &ssl->out_buf, &ssl->out_buf_len, len, used,
+                                ptrs, sizeof( ptrs ) / sizeof( ptrs[0] ) ) );
+}
+
+/*
+ * Shrink the buffers of an idle connection. Failing to allocate the
+ * smaller buffer is not an error, the larger one is kept.
+ */
+static void ssl_shrink_in_buf( mbedtls_ssl_context *ssl )
+{
+    if( ssl->state == MBEDTLS_SSL_HANDSHAKE_OVER &&
+        ssl->in_buf_len > SSL_BUFFER_LEN_FOR( MBEDTLS_SSL_IDLE_CONTENT_LEN ) )
+    {
+        (void) ssl_resize_in_buf( ssl,
+                        SSL_BUFFER_LEN_FOR( MBEDTLS_SSL_IDLE_CONTENT_LEN ) );
+    }
+}
+
+static void ssl_shrink_out_buf( mbedtls_ssl_context *ssl )
+{
+    if( ssl->state == MBEDTLS_SSL_HANDSHAKE_OVER && ssl->out_left == 0 &&
+        ssl->out_buf_len > SSL_BUFFER_LEN_FOR( MBEDTLS_SSL_IDLE_CONTENT_LEN ) )
+    {
+        (void) ssl_resize_out_buf( ssl,
+                        SSL_BUFFER_LEN_FOR( MBEDTLS_SSL_IDLE_CONTENT_LEN ) );
+    }
+}
+#endif /* MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH */
+
 /*
  * Fill the input message buffer by appending data to it.
  * The amount of data already fetched is in ssl->in_left.
@@ -2419,6 +2579,24 @@ int mbedtls_ssl_fetch_input( mbedtls_ssl_context *ssl, size_t nb_want )
         return( MBEDTLS_ERR_SSL_BAD_INPUT_DATA );
     }
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+    /*
+     * Grow the input buffer to the record, plus room for the CBC padding
+     * check of ssl_decrypt_buf() which reads 256 bytes whatever the padding
+     * length.
+     */
+    len = ( ssl->in_hdr - ssl->in_buf ) + nb_want + MBEDTLS_SSL_PADDING_ADD;
+    if( len > MBEDTLS_SSL_BUFFER_LEN )
+        len = MBEDTLS_SSL_BUFFER_LEN;
+
+    if( len > ssl->in_buf_len &&
+        ( ret = ssl_resize_in_buf( ssl, len ) ) != 0 )
+    {
+        MBEDTLS_SSL_DEBUG_RET( 1, "ssl_resize_in_buf", ret );
+        return( ret );
+    }
+#endif
+
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
     if( ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM )
     {
@@ -2496,7 +2674,7 @@ int mbedtls_ssl_fetch_input( mbedtls_ssl_context *ssl, size_t nb_want )
             ret = MBEDTLS_ERR_SSL_TIMEOUT;
         else
         {
-            len = MBEDTLS_SSL_BUFFER_LEN - ( ssl->in_hdr - ssl->in_buf );
+            len = SSL_IN_BUF_LEN( ssl ) - ( ssl->in_hdr - ssl->in_buf );
 
             if( ssl->state != MBEDTLS_SSL_HANDSHAKE_OVER )
                 timeout = ssl->handshake->retransmit_timeout;
@@ -2592,6 +2770,16 @@ int mbedtls_ssl_fetch_input( mbedtls_ssl_context *ssl, size_t nb_want )
             if( ret == 0 )
                 return( MBEDTLS_ERR_SSL_CONN_EOF );
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+            /* Nothing arrived between records, the connection is idle */
+            if( ( ret == MBEDTLS_ERR_SSL_WANT_READ ||
+                  ret == MBEDTLS_ERR_SSL_TIMEOUT ) && ssl->in_left == 0 )
+            {
+                ssl_shrink_in_buf( ssl );
+                ssl_shrink_out_buf( ssl );
+            }
+#endif
+
             if( ret < 0 )
                 return( ret );
 
@@ -3280,7 +3468,7 @@ static int ssl_reassemble_dtls_handshake( mbedtls_ssl_context *ssl )
         ssl->next_record_offset = new_remain - ssl->in_hdr;
         ssl->in_left = ssl->next_record_offset + remain_len;
 
-        if( ssl->in_left > MBEDTLS_SSL_BUFFER_LEN -
+        if( ssl->in_left > SSL_IN_BUF_LEN( ssl ) -
                            (size_t)( ssl->in_hdr - ssl->in_buf ) )
         {
             MBEDTLS_SSL_DEBUG_MSG( 1, ( "reassembled message too large for buffer" ) );
@@ -5556,6 +5744,11 @@ void mbedtls_ssl_handshake_wrapup( mbedtls_ssl_context *ssl )
 
     ssl->state++;
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+    ssl_shrink_in_buf( ssl );
+    ssl_shrink_out_buf( ssl );
+#endif
+
     MBEDTLS_SSL_DEBUG_MSG( 3, ( "<= handshake wrapup" ) );
 }
 
@@ -5940,15 +6133,22 @@ int mbedtls_ssl_setup( mbedtls_ssl_context *ssl,
 {
     int ret;
     const size_t len = MBEDTLS_SSL_BUFFER_LEN;
+    size_t in_buf_len = len;
 
     ssl->conf = conf;
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+    /* The input buffer grows with the records, see ssl_resize_in_buf() */
+    if( conf->transport == MBEDTLS_SSL_TRANSPORT_STREAM )
+        in_buf_len = SSL_BUFFER_LEN_FOR( MBEDTLS_SSL_IDLE_CONTENT_LEN );
+#endif
+
     /*
      * Prepare base structures
      */
     ssl->in_buf = NULL;
     ssl->out_buf = NULL;
-    if( ( ssl-> in_buf = mbedtls_calloc( 1, len ) ) == NULL ||
+    if( ( ssl-> in_buf = mbedtls_calloc( 1, in_buf_len ) ) == NULL ||
         ( ssl->out_buf = mbedtls_calloc( 1, len ) ) == NULL )
     {
         MBEDTLS_SSL_DEBUG_MSG( 1, ( "alloc(%d bytes) failed", len ) );
@@ -5956,6 +6156,11 @@ int mbedtls_ssl_setup( mbedtls_ssl_context *ssl,
         goto error;
     }
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+    ssl->in_buf_len = in_buf_len;
+    ssl->out_buf_len = len;
+#endif
+
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
     if( conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM )
     {
@@ -6077,10 +6282,19 @@ static int ssl_session_reset_int( mbedtls_ssl_context *ssl, int partial )
     ssl->session_in = NULL;
     ssl->session_out = NULL;
 
-    memset( ssl->out_buf, 0, MBEDTLS_SSL_BUFFER_LEN );
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+    /* The handshake writes its messages in place */
+    if( ( ret = ssl_resize_out_buf( ssl, MBEDTLS_SSL_BUFFER_LEN ) ) != 0 )
+    {
+        MBEDTLS_SSL_DEBUG_RET( 1, "ssl_resize_out_buf", ret );
+        return( ret );
+    }
+#endif
+
+    memset( ssl->out_buf, 0, SSL_OUT_BUF_LEN( ssl ) );
 
     if( partial == 0 )
-        memset( ssl->in_buf, 0, MBEDTLS_SSL_BUFFER_LEN );
+        memset( ssl->in_buf, 0, SSL_IN_BUF_LEN( ssl ) );
 
 #if defined(MBEDTLS_SSL_HW_RECORD_ACCEL)
     if( mbedtls_ssl_hw_record_reset != NULL )
@@ -7079,6 +7293,14 @@ static int ssl_start_renegotiation( mbedtls_ssl_context *ssl )
 
     MBEDTLS_SSL_DEBUG_MSG( 2, ( "=> renegotiate" ) );
 
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+    if( ( ret = ssl_resize_out_buf( ssl, MBEDTLS_SSL_BUFFER_LEN ) ) != 0 )
+    {
+        MBEDTLS_SSL_DEBUG_RET( 1, "ssl_resize_out_buf", ret );
+        return( ret );
+    }
+#endif
+
     if( ( ret = ssl_handshake_init( ssl ) ) != 0 )
         return( ret );
 
@@ -7478,6 +7700,35 @@ int mbedtls_ssl_read( mbedtls_ssl_context *ssl, unsigned char *buf, size_t len )
     return( (int) n );
 }
 
+#if defined(MBEDTLS_SSL_AEAD_ENCRYPT_FROM_USER)
+/*
+ * Whether ssl_encrypt_buf() can read the plaintext of the next record from
+ * the buffer of the application: AEAD ciphers encrypt from one buffer into
+ * another as well as in place, and nothing else looks at the plaintext of
+ * application data on its way to the encryption.
+ */
+static int ssl_encrypt_from_user( const mbedtls_ssl_context *ssl )
+{
+    mbedtls_cipher_mode_t mode;
+
+    if( ssl->transform_out == NULL )
+        return( 0 );
+
+#if defined(MBEDTLS_ZLIB_SUPPORT)
+    if( ssl->session_out->compression == MBEDTLS_SSL_COMPRESS_DEFLATE )
+        return( 0 );
+#endif
+#if defined(MBEDTLS_SSL_HW_RECORD_ACCEL)
+    if( mbedtls_ssl_hw_record_write != NULL )
+        return( 0 );
+#endif
+
+    mode = mbedtls_cipher_get_cipher_mode( &ssl->transform_out->cipher_ctx_enc );
+
+    return( mode == MBEDTLS_MODE_GCM || mode == MBEDTLS_MODE_CCM );
+}
+#endif /* MBEDTLS_SSL_AEAD_ENCRYPT_FROM_USER */
+
 /*
  * Send application data to be encrypted by the SSL layer, taking care of max
  * fragment length and buffer size.
@@ -7535,11 +7786,29 @@ static int ssl_write_real( mbedtls_ssl_context *ssl,
          * copy the data into the internal buffers and setup the data structure
          * to keep track of partial writes
          */
+#if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
+        if( ssl->out_buf_len < SSL_BUFFER_LEN_FOR( len ) &&
+            ( ret = ssl_resize_out_buf( ssl, SSL_BUFFER_LEN_FOR( len ) ) ) != 0 )
+        {
+            MBEDTLS_SSL_DEBUG_RET( 1, "ssl_resize_out_buf", ret );
+            return( ret );
+        }
+#endif
+
         ssl->out_msglen  = len;
         ssl->out_msgtype = MBEDTLS_SSL_MSG_APPLICATION_DATA;
-        memcpy( ssl->out_msg, buf, len );
+#if defined(MBEDTLS_SSL_AEAD_ENCRYPT_FROM_USER)
+        if( ssl_encrypt_from_user( ssl ) )
+            ssl->out_src = buf;
+        else
+#endif
+            memcpy( ssl->out_msg, buf, len );
 
-        if( ( ret = mbedtls_ssl_write_record( ssl ) ) != 0 )
+        ret = mbedtls_ssl_write_record( ssl );
+#if defined(MBEDTLS_SSL_AEAD_ENCRYPT_FROM_USER)
+        ssl->out_src = NULL;
+#endif
+        if( ret != 0 )
         {
             MBEDTLS_SSL_DEBUG_RET( 1, "mbedtls_ssl_write_record", ret );
             return( ret );
@@ -7799,13 +8068,13 @@ void mbedtls_ssl_free( mbedtls_ssl_context *ssl )
 
     if( ssl->out_buf != NULL )
     {
-        mbedtls_zeroize( ssl->out_buf, MBEDTLS_SSL_BUFFER_LEN );
+        mbedtls_zeroize( ssl->out_buf, SSL_OUT_BUF_LEN( ssl ) );
         mbedtls_free( ssl->out_buf );
     }
 
     if( ssl->in_buf != NULL )
     {
-        mbedtls_zeroize( ssl->in_buf, MBEDTLS_SSL_BUFFER_LEN );
+        mbedtls_zeroize( ssl->in_buf, SSL_IN_BUF_LEN( ssl ) );
         mbedtls_free( ssl->in_buf );
     }
 
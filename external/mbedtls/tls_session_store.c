@@ -0,0 +1,557 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <crc32.h>
+
+#include "mbedtls/tls_session_store.h"
+#include "mbedtls/ssl_ciphersuites.h"
+
+#if defined(MBEDTLS_PLATFORM_C)
+#include "mbedtls/platform.h"
+#else
+#define mbedtls_calloc    calloc
+#define mbedtls_free      free
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TLS_SESSION_STORE_PATH      CONFIG_TLS_SESSION_STORE_PATH
+#define TLS_SESSION_STORE_TMP_PATH  CONFIG_TLS_SESSION_STORE_PATH ".tmp"
+#define TLS_SESSION_STORE_MAGIC     0x53534c54	/* "TLSS" */
+#define TLS_SESSION_STORE_VERSION   1
+#define TLS_SESSION_STORE_KEY_LEN   80			/* "host:port" and '\0' */
+#define TLS_SESSION_STORE_COPY_LEN  64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The file is a list of records, each followed by its key and session */
+
+struct tls_session_record_s {
+	uint32_t magic;
+	uint32_t crc;				/* of the key and the session */
+	uint32_t saved;				/* time() when the session was stored */
+	uint32_t lifetime;			/* seconds the session may be resumed for */
+	uint16_t length;			/* bytes of the key and the session */
+	uint8_t key_len;
+	uint8_t version;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_mutex_t g_store_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void tls_session_zeroize(void *v, size_t n)
+{
+	volatile unsigned char *p = v;
+
+	while (n--) {
+		*p++ = 0;
+	}
+}
+
+static int tls_session_key(char *key, const char *host, int port)
+{
+	int len;
+
+	if (host == NULL || port <= 0) {
+		return -1;
+	}
+	len = snprintf(key, TLS_SESSION_STORE_KEY_LEN, "%s:%d", host, port);
+	return (len > 0 && len < TLS_SESSION_STORE_KEY_LEN) ? len : -1;
+}
+
+static unsigned char *tls_session_put(unsigned char *p, uint32_t value, int bytes)
+{
+	while (bytes-- > 0) {
+		*p++ = (unsigned char)(value >> (bytes * 8));
+	}
+	return p;
+}
+
+static uint32_t tls_session_get(const unsigned char *p, int bytes)
+{
+	uint32_t value = 0;
+
+	while (bytes-- > 0) {
+		value = (value << 8) | *p++;
+	}
+	return value;
+}
+
+static const unsigned char *tls_session_ticket(const mbedtls_ssl_session *session, size_t *len, uint32_t *lifetime)
+{
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+	*len = session->ticket ? session->ticket_len : 0;
+	*lifetime = session->ticket_lifetime;
+	return session->ticket;
+#else
+	*len = 0;
+	*lifetime = 0;
+	return NULL;
+#endif
+}
+
+static const unsigned char *tls_session_cert(const mbedtls_ssl_session *session, size_t *len)
+{
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+	if (session->peer_cert != NULL) {
+		*len = session->peer_cert->raw.len;
+		return session->peer_cert->raw.p;
+	}
+#endif
+	*len = 0;
+	return NULL;
+}
+
+/*
+ * Serialized session:
+ * ciphersuite(2) compression(1) id_len(1) id master(48) verify_result(4)
+ * mfl_code(1) trunc_hmac(1) encrypt_then_mac(1)
+ * ticket_len(2) ticket ticket_lifetime(4) cert_len(2) cert
+ */
+static size_t tls_session_size(const mbedtls_ssl_session *session, size_t cert_len)
+{
+	size_t ticket_len;
+	uint32_t lifetime;
+
+	tls_session_ticket(session, &ticket_len, &lifetime);
+	return 4 + session->id_len + sizeof(session->master) + 7 + 2 + ticket_len + 4 + 2 + cert_len;
+}
+
+static void tls_session_write(const mbedtls_ssl_session *session, unsigned char *p, size_t cert_len)
+{
+	const unsigned char *ticket;
+	size_t ticket_len;
+	uint32_t lifetime;
+	int mfl_code = 0;
+	int trunc_hmac = 0;
+	int encrypt_then_mac = 0;
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+	mfl_code = session->mfl_code;
+#endif
+#if defined(MBEDTLS_SSL_TRUNCATED_HMAC)
+	trunc_hmac = session->trunc_hmac;
+#endif
+#if defined(MBEDTLS_SSL_ENCRYPT_THEN_MAC)
+	encrypt_then_mac = session->encrypt_then_mac;
+#endif
+
+	p = tls_session_put(p, session->ciphersuite, 2);
+	p = tls_session_put(p, session->compression, 1);
+	p = tls_session_put(p, session->id_len, 1);
+	memcpy(p, session->id, session->id_len);
+	p += session->id_len;
+	memcpy(p, session->master, sizeof(session->master));
+	p += sizeof(session->master);
+	p = tls_session_put(p, session->verify_result, 4);
+	p = tls_session_put(p, mfl_code, 1);
+	p = tls_session_put(p, trunc_hmac, 1);
+	p = tls_session_put(p, encrypt_then_mac, 1);
+
+	ticket = tls_session_ticket(session, &ticket_len, &lifetime);
+	p = tls_session_put(p, ticket_len, 2);
+	if (ticket_len > 0) {
+		memcpy(p, ticket, ticket_len);
+		p += ticket_len;
+	}
+	p = tls_session_put(p, lifetime, 4);
+
+	p = tls_session_put(p, cert_len, 2);
+	if (cert_len > 0) {
+		memcpy(p, tls_session_cert(session, &cert_len), cert_len);
+	}
+}
+
+static int tls_session_read(mbedtls_ssl_session *session, const unsigned char *p, size_t len)
+{
+	const unsigned char *end = p + len;
+	size_t ticket_len;
+	size_t cert_len;
+	uint32_t lifetime;
+
+	if (len < 4) {
+		return -1;
+	}
+	session->ciphersuite = tls_session_get(p, 2);
+	session->compression = p[2];
+	session->id_len = p[3];
+	p += 4;
+	if (session->id_len > sizeof(session->id) || mbedtls_ssl_ciphersuite_from_id(session->ciphersuite) == NULL) {
+		return -1;
+	}
+	if ((size_t)(end - p) < session->id_len + sizeof(session->master) + 7 + 2) {
+		return -1;
+	}
+	memcpy(session->id, p, session->id_len);
+	p += session->id_len;
+	memcpy(session->master, p, sizeof(session->master));
+	p += sizeof(session->master);
+	session->verify_result = tls_session_get(p, 4);
+	p += 4;
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+	session->mfl_code = p[0];
+#endif
+#if defined(MBEDTLS_SSL_TRUNCATED_HMAC)
+	session->trunc_hmac = p[1];
+#endif
+#if defined(MBEDTLS_SSL_ENCRYPT_THEN_MAC)
+	session->encrypt_then_mac = p[2];
+#endif
+	p += 3;
+
+	ticket_len = tls_session_get(p, 2);
+	p += 2;
+	if ((size_t)(end - p) < ticket_len + 4 + 2) {
+		return -1;
+	}
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+	if (ticket_len > 0) {
+		session->ticket = mbedtls_calloc(1, ticket_len);
+		if (session->ticket == NULL) {
+			return -1;
+		}
+		memcpy(session->ticket, p, ticket_len);
+		session->ticket_len = ticket_len;
+	}
+#endif
+	p += ticket_len;
+	lifetime = tls_session_get(p, 4);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+	session->ticket_lifetime = lifetime;
+#else
+	(void)lifetime;
+#endif
+	p += 4;
+
+	cert_len = tls_session_get(p, 2);
+	p += 2;
+	if ((size_t)(end - p) != cert_len) {
+		return -1;
+	}
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+	if (cert_len > 0) {
+		session->peer_cert = mbedtls_calloc(1, sizeof(mbedtls_x509_crt));
+		if (session->peer_cert == NULL) {
+			return -1;
+		}
+		mbedtls_x509_crt_init(session->peer_cert);
+		if (mbedtls_x509_crt_parse_der(session->peer_cert, p, cert_len) != 0) {
+			mbedtls_x509_crt_free(session->peer_cert);
+			mbedtls_free(session->peer_cert);
+			session->peer_cert = NULL;
+			return -1;
+		}
+	}
+#endif
+#if defined(MBEDTLS_HAVE_TIME)
+	session->start = mbedtls_time(NULL);
+#endif
+
+	return 0;
+}
+
+/* Reads the header and the key of the next record, 0 at the end of the file or at a broken record */
+
+static int tls_session_next(int fd, struct tls_session_record_s *rec, char *key)
+{
+	if (read(fd, rec, sizeof(*rec)) != sizeof(*rec)) {
+		return 0;
+	}
+	if (rec->magic != TLS_SESSION_STORE_MAGIC || rec->version != TLS_SESSION_STORE_VERSION || rec->key_len == 0 || rec->key_len >= TLS_SESSION_STORE_KEY_LEN || rec->length <= rec->key_len) {
+		return 0;
+	}
+	if (read(fd, key, rec->key_len) != rec->key_len) {
+		return 0;
+	}
+	key[rec->key_len] = '\0';
+	return 1;
+}
+
+static int tls_session_skip(int fd, const struct tls_session_record_s *rec)
+{
+	return lseek(fd, rec->length - rec->key_len, SEEK_CUR) < 0 ? -1 : 0;
+}
+
+static int tls_session_expired(const struct tls_session_record_s *rec, uint32_t now)
+{
+	/* A clock that was not set since the boot is behind the record, leave it to the server */
+	return now >= rec->saved && now - rec->saved > rec->lifetime;
+}
+
+static int tls_session_copy(int in, int out, const struct tls_session_record_s *rec, const char *key)
+{
+	unsigned char buf[TLS_SESSION_STORE_COPY_LEN];
+	size_t left = rec->length - rec->key_len;
+	size_t len;
+
+	if (write(out, rec, sizeof(*rec)) != sizeof(*rec) || write(out, key, rec->key_len) != rec->key_len) {
+		return -1;
+	}
+	while (left > 0) {
+		len = left < sizeof(buf) ? left : sizeof(buf);
+		if (read(in, buf, len) != (ssize_t)len || write(out, buf, len) != (ssize_t)len) {
+			return -1;
+		}
+		left -= len;
+	}
+	return 0;
+}
+
+/*
+ * Rewrites the file with the record new first, followed by the other
+ * records which are not expired, without the one of key. new NULL only
+ * removes the record of key. Called with g_store_lock held.
+ */
+static int tls_session_update(const char *key, const struct tls_session_record_s *new, const unsigned char *data)
+{
+	struct tls_session_record_s rec;
+	char name[TLS_SESSION_STORE_KEY_LEN];
+	uint32_t now = (uint32_t)time(NULL);
+	int found = 0;
+	int count = 0;
+	int ret = 0;
+	int in;
+	int out;
+
+	in = open(TLS_SESSION_STORE_PATH, O_RDONLY);
+	if (in >= 0) {
+		while (tls_session_next(in, &rec, name)) {
+			if (strcmp(name, key) == 0) {
+				found = 1;
+				break;
+			}
+			if (tls_session_skip(in, &rec) < 0) {
+				break;
+			}
+		}
+
+		/* Do not wear the flash when a resumed session is saved again */
+		if (found && new && rec.crc == new->crc && rec.length == new->length) {
+			close(in);
+			return 0;
+		}
+		lseek(in, 0, SEEK_SET);
+	}
+	if (!found && new == NULL) {
+		if (in >= 0) {
+			close(in);
+		}
+		return 0;
+	}
+
+	out = open(TLS_SESSION_STORE_TMP_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (out < 0) {
+		if (in >= 0) {
+			close(in);
+		}
+		return -1;
+	}
+
+	if (new) {
+		if (write(out, new, sizeof(*new)) != sizeof(*new) || write(out, data, new->length) != new->length) {
+			ret = -1;
+		}
+		count++;
+	}
+
+	while (ret == 0 && in >= 0 && count < CONFIG_TLS_SESSION_STORE_ENTRIES && tls_session_next(in, &rec, name)) {
+		if (strcmp(name, key) == 0 || tls_session_expired(&rec, now)) {
+			ret = tls_session_skip(in, &rec);
+			continue;
+		}
+		ret = tls_session_copy(in, out, &rec, name);
+		count++;
+	}
+
+	if (in >= 0) {
+		close(in);
+	}
+	close(out);
+
+	if (ret == 0) {
+		unlink(TLS_SESSION_STORE_PATH);
+		ret = rename(TLS_SESSION_STORE_TMP_PATH, TLS_SESSION_STORE_PATH) < 0 ? -1 : 0;
+	}
+	if (ret < 0) {
+		unlink(TLS_SESSION_STORE_TMP_PATH);
+	}
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int tls_session_store_load(mbedtls_ssl_context *ssl, const char *host, int port)
+{
+	struct tls_session_record_s rec;
+	mbedtls_ssl_session session;
+	char key[TLS_SESSION_STORE_KEY_LEN];
+	char name[TLS_SESSION_STORE_KEY_LEN];
+	unsigned char *data = NULL;
+	size_t len = 0;
+	int ret = -1;
+	int fd;
+
+	if (ssl == NULL || tls_session_key(key, host, port) < 0) {
+		return -1;
+	}
+
+	pthread_mutex_lock(&g_store_lock);
+	fd = open(TLS_SESSION_STORE_PATH, O_RDONLY);
+	if (fd < 0) {
+		pthread_mutex_unlock(&g_store_lock);
+		return -1;
+	}
+
+	while (tls_session_next(fd, &rec, name)) {
+		if (strcmp(name, key) != 0) {
+			if (tls_session_skip(fd, &rec) < 0) {
+				break;
+			}
+			continue;
+		}
+		if (tls_session_expired(&rec, (uint32_t)time(NULL))) {
+			break;
+		}
+
+		len = rec.length - rec.key_len;
+		data = malloc(len);
+		if (data == NULL || read(fd, data, len) != (ssize_t)len) {
+			break;
+		}
+		if (crc32part(data, len, crc32((uint8_t *)name, rec.key_len)) != rec.crc) {
+			break;
+		}
+
+		mbedtls_ssl_session_init(&session);
+		if (tls_session_read(&session, data, len) == 0 && mbedtls_ssl_set_session(ssl, &session) == 0) {
+			ret = 0;
+		}
+		mbedtls_ssl_session_free(&session);
+		break;
+	}
+	close(fd);
+	pthread_mutex_unlock(&g_store_lock);
+
+	if (data) {
+		tls_session_zeroize(data, len);
+		free(data);
+	}
+	return ret;
+}
+
+int tls_session_store_save(const mbedtls_ssl_context *ssl, const char *host, int port)
+{
+	const mbedtls_ssl_session *session;
+	struct tls_session_record_s rec;
+	char key[TLS_SESSION_STORE_KEY_LEN];
+	unsigned char *data;
+	size_t ticket_len;
+	size_t cert_len;
+	size_t len;
+	uint32_t lifetime;
+	int key_len;
+	int ret;
+
+	key_len = tls_session_key(key, host, port);
+	if (ssl == NULL || ssl->session == NULL || ssl->conf->endpoint != MBEDTLS_SSL_IS_CLIENT || key_len < 0) {
+		return -1;
+	}
+	session = ssl->session;
+
+	/* A session without an id or a ticket cannot be resumed */
+	tls_session_ticket(session, &ticket_len, &lifetime);
+	if (session->id_len == 0 && ticket_len == 0) {
+		return -1;
+	}
+
+	/* The peer certificate is only kept for mbedtls_ssl_get_peer_cert(), drop it if it does not fit */
+	tls_session_cert(session, &cert_len);
+	len = key_len + tls_session_size(session, cert_len);
+	if (len > UINT16_MAX) {
+		cert_len = 0;
+		len = key_len + tls_session_size(session, 0);
+		if (len > UINT16_MAX) {
+			return -1;
+		}
+	}
+
+	data = malloc(len);
+	if (data == NULL) {
+		return -1;
+	}
+	memcpy(data, key, key_len);
+	tls_session_write(session, data + key_len, cert_len);
+
+	memset(&rec, 0, sizeof(rec));
+	rec.magic = TLS_SESSION_STORE_MAGIC;
+	rec.version = TLS_SESSION_STORE_VERSION;
+	rec.crc = crc32(data, len);
+	rec.saved = (uint32_t)time(NULL);
+	rec.lifetime = CONFIG_TLS_SESSION_STORE_LIFETIME;
+	if (ticket_len > 0 && lifetime > 0 && lifetime < rec.lifetime) {
+		rec.lifetime = lifetime;
+	}
+	rec.length = len;
+	rec.key_len = key_len;
+
+	pthread_mutex_lock(&g_store_lock);
+	ret = tls_session_update(key, &rec, data);
+	pthread_mutex_unlock(&g_store_lock);
+
+	tls_session_zeroize(data, len);
+	free(data);
+	return ret;
+}
+
+int tls_session_store_remove(const char *host, int port)
+{
+	char key[TLS_SESSION_STORE_KEY_LEN];
+	int ret;
+
+	if (tls_session_key(key, host, port) < 0) {
+		return -1;
+	}
+
+	pthread_mutex_lock(&g_store_lock);
+	ret = tls_session_update(key, NULL, NULL);
+	pthread_mutex_unlock(&g_store_lock);
+
+	return ret;
+}
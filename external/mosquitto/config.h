@@ -56,4 +56,7 @@
 #include "mbedtls/ctr_drbg.h"
 #include "mbedtls/ssl_cache.h"
 #include "mbedtls/entropy.h"
+#ifdef CONFIG_TLS_SESSION_STORE
+#include "mbedtls/tls_session_store.h"
+#endif
 #endif
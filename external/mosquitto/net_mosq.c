@@ -538,9 +538,15 @@ int _mosquitto_socket_connect(struct mosquitto *mosq, const char *host, uint16_t
 		((mbedtls_net_context *)mosq->net)->fd = (int)sock;
 		mbedtls_ssl_set_bio(mosq->ssl_ctx, mosq->net, mbedtls_net_send, mbedtls_net_recv, NULL);
 
+#ifdef CONFIG_TLS_SESSION_STORE
+		tls_session_store_load(mosq->ssl_ctx, host, port);
+#endif
 		if (mosquitto__socket_connect_tls(mosq)) {
 			return MOSQ_ERR_TLS;
 		}
+#ifdef CONFIG_TLS_SESSION_STORE
+		tls_session_store_save(mosq->ssl_ctx, host, port);
+#endif
 	}
 #endif
 
@@ -279,6 +279,13 @@ int http_server_start(struct http_server_t *server)
 		return HTTP_ERROR;
 	}
 
+#ifdef CONFIG_NETUTILS_WEBSERVER_EVENT_LOOP
+	/* HTTPS handshakes block, so TLS servers keep the thread per request model */
+	if (!server->tls_init) {
+		return http_server_event_start(server);
+	}
+#endif
+
 	if (pthread_attr_init(&attr) != 0) {
 		HTTP_LOGE("Error: Cannot initialize ptread attribute\n");
 		return HTTP_ERROR;
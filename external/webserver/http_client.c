@@ -17,6 +17,7 @@
  ****************************************************************************/
 
 #include <fcntl.h>
+#include <strings.h>
 #include <protocols/webserver/http_err.h>
 #include <protocols/webserver/http_keyvalue_list.h>
 #include <protocols/webclient.h>
@@ -31,8 +32,6 @@
 #include "http_arch.h"
 #include "http_log.h"
 
-#define MIN_WS_HEADER_FIELD 2
-
 pthread_addr_t http_handle_client(pthread_addr_t arg)
 {
 	struct http_server_t *server = (struct http_server_t *)arg;
@@ -513,37 +512,9 @@ int http_recv_and_handle_request(struct http_client_t *client, struct http_keyva
 #ifdef CONFIG_NETUTILS_WEBSOCKET
 	/* open websocket */
 	if (client->ws_state >= MIN_WS_HEADER_FIELD) {
-		websocket_t *ws = NULL;
-		ws = websocket_find_table();
-		if (ws == NULL) {
-			goto errout;
-		}
-		ws->fd = client->client_fd;
-		ws->cb = &client->server->ws_cb;
-#ifdef CONFIG_NET_SECURITY_TLS
-		if (client->server->tls_init) {
-			ws->tls_enabled = 1;
-			ws->tls_net.fd = client->tls_client_fd.fd;
-			ws->tls_ssl = (mbedtls_ssl_context *)malloc(sizeof(mbedtls_ssl_context));
-			memcpy(ws->tls_ssl, &client->tls_ssl, sizeof(mbedtls_ssl_context));
-			ws->tls_conf = &client->server->tls_conf;
-			mbedtls_ssl_set_bio(ws->tls_ssl, &ws->tls_net, mbedtls_net_send, mbedtls_net_recv, NULL);
-		}
-#endif
-		if (pthread_attr_init(&ws->thread_attr) != 0) {
-			HTTP_LOGE("Error: Cannot initialize thread attribute\n");
-			goto errout;
-		}
-		pthread_attr_setstacksize(&ws->thread_attr, WEBSOCKET_STACKSIZE);
-		pthread_attr_setschedpolicy(&ws->thread_attr, SCHED_RR);
-		if (pthread_create(&ws->thread_id, &ws->thread_attr,
-						   (pthread_startroutine_t)websocket_server_init,
-						   (pthread_addr_t)ws) != 0) {
-			HTTP_LOGE("Error: Cannot create websocket thread!!\n");
+		if (http_client_open_websocket(client) != HTTP_OK) {
 			goto errout;
 		}
-		pthread_setname_np(ws->thread_id, "websocket handle server");
-		pthread_detach(ws->thread_id);
 	} else
 #endif
 	{
@@ -564,6 +535,45 @@ errout:
 	return HTTP_ERROR;
 }
 
+#ifdef CONFIG_NETUTILS_WEBSOCKET
+int http_client_open_websocket(struct http_client_t *client)
+{
+	websocket_t *ws = NULL;
+
+	ws = websocket_find_table();
+	if (ws == NULL) {
+		return HTTP_ERROR;
+	}
+	ws->fd = client->client_fd;
+	ws->cb = &client->server->ws_cb;
+#ifdef CONFIG_NET_SECURITY_TLS
+	if (client->server->tls_init) {
+		ws->tls_enabled = 1;
+		ws->tls_net.fd = client->tls_client_fd.fd;
+		ws->tls_ssl = (mbedtls_ssl_context *)malloc(sizeof(mbedtls_ssl_context));
+		memcpy(ws->tls_ssl, &client->tls_ssl, sizeof(mbedtls_ssl_context));
+		ws->tls_conf = &client->server->tls_conf;
+		mbedtls_ssl_set_bio(ws->tls_ssl, &ws->tls_net, mbedtls_net_send, mbedtls_net_recv, NULL);
+	}
+#endif
+	if (pthread_attr_init(&ws->thread_attr) != 0) {
+		HTTP_LOGE("Error: Cannot initialize thread attribute\n");
+		return HTTP_ERROR;
+	}
+	pthread_attr_setstacksize(&ws->thread_attr, WEBSOCKET_STACKSIZE);
+	pthread_attr_setschedpolicy(&ws->thread_attr, SCHED_RR);
+	if (pthread_create(&ws->thread_id, &ws->thread_attr,
+					   (pthread_startroutine_t)websocket_server_init,
+					   (pthread_addr_t)ws) != 0) {
+		HTTP_LOGE("Error: Cannot create websocket thread!!\n");
+		return HTTP_ERROR;
+	}
+	pthread_setname_np(ws->thread_id, "websocket handle server");
+	pthread_detach(ws->thread_id);
+	return HTTP_OK;
+}
+#endif
+
 void http_handle_file(struct http_client_t *client, int method, const char *url, char *entity)
 {
 	FILE *f;
@@ -661,8 +671,9 @@ void http_handle_file(struct http_client_t *client, int method, const char *url,
 int http_send_response(struct http_client_t *client, int status, const char *body, struct http_keyvalue_list_t *headers)
 {
 	char *buf;
-	int buflen = 0, ret, sndlen;
+	int buflen = 0, ret;
 	struct http_keyvalue_t *cur = NULL;
+	const char *connection;
 
 	buf = HTTP_MALLOC(HTTP_CONF_MAX_REQUEST_LENGTH);
 	if (buf == NULL) {
@@ -682,6 +693,8 @@ int http_send_response(struct http_client_t *client, int status, const char *bod
 	} else
 #endif
 	{
+		int has_length = 0;
+
 		buflen = snprintf(buf, HTTP_CONF_MAX_REQUEST_LENGTH, "HTTP/1.1 %d %s\r\n",
 						  status, (status == 200) ? "OK" : body);
 		if (headers) {
@@ -689,15 +702,25 @@ int http_send_response(struct http_client_t *client, int status, const char *bod
 			while (cur != headers->tail) {
 				buflen += snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
 								   "%s: %s\r\n", cur->key, cur->value);
+				/* Without a length the client reads the body until the connection closes */
+				if (strcasecmp(cur->key, "Content-Length") == 0) {
+					has_length = 1;
+				} else if (strcasecmp(cur->key, "Connection") == 0 && strcasecmp(cur->value, "close") == 0) {
+					client->keep_alive = 0;
+				}
 				cur = cur->next;
 			}
+			if (!has_length) {
+				client->keep_alive = 0;
+			}
 		}
+		connection = client->keep_alive ? "keep-alive" : "close";
 
 		if (status == 200) {
 			if (headers == NULL) {
 				buflen += snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
 								   "Content-type: text/html\r\n"
-								   "Connection: close\r\n");
+								   "Connection: %s\r\n", connection);
 				if (body) {
 					buflen += snprintf(buf + buflen,
 									   HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
@@ -708,35 +731,50 @@ int http_send_response(struct http_client_t *client, int status, const char *bod
 				} else {
 					buflen += snprintf(buf + buflen,
 									   HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
+									   "Content-Length: 0\r\n"
 									   "\r\n");
 				}
 			} else {
 				snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
 						 "\r\n%s", body);
 			}
+		} else if (headers == NULL) {
+			snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
+					 "Content-Length: 0\r\n"
+					 "Connection: %s\r\n"
+					 "\r\n", connection);
+		} else {
+			snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen, "\r\n");
 		}
 	}
 
-	sndlen = strlen(buf);
-	buflen = 0;
-	while (sndlen > 0) {
+	ret = http_client_send(client, buf, strlen(buf));
+	HTTP_FREE(buf);
+	return ret;
+}
+
+int http_client_send(struct http_client_t *client, const char *buf, int len)
+{
+	int ret;
+
+	while (len > 0) {
 #ifdef CONFIG_NET_SECURITY_TLS
 		if (client->server->tls_init) {
-			ret = mbedtls_ssl_write(&(client->tls_ssl), (unsigned char *)buf + buflen, sndlen);
+			ret = mbedtls_ssl_write(&(client->tls_ssl), (const unsigned char *)buf, len);
 		} else
 #endif
 		{
-			ret = send(client->client_fd, buf + buflen, sndlen, 0);
+			ret = send(client->client_fd, buf, len, 0);
 		}
 
 		if (ret < 1) {
-			HTTP_FREE(buf);
+			/* The stream is broken or timed out, do not wait for another request */
+			client->keep_alive = 0;
 			return HTTP_ERROR;
-		} else {
-			sndlen -= ret;
-			buflen += ret;
 		}
+		len -= ret;
+		buf += ret;
+		client->sent += ret;
 	}
-	HTTP_FREE(buf);
 	return HTTP_OK;
 }
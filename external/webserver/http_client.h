@@ -36,6 +36,8 @@
 #include "mbedtls/ssl_cache.h"
 #endif
 
+#define MIN_WS_HEADER_FIELD 2
+
 enum {
 	HTTP_REQUEST_HEADER, HTTP_REQUEST_PARAMETERS, HTTP_REQUEST_BODY
 };
@@ -45,6 +47,8 @@ struct http_client_t {
 	struct http_server_t *server;
 	int ws_state;
 	unsigned char ws_key[WEBSOCKET_CLIENT_KEY_LEN];
+	int keep_alive;				/* the connection stays open after the response */
+	int sent;					/* bytes sent since the request was read */
 
 #ifdef CONFIG_NET_SECURITY_TLS
 	mbedtls_ssl_context       tls_ssl;
@@ -75,6 +79,14 @@ int http_parse_message(char *buf, int buf_len, int *method, char *url,
 					   struct http_client_response_t *response,
 					   struct http_req_message *req);
 int   http_recv_and_handle_request(struct http_client_t *client, struct http_keyvalue_list_t *request_params);
+int   http_client_send(struct http_client_t *client, const char *buf, int len);
+#ifdef CONFIG_NETUTILS_WEBSOCKET
+int   http_client_open_websocket(struct http_client_t *client);
+#endif
+
+#ifdef CONFIG_NETUTILS_WEBSERVER_EVENT_LOOP
+int   http_server_event_start(struct http_server_t *server);
+#endif
 
 #ifdef CONFIG_NET_SECURITY_TLS
 int   http_client_tls_init(struct http_client_t *client);
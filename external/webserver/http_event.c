@@ -0,0 +1,409 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/*
+ * Event loop of the webserver.
+ *
+ * A single thread polls the listening socket and every open connection.
+ * Requests are framed in a per-connection buffer, so a connection can stay
+ * open between requests (HTTP/1.1 keep-alive) and several requests sent
+ * back to back (pipelining) are answered in order. Callbacks run on the
+ * loop thread and write their response before the next request is read.
+ * A client which stops reading would stall every other connection, so a
+ * send is bounded by HTTP_CONF_SEND_TIMEOUT_MSEC and the client is dropped
+ * when it expires.
+ */
+
+#include <sys/types.h>
+#include <pthread.h>
+#include <poll.h>
+#include <errno.h>
+#include <strings.h>
+#include <time.h>
+#include <protocols/webserver/http_err.h>
+#include <protocols/webserver/http_server.h>
+#include <protocols/webserver/http_keyvalue_list.h>
+
+#include "http.h"
+#include "http_client.h"
+#include "http_query.h"
+#include "http_arch.h"
+#include "http_log.h"
+
+#define HTTP_EVENT_POLL_TIMEOUT_MS  100
+#define HTTP_EVENT_STACKSIZE        (1024 * 6)
+
+enum {
+	HTTP_EVENT_KEEP,			/* wait for the next request */
+	HTTP_EVENT_CLOSE,			/* close the connection */
+	HTTP_EVENT_DETACH,			/* the socket was handed over, e.g. to websocket */
+};
+
+struct http_conn_t {
+	struct http_client_t *client;
+	uint32_t client_ip;
+	char *buf;					/* HTTP_CONF_MAX_REQUEST_LENGTH + 1 bytes */
+	int len;
+	unsigned long idle_since;	/* msec */
+};
+
+static unsigned long http_event_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int http_event_find(const char *buf, int len, int start, const char *pat)
+{
+	int patlen = strlen(pat);
+	int i;
+
+	for (i = start; i + patlen <= len; i++) {
+		if (buf[i] == pat[0] && memcmp(buf + i, pat, patlen) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* Value of the header named key within buf[0..hdrlen), NULL if absent */
+static const char *http_event_header(const char *buf, int hdrlen, const char *key, int *vlen)
+{
+	int keylen = strlen(key);
+	int pos = http_event_find(buf, hdrlen, 0, "\r\n") + 2;
+	int end;
+
+	while (pos > 1 && pos < hdrlen) {
+		end = http_event_find(buf, hdrlen + 2, pos, "\r\n");
+		if (end < 0) {
+			break;
+		}
+		if (end - pos > keylen && buf[pos + keylen] == ':' && strncasecmp(buf + pos, key, keylen) == 0) {
+			pos += keylen + 1;
+			while (pos < end && buf[pos] == ' ') {
+				pos++;
+			}
+			*vlen = end - pos;
+			return buf + pos;
+		}
+		pos = end + 2;
+	}
+	return NULL;
+}
+
+/*
+ * Length of the first complete request in buf, 0 if more data is needed
+ * and -1 if the request cannot be framed.
+ */
+static int http_event_request_len(const char *buf, int len)
+{
+	const char *value;
+	int hdrlen;
+	int vlen;
+	int end;
+
+	end = http_event_find(buf, len, 0, "\r\n\r\n");
+	if (end < 0) {
+		return 0;
+	}
+	hdrlen = end + 4;
+
+	value = http_event_header(buf, end, "Transfer-Encoding", &vlen);
+	if (value && vlen == 7 && strncasecmp(value, "chunked", 7) == 0) {
+		/* The last chunk has a zero size, the body may start with it */
+		end = http_event_find(buf, len, end, "\r\n0\r\n\r\n");
+		return (end < 0) ? 0 : end + 7;
+	}
+
+	value = http_event_header(buf, end, "Content-Length", &vlen);
+	if (value) {
+		int content_len = HTTP_ATOI(value);
+		if (content_len < 0 || content_len > HTTP_CONF_MAX_REQUEST_LENGTH - hdrlen) {
+			return -1;
+		}
+		return (len < hdrlen + content_len) ? 0 : hdrlen + content_len;
+	}
+
+	return hdrlen;
+}
+
+/* HTTP/1.1 keeps the connection unless told otherwise, HTTP/1.0 only on request */
+static int http_event_keep_alive(const char *buf, int reqlen)
+{
+	const char *value;
+	int line = http_event_find(buf, reqlen, 0, "\r\n");
+	int hdrlen = http_event_find(buf, reqlen, 0, "\r\n\r\n");
+	int vlen;
+
+	value = http_event_header(buf, hdrlen, "Connection", &vlen);
+	if (line >= 8 && memcmp(buf + line - 8, "HTTP/1.1", 8) == 0) {
+		return !(value && vlen == 5 && strncasecmp(value, "close", 5) == 0);
+	}
+	return value && vlen == 10 && strncasecmp(value, "keep-alive", 10) == 0;
+}
+
+static int http_event_handle_request(struct http_conn_t *conn, char *buf, int reqlen)
+{
+	struct http_client_t *client = conn->client;
+	struct http_keyvalue_list_t params;
+	struct http_client_response_t response;
+	struct http_message_len_t mlen = {0, };
+	struct http_req_message req = {0, };
+	char url[HTTP_CONF_MAX_REQUEST_HEADER_URL_LENGTH] = {0, };
+	int method = HTTP_METHOD_UNKNOWN;
+	int enc = HTTP_CONTENT_LENGTH;
+	int state = HTTP_REQUEST_HEADER;
+	char *body = NULL;
+	char next;
+	int ret;
+
+	client->ws_state = 0;
+	client->sent = 0;
+	client->keep_alive = http_event_keep_alive(buf, reqlen);
+
+	if (http_keyvalue_list_init(&params) == HTTP_ERROR) {
+		return HTTP_EVENT_CLOSE;
+	}
+	memset(&response, 0, sizeof(response));
+
+	req.req_msg = buf;
+	req.url = url;
+	req.headers = &params;
+	req.client_ip = conn->client_ip;
+	req.encoding = HTTP_CONTENT_LENGTH;
+
+	/* The parser terminates the body in place, over the next pipelined request */
+	next = buf[reqlen];
+	ret = http_parse_message(buf, reqlen, &method, url, &body, &enc, &state, &mlen, &params, client, &response, &req);
+	if (ret == true && method != HTTP_METHOD_UNKNOWN) {
+		if (enc == HTTP_CONTENT_LENGTH) {
+			req.entity = body;
+			http_dispatch_url(client, &req);
+		}
+		/* Nothing handled the URL, the client would wait for the timeout */
+		if (client->sent == 0 && client->ws_state < MIN_WS_HEADER_FIELD) {
+			http_send_response(client, 404, HTTP_ERROR_404, NULL);
+		}
+	} else {
+		http_send_response(client, 400, HTTP_ERROR_400, NULL);
+		client->keep_alive = 0;
+	}
+	buf[reqlen] = next;
+
+	if (enc == HTTP_CHUNKED_ENCODING) {
+		HTTP_FREE(body);
+	}
+	http_keyvalue_list_release(&params);
+
+#ifdef CONFIG_NETUTILS_WEBSOCKET
+	if (client->ws_state >= MIN_WS_HEADER_FIELD) {
+		return (http_client_open_websocket(client) == HTTP_OK) ? HTTP_EVENT_DETACH : HTTP_EVENT_CLOSE;
+	}
+#endif
+	return client->keep_alive ? HTTP_EVENT_KEEP : HTTP_EVENT_CLOSE;
+}
+
+/* Read what arrived and answer every complete request in order */
+static int http_event_read(struct http_conn_t *conn)
+{
+	int start = 0;
+	int reqlen;
+	int ret;
+
+	ret = recv(conn->client->client_fd, conn->buf + conn->len, HTTP_CONF_MAX_REQUEST_LENGTH - conn->len, 0);
+	if (ret <= 0) {
+		return HTTP_EVENT_CLOSE;
+	}
+	conn->len += ret;
+
+	while ((reqlen = http_event_request_len(conn->buf + start, conn->len - start)) > 0) {
+		ret = http_event_handle_request(conn, conn->buf + start, reqlen);
+		start += reqlen;
+		if (ret != HTTP_EVENT_KEEP) {
+			return ret;
+		}
+	}
+
+	if (reqlen < 0 || (start == 0 && conn->len == HTTP_CONF_MAX_REQUEST_LENGTH)) {
+		HTTP_LOGE("Error: Request size is too large!!\n");
+		http_send_response(conn->client, 400, HTTP_ERROR_400, NULL);
+		return HTTP_EVENT_CLOSE;
+	}
+
+	if (start > 0) {
+		conn->len -= start;
+		HTTP_MEMCPY(conn->buf, conn->buf + start, conn->len);
+	}
+	return HTTP_EVENT_KEEP;
+}
+
+static struct http_conn_t *http_event_accept(struct http_server_t *server)
+{
+	struct http_conn_t *conn;
+	struct sockaddr_in addr;
+	socklen_t addrlen = sizeof(addr);
+	struct timeval tv;
+	int nodelay = 1;
+	int fd;
+
+	fd = accept(server->listen_fd, (struct sockaddr *)&addr, &addrlen);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	/*
+	 * A response is written in pieces and the client only sends the next
+	 * request once it has all of them, so Nagle would hold the last piece
+	 * until the delayed ACK.
+	 */
+	if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay)) < 0) {
+		HTTP_LOGD("Cannot set TCP_NODELAY %d\n", fd);
+	}
+
+	tv.tv_sec = HTTP_CONF_SEND_TIMEOUT_MSEC / 1000;
+	tv.tv_usec = (HTTP_CONF_SEND_TIMEOUT_MSEC % 1000) * 1000;
+	if (setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, (struct timeval *)&tv, sizeof(struct timeval)) < 0) {
+		HTTP_LOGE("Error: Cannot set SO_SNDTIMEO %d\n", fd);
+		goto errout;
+	}
+
+	conn = (struct http_conn_t *)HTTP_MALLOC(sizeof(struct http_conn_t));
+	if (conn == NULL) {
+		goto errout;
+	}
+	conn->buf = HTTP_MALLOC(HTTP_CONF_MAX_REQUEST_LENGTH + 1);
+	conn->client = http_client_init(server, fd);
+	if (conn->buf == NULL || conn->client == NULL) {
+		goto errout_with_conn;
+	}
+
+	conn->client_ip = addr.sin_addr.s_addr;
+	conn->len = 0;
+	conn->idle_since = http_event_now();
+	HTTP_LOGD("Client %d is accepted\n", fd);
+	return conn;
+
+errout_with_conn:
+	if (conn->client) {
+		http_client_release(conn->client);
+	}
+	if (conn->buf) {
+		HTTP_FREE(conn->buf);
+	}
+	HTTP_FREE(conn);
+errout:
+	close(fd);
+	return NULL;
+}
+
+static void http_event_release(struct http_conn_t *conn, int detach)
+{
+	if (!detach) {
+		close(conn->client->client_fd);
+	}
+	http_client_release(conn->client);
+	HTTP_FREE(conn->buf);
+	HTTP_FREE(conn);
+}
+
+static pthread_addr_t http_event_loop(pthread_addr_t arg)
+{
+	struct http_server_t *server = (struct http_server_t *)arg;
+	struct http_conn_t *conns[HTTP_CONF_MAX_CONNECTION];
+	struct pollfd fds[HTTP_CONF_MAX_CONNECTION + 1];
+	unsigned long now;
+	int nconns = 0;
+	int ret;
+	int i;
+
+	server->state = HTTP_SERVER_RUN;
+
+	while (server->state == HTTP_SERVER_RUN) {
+		/* Stop accepting while every connection slot is busy */
+		fds[0].fd = server->listen_fd;
+		fds[0].events = (nconns < HTTP_CONF_MAX_CONNECTION) ? POLLIN : 0;
+		fds[0].revents = 0;
+		for (i = 0; i < nconns; i++) {
+			fds[i + 1].fd = conns[i]->client->client_fd;
+			fds[i + 1].events = POLLIN;
+			fds[i + 1].revents = 0;
+		}
+
+		ret = poll(fds, nconns + 1, HTTP_EVENT_POLL_TIMEOUT_MS);
+		if (ret < 0 && errno != EINTR) {
+			HTTP_LOGE("Error: poll fail %d\n", errno);
+			break;
+		}
+
+		/* Backwards, so the last connection can fill a freed slot */
+		now = http_event_now();
+		for (i = nconns - 1; i >= 0; i--) {
+			if (fds[i + 1].revents) {
+				ret = http_event_read(conns[i]);
+				conns[i]->idle_since = now;
+			} else if (now - conns[i]->idle_since > HTTP_CONF_KEEPALIVE_TIMEOUT_MSEC) {
+				ret = HTTP_EVENT_CLOSE;
+			} else {
+				continue;
+			}
+
+			if (ret != HTTP_EVENT_KEEP) {
+				http_event_release(conns[i], ret == HTTP_EVENT_DETACH);
+				conns[i] = conns[--nconns];
+			}
+		}
+
+		if (fds[0].revents & POLLIN) {
+			conns[nconns] = http_event_accept(server);
+			if (conns[nconns] != NULL) {
+				nconns++;
+			}
+		}
+	}
+
+	for (i = 0; i < nconns; i++) {
+		http_event_release(conns[i], 0);
+	}
+
+	HTTP_LOGD("http_event_loop stop :%d\n", server->port);
+	server->state = HTTP_SERVER_STOP;
+	return NULL;
+}
+
+int http_server_event_start(struct http_server_t *server)
+{
+	pthread_attr_t attr;
+
+	if (pthread_attr_init(&attr) != 0) {
+		HTTP_LOGE("Error: Cannot initialize ptread attribute\n");
+		return HTTP_ERROR;
+	}
+	pthread_attr_setschedpolicy(&attr, SCHED_RR);
+	pthread_attr_setstacksize(&attr, HTTP_EVENT_STACKSIZE);
+
+	if (pthread_create(&server->tid, &attr, http_event_loop, (void *)server) != 0) {
+		HTTP_LOGE("Error: Cannot create server thread!!\n");
+		return HTTP_ERROR;
+	}
+	pthread_setname_np(server->tid, "webserver event loop");
+	pthread_detach(server->tid);
+
+	return HTTP_OK;
+}
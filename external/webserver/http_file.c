@@ -0,0 +1,250 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <strings.h>
+#include <protocols/webserver/http_err.h>
+#include <protocols/webserver/http_server.h>
+#include <protocols/webserver/http_keyvalue_list.h>
+
+#include "http.h"
+#include "http_client.h"
+#include "http_arch.h"
+#include "http_log.h"
+
+#define HTTP_FILE_ETAG_LENGTH  24
+#define HTTP_FILE_CHUNK_SIZE   1024
+
+#ifdef CONFIG_NETUTILS_WEBSERVER_FILE_CACHE
+struct http_file_entry_t {
+	char path[HTTP_CONF_MAX_REQUEST_HEADER_URL_LENGTH];
+	char etag[HTTP_FILE_ETAG_LENGTH];
+	char *data;
+	int size;
+	int refs;					/* responses still sending data */
+	unsigned int last_used;
+};
+
+static struct http_file_entry_t g_file_cache[CONFIG_NETUTILS_WEBSERVER_FILE_CACHE_ENTRIES];
+static pthread_mutex_t g_file_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int g_file_cache_tick;
+#endif
+
+static int http_file_read(int fd, char *buf, int len)
+{
+	int total = 0;
+	int ret;
+
+	while (total < len) {
+		ret = read(fd, buf + total, len - total);
+		if (ret <= 0) {
+			break;
+		}
+		total += ret;
+	}
+	return total;
+}
+
+#ifdef CONFIG_NETUTILS_WEBSERVER_FILE_CACHE
+/*
+ * Returns the cached copy of path with a reference held, loading it if
+ * needed. NULL means the file has to be read from the file system.
+ */
+static struct http_file_entry_t *http_file_cache_get(const char *path, const char *etag, int size)
+{
+	struct http_file_entry_t *entry = NULL;
+	struct http_file_entry_t *victim = NULL;
+	int fd;
+	int i;
+
+	if (size > CONFIG_NETUTILS_WEBSERVER_FILE_CACHE_MAX_SIZE || strlen(path) >= sizeof(entry->path)) {
+		return NULL;
+	}
+
+	pthread_mutex_lock(&g_file_cache_lock);
+	for (i = 0; i < CONFIG_NETUTILS_WEBSERVER_FILE_CACHE_ENTRIES; i++) {
+		if (g_file_cache[i].data && strcmp(g_file_cache[i].path, path) == 0) {
+			entry = &g_file_cache[i];
+			break;
+		}
+		/* Prefer a free slot, then the least recently used idle one */
+		if (g_file_cache[i].refs == 0 && (victim == NULL || (victim->data != NULL &&
+			(g_file_cache[i].data == NULL || g_file_cache[i].last_used < victim->last_used)))) {
+			victim = &g_file_cache[i];
+		}
+	}
+
+	if (entry && strcmp(entry->etag, etag) != 0) {
+		/* The file changed, reload it unless the old copy is being sent */
+		victim = (entry->refs == 0) ? entry : NULL;
+		entry = NULL;
+	}
+
+	if (entry == NULL && victim != NULL) {
+		HTTP_FREE(victim->data);
+		victim->data = HTTP_MALLOC(size + 1);
+		fd = open(path, O_RDONLY);
+		if (victim->data && fd >= 0 && http_file_read(fd, victim->data, size) == size) {
+			strncpy(victim->path, path, sizeof(victim->path));
+			strncpy(victim->etag, etag, sizeof(victim->etag));
+			victim->size = size;
+			entry = victim;
+		} else {
+			HTTP_FREE(victim->data);
+			victim->data = NULL;
+		}
+		if (fd >= 0) {
+			close(fd);
+		}
+	}
+
+	if (entry) {
+		entry->refs++;
+		entry->last_used = ++g_file_cache_tick;
+	}
+	pthread_mutex_unlock(&g_file_cache_lock);
+
+	return entry;
+}
+
+static void http_file_cache_put(struct http_file_entry_t *entry)
+{
+	pthread_mutex_lock(&g_file_cache_lock);
+	entry->refs--;
+	pthread_mutex_unlock(&g_file_cache_lock);
+}
+#endif
+
+static int http_file_stream(struct http_client_t *client, const char *path, int size)
+{
+	char *buf;
+	int fd;
+	int ret = HTTP_OK;
+	int len;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return HTTP_ERROR;
+	}
+	buf = HTTP_MALLOC(HTTP_FILE_CHUNK_SIZE);
+	if (buf == NULL) {
+		close(fd);
+		return HTTP_ERROR;
+	}
+
+	/* The length is already sent, a short file has to fail the connection */
+	while (size > 0 && ret == HTTP_OK) {
+		len = http_file_read(fd, buf, (size < HTTP_FILE_CHUNK_SIZE) ? size : HTTP_FILE_CHUNK_SIZE);
+		if (len <= 0) {
+			ret = HTTP_ERROR;
+			break;
+		}
+		ret = http_client_send(client, buf, len);
+		size -= len;
+	}
+
+	HTTP_FREE(buf);
+	close(fd);
+	return ret;
+}
+
+static const char *http_file_if_none_match(struct http_req_message *req)
+{
+	struct http_keyvalue_t *cur;
+
+	if (req == NULL || req->headers == NULL) {
+		return NULL;
+	}
+	for (cur = req->headers->head->next; cur != req->headers->tail; cur = cur->next) {
+		if (strcasecmp(cur->key, "If-None-Match") == 0) {
+			return cur->value;
+		}
+	}
+	return NULL;
+}
+
+int http_send_file(struct http_client_t *client, struct http_req_message *req, const char *path, const char *content_type)
+{
+	char header[256];
+	char etag[HTTP_FILE_ETAG_LENGTH];
+	const char *match;
+	struct stat st;
+	int len;
+	int ret;
+#ifdef CONFIG_NETUTILS_WEBSERVER_FILE_CACHE
+	struct http_file_entry_t *entry;
+#endif
+
+	if (client == NULL || path == NULL) {
+		return HTTP_ERROR;
+	}
+
+	if (stat(path, &st) < 0 || !S_ISREG(st.st_mode)) {
+		return http_send_response(client, 404, HTTP_ERROR_404, NULL);
+	}
+	snprintf(etag, sizeof(etag), "\"%lx-%lx\"", (unsigned long)st.st_mtime, (unsigned long)st.st_size);
+
+	match = http_file_if_none_match(req);
+	if (match && strcmp(match, etag) == 0) {
+		len = snprintf(header, sizeof(header), "HTTP/1.1 304 Not Modified\r\n"
+					   "ETag: %s\r\n"
+					   "Connection: %s\r\n"
+					   "\r\n", etag, client->keep_alive ? "keep-alive" : "close");
+		if (len < 0 || len >= sizeof(header)) {
+			return HTTP_ERROR;
+		}
+		return http_client_send(client, header, len);
+	}
+
+	len = snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\n"
+				   "Content-Type: %s\r\n"
+				   "Content-Length: %lu\r\n"
+				   "ETag: %s\r\n"
+				   "Connection: %s\r\n"
+				   "\r\n", content_type ? content_type : "application/octet-stream",
+				   (unsigned long)st.st_size, etag, client->keep_alive ? "keep-alive" : "close");
+	if (len < 0 || len >= sizeof(header)) {
+		HTTP_LOGE("Error: Header of %s is too long\n", path);
+		return http_send_response(client, 500, HTTP_ERROR_500, NULL);
+	}
+
+#ifdef CONFIG_NETUTILS_WEBSERVER_FILE_CACHE
+	entry = http_file_cache_get(path, etag, st.st_size);
+	if (entry) {
+		ret = http_client_send(client, header, len);
+		if (ret == HTTP_OK) {
+			ret = http_client_send(client, entry->data, entry->size);
+		}
+		http_file_cache_put(entry);
+		return ret;
+	}
+#endif
+
+	ret = http_client_send(client, header, len);
+	if (ret == HTTP_OK) {
+		ret = http_file_stream(client, path, st.st_size);
+	}
+	if (ret != HTTP_OK) {
+		HTTP_LOGE("Error: Fail to send %s\n", path);
+		client->keep_alive = 0;
+	}
+	return ret;
+}
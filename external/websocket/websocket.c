@@ -40,6 +40,9 @@
 #include <sys/time.h>
 #include "mbedtls/sha1.h"
 #include "mbedtls/base64.h"
+#ifdef CONFIG_TLS_SESSION_STORE
+#include "mbedtls/tls_session_store.h"
+#endif
 #include <netutils/netlib.h>
 #include <protocols/websocket.h>
 #include <protocols/wslay/wslay.h>
@@ -67,7 +70,7 @@ websocket_t ws_srv_table[WEBSOCKET_MAX_CLIENT];
 
 /****** websocket common functions *****/
 
-int websocket_tls_handshake(websocket_t *data, char *hostname, int auth_mode)
+int websocket_tls_handshake(websocket_t *data, char *hostname, int port, int auth_mode)
 {
 	int r;
 
@@ -98,6 +101,13 @@ int websocket_tls_handshake(websocket_t *data, char *hostname, int auth_mode)
 
 	mbedtls_ssl_set_bio(data->tls_ssl, &(data->tls_net), mbedtls_net_send, mbedtls_net_recv, NULL);
 
+#ifdef CONFIG_TLS_SESSION_STORE
+	/* resume the session kept for this server, if any */
+	if (hostname != NULL) {
+		tls_session_store_load(data->tls_ssl, hostname, port);
+	}
+#endif
+
 	/* Handshake */
 	WEBSOCKET_DEBUG("  . Performing the SSL/TLS handshake...");
 
@@ -108,6 +118,12 @@ int websocket_tls_handshake(websocket_t *data, char *hostname, int auth_mode)
 		}
 	}
 
+#ifdef CONFIG_TLS_SESSION_STORE
+	if (hostname != NULL) {
+		tls_session_store_save(data->tls_ssl, hostname, port);
+	}
+#endif
+
 	WEBSOCKET_DEBUG("OK\n");
 	return WEBSOCKET_SUCCESS;
 }
@@ -413,7 +429,7 @@ TLS_HS_RETRY:
 	}
 
 	if (client->tls_enabled) {
-		if ((r = websocket_tls_handshake(client, host, client->auth_mode)) != WEBSOCKET_SUCCESS) {
+		if ((r = websocket_tls_handshake(client, host, atoi(port), client->auth_mode)) != WEBSOCKET_SUCCESS) {
 			if (r == MBEDTLS_ERR_NET_SEND_FAILED || r == MBEDTLS_ERR_NET_RECV_FAILED || r == MBEDTLS_ERR_SSL_CONN_EOF) {
 				if (tls_hs_retry-- > 0) {
 					WEBSOCKET_DEBUG("Handshake again.... \n");
@@ -536,7 +552,7 @@ int websocket_server_authenticate(websocket_t *server)
 		mbedtls_ssl_init(server->tls_ssl);
 		mbedtls_net_init(&(server->tls_net));
 
-		if ((r = websocket_tls_handshake(server, NULL, server->auth_mode)) != WEBSOCKET_SUCCESS) {
+		if ((r = websocket_tls_handshake(server, NULL, 0, server->auth_mode)) != WEBSOCKET_SUCCESS) {
 			WEBSOCKET_DEBUG("fail to tls handshake\n");
 			r = WEBSOCKET_TLS_HANDSHAKE_ERROR;
 			goto EXIT_SERVER_START;
@@ -354,6 +354,21 @@ ui_error_t ui_widget_set_userdata(ui_widget_t widget, void *userdata);
  */
 void *ui_widget_get_userdata(ui_widget_t widget);
 
+#if defined(CONFIG_UI_WIDGET_RENDER_STATS)
+/**
+ * @brief Get the rendering statistics of the widget.
+ *
+ * The statistics are accumulated since the widget was created.
+ * The resolution of the time depends on the resolution of CLOCK_MONOTONIC.
+ *
+ * @param[in] widget Handle of the widget
+ * @param[out] count Number of times the widget has been rendered
+ * @param[out] time_us Accumulated rendering time of the widget (Microseconds)
+ * @return On success, UI_OK is returned. On failure, the defined error type is returned.
+ */
+ui_error_t ui_widget_get_render_stats(ui_widget_t widget, uint32_t *count, uint32_t *time_us);
+#endif
+
 /**
  * @brief Set the animation of the widget.
  *
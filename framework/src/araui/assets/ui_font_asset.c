@@ -26,6 +26,7 @@
 #include "ui_asset_internal.h"
 #include "ui_commons_internal.h"
 #include "ui_request_callback.h"
+#include "ui_glyph_atlas_internal.h"
 #include "ui_debug.h"
 
 #define STB_TRUETYPE_IMPLEMENTATION 
@@ -175,6 +176,10 @@ static void _ui_font_asset_destroy_func(void *userdata)
 
 	body = (ui_font_asset_body_t *)userdata;
 
+#if defined(CONFIG_UI_GLYPH_ATLAS)
+	ui_glyph_atlas_invalidate_font(body);
+#endif
+
 	UI_FREE(body->ttf_buf);
 	UI_FREE(body);
 }
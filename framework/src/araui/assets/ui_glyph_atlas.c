@@ -0,0 +1,241 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stb/stb_truetype.h>
+#include <araui/ui_commons.h>
+#include "ui_debug.h"
+#include "ui_asset_internal.h"
+#include "ui_glyph_atlas_internal.h"
+
+#if defined(CONFIG_UI_GLYPH_ATLAS)
+
+#define UI_GLYPH_ATLAS_SLOT_SIZE  CONFIG_UI_GLYPH_ATLAS_SLOT_SIZE
+#define UI_GLYPH_ATLAS_SLOT_NUM   CONFIG_UI_GLYPH_ATLAS_SLOT_NUM
+#define UI_GLYPH_ATLAS_HASH_SIZE  64
+#define UI_GLYPH_ATLAS_NONE       (-1)
+
+#define UI_GLYPH_ATLAS_HASH(font, size, code) \
+	((((uint32_t)(uintptr_t)(font) >> 4) ^ ((uint32_t)(size) * 31) ^ (uint32_t)(code)) & (UI_GLYPH_ATLAS_HASH_SIZE - 1))
+
+#if (UI_GLYPH_ATLAS_SLOT_NUM > 32767)
+#error "CONFIG_UI_GLYPH_ATLAS_SLOT_NUM is too large"
+#endif
+
+/**
+ * @brief One slot of the atlas holds one glyph.
+ * All slots are linked in LRU order, and the occupied slots are linked in the hash bucket.
+ */
+typedef struct {
+	ui_font_asset_body_t *font;
+	uint32_t code;
+	uint32_t font_size;
+	int16_t width;
+	int16_t height;
+	int16_t y_offset;
+	int16_t prev;
+	int16_t next;
+	int16_t hash_next;
+} ui_glyph_slot_t;
+
+static uint8_t g_glyph_atlas[UI_GLYPH_ATLAS_SLOT_NUM][UI_GLYPH_ATLAS_SLOT_SIZE * UI_GLYPH_ATLAS_SLOT_SIZE];
+static ui_glyph_slot_t g_glyph_slot[UI_GLYPH_ATLAS_SLOT_NUM];
+static int16_t g_glyph_hash[UI_GLYPH_ATLAS_HASH_SIZE];
+static int16_t g_lru_head = UI_GLYPH_ATLAS_NONE;	//!< Most recently used
+static int16_t g_lru_tail = UI_GLYPH_ATLAS_NONE;	//!< Least recently used
+static bool g_glyph_atlas_ready = false;
+
+static void _ui_glyph_atlas_init(void)
+{
+	int idx;
+
+	for (idx = 0; idx < UI_GLYPH_ATLAS_HASH_SIZE; idx++) {
+		g_glyph_hash[idx] = UI_GLYPH_ATLAS_NONE;
+	}
+
+	for (idx = 0; idx < UI_GLYPH_ATLAS_SLOT_NUM; idx++) {
+		g_glyph_slot[idx].font = NULL;
+		g_glyph_slot[idx].prev = idx - 1;
+		g_glyph_slot[idx].next = (idx + 1 < UI_GLYPH_ATLAS_SLOT_NUM) ? idx + 1 : UI_GLYPH_ATLAS_NONE;
+		g_glyph_slot[idx].hash_next = UI_GLYPH_ATLAS_NONE;
+	}
+
+	g_lru_head = 0;
+	g_lru_tail = UI_GLYPH_ATLAS_SLOT_NUM - 1;
+	g_glyph_atlas_ready = true;
+}
+
+static void _ui_glyph_atlas_lru_unlink(int16_t idx)
+{
+	ui_glyph_slot_t *slot = &g_glyph_slot[idx];
+
+	if (slot->prev != UI_GLYPH_ATLAS_NONE) {
+		g_glyph_slot[slot->prev].next = slot->next;
+	} else {
+		g_lru_head = slot->next;
+	}
+
+	if (slot->next != UI_GLYPH_ATLAS_NONE) {
+		g_glyph_slot[slot->next].prev = slot->prev;
+	} else {
+		g_lru_tail = slot->prev;
+	}
+}
+
+static void _ui_glyph_atlas_lru_push_head(int16_t idx)
+{
+	g_glyph_slot[idx].prev = UI_GLYPH_ATLAS_NONE;
+	g_glyph_slot[idx].next = g_lru_head;
+
+	if (g_lru_head != UI_GLYPH_ATLAS_NONE) {
+		g_glyph_slot[g_lru_head].prev = idx;
+	}
+	g_lru_head = idx;
+
+	if (g_lru_tail == UI_GLYPH_ATLAS_NONE) {
+		g_lru_tail = idx;
+	}
+}
+
+static void _ui_glyph_atlas_lru_push_tail(int16_t idx)
+{
+	g_glyph_slot[idx].prev = g_lru_tail;
+	g_glyph_slot[idx].next = UI_GLYPH_ATLAS_NONE;
+
+	if (g_lru_tail != UI_GLYPH_ATLAS_NONE) {
+		g_glyph_slot[g_lru_tail].next = idx;
+	}
+	g_lru_tail = idx;
+
+	if (g_lru_head == UI_GLYPH_ATLAS_NONE) {
+		g_lru_head = idx;
+	}
+}
+
+static void _ui_glyph_atlas_hash_remove(int16_t idx)
+{
+	ui_glyph_slot_t *slot = &g_glyph_slot[idx];
+	int16_t *link;
+
+	link = &g_glyph_hash[UI_GLYPH_ATLAS_HASH(slot->font, slot->font_size, slot->code)];
+	while (*link != UI_GLYPH_ATLAS_NONE) {
+		if (*link == idx) {
+			*link = slot->hash_next;
+			break;
+		}
+		link = &g_glyph_slot[*link].hash_next;
+	}
+
+	slot->hash_next = UI_GLYPH_ATLAS_NONE;
+	slot->font = NULL;
+}
+
+static void _ui_glyph_atlas_fill(ui_glyph_t *glyph, int16_t idx)
+{
+	glyph->bitmap = g_glyph_atlas[idx];
+	glyph->width = g_glyph_slot[idx].width;
+	glyph->height = g_glyph_slot[idx].height;
+	glyph->y_offset = g_glyph_slot[idx].y_offset;
+}
+
+ui_error_t ui_glyph_atlas_get(ui_font_asset_body_t *font, size_t font_size, float scale, uint32_t code, ui_glyph_t *glyph)
+{
+	ui_glyph_slot_t *slot;
+	uint32_t bucket;
+	int16_t idx;
+	int c_x1;
+	int c_y1;
+	int c_x2;
+	int c_y2;
+
+	if (!font || !glyph) {
+		return UI_INVALID_PARAM;
+	}
+
+	if (!g_glyph_atlas_ready) {
+		_ui_glyph_atlas_init();
+	}
+
+	bucket = UI_GLYPH_ATLAS_HASH(font, font_size, code);
+
+	for (idx = g_glyph_hash[bucket]; idx != UI_GLYPH_ATLAS_NONE; idx = g_glyph_slot[idx].hash_next) {
+		slot = &g_glyph_slot[idx];
+		if (slot->font == font && slot->font_size == font_size && slot->code == code) {
+			_ui_glyph_atlas_lru_unlink(idx);
+			_ui_glyph_atlas_lru_push_head(idx);
+			_ui_glyph_atlas_fill(glyph, idx);
+			return UI_OK;
+		}
+	}
+
+	stbtt_GetCodepointBitmapBox(&font->ttf_info, code, scale, scale, &c_x1, &c_y1, &c_x2, &c_y2);
+
+	if ((c_x2 - c_x1) > UI_GLYPH_ATLAS_SLOT_SIZE || (c_y2 - c_y1) > UI_GLYPH_ATLAS_SLOT_SIZE) {
+		return UI_OPERATION_FAIL;
+	}
+
+	// Evict the least recently used slot
+	idx = g_lru_tail;
+	if (g_glyph_slot[idx].font) {
+		_ui_glyph_atlas_hash_remove(idx);
+	}
+
+	slot = &g_glyph_slot[idx];
+	slot->font = font;
+	slot->font_size = font_size;
+	slot->code = code;
+	slot->width = c_x2 - c_x1;
+	slot->height = c_y2 - c_y1;
+	slot->y_offset = c_y1;
+
+	stbtt_MakeCodepointBitmap(&font->ttf_info, g_glyph_atlas[idx],
+		slot->width, slot->height, slot->width, scale, scale, code);
+
+	slot->hash_next = g_glyph_hash[bucket];
+	g_glyph_hash[bucket] = idx;
+
+	_ui_glyph_atlas_lru_unlink(idx);
+	_ui_glyph_atlas_lru_push_head(idx);
+	_ui_glyph_atlas_fill(glyph, idx);
+
+	return UI_OK;
+}
+
+void ui_glyph_atlas_invalidate_font(ui_font_asset_body_t *font)
+{
+	int16_t idx;
+
+	if (!font || !g_glyph_atlas_ready) {
+		return;
+	}
+
+	for (idx = 0; idx < UI_GLYPH_ATLAS_SLOT_NUM; idx++) {
+		if (g_glyph_slot[idx].font == font) {
+			_ui_glyph_atlas_hash_remove(idx);
+
+			// Freed slots are reused first
+			_ui_glyph_atlas_lru_unlink(idx);
+			_ui_glyph_atlas_lru_push_tail(idx);
+		}
+	}
+}
+
+#endif // CONFIG_UI_GLYPH_ATLAS
@@ -38,6 +38,7 @@
 #include "ui_asset_internal.h"
 #include "ui_widget_internal.h"
 #include "ui_window_internal.h"
+#include "ui_tile_internal.h"
 #include "ui_commons_internal.h"
 #include "ui_animation_internal.h"
 #include "dal/ui_dal.h"
@@ -265,6 +266,7 @@ static ui_error_t _ui_process_widget(ui_widget_body_t *widget, uint32_t dt)
 	return UI_OK;
 }
 
+#if !defined(CONFIG_UI_TILE_RENDERER)
 static ui_error_t _ui_render_widget(ui_widget_body_t *widget, ui_rect_t draw_area, uint32_t dt)
 {
 	int iter;
@@ -294,10 +296,10 @@ static ui_error_t _ui_render_widget(ui_widget_body_t *widget, ui_rect_t draw_are
 #if defined(CONFIG_UI_PARTIAL_UPDATE)
 				new_vp = ui_rect_intersect(draw_area, curr_widget->global_rect);
 				ui_dal_set_viewport(new_vp.x, new_vp.y, new_vp.width, new_vp.height);
-				curr_widget->render_cb((ui_widget_t)curr_widget, dt);
+				ui_widget_render(curr_widget, dt);
 				ui_dal_set_viewport(draw_area.x, draw_area.y, draw_area.width, draw_area.height);
 #else
-				curr_widget->render_cb((ui_widget_t)curr_widget, dt);
+				ui_widget_render(curr_widget, dt);
 #endif
 			}
 
@@ -309,6 +311,7 @@ static ui_error_t _ui_render_widget(ui_widget_body_t *widget, ui_rect_t draw_are
 
 	return UI_OK;
 }
+#endif
 
 static void _ui_call_anim_finished_cb(void *userdata)
 {
@@ -329,7 +332,11 @@ static void _ui_call_anim_finished_cb(void *userdata)
 
 static void _ui_redraw(uint32_t dt)
 {
-#if defined(CONFIG_UI_PARTIAL_UPDATE)
+#if defined(CONFIG_UI_TILE_RENDERER)
+	ui_rect_t *redraw_rects;
+	int num;
+	int idx;
+#elif defined(CONFIG_UI_PARTIAL_UPDATE)
 	ui_rect_t *redraw_rect;
 	int iter;
 #else
@@ -337,7 +344,32 @@ static void _ui_redraw(uint32_t dt)
 #endif
 	ui_window_body_t *window;
 
-#if defined(CONFIG_UI_PARTIAL_UPDATE)
+#if defined(CONFIG_UI_TILE_RENDERER)
+	num = ui_tile_get_dirty_rects(&redraw_rects);
+	if (num > 0) {
+		// Bin the widgets once per frame, widgets outside of dirty tiles are culled.
+		ui_tile_bin_reset();
+
+		window = ui_window_get_current();
+		if (window) {
+			ui_tile_bin_widget_tree(window->root);
+		}
+
+		if (_ui_core_quick_panel_visible()) {
+			ui_tile_bin_widget_tree(g_quick_panel_info[g_core.visible_event_type]);
+		}
+
+		for (idx = 0; idx < num; idx++) {
+			ui_tile_render_rect(redraw_rects[idx], dt);
+
+			if (window || _ui_core_quick_panel_visible()) {
+				ui_dal_redraw(redraw_rects[idx].x, redraw_rects[idx].y, redraw_rects[idx].width, redraw_rects[idx].height);
+			}
+		}
+	}
+
+	ui_window_redraw_list_clear();
+#elif defined(CONFIG_UI_PARTIAL_UPDATE)
 	vec_foreach(ui_window_get_redraw_list(), redraw_rect, iter) {
 		window = ui_window_get_current();
 		if (window) {
@@ -0,0 +1,270 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <vec/vec.h>
+#include <araui/ui_commons.h>
+#include "ui_debug.h"
+#include "ui_renderer.h"
+#include "ui_tile_internal.h"
+#include "ui_widget_internal.h"
+#include "ui_commons_internal.h"
+#include "dal/ui_dal.h"
+
+#if defined(CONFIG_UI_TILE_RENDERER)
+
+#if (UI_TILE_COLS > 32)
+#error "CONFIG_UI_TILE_SIZE is too small for the display width (tile columns must be <= 32)"
+#endif
+
+/**
+ * @brief The window tree and a quick panel tree can be binned in one frame.
+ */
+#define UI_TILE_MAX_BIN_NUM (CONFIG_UI_MAX_WIDGET_NUM * 2)
+
+#define UI_TILE_COL_MASK(from, to) ((0xffffffffu >> (31 - (to))) & ~((1u << (from)) - 1))
+
+typedef struct {
+	ui_widget_body_t *widget;
+	ui_rect_t area;	//!< Drawable area of the widget, clamped to the display
+	int16_t tx0;
+	int16_t ty0;
+	int16_t tx1;
+	int16_t ty1;
+} ui_tile_bin_t;
+
+static uint32_t g_tile_dirty[UI_TILE_ROWS];
+static ui_rect_t g_tile_rects[UI_TILE_MAX_RECTS];
+static ui_tile_bin_t g_tile_bin[UI_TILE_MAX_BIN_NUM];
+static int g_tile_bin_num;
+
+/**
+ * @brief Convert a rect into the inclusive pixel bounds clamped to the display.
+ *
+ * The global rect of a widget is truncated from the float bounding box,
+ * so the right and bottom edges are grown by one pixel to cover partial pixels.
+ */
+static bool _ui_tile_get_bounds(ui_rect_t rect, int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1)
+{
+	if (rect.width <= 0 || rect.height <= 0) {
+		return false;
+	}
+
+	*x0 = UI_MAX(rect.x, 0);
+	*y0 = UI_MAX(rect.y, 0);
+	*x1 = UI_MIN(rect.x + rect.width, CONFIG_UI_DISPLAY_WIDTH - 1);
+	*y1 = UI_MIN(rect.y + rect.height, CONFIG_UI_DISPLAY_HEIGHT - 1);
+
+	return (*x0 <= *x1 && *y0 <= *y1);
+}
+
+ui_error_t ui_tile_init(void)
+{
+	ui_tile_clear();
+	ui_tile_bin_reset();
+
+	return UI_OK;
+}
+
+void ui_tile_clear(void)
+{
+	memset(g_tile_dirty, 0, sizeof(g_tile_dirty));
+}
+
+void ui_tile_mark_dirty(ui_rect_t rect)
+{
+	int32_t x0;
+	int32_t y0;
+	int32_t x1;
+	int32_t y1;
+	uint32_t mask;
+	int ty;
+
+	if (!_ui_tile_get_bounds(rect, &x0, &y0, &x1, &y1)) {
+		return;
+	}
+
+	mask = UI_TILE_COL_MASK(x0 / UI_TILE_SIZE, x1 / UI_TILE_SIZE);
+	for (ty = y0 / UI_TILE_SIZE; ty <= y1 / UI_TILE_SIZE; ty++) {
+		g_tile_dirty[ty] |= mask;
+	}
+}
+
+int ui_tile_get_dirty_rects(ui_rect_t **rects)
+{
+	uint32_t rows[UI_TILE_ROWS];
+	uint32_t run;
+	int num = 0;
+	int tx0;
+	int tx1;
+	int ty0;
+	int ty1;
+
+	memcpy(rows, g_tile_dirty, sizeof(rows));
+
+	// Take the leftmost run of dirty tiles in a row, and extend it downward
+	// while the rows below contain the whole run. Every dirty tile is covered
+	// by exactly one rect, so no pixel is rendered twice in a frame.
+	for (ty0 = 0; ty0 < UI_TILE_ROWS; ty0++) {
+		while (rows[ty0]) {
+			tx0 = 0;
+			while (!(rows[ty0] & (1u << tx0))) {
+				tx0++;
+			}
+			tx1 = tx0;
+			while (tx1 + 1 < UI_TILE_COLS && (rows[ty0] & (1u << (tx1 + 1)))) {
+				tx1++;
+			}
+
+			run = UI_TILE_COL_MASK(tx0, tx1);
+			rows[ty0] &= ~run;
+
+			ty1 = ty0;
+			while (ty1 + 1 < UI_TILE_ROWS && (rows[ty1 + 1] & run) == run) {
+				ty1++;
+				rows[ty1] &= ~run;
+			}
+
+			g_tile_rects[num].x = tx0 * UI_TILE_SIZE;
+			g_tile_rects[num].y = ty0 * UI_TILE_SIZE;
+			g_tile_rects[num].width = UI_MIN((tx1 + 1) * UI_TILE_SIZE, CONFIG_UI_DISPLAY_WIDTH) - g_tile_rects[num].x;
+			g_tile_rects[num].height = UI_MIN((ty1 + 1) * UI_TILE_SIZE, CONFIG_UI_DISPLAY_HEIGHT) - g_tile_rects[num].y;
+			num++;
+		}
+	}
+
+	*rects = g_tile_rects;
+
+	return num;
+}
+
+void ui_tile_bin_reset(void)
+{
+	g_tile_bin_num = 0;
+}
+
+ui_error_t ui_tile_bin_widget_tree(ui_widget_body_t *root)
+{
+	int iter;
+	int ty;
+	int32_t x0;
+	int32_t y0;
+	int32_t x1;
+	int32_t y1;
+	uint32_t mask;
+	ui_widget_body_t *curr_widget;
+	ui_widget_body_t *child;
+	ui_tile_bin_t *bin;
+
+	if (!root) {
+		UI_LOGE("error: invalid widget!\n");
+		return UI_INVALID_PARAM;
+	}
+
+	ui_widget_queue_init();
+	ui_widget_queue_enqueue(root);
+
+	while (!ui_widget_is_queue_empty()) {
+		curr_widget = ui_widget_queue_dequeue();
+		if (!curr_widget) {
+			UI_LOGE("error: curr widget is NULL!\n");
+			return UI_OPERATION_FAIL;
+		}
+
+		if (!curr_widget->visible) {
+			continue;
+		}
+
+		// Children are not clipped by their parent, so only the widget itself is culled.
+		if (curr_widget->render_cb && _ui_tile_get_bounds(curr_widget->global_rect, &x0, &y0, &x1, &y1)) {
+			mask = UI_TILE_COL_MASK(x0 / UI_TILE_SIZE, x1 / UI_TILE_SIZE);
+			for (ty = y0 / UI_TILE_SIZE; ty <= y1 / UI_TILE_SIZE; ty++) {
+				if (g_tile_dirty[ty] & mask) {
+					break;
+				}
+			}
+
+			if (ty <= y1 / UI_TILE_SIZE) {
+				if (g_tile_bin_num >= UI_TILE_MAX_BIN_NUM) {
+					UI_LOGE("error: tile bin is full!\n");
+					return UI_OPERATION_FAIL;
+				}
+
+				bin = &g_tile_bin[g_tile_bin_num++];
+				bin->widget = curr_widget;
+				bin->area.x = x0;
+				bin->area.y = y0;
+				bin->area.width = x1 - x0 + 1;
+				bin->area.height = y1 - y0 + 1;
+				bin->tx0 = x0 / UI_TILE_SIZE;
+				bin->ty0 = y0 / UI_TILE_SIZE;
+				bin->tx1 = x1 / UI_TILE_SIZE;
+				bin->ty1 = y1 / UI_TILE_SIZE;
+			}
+		}
+
+		vec_foreach(&curr_widget->children, child, iter) {
+			ui_widget_queue_enqueue(child);
+		}
+	}
+
+	return UI_OK;
+}
+
+void ui_tile_render_rect(ui_rect_t rect, uint32_t dt)
+{
+	ui_tile_bin_t *bin;
+	ui_rect_t clip;
+	int tx0;
+	int ty0;
+	int tx1;
+	int ty1;
+	int idx;
+
+	tx0 = rect.x / UI_TILE_SIZE;
+	ty0 = rect.y / UI_TILE_SIZE;
+	tx1 = (rect.x + rect.width - 1) / UI_TILE_SIZE;
+	ty1 = (rect.y + rect.height - 1) / UI_TILE_SIZE;
+
+	for (idx = 0; idx < g_tile_bin_num; idx++) {
+		bin = &g_tile_bin[idx];
+
+		if (bin->tx1 < tx0 || bin->tx0 > tx1 || bin->ty1 < ty0 || bin->ty0 > ty1) {
+			continue;
+		}
+
+		clip.x = UI_MAX(rect.x, bin->area.x);
+		clip.y = UI_MAX(rect.y, bin->area.y);
+		clip.width = UI_MIN(rect.x + rect.width, bin->area.x + bin->area.width) - clip.x;
+		clip.height = UI_MIN(rect.y + rect.height, bin->area.y + bin->area.height) - clip.y;
+
+		ui_dal_set_viewport(clip.x, clip.y, clip.width, clip.height);
+		ui_renderer_set_clip_rect(clip);
+		ui_widget_render(bin->widget, dt);
+	}
+
+	ui_dal_set_viewport(rect.x, rect.y, rect.width, rect.height);
+	ui_renderer_set_clip_rect((ui_rect_t) {
+		0, 0, CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT
+	});
+}
+
+#endif // CONFIG_UI_TILE_RENDERER
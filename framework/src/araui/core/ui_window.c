@@ -27,18 +27,23 @@
 #include "ui_window_internal.h"
 #include "ui_request_callback.h"
 #include "ui_commons_internal.h"
+#if defined(CONFIG_UI_TILE_RENDERER)
+#include "ui_tile_internal.h"
+#endif
 
 static vec_void_t g_window_list;
 static ui_window_body_t *g_current_window = UI_NULL;
 #if defined(CONFIG_UI_PARTIAL_UPDATE)
 static vec_void_t g_window_redraw_list;
+#if !defined(CONFIG_UI_TILE_RENDERER)
 static ui_rect_t g_rect_mempool[CONFIG_UI_UPDATE_MEMPOOL_SIZE];
 static int g_rect_mempool_idx = 0;
 #endif
+#endif
 
 static void _ui_window_create_func(void *userdata);
 static void _ui_window_destroy_func(void *userdata);
-#if defined(CONFIG_UI_PARTIAL_UPDATE)
+#if defined(CONFIG_UI_PARTIAL_UPDATE) && !defined(CONFIG_UI_TILE_RENDERER)
 static ui_rect_t *_ui_window_get_mempool_rect(void);
 #endif
 
@@ -67,7 +72,11 @@ ui_error_t ui_window_redraw_list_init(void)
 {
 	vec_init(&g_window_redraw_list);
 
+#if defined(CONFIG_UI_TILE_RENDERER)
+	return ui_tile_init();
+#else
 	return UI_OK;
+#endif
 }
 
 ui_error_t ui_window_redraw_list_deinit(void)
@@ -256,6 +265,10 @@ vec_void_t *ui_window_get_redraw_list(void)
 
 ui_error_t ui_window_add_redraw_list(ui_rect_t redraw_rect)
 {
+#if defined(CONFIG_UI_TILE_RENDERER)
+	// Dirty areas are tracked per tile and merged right before the redraw.
+	ui_tile_mark_dirty(redraw_rect);
+#else
 	ui_rect_t *window;
 	ui_rect_t *new_area;
 	ui_rect_t previous;
@@ -323,6 +336,7 @@ ui_error_t ui_window_add_redraw_list(ui_rect_t redraw_rect)
 	}
 
 	vec_push(&g_window_redraw_list, new_area);
+#endif
 
 	return UI_OK;
 }
@@ -330,10 +344,14 @@ ui_error_t ui_window_add_redraw_list(ui_rect_t redraw_rect)
 ui_error_t ui_window_redraw_list_clear(void)
 {
 	vec_clear(&g_window_redraw_list);
+#if defined(CONFIG_UI_TILE_RENDERER)
+	ui_tile_clear();
+#endif
 
 	return UI_OK;
 }
 
+#if !defined(CONFIG_UI_TILE_RENDERER)
 static ui_rect_t *_ui_window_get_mempool_rect(void)
 {
 	int alloc_idx = g_rect_mempool_idx;
@@ -345,6 +363,7 @@ static ui_rect_t *_ui_window_get_mempool_rect(void)
 
 	return &g_rect_mempool[alloc_idx];
 }
+#endif
 #endif // CONFIG_UI_PARTIAL_UPDATE
 
 ui_window_body_t *ui_window_get_current(void)
@@ -0,0 +1,64 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __UI_GLYPH_ATLAS_INTERNAL_H__
+#define __UI_GLYPH_ATLAS_INTERNAL_H__
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <araui/ui_commons.h>
+#include "ui_asset_internal.h"
+
+#if defined(CONFIG_UI_GLYPH_ATLAS)
+
+/**
+ * @brief Rasterized glyph in A8 format. The stride of the bitmap is same with the width.
+ */
+typedef struct {
+	uint8_t *bitmap;
+	int32_t width;
+	int32_t height;
+	int32_t y_offset;	//!< Offset from the baseline to the top of the bitmap
+} ui_glyph_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the rasterized glyph of (font, font_size, code) from the atlas.
+ *
+ * If the glyph is not in the atlas, it is rasterized into the least recently used slot.
+ * The bitmap is valid until the next call of this function.
+ *
+ * @return On success, UI_OK is returned. If the glyph is larger than a slot, UI_OPERATION_FAIL is returned.
+ */
+ui_error_t ui_glyph_atlas_get(ui_font_asset_body_t *font, size_t font_size, float scale, uint32_t code, ui_glyph_t *glyph);
+
+/**
+ * @brief Drop every glyph of the font from the atlas. Called when the font asset is destroyed.
+ */
+void ui_glyph_atlas_invalidate_font(ui_font_asset_body_t *font);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONFIG_UI_GLYPH_ATLAS
+
+#endif
@@ -75,6 +75,9 @@ void ui_renderer_rotate(ui_mat3_t *mat, int32_t deg);
 void ui_renderer_scale(ui_mat3_t *mat, float x, float y);
 void ui_renderer_set_texture(uint8_t *bitmap, int32_t width, int32_t height, ui_pixel_format_t pf);
 void ui_renderer_set_fill_color(ui_color_t color);
+#if defined(CONFIG_UI_TILE_RENDERER)
+void ui_renderer_set_clip_rect(ui_rect_t rect);
+#endif
 
 /**
  * @brief Rendering geometry functions
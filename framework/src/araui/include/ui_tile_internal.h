@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __UI_TILE_INTERNAL_H__
+#define __UI_TILE_INTERNAL_H__
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <araui/ui_commons.h>
+#include "ui_widget_internal.h"
+
+#if defined(CONFIG_UI_TILE_RENDERER)
+
+/**
+ * @brief The screen is divided into UI_TILE_SIZE x UI_TILE_SIZE tiles.
+ * Dirty areas are tracked per tile, one bit per tile column in a row mask.
+ */
+#define UI_TILE_SIZE      (CONFIG_UI_TILE_SIZE)
+#define UI_TILE_COLS      ((CONFIG_UI_DISPLAY_WIDTH + UI_TILE_SIZE - 1) / UI_TILE_SIZE)
+#define UI_TILE_ROWS      ((CONFIG_UI_DISPLAY_HEIGHT + UI_TILE_SIZE - 1) / UI_TILE_SIZE)
+#define UI_TILE_MAX_RECTS (UI_TILE_COLS * UI_TILE_ROWS)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ui_error_t ui_tile_init(void);
+void ui_tile_clear(void);
+
+/**
+ * @brief Mark every tile touched by the rect as dirty.
+ */
+void ui_tile_mark_dirty(ui_rect_t rect);
+
+/**
+ * @brief Merge the dirty tiles into tile-aligned rectangles.
+ *
+ * @param[out] rects Internal array of the merged rectangles, valid until next call.
+ * @return The number of merged rectangles.
+ */
+int ui_tile_get_dirty_rects(ui_rect_t **rects);
+
+/**
+ * @brief Collect the visible widgets of the tree which overlap any dirty tile.
+ * The widgets are kept in rendering order, and the others are culled.
+ */
+void ui_tile_bin_reset(void);
+ui_error_t ui_tile_bin_widget_tree(ui_widget_body_t *root);
+
+/**
+ * @brief Render the binned widgets which overlap the rect.
+ * Drawing is clipped to the rect.
+ */
+void ui_tile_render_rect(ui_rect_t rect, uint32_t dt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONFIG_UI_TILE_RENDERER
+
+#endif
@@ -115,6 +115,11 @@ struct ui_widget_body_s {
 #endif
 	interval_info_t interval_info;
 
+#if defined(CONFIG_UI_WIDGET_RENDER_STATS)
+	uint32_t render_count;		//!< Number of render_cb calls
+	uint32_t render_time_us;	//!< Accumulated time spent in render_cb
+#endif
+
 	void *userdata;
 };
 
@@ -125,6 +130,12 @@ typedef struct {
 	ui_uv_t uv[4]; // top-left, bottom-left, bottom-right, top-right
 } ui_image_widget_body_t;
 
+typedef struct {
+	size_t start;	//!< Index of the first utf code of the line
+	size_t end;	//!< Index next to the last utf code of the line
+	int32_t width;	//!< Width of the line (Pixel)
+} ui_text_line_t;
+
 typedef struct {
 	ui_widget_body_t base;
 	ui_font_asset_body_t *font;
@@ -136,6 +147,15 @@ typedef struct {
 	size_t line_num;
 	ui_align_t align;
 	bool word_wrap;
+
+	/**
+	 * @brief Cached layout, rebuilt only when the text, font size, word wrap or width is changed.
+	 */
+	ui_text_line_t *lines;
+	int32_t layout_width;
+	bool layout_valid;
+	float scale;
+	int ascent;
 } ui_text_widget_body_t;
 
 typedef struct {
@@ -236,6 +256,7 @@ ui_error_t ui_widget_update_position_info(ui_widget_body_t *widget);
 void ui_widget_init(ui_widget_body_t *body, int32_t width, int32_t height);
 void ui_widget_deinit(ui_widget_body_t *body);
 void ui_widget_update_global_rect(ui_widget_body_t *widget);
+void ui_widget_render(ui_widget_body_t *body, uint32_t dt);
 ui_error_t ui_widget_destroy_sync(ui_widget_body_t *body);
 ui_error_t ui_widget_set_position_sync(ui_widget_body_t *body, int32_t x, int32_t y);
 ui_error_t ui_widget_set_rotation_sync(ui_widget_body_t *body, int32_t degree);
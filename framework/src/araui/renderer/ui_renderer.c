@@ -40,10 +40,25 @@
 
 #define CONFIG_UI_DEFAULT_FILL_COLOR 0x000000
 
+#if defined(CONFIG_UI_TILE_RENDERER)
+/**
+ * Edge function rasterizer works on 28.4 fixed-point vertex coordinates.
+ * Vertices must be inside of +-UI_EDGE_MAX_COORD pixels to keep the edge
+ * function values in 32 bits, otherwise the scanline rasterizer is used.
+ */
+#define UI_EDGE_SUBPIX_SHIFT (4)
+#define UI_EDGE_SUBPIX_ONE (1 << UI_EDGE_SUBPIX_SHIFT)
+#define UI_EDGE_MAX_COORD (512.0f)
+#define UI_EDGE_IS_TOP_LEFT(dx, dy) (((dy) < 0) || (((dy) == 0) && ((dx) > 0)))
+#endif
+
 /****************************************************************************
  * Private function declaration
  ****************************************************************************/
 static void ui_draw_triangle_segment(int32_t y1, int32_t y2);
+#if defined(CONFIG_UI_TILE_RENDERER)
+static bool ui_draw_triangle_edge(ui_vec3_t *v1, ui_vec3_t *v2, ui_vec3_t *v3, ui_uv_t *uv1, ui_uv_t *uv2, ui_uv_t *uv3);
+#endif
 
 /****************************************************************************
  * Private types
@@ -54,6 +69,9 @@ typedef struct {
 	int32_t           tex_height;
 	ui_pixel_format_t tex_pf;
 	ui_color_t        fill_color;
+#if defined(CONFIG_UI_TILE_RENDERER)
+	ui_rect_t         clip;
+#endif
 } ui_render_context_t;
 
 //!< Render context (global instance)
@@ -62,7 +80,10 @@ ui_render_context_t g_rc = {
 	.tex_width = 0,
 	.tex_height = 0,
 	.tex_pf = UI_PIXEL_FORMAT_UNKNOWN,
-	.fill_color = CONFIG_UI_DEFAULT_FILL_COLOR
+	.fill_color = CONFIG_UI_DEFAULT_FILL_COLOR,
+#if defined(CONFIG_UI_TILE_RENDERER)
+	.clip = { 0, 0, CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT }
+#endif
 };
 
 float g_left_dxdy;
@@ -190,6 +211,13 @@ void ui_renderer_set_fill_color(ui_color_t color)
 	g_rc.fill_color = color;
 }
 
+#if defined(CONFIG_UI_TILE_RENDERER)
+void ui_renderer_set_clip_rect(ui_rect_t rect)
+{
+	g_rc.clip = rect;
+}
+#endif
+
 void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 	ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3,
 	ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3)
@@ -225,6 +253,12 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 	v2 = ui_mat3_vec3_multiply(trans_mat, &v2);
 	v3 = ui_mat3_vec3_multiply(trans_mat, &v3);
 
+#if defined(CONFIG_UI_TILE_RENDERER)
+	if (ui_draw_triangle_edge(&v1, &v2, &v3, &uv1, &uv2, &uv3)) {
+		return;
+	}
+#endif
+
 	if (v1.y > v2.y) {
 		UI_SWAP(v1, v2);
 		UI_SWAP(uv1, uv2);
@@ -402,6 +436,227 @@ void ui_render_quad_uv(ui_mat3_t *trans_mat,
 /****************************************************************************
  * Private function implementation
  ****************************************************************************/
+#if defined(CONFIG_UI_TILE_RENDERER)
+static inline void ui_put_texel(int32_t x, int32_t y, int32_t iu, int32_t iv)
+{
+	int32_t uv_offset;
+
+	if (g_rc.tex_pf == UI_PIXEL_FORMAT_RGBA8888) {
+		uv_offset = ((iv * g_rc.tex_width) + iu) * 4;
+		ui_dal_put_pixel_rgba8888(x, y, UI_COLOR_RGBA8888(
+			g_rc.texture[uv_offset + 0],
+			g_rc.texture[uv_offset + 1],
+			g_rc.texture[uv_offset + 2],
+			g_rc.texture[uv_offset + 3]
+		));
+	} else if (g_rc.tex_pf == UI_PIXEL_FORMAT_RGB888) {
+		uv_offset = ((iv * g_rc.tex_width) + iu) * 3;
+		ui_dal_put_pixel_rgb888(x, y, UI_COLOR_RGB888(
+			g_rc.texture[uv_offset + 0],
+			g_rc.texture[uv_offset + 1],
+			g_rc.texture[uv_offset + 2]
+		));
+	} else if (g_rc.tex_pf == UI_PIXEL_FORMAT_A8) {
+		uv_offset = ((iv * g_rc.tex_width) + iu);
+		ui_dal_put_pixel_rgba8888(x, y, UI_COLOR_RGBA8888(
+			(g_rc.fill_color & 0xff0000) >> 16,
+			(g_rc.fill_color & 0x00ff00) >> 8,
+			(g_rc.fill_color & 0x0000ff) >> 0,
+			g_rc.texture[uv_offset]
+		));
+	}
+}
+
+/**
+ * @brief Narrow the span [x_left, x_right] to the pixels where e + (x - x0) * e_dx >= 0.
+ */
+static inline void ui_edge_clip_span(int32_t e, int32_t e_dx, int32_t x0, int32_t *x_left, int32_t *x_right)
+{
+	int32_t bound;
+
+	if (e_dx > 0) {
+		if (e < 0) {
+			bound = x0 + (-e + e_dx - 1) / e_dx;
+			*x_left = UI_MAX(*x_left, bound);
+		}
+	} else if (e_dx < 0) {
+		if (e < 0) {
+			*x_right = x0 - 1;
+		} else {
+			bound = x0 + e / -e_dx;
+			*x_right = UI_MIN(*x_right, bound);
+		}
+	} else if (e < 0) {
+		*x_right = x0 - 1;
+	}
+}
+
+/**
+ * @brief Rasterize a transformed triangle with the fixed-point edge functions.
+ *
+ * Pixels are sampled at integer coordinates same with the scanline rasterizer.
+ * The top-left fill rule is applied, so the two triangles of a quad never
+ * draw the shared edge twice. Only the pixels inside of the clip rect are visited.
+ *
+ * @return false if the triangle is out of the fixed-point range and not drawn.
+ */
+static bool ui_draw_triangle_edge(ui_vec3_t *v1, ui_vec3_t *v2, ui_vec3_t *v3, ui_uv_t *uv1, ui_uv_t *uv2, ui_uv_t *uv3)
+{
+	int32_t x1;
+	int32_t y1;
+	int32_t x2;
+	int32_t y2;
+	int32_t x3;
+	int32_t y3;
+	int32_t area;
+	int32_t min_x;
+	int32_t min_y;
+	int32_t max_x;
+	int32_t max_y;
+	int32_t x;
+	int32_t y;
+	int32_t e1_row;
+	int32_t e2_row;
+	int32_t e3_row;
+	int32_t x_left;
+	int32_t x_right;
+	int32_t e1_dx;
+	int32_t e2_dx;
+	int32_t e3_dx;
+	int32_t e1_dy;
+	int32_t e2_dy;
+	int32_t e3_dy;
+	int32_t U_row;
+	int32_t V_row;
+	int32_t U;
+	int32_t V;
+	int32_t dudx;
+	int32_t dvdx;
+	int32_t dudy;
+	int32_t dvdy;
+	int32_t iu;
+	int32_t iv;
+	float inv_area;
+	float tu;
+	float tv;
+	float w1;
+	float w2;
+	float w3;
+
+	if (fabsf(v1->x) > UI_EDGE_MAX_COORD || fabsf(v1->y) > UI_EDGE_MAX_COORD ||
+		fabsf(v2->x) > UI_EDGE_MAX_COORD || fabsf(v2->y) > UI_EDGE_MAX_COORD ||
+		fabsf(v3->x) > UI_EDGE_MAX_COORD || fabsf(v3->y) > UI_EDGE_MAX_COORD) {
+		return false;
+	}
+
+	if (!g_rc.texture || g_rc.tex_width <= 0 || g_rc.tex_height <= 0) {
+		return true;
+	}
+
+	x1 = (int32_t)floorf(v1->x * UI_EDGE_SUBPIX_ONE + 0.5f);
+	y1 = (int32_t)floorf(v1->y * UI_EDGE_SUBPIX_ONE + 0.5f);
+	x2 = (int32_t)floorf(v2->x * UI_EDGE_SUBPIX_ONE + 0.5f);
+	y2 = (int32_t)floorf(v2->y * UI_EDGE_SUBPIX_ONE + 0.5f);
+	x3 = (int32_t)floorf(v3->x * UI_EDGE_SUBPIX_ONE + 0.5f);
+	y3 = (int32_t)floorf(v3->y * UI_EDGE_SUBPIX_ONE + 0.5f);
+
+	area = (x2 - x1) * (y3 - y1) - (y2 - y1) * (x3 - x1);
+	if (area == 0) {
+		return true;
+	}
+
+	// Make the vertex order to have positive area, then inside is e >= 0.
+	if (area < 0) {
+		UI_SWAP(x2, x3);
+		UI_SWAP(y2, y3);
+		UI_SWAP(uv2, uv3);
+		area = -area;
+	}
+
+	// Bounding box in pixels, clipped to the clip rect
+	min_x = (UI_MIN(UI_MIN(x1, x2), x3) + UI_EDGE_SUBPIX_ONE - 1) >> UI_EDGE_SUBPIX_SHIFT;
+	min_y = (UI_MIN(UI_MIN(y1, y2), y3) + UI_EDGE_SUBPIX_ONE - 1) >> UI_EDGE_SUBPIX_SHIFT;
+	max_x = UI_MAX(UI_MAX(x1, x2), x3) >> UI_EDGE_SUBPIX_SHIFT;
+	max_y = UI_MAX(UI_MAX(y1, y2), y3) >> UI_EDGE_SUBPIX_SHIFT;
+
+	min_x = UI_MAX(min_x, g_rc.clip.x);
+	min_y = UI_MAX(min_y, g_rc.clip.y);
+	max_x = UI_MIN(max_x, g_rc.clip.x + g_rc.clip.width - 1);
+	max_y = UI_MIN(max_y, g_rc.clip.y + g_rc.clip.height - 1);
+
+	if (min_x > max_x || min_y > max_y) {
+		return true;
+	}
+
+	// e1, e2, e3 are the edge functions of the edges opposite to v1, v2, v3.
+	// The non top-left edges are biased by -1 to exclude the pixels on the edge.
+	e1_dx = -(y3 - y2) * UI_EDGE_SUBPIX_ONE;
+	e2_dx = -(y1 - y3) * UI_EDGE_SUBPIX_ONE;
+	e3_dx = -(y2 - y1) * UI_EDGE_SUBPIX_ONE;
+	e1_dy = (x3 - x2) * UI_EDGE_SUBPIX_ONE;
+	e2_dy = (x1 - x3) * UI_EDGE_SUBPIX_ONE;
+	e3_dy = (x2 - x1) * UI_EDGE_SUBPIX_ONE;
+
+	x = min_x << UI_EDGE_SUBPIX_SHIFT;
+	y = min_y << UI_EDGE_SUBPIX_SHIFT;
+	e1_row = (x3 - x2) * (y - y2) - (y3 - y2) * (x - x2);
+	e2_row = (x1 - x3) * (y - y3) - (y1 - y3) * (x - x3);
+	e3_row = (x2 - x1) * (y - y1) - (y2 - y1) * (x - x1);
+
+	w1 = (float)e1_row;
+	w2 = (float)e2_row;
+	w3 = (float)e3_row;
+
+	e1_row -= UI_EDGE_IS_TOP_LEFT(x3 - x2, y3 - y2) ? 0 : 1;
+	e2_row -= UI_EDGE_IS_TOP_LEFT(x1 - x3, y1 - y3) ? 0 : 1;
+	e3_row -= UI_EDGE_IS_TOP_LEFT(x2 - x1, y2 - y1) ? 0 : 1;
+
+	// Texture coordinates are interpolated in 16.16 texel units.
+	inv_area = 1.0f / (float)area;
+	tu = (float)(g_rc.tex_width - 1) * 65536.0f * inv_area;
+	tv = (float)(g_rc.tex_height - 1) * 65536.0f * inv_area;
+
+	U_row = (int32_t)((w1 * uv1->u + w2 * uv2->u + w3 * uv3->u) * tu);
+	V_row = (int32_t)((w1 * uv1->v + w2 * uv2->v + w3 * uv3->v) * tv);
+	dudx = (int32_t)((e1_dx * uv1->u + e2_dx * uv2->u + e3_dx * uv3->u) * tu);
+	dvdx = (int32_t)((e1_dx * uv1->v + e2_dx * uv2->v + e3_dx * uv3->v) * tv);
+	dudy = (int32_t)((e1_dy * uv1->u + e2_dy * uv2->u + e3_dy * uv3->u) * tu);
+	dvdy = (int32_t)((e1_dy * uv1->v + e2_dy * uv2->v + e3_dy * uv3->v) * tv);
+
+	for (y = min_y; y <= max_y; y++) {
+		// The triangle is convex, so the inside pixels of a row are one span.
+		x_left = min_x;
+		x_right = max_x;
+		ui_edge_clip_span(e1_row, e1_dx, min_x, &x_left, &x_right);
+		ui_edge_clip_span(e2_row, e2_dx, min_x, &x_left, &x_right);
+		ui_edge_clip_span(e3_row, e3_dx, min_x, &x_left, &x_right);
+
+		U = U_row + dudx * (x_left - min_x);
+		V = V_row + dvdx * (x_left - min_x);
+
+		for (x = x_left; x <= x_right; x++) {
+			iu = (U + 0x8000) >> 16;
+			iv = (V + 0x8000) >> 16;
+			iu = UI_MIN(UI_MAX(iu, 0), g_rc.tex_width - 1);
+			iv = UI_MIN(UI_MAX(iv, 0), g_rc.tex_height - 1);
+
+			ui_put_texel(x, y, iu, iv);
+
+			U += dudx;
+			V += dvdx;
+		}
+
+		e1_row += e1_dy;
+		e2_row += e2_dy;
+		e3_row += e3_dy;
+		U_row += dudy;
+		V_row += dvdy;
+	}
+
+	return true;
+}
+#endif // CONFIG_UI_TILE_RENDERER
+
 static void ui_draw_triangle_segment(int32_t y1, int32_t y2)
 {
 	float u;
@@ -32,6 +32,7 @@
 #include "ui_widget_internal.h"
 #include "ui_asset_internal.h"
 #include "ui_window_internal.h"
+#include "ui_glyph_atlas_internal.h"
 #include "dal/ui_dal.h"
 
 #if defined(CONFIG_UI_ENABLE_EMOJI)
@@ -77,6 +78,7 @@ static void _ui_text_widget_set_color(void *userdata);
 static void _ui_text_widget_set_word_wrap_func(void *userdata);
 static void _ui_text_widget_set_font_size_func(void *userdata);
 static void _ui_text_widget_calculate_line_num(ui_text_widget_body_t *body);
+static ui_error_t _ui_text_widget_update_layout(ui_text_widget_body_t *body);
 
 static uint8_t g_glyph_bitmap[CONFIG_UI_GLYPH_BITMAP_WIDTH * CONFIG_UI_GLYPH_BITMAP_HEIGHT];
 
@@ -426,11 +428,76 @@ static void _ui_text_widget_set_color(void *userdata)
 	UI_FREE(info);
 }
 
+static ui_error_t _ui_text_widget_update_layout(ui_text_widget_body_t *body)
+{
+	ui_text_line_t *lines;
+	int32_t text_width;
+	size_t utf_idx = 0;
+	size_t i;
+
+	if (body->layout_valid && body->layout_width == body->base.local_rect.width) {
+		return UI_OK;
+	}
+
+	// If the width is changed, the wrapped lines can be changed also.
+	if (body->word_wrap && body->layout_width != body->base.local_rect.width) {
+		_ui_text_widget_calculate_line_num(body);
+	}
+
+	lines = (ui_text_line_t *)UI_ALLOC(body->line_num * sizeof(ui_text_line_t));
+	if (!lines) {
+		return UI_NOT_ENOUGH_MEMORY;
+	}
+
+	UI_FREE(body->lines);
+	body->lines = lines;
+
+	body->scale = stbtt_ScaleForPixelHeight(&(body->font->ttf_info), body->font_size);
+
+	stbtt_GetFontVMetrics(&(body->font->ttf_info), &body->ascent, NULL, NULL);
+	body->ascent *= body->scale;
+
+	for (i = 0; i < body->line_num; i++) {
+		lines[i].start = utf_idx;
+
+		// Calculate the width of text
+		text_width = 0;
+		while (utf_idx < body->text_length && body->utf_code[utf_idx] != '\n') {
+			text_width += body->width_array[utf_idx];
+
+			if (body->word_wrap) {
+				if (text_width > body->base.local_rect.width) {
+					// As the width of text exceeds the width of text widget,
+					// this utf code will be printed at the next line.
+					text_width -= body->width_array[utf_idx];
+					utf_idx--;
+					break;
+				}
+			}
+
+			if (utf_idx >= (body->text_length - 1)) {
+				break;
+			} else {
+				utf_idx++;
+			}
+		}
+
+		utf_idx++;
+
+		lines[i].end = UI_MIN(utf_idx, body->text_length);
+		lines[i].width = text_width;
+	}
+
+	body->layout_width = body->base.local_rect.width;
+	body->layout_valid = true;
+
+	return UI_OK;
+}
+
 static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
 {
 	ui_text_widget_body_t *body;
-	float scale;
-	int ascent;
+	uint8_t *glyph_bitmap;
 	int i;
 	int c_x1;
 	int c_y1;
@@ -440,21 +507,17 @@ static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
 	int out_h;
 	int x;
 	int y;
-	int32_t text_width;
-	size_t utf_idx = 0;
-	size_t draw_idx = 0;
-#if defined(CONFIG_UI_DISPLAY_RGB888)
-	uint8_t r = 0;
-	uint8_t g = 0;
-	uint8_t b = 0;
-	uint8_t a = 0;
-#endif
+	size_t draw_idx;
 	ui_vec3_t v1;
 	ui_vec3_t v2;
 	ui_vec3_t v3;
 	ui_vec3_t v4;
 	ui_mat3_t text_mat;
 
+#if defined(CONFIG_UI_GLYPH_ATLAS)
+	ui_glyph_t glyph;
+#endif
+
 #if defined(CONFIG_UI_ENABLE_EMOJI)
 	ui_bitmap_data_t *emoji_bitmap;
 	ui_vec3_t emoji_v1;
@@ -475,12 +538,10 @@ static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
 		return;
 	}
 
-	memset(g_glyph_bitmap, 0, CONFIG_UI_GLYPH_BITMAP_WIDTH * CONFIG_UI_GLYPH_BITMAP_HEIGHT);
-
-	scale = stbtt_ScaleForPixelHeight(&(body->font->ttf_info), body->font_size);
-
-	stbtt_GetFontVMetrics(&(body->font->ttf_info), &ascent, NULL, NULL);
-	ascent *= scale;
+	if (_ui_text_widget_update_layout(body) != UI_OK) {
+		UI_LOGE("error: failed to update the layout!\n");
+		return;
+	}
 
 	x = 0;
 	y = 0;
@@ -491,50 +552,20 @@ static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
 		y = (body->base.global_rect.height - ((int32_t)body->line_num * body->font_size));
 	}
 
-	for (i = 0; i < body->line_num; i++) {
-		// Calculate the width of text
-		text_width = 0;
-		while (body->utf_code[utf_idx] != '\n') {
-			text_width += body->width_array[utf_idx];
-
-			if (body->word_wrap) {
-				if (text_width > body->base.local_rect.width) {
-					// As the width of text exceeds the width of text widget,
-					// this utf code will be printed at the next line.
-					text_width -= body->width_array[utf_idx];
-					utf_idx--;
-					break;
-				}
-			}
-
-			if (utf_idx >= (body->text_length - 1)) {
-				break;
-			} else {
-				utf_idx++;
-			}
-		}
-
-		utf_idx++;
+	ui_renderer_set_fill_color(body->font_color);
 
+	for (i = 0; i < body->line_num; i++) {
 		// Calculate proper x coordinate according to align
 		if (body->align & UI_ALIGN_LEFT) {
 			x = 0;
 		} else if (body->align & UI_ALIGN_CENTER) {
-			x = ((body->base.global_rect.width - text_width) >> 1);
+			x = ((body->base.global_rect.width - body->lines[i].width) >> 1);
 		} else if (body->align & UI_ALIGN_RIGHT) {
-			x = (body->base.global_rect.width - text_width);
+			x = (body->base.global_rect.width - body->lines[i].width);
 		}
 
-#if defined(CONFIG_UI_DISPLAY_RGB888)
-		a = ((ui_color_argb8888_t *)&(body->font_color))->a;
-		r = ((ui_color_argb8888_t *)&(body->font_color))->r;
-		g = ((ui_color_argb8888_t *)&(body->font_color))->g;
-		b = ((ui_color_argb8888_t *)&(body->font_color))->b;
-#endif
-
-		while (draw_idx < utf_idx) {
+		for (draw_idx = body->lines[i].start; draw_idx < body->lines[i].end; draw_idx++) {
 			if (body->utf_code[draw_idx] == '\n') {
-				draw_idx++;
 				continue;
 			}
 
@@ -563,66 +594,75 @@ static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
 						ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
 				}
 				x += body->font_size;
+				continue;
+			}
+#endif
+
+#if defined(CONFIG_UI_GLYPH_ATLAS)
+			if (ui_glyph_atlas_get(body->font, body->font_size, body->scale, body->utf_code[draw_idx], &glyph) == UI_OK) {
+				glyph_bitmap = glyph.bitmap;
+				out_w = glyph.width;
+				out_h = glyph.height;
+				c_y1 = glyph.y_offset;
 			} else {
 #endif
 				/* get bounding box for character (may be offset to account for chars that dip above or below the line */
 				stbtt_GetCodepointBitmapBox(&(body->font->ttf_info), body->utf_code[draw_idx],
-					scale, scale, &c_x1, &c_y1, &c_x2, &c_y2);
+					body->scale, body->scale, &c_x1, &c_y1, &c_x2, &c_y2);
 
 				out_w = c_x2 - c_x1;
 				out_h = c_y2 - c_y1;
 
 				/* render character (stride and offset is important here) */
-				stbtt_MakeCodepointBitmap(&(body->font->ttf_info), g_glyph_bitmap,
+				glyph_bitmap = g_glyph_bitmap;
+				stbtt_MakeCodepointBitmap(&(body->font->ttf_info), glyph_bitmap,
 					out_w, out_h,
 					out_w,
-					scale, scale,
+					body->scale, body->scale,
 					body->utf_code[draw_idx]);
-
-				ui_renderer_translate(&body->base.trans_mat, &text_mat, (float)x, (float)(y + ascent + c_y1));
-				ui_renderer_set_texture(g_glyph_bitmap, out_w, out_h, UI_PIXEL_FORMAT_A8);
-				ui_renderer_set_fill_color(body->font_color);
-
-				v1 = (ui_vec3_t){
-					.x = 0.0f,
-					.y = 0.0f,
-					1.0f
-				};
-				v2 = (ui_vec3_t){
-					.x = 0.0f,
-					.y = out_h,
-					1.0f
-				};
-				v3 = (ui_vec3_t){
-					.x = out_w,
-					.y = out_h,
-					1.0f
-				};
-				v4 = (ui_vec3_t){
-					.x = out_w,
-					.y = 0.0f,
-					1.0f
-				};
-
-				ui_render_quad_uv(&text_mat, v1, v2, v3, v4,
-							(ui_uv_t){ 0.0f, 0.0f },
-							(ui_uv_t){ 0.0f, 1.0f },
-							(ui_uv_t){ 1.0f, 1.0f },
-							(ui_uv_t){ 1.0f, 0.0f });
-
-				ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
-				ui_renderer_set_fill_color(CONFIG_UI_DEFAULT_FILL_COLOR);
-				memset(g_glyph_bitmap, 0, out_w * out_h);
-
-				x += body->width_array[draw_idx];
-#if defined(CONFIG_UI_ENABLE_EMOJI)
+#if defined(CONFIG_UI_GLYPH_ATLAS)
 			}
 #endif
-			draw_idx++;
+
+			ui_renderer_translate(&body->base.trans_mat, &text_mat, (float)x, (float)(y + body->ascent + c_y1));
+			ui_renderer_set_texture(glyph_bitmap, out_w, out_h, UI_PIXEL_FORMAT_A8);
+
+			v1 = (ui_vec3_t){
+				.x = 0.0f,
+				.y = 0.0f,
+				1.0f
+			};
+			v2 = (ui_vec3_t){
+				.x = 0.0f,
+				.y = out_h,
+				1.0f
+			};
+			v3 = (ui_vec3_t){
+				.x = out_w,
+				.y = out_h,
+				1.0f
+			};
+			v4 = (ui_vec3_t){
+				.x = out_w,
+				.y = 0.0f,
+				1.0f
+			};
+
+			ui_render_quad_uv(&text_mat, v1, v2, v3, v4,
+						(ui_uv_t){ 0.0f, 0.0f },
+						(ui_uv_t){ 0.0f, 1.0f },
+						(ui_uv_t){ 1.0f, 1.0f },
+						(ui_uv_t){ 1.0f, 0.0f });
+
+			ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
+
+			x += body->width_array[draw_idx];
 		}
 
 		y += body->font_size;
 	}
+
+	ui_renderer_set_fill_color(CONFIG_UI_DEFAULT_FILL_COLOR);
 }
 
 static void _ui_text_widget_removed_func(ui_widget_t widget)
@@ -638,6 +678,7 @@ static void _ui_text_widget_removed_func(ui_widget_t widget)
 
 	UI_FREE(body->utf_code);
 	UI_FREE(body->width_array);
+	UI_FREE(body->lines);
 }
 
 ui_error_t ui_text_widget_set_word_wrap(ui_widget_t widget, bool word_wrap)
@@ -772,6 +813,8 @@ static void _ui_text_widget_calculate_line_num(ui_text_widget_body_t *body)
 		return;
 	}
 
+	body->layout_valid = false;
+
 	scale = stbtt_ScaleForPixelHeight(&(body->font->ttf_info), body->font_size);
 
 	if (body->word_wrap) {
@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <sys/types.h>
+#include <time.h>
 #include <vec/vec.h>
 #include <araui/ui_commons.h>
 #include <araui/ui_widget.h>
@@ -875,6 +876,41 @@ void *ui_widget_get_userdata(ui_widget_t widget)
 	return body->userdata;
 }
 
+#if defined(CONFIG_UI_WIDGET_RENDER_STATS)
+ui_error_t ui_widget_get_render_stats(ui_widget_t widget, uint32_t *count, uint32_t *time_us)
+{
+	ui_widget_body_t *body = (ui_widget_body_t *)widget;
+
+	if (!body || !count || !time_us) {
+		return UI_INVALID_PARAM;
+	}
+
+	*count = body->render_count;
+	*time_us = body->render_time_us;
+
+	return UI_OK;
+}
+#endif
+
+void ui_widget_render(ui_widget_body_t *body, uint32_t dt)
+{
+#if defined(CONFIG_UI_WIDGET_RENDER_STATS)
+	struct timespec start;
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+#endif
+
+	body->render_cb((ui_widget_t)body, dt);
+
+#if defined(CONFIG_UI_WIDGET_RENDER_STATS)
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	body->render_count++;
+	body->render_time_us += ((end.tv_sec - start.tv_sec) * 1000000) + ((end.tv_nsec - start.tv_nsec) / 1000);
+#endif
+}
+
 ui_error_t ui_widget_play_anim(ui_widget_t widget, ui_anim_t anim, anim_finished_callback anim_finished_cb, bool loop)
 {
 	ui_set_anim_info_t *info;
@@ -24,6 +24,7 @@
 ** file at : https://github.com/erikd/libsamplerate/blob/master/COPYING
 */
 
+#include <tinyara/config.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -31,6 +32,7 @@
 #include <math.h>
 #include "samplerate.h"
 #include "../../utils/remix.h"
+#include "../../utils/remix_kernels.h"
 
 
 /****************************************************************************
@@ -90,6 +92,16 @@
 #define OLD_FRAMES_TO_BYTES(src, frames) ((frames) * (src)->old_channel_num * BYTES_PER_SAMPLE((src)->old_sample_width))
 #define NEW_FRAMES_TO_BYTES(src, frames) ((frames) * (src)->new_channel_num * BYTES_PER_SAMPLE((src)->new_sample_width))
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Q15 fixed point value of 1.0, sum of coefficients of every polyphase filter phase
+#define Q15_ONE (1 << 15)
+
+// Cut-off frequency of the polyphase prototype filter, relative to the lower Nyquist frequency
+#define POLYPHASE_CUTOFF (0.9f)
+
 // Check src context initialized or not
 #define CHECK_SRC_CONTEXT_INIT(src) ((src)->in_buffer != NULL)
 
@@ -108,6 +120,7 @@ struct src_context_s {
 	int in_buffer_frames;   // internal input buffer capability in frames
 	int left_frames;        // number of frames remained in internal input buffer
 	int used_frames;        // number of frames used in internal input buffer
+	int filtered_frames;    // number of frames at the head of internal input buffer already filtered
 	int old_channel_num;    // memorize old channel number
 	int new_channel_num;    // memorize new channel number
 	int old_sample_rate;    // memorize old sample rate
@@ -119,6 +132,15 @@ struct src_context_s {
 	float ratio;            // (float)new_sample_rate / (float)old_sample_rate
 	float inverse_ratio;    // (float)old_sample_rate / (float)new_sample_rate
 	uint32_t fp_frac;       // fraction part value of last fixed point index
+#ifdef CONFIG_AUDIO_RESAMPLER_POLYPHASE
+	int16_t *poly_bank;     // polyphase filter bank, poly_phases rows of poly_taps Q15 coefficients
+	int32_t poly_taps;      // number of coefficients per phase
+	int32_t poly_phases;    // interpolation factor L, new_sample_rate / gcd
+	int32_t poly_step_int;  // integer part of decimation factor M / L, M = old_sample_rate / gcd
+	int32_t poly_step_frac; // M % L
+	int32_t poly_phase;     // phase of next output frame, kept between src_simple() calls
+#endif
+	int32_t out_frames_max; // capability of the external output buffer in frames
 	/**
 	 * @brief   Function pointer to resampling process function
 	 * @param   src_context_t *: pointer to resampler object.
@@ -190,12 +212,15 @@ static int16_t clip(int32_t x)
  */
 static int32_t resample_frac(src_context_t *src, int32_t *num_frames_in)
 {
-	int32_t num_frames_out = (int32_t)((float)*num_frames_in * src->ratio);
 	const int16_t *input = src->in_buffer;
 	int16_t *output = src->out_buffer;
 	int32_t channels_num = src->new_channel_num;
 	uint32_t step = TO_16_16_FIXED(src->inverse_ratio);
 	uint32_t fp_index = src->fp_frac;
+	// Every output frame must start inside the given input frames, and fit in output buffer
+	uint32_t fp_end = (uint32_t)*num_frames_in << FRACBITS;
+	int32_t num_frames_out = (fp_end > fp_index) ? (int32_t)((fp_end - fp_index + step - 1) / step) : 0;
+	num_frames_out = MINIMUM(num_frames_out, src->out_frames_max);
 	uint32_t whole, frac;
 	int32_t i, j, s1, s2;
 
@@ -244,28 +269,146 @@ static int32_t downresample_int(src_context_t *src, int32_t *num_frames_in)
 	return num_frames_out;
 }
 
+#ifdef CONFIG_AUDIO_RESAMPLER_POLYPHASE
+static int32_t gcd(int32_t a, int32_t b)
+{
+	while (b != 0) {
+		int32_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/**
+ * @brief   Build polyphase filter bank for conversion ratio L/M.
+ * @remarks The prototype is a Blackman windowed sinc low pass filter, cut-off at
+ *          POLYPHASE_CUTOFF of the lower Nyquist frequency of both rates.
+ *          Phase p interpolates input position (idx + taps / 2 - 1 + p / L) from
+ *          frames [idx, idx + taps), so its coefficients are stored in input order.
+ *          Every phase is quantized to Q15 and normalized to unity DC gain.
+ *          Float math is only used here, once per stream, never per sample.
+ * @return  pointer to L * taps coefficients allocated, NULL on failure.
+ */
+static int16_t *build_polyphase_bank(int32_t phases, int32_t step, int32_t taps)
+{
+	int16_t *bank = (int16_t *)malloc(phases * taps * sizeof(int16_t));
+	RETURN_VAL_IF_FAIL((bank != NULL), NULL);
+
+	float cutoff = POLYPHASE_CUTOFF * MINIMUM(1.0f, (float)phases / (float)step);
+	int32_t p, j;
+	for (p = 0; p < phases; p++) {
+		int16_t *coeff = bank + p * taps;
+		int32_t sum = 0;
+		int32_t center = 0;
+		for (j = 0; j < taps; j++) {
+			float t = (float)(j - (taps / 2 - 1)) - (float)p / (float)phases;
+			float x = (float)M_PI * cutoff * t;
+			float sinc = (fabsf(x) < FLOAT_ACCURACY) ? 1.0f : sinf(x) / x;
+			float w = 2.0f * (float)M_PI * t / (float)taps;
+			float window = 0.42f + 0.5f * cosf(w) + 0.08f * cosf(2.0f * w);
+			// LRINTPF() rounds positive numbers only, so offset by 1.0 before rounding
+			coeff[j] = (int16_t)(LRINTPF(cutoff * sinc * window * Q15_ONE + Q15_ONE) - Q15_ONE);
+			sum += coeff[j];
+			if (coeff[j] > coeff[center]) {
+				center = j;
+			}
+		}
+		// Move rounding residue to the main tap, so DC gain is exactly 1.0
+		coeff[center] += Q15_ONE - sum;
+	}
+
+	return bank;
+}
+
+/**
+ * It handles all conversion ratios which have no more than
+ * CONFIG_AUDIO_RESAMPLER_POLYPHASE_MAX_PHASES phases, up and down scaling.
+ * Per output frame it costs one Q15 dot product of poly_taps samples per channel,
+ * anti-aliasing/anti-imaging is part of the filter bank, no extra filtering needed.
+ */
+static int32_t resample_polyphase(src_context_t *src, int32_t *num_frames_in)
+{
+	const int16_t *input = src->in_buffer;
+	int16_t *output = src->out_buffer;
+	int32_t channels_num = src->new_channel_num;
+	int32_t taps = src->poly_taps;
+	int32_t phase = src->poly_phase;
+	int32_t index = 0;
+	int32_t num_frames_out = 0;
+	int32_t j;
+
+	while ((index < *num_frames_in) && (num_frames_out < src->out_frames_max)) {
+		const int16_t *coeff = src->poly_bank + phase * taps;
+		const int16_t *frame = input + index * channels_num;
+		for (j = 0; j < channels_num; j++) {
+			*output++ = remix_dot_q15(frame + j, coeff, taps, channels_num);
+		}
+		num_frames_out++;
+
+		index += src->poly_step_int;
+		phase += src->poly_step_frac;
+		if (phase >= src->poly_phases) {
+			phase -= src->poly_phases;
+			index++;
+		}
+	}
+
+	*num_frames_in = index;
+	src->poly_phase = phase;
+	return num_frames_out;
+}
+
+/**
+ * @brief   Select polyphase resampling if the conversion ratio has few enough phases.
+ * @param   src: pointer to resampler object.
+ * @return  true if polyphase resampling is set up, false means fall back to the other methods.
+ */
+static bool init_polyphase(src_context_t *src)
+{
+	int32_t g = gcd(src->old_sample_rate, src->new_sample_rate);
+	int32_t phases = src->new_sample_rate / g;
+	int32_t step = src->old_sample_rate / g;
+
+	src->poly_bank = NULL;
+	if (phases > CONFIG_AUDIO_RESAMPLER_POLYPHASE_MAX_PHASES) {
+		return false;
+	}
+
+	src->poly_bank = build_polyphase_bank(phases, step, CONFIG_AUDIO_RESAMPLER_POLYPHASE_TAPS);
+	if (src->poly_bank == NULL) {
+		return false;
+	}
+
+	src->poly_taps = CONFIG_AUDIO_RESAMPLER_POLYPHASE_TAPS;
+	src->poly_phases = phases;
+	src->poly_step_int = step / phases;
+	src->poly_step_frac = step % phases;
+	src->poly_phase = 0;
+	src->filter_coeff = NULL;
+	// Reserve look-ahead frames of the last output, and frames skipped by its step
+	src->overlap_frames = src->poly_taps - 1 + src->poly_step_int + 1;
+	src->src_func = resample_polyphase;
+	return true;
+}
+#endif /* CONFIG_AUDIO_RESAMPLER_POLYPHASE */
+
 /**
  * @brief   Do filtering once new frames added to internal buffer.
+ * @remarks Frames are filtered once they have overlap_frames look-ahead frames.
  * @param   src: pointer to resampler object.
- * @param   num_frames_add: number of frames added
  */
-static void convolution_filtering(src_context_t *src, int32_t num_frames_add)
+static void convolution_filtering(src_context_t *src)
 {
-	if ((src->filter_coeff != NULL) && (src->left_frames > src->overlap_frames)) {
-		int16_t *input;
-		int32_t samples;
-		if (src->left_frames == num_frames_add) {
-			input = src->in_buffer;
-			samples = (num_frames_add - src->overlap_frames) * src->new_channel_num;
-		} else {
-			input = src->in_buffer + src->left_frames - num_frames_add - src->overlap_frames;
-			samples = num_frames_add * src->new_channel_num;
-		}
+	if ((src->filter_coeff != NULL) && (src->left_frames - src->overlap_frames > src->filtered_frames)) {
+		int16_t *input = src->in_buffer + src->filtered_frames * src->new_channel_num;
+		int32_t samples = (src->left_frames - src->overlap_frames - src->filtered_frames) * src->new_channel_num;
 
 		int32_t i;
 		for (i = 0; i < samples; ++i) {
 			input[i] = fir_convolve(input + i, src->filter_coeff, src->overlap_frames, src->new_channel_num);
 		}
+		src->filtered_frames = src->left_frames - src->overlap_frames;
 	}
 }
 
@@ -325,15 +468,23 @@ static int init_src_context(src_context_t *src, src_data_t *src_data)
 	src->new_sample_width = src_data->desired_sample_width;
 	src->old_sample_rate = src_data->origin_sample_rate;
 	src->new_sample_rate = src_data->desired_sample_rate;
-	src->in_buffer_frames = src->in_buffer_bytes / OLD_FRAMES_TO_BYTES(src, 1);
+	// Frames are stored in internal buffer after rechanneling, so count in new channel number
+	src->in_buffer_frames = src->in_buffer_bytes / NEW_FRAMES_TO_BYTES(src, 1);
 	src->left_frames = 0;
 	src->used_frames = 0;
+	src->filtered_frames = 0;
 	src->fp_frac = 0;
 
 	// Calculate converting ratio for later use
 	src->ratio = (float)src->new_sample_rate / (float)src->old_sample_rate;
 	src->inverse_ratio = (float)src->old_sample_rate / (float)src->new_sample_rate;
 
+#ifdef CONFIG_AUDIO_RESAMPLER_POLYPHASE
+	if (init_polyphase(src)) {
+		return SRC_ERR_NO_ERROR;
+	}
+#endif
+
 	// Set overlap frame number and converting function as per converting ratio
 	if (src->old_sample_rate > src->new_sample_rate) {
 		// down resampling
@@ -378,6 +529,9 @@ src_handle_t src_init(int size)
 	src->in_buffer_bytes = (((size + max_frame_size - 1) / max_frame_size) * max_frame_size);
 	src->in_buffer_frames = 0;
 	src->in_buffer = NULL;
+#ifdef CONFIG_AUDIO_RESAMPLER_POLYPHASE
+	src->poly_bank = NULL;
+#endif
 	// Other members will be initilized before first use,
 	// as soon as in_buffer allocated in init_src_context().
 
@@ -391,6 +545,10 @@ int src_destroy(src_handle_t handle)
 
 	free(src->in_buffer);
 	src->in_buffer = NULL;
+#ifdef CONFIG_AUDIO_RESAMPLER_POLYPHASE
+	free(src->poly_bank);
+	src->poly_bank = NULL;
+#endif
 
 	free(src);
 	return SRC_ERR_NO_ERROR;
@@ -442,12 +600,15 @@ int src_simple(src_handle_t handle, src_data_t *src_data)
 
 	// Update output buffer to src context (used in converting proccess functions)
 	src->out_buffer = (int16_t *)src_data->data_out;
-
-	// Move remaining frames in internal buffer
-	if ((src->used_frames > 0) && (src->left_frames > 0)) {
-		memcpy((void *)src->in_buffer, \
-			(const void *)((int8_t *)src->in_buffer + NEW_FRAMES_TO_BYTES(src, src->used_frames)), \
-			NEW_FRAMES_TO_BYTES(src, src->left_frames));
+	src->out_frames_max = out_buffer_frames;
+
+	// Move remaining frames in internal buffer, source and destination may overlap
+	if (src->used_frames > 0) {
+		if (src->left_frames > 0) {
+			memmove((void *)src->in_buffer, \
+				(const void *)((int8_t *)src->in_buffer + NEW_FRAMES_TO_BYTES(src, src->used_frames)), \
+				NEW_FRAMES_TO_BYTES(src, src->left_frames));
+		}
 		src->used_frames = 0;
 	}
 
@@ -460,7 +621,7 @@ int src_simple(src_handle_t handle, src_data_t *src_data)
 	src->left_frames += input_frames_used;
 
 	// Filtering on new appended frames
-	convolution_filtering(src, input_frames_used);
+	convolution_filtering(src);
 
 	// Calculate how many input frames needed if fill up out buffer
 	float input_frames_need = (float)out_buffer_frames / src->ratio;
@@ -476,6 +637,7 @@ int src_simple(src_handle_t handle, src_data_t *src_data)
 		if (output_frames_gen != 0) {
 			src->used_frames = frames;
 			src->left_frames -= frames;
+			src->filtered_frames = MAXIMUM(src->filtered_frames - frames, 0);
 		}
 	}
 
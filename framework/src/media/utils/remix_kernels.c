@@ -0,0 +1,312 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <string.h>
+#include "remix_kernels.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#if defined(CONFIG_MEDIA_AUDIO_SIMD) && defined(__ARM_FEATURE_DSP)
+#define REMIX_USE_ARM_DSP
+#elif defined(CONFIG_MEDIA_AUDIO_SIMD) && defined(__GNUC__)
+#define REMIX_USE_VECTOR
+#endif
+
+// Divide by 2 and round toward zero, same as '(int32_t)x / 2' without branch or division
+#define HALF(x) (((x) + (int32_t)((uint32_t)(x) >> 31)) >> 1)
+
+// 0.7071, keep the same integer arithmetic as MIX_COEFF in remix.cpp
+#define MIX_5CH(x) ((x) * 7071 / 1000)
+
+// Frames processed by one iteration of block loops
+#define BLOCK_FRAMES 4
+
+/****************************************************************************
+ * Private Declarations
+ ****************************************************************************/
+#ifdef REMIX_USE_VECTOR
+typedef int32_t v4s32 __attribute__((vector_size(16)));
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+#ifdef REMIX_USE_ARM_DSP
+/* DSP instructions are wrapped here instead of using <arm_acle.h>, whose
+ * SIMD32 intrinsics are missing in older toolchains. */
+static inline int32_t dsp_ssat16(int32_t x)
+{
+	int32_t r;
+	__asm__("ssat %0, #16, %1" : "=r"(r) : "r"(x));
+	return r;
+}
+
+// r = x.lo * y.lo + x.hi * y.hi
+static inline int32_t dsp_smuad(int32_t x, int32_t y)
+{
+	int32_t r;
+	__asm__("smuad %0, %1, %2" : "=r"(r) : "r"(x), "r"(y));
+	return r;
+}
+
+// r = acc + x.lo * y.lo + x.hi * y.hi
+static inline int32_t dsp_smlad(int32_t x, int32_t y, int32_t acc)
+{
+	int32_t r;
+	__asm__("smlad %0, %1, %2, %3" : "=r"(r) : "r"(x), "r"(y), "r"(acc));
+	return r;
+}
+
+// Load two adjacent 16 bits samples as one packed word, unaligned access is allowed on DSP cores
+static inline int32_t load_s16x2(const int16_t *p)
+{
+	int32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline void store_s16x2(int16_t *p, int32_t v)
+{
+	memcpy(p, &v, sizeof(v));
+}
+#endif
+
+static inline int16_t clip16(int32_t x)
+{
+#ifdef REMIX_USE_ARM_DSP
+	return (int16_t)dsp_ssat16(x);
+#else
+	x = (x > INT16_MAX) ? INT16_MAX : x;
+	x = (x < INT16_MIN) ? INT16_MIN : x;
+	return (int16_t)x;
+#endif
+}
+
+#ifdef REMIX_USE_VECTOR
+static inline v4s32 v_clip16(v4s32 x)
+{
+	const v4s32 hi = { INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX };
+	const v4s32 lo = { INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN };
+	v4s32 m = x > hi;
+	x = (x & ~m) | (hi & m);
+	m = x < lo;
+	return (x & ~m) | (lo & m);
+}
+
+static inline v4s32 v_half(v4s32 x)
+{
+	const v4s32 sign_shift = { 31, 31, 31, 31 };
+	typedef uint32_t v4u32 __attribute__((vector_size(16)));
+	return (x + (v4s32)((v4u32)x >> (v4u32)sign_shift)) >> 1;
+}
+
+static inline void v_store_s16(int16_t *out, uint32_t step, v4s32 v)
+{
+	out[0] = (int16_t)v[0];
+	out[step] = (int16_t)v[1];
+	out[step * 2] = (int16_t)v[2];
+	out[step * 3] = (int16_t)v[3];
+}
+
+// Gather one channel of 4 frames
+#define V_LOAD(p, step) ((v4s32){ (p)[0], (p)[(step)], (p)[(step) * 2], (p)[(step) * 3] })
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+void remix_clip_s32(const int32_t *input, int16_t *output, uint32_t samples)
+{
+	uint32_t i = 0;
+
+#ifdef REMIX_USE_VECTOR
+	for (; i + BLOCK_FRAMES <= samples; i += BLOCK_FRAMES) {
+		v_store_s16(&output[i], 1, v_clip16(V_LOAD(&input[i], 1)));
+	}
+#endif
+	for (; i < samples; i++) {
+		output[i] = clip16(input[i]);
+	}
+}
+
+void remix_mono_to_stereo(const int16_t *input, int16_t *output, uint32_t frames)
+{
+	// Maybe input == output, upmix backward.
+	uint32_t i = frames;
+
+#ifdef REMIX_USE_ARM_DSP
+	for (; i >= BLOCK_FRAMES; i -= BLOCK_FRAMES) {
+		// Duplicate each sample into both halfwords, compiled to PKHBT
+		uint32_t s3 = (uint16_t)input[i - 1];
+		uint32_t s2 = (uint16_t)input[i - 2];
+		uint32_t s1 = (uint16_t)input[i - 3];
+		uint32_t s0 = (uint16_t)input[i - 4];
+		store_s16x2(&output[(i - 1) * 2], (int32_t)(s3 | (s3 << 16)));
+		store_s16x2(&output[(i - 2) * 2], (int32_t)(s2 | (s2 << 16)));
+		store_s16x2(&output[(i - 3) * 2], (int32_t)(s1 | (s1 << 16)));
+		store_s16x2(&output[(i - 4) * 2], (int32_t)(s0 | (s0 << 16)));
+	}
+#endif
+	while (i > 0) {
+		i--;
+		int16_t s = input[i];
+		output[i * 2 + 1] = s;
+		output[i * 2] = s;
+	}
+}
+
+void remix_stereo_to_mono(const int16_t *input, int16_t *output, uint32_t frames)
+{
+	uint32_t i = 0;
+
+#if defined(REMIX_USE_ARM_DSP)
+	for (; i + BLOCK_FRAMES <= frames; i += BLOCK_FRAMES) {
+		// SMUAD with 0x00010001 adds both halfwords: l + r
+		int32_t s0 = dsp_smuad(load_s16x2(&input[i * 2]), 0x00010001);
+		int32_t s1 = dsp_smuad(load_s16x2(&input[i * 2 + 2]), 0x00010001);
+		int32_t s2 = dsp_smuad(load_s16x2(&input[i * 2 + 4]), 0x00010001);
+		int32_t s3 = dsp_smuad(load_s16x2(&input[i * 2 + 6]), 0x00010001);
+		output[i] = (int16_t)HALF(s0);
+		output[i + 1] = (int16_t)HALF(s1);
+		output[i + 2] = (int16_t)HALF(s2);
+		output[i + 3] = (int16_t)HALF(s3);
+	}
+#elif defined(REMIX_USE_VECTOR)
+	for (; i + BLOCK_FRAMES <= frames; i += BLOCK_FRAMES) {
+		v4s32 s = V_LOAD(&input[i * 2], 2) + V_LOAD(&input[i * 2 + 1], 2);
+		v_store_s16(&output[i], 1, v_half(s));
+	}
+#endif
+	for (; i < frames; i++) {
+		int32_t s = (int32_t)input[i * 2] + input[i * 2 + 1];
+		output[i] = (int16_t)HALF(s);
+	}
+}
+
+void remix_front_to_stereo(const int16_t *input, uint32_t in_ch, int16_t *output, uint32_t frames)
+{
+	uint32_t i;
+
+	for (i = 0; i < frames; i++) {
+		int16_t l = input[i * in_ch];
+		int16_t r = input[i * in_ch + 1];
+		output[i * 2] = l;
+		output[i * 2 + 1] = r;
+	}
+}
+
+void remix_surround_to_stereo(const int16_t *input, uint32_t in_ch, int16_t *output, uint32_t frames)
+{
+	uint32_t i = 0;
+
+#ifdef REMIX_USE_VECTOR
+	for (; i + BLOCK_FRAMES <= frames; i += BLOCK_FRAMES) {
+		const int16_t *in = &input[i * in_ch];
+		v4s32 c = V_LOAD(&in[2], in_ch);
+		// 'c / 2' of vector extension rounds toward zero like the scalar one
+		c = c / 2;
+		v4s32 l = v_clip16(V_LOAD(&in[0], in_ch) + c);
+		v4s32 r = v_clip16(V_LOAD(&in[1], in_ch) + c);
+		v_store_s16(&output[i * 2], 2, l);
+		v_store_s16(&output[i * 2 + 1], 2, r);
+	}
+#endif
+	for (; i < frames; i++) {
+		const int16_t *in = &input[i * in_ch];
+		int32_t c = in[2] / 2;
+		int32_t l = in[0] + c;
+		int32_t r = in[1] + c;
+		output[i * 2] = clip16(l);
+		output[i * 2 + 1] = clip16(r);
+	}
+}
+
+void remix_quad_to_stereo(const int16_t *input, int16_t *output, uint32_t frames)
+{
+	uint32_t i = 0;
+
+#ifdef REMIX_USE_VECTOR
+	for (; i + BLOCK_FRAMES <= frames; i += BLOCK_FRAMES) {
+		const int16_t *in = &input[i * 4];
+		v4s32 l = v_half(V_LOAD(&in[0], 4) + V_LOAD(&in[2], 4));
+		v4s32 r = v_half(V_LOAD(&in[1], 4) + V_LOAD(&in[3], 4));
+		v_store_s16(&output[i * 2], 2, l);
+		v_store_s16(&output[i * 2 + 1], 2, r);
+	}
+#endif
+	for (; i < frames; i++) {
+		const int16_t *in = &input[i * 4];
+		int32_t l = (int32_t)in[0] + in[2];
+		int32_t r = (int32_t)in[1] + in[3];
+		output[i * 2] = (int16_t)HALF(l);
+		output[i * 2 + 1] = (int16_t)HALF(r);
+	}
+}
+
+void remix_5ch_to_stereo(const int16_t *input, uint32_t in_ch, uint32_t bl_offset, int16_t *output, uint32_t frames)
+{
+	uint32_t i = 0;
+
+#ifdef REMIX_USE_VECTOR
+	for (; i + BLOCK_FRAMES <= frames; i += BLOCK_FRAMES) {
+		const int16_t *in = &input[i * in_ch];
+		v4s32 c = V_LOAD(&in[2], in_ch);
+		v4s32 l = V_LOAD(&in[0], in_ch) + MIX_5CH(c + V_LOAD(&in[bl_offset], in_ch));
+		v4s32 r = V_LOAD(&in[1], in_ch) + MIX_5CH(c + V_LOAD(&in[bl_offset + 1], in_ch));
+		v_store_s16(&output[i * 2], 2, v_clip16(l));
+		v_store_s16(&output[i * 2 + 1], 2, v_clip16(r));
+	}
+#endif
+	for (; i < frames; i++) {
+		const int16_t *in = &input[i * in_ch];
+		int32_t l = in[0] + MIX_5CH((int32_t)in[2] + in[bl_offset]);
+		int32_t r = in[1] + MIX_5CH((int32_t)in[2] + in[bl_offset + 1]);
+		output[i * 2] = clip16(l);
+		output[i * 2 + 1] = clip16(r);
+	}
+}
+
+int16_t remix_dot_q15(const int16_t *input, const int16_t *coeff, uint32_t taps, uint32_t stride)
+{
+	int32_t sum = 1 << 14;
+	uint32_t i = 0;
+
+	if (stride == 1) {
+#if defined(REMIX_USE_ARM_DSP)
+		for (; i + 4 <= taps; i += 4) {
+			sum = dsp_smlad(load_s16x2(&input[i]), load_s16x2(&coeff[i]), sum);
+			sum = dsp_smlad(load_s16x2(&input[i + 2]), load_s16x2(&coeff[i + 2]), sum);
+		}
+#elif defined(REMIX_USE_VECTOR)
+		v4s32 acc = { 0, 0, 0, 0 };
+		for (; i + 4 <= taps; i += 4) {
+			acc += V_LOAD(&input[i], 1) * V_LOAD(&coeff[i], 1);
+		}
+		sum += acc[0] + acc[1] + acc[2] + acc[3];
+#endif
+	}
+
+	for (; i < taps; i++) {
+		sum += (int32_t)input[i * stride] * coeff[i];
+	}
+
+	return clip16(sum >> 15);
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef REMIX_KERNELS_H
+#define REMIX_KERNELS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Block-processed sample kernels shared by rechannel() and the resampler.
+ *
+ * Every kernel has a portable C implementation. If CONFIG_MEDIA_AUDIO_SIMD
+ * is enabled, kernels are built with ARM DSP intrinsics when the core has
+ * the DSP extension (__ARM_FEATURE_DSP), or with GCC vector extensions
+ * otherwise. All variants are bit-exact with each other and with the
+ * original per-sample formulas in remix.cpp.
+ */
+
+/**
+ * @brief   Saturate 32 bits samples to 16 bits, out[i] = clip(in[i])
+ * @remarks output may be the same buffer as input is (interpreted as int16_t).
+ */
+void remix_clip_s32(const int32_t *input, int16_t *output, uint32_t samples);
+
+/**
+ * @brief   Mono to stereo, out[2i] = out[2i + 1] = in[i]
+ * @remarks input may be same with output, frames are processed backward then.
+ */
+void remix_mono_to_stereo(const int16_t *input, int16_t *output, uint32_t frames);
+
+/**
+ * @brief   Stereo to mono, out[i] = (in[2i] + in[2i + 1]) / 2
+ * @remarks input may be same with output.
+ */
+void remix_stereo_to_mono(const int16_t *input, int16_t *output, uint32_t frames);
+
+/**
+ * @brief   Multi-channel to stereo, out[2i] = in[i * in_ch], out[2i + 1] = in[i * in_ch + 1]
+ * @remarks Used for 2.1 layout, LFE channel is dropped. input may be same with output.
+ */
+void remix_front_to_stereo(const int16_t *input, uint32_t in_ch, int16_t *output, uint32_t frames);
+
+/**
+ * @brief   Surround/3.1 to stereo, out.l = clip(fl + fc / 2), out.r = clip(fr + fc / 2)
+ * @remarks fc is at offset 2 in every input frame. input may be same with output.
+ */
+void remix_surround_to_stereo(const int16_t *input, uint32_t in_ch, int16_t *output, uint32_t frames);
+
+/**
+ * @brief   Quad to stereo, out.l = (fl + bl) / 2, out.r = (fr + br) / 2
+ * @remarks input may be same with output.
+ */
+void remix_quad_to_stereo(const int16_t *input, int16_t *output, uint32_t frames);
+
+/**
+ * @brief   5.0/5.1 to stereo, out.l = clip(fl + (fc + bl) * 0.7071), out.r = clip(fr + (fc + br) * 0.7071)
+ * @param   bl_offset: offset of back left channel in one input frame, 3 for 5.0 and 4 for 5.1.
+ * @remarks input may be same with output.
+ */
+void remix_5ch_to_stereo(const int16_t *input, uint32_t in_ch, uint32_t bl_offset, int16_t *output, uint32_t frames);
+
+/**
+ * @brief   Q15 dot product used by the polyphase resampler
+ * @param   input: first sample, samples are read with step 'stride' (number of channels)
+ * @param   coeff: 'taps' Q15 coefficients
+ * @return  clip((sum(input[i * stride] * coeff[i]) + (1 << 14)) >> 15)
+ * @remarks The accumulator is 32 bits, coefficients of one phase must satisfy
+ *          sum(|coeff|) < 65536 which holds for every low pass bank we generate.
+ */
+int16_t remix_dot_q15(const int16_t *input, const int16_t *coeff, uint32_t taps, uint32_t stride);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* REMIX_KERNELS_H */
@@ -258,6 +258,54 @@ int sl_get_hash(sl_ctx hnd, hal_hash_type mode, hal_data *input, _OUT_ hal_data
 	return SECLINK_OK;
 }
 
+int sl_hash_init(sl_ctx hnd, hal_hash_type mode, uint32_t hash_idx, hal_result_e *hres)
+{
+	SLC_LOGI(TAG, "--> hnd(%p) mode(%d) idx(%d)\n", hnd, mode, hash_idx);
+
+	SL_CHECK_VALID(hnd);
+
+	struct _seclink_s_ *sl = (struct _seclink_s_ *)hnd;
+	struct seclink_auth_info info = {.auth_type.hash_type = mode, hash_idx, NULL, .auth_data.data = NULL};
+	struct seclink_req req = {.req_type.auth = &info, 0};
+
+	SL_CALL(sl, SECLINKIOC_HASHINIT, req);
+	*hres = req.res;
+
+	return SECLINK_OK;
+}
+
+int sl_hash_update(sl_ctx hnd, uint32_t hash_idx, hal_data *input, hal_result_e *hres)
+{
+	SLC_LOGI(TAG, "--> hnd(%p) idx(%d)\n", hnd, hash_idx);
+
+	SL_CHECK_VALID(hnd);
+
+	struct _seclink_s_ *sl = (struct _seclink_s_ *)hnd;
+	struct seclink_auth_info info = {.auth_type.hash_type = HAL_HASH_UNKNOWN, hash_idx, input, .auth_data.data = NULL};
+	struct seclink_req req = {.req_type.auth = &info, 0};
+
+	SL_CALL(sl, SECLINKIOC_HASHUPDATE, req);
+	*hres = req.res;
+
+	return SECLINK_OK;
+}
+
+int sl_hash_final(sl_ctx hnd, uint32_t hash_idx, _OUT_ hal_data *hash, hal_result_e *hres)
+{
+	SLC_LOGI(TAG, "--> hnd(%p) idx(%d)\n", hnd, hash_idx);
+
+	SL_CHECK_VALID(hnd);
+
+	struct _seclink_s_ *sl = (struct _seclink_s_ *)hnd;
+	struct seclink_auth_info info = {.auth_type.hash_type = HAL_HASH_UNKNOWN, hash_idx, NULL, .auth_data.data = hash};
+	struct seclink_req req = {.req_type.auth = &info, 0};
+
+	SL_CALL(sl, SECLINKIOC_HASHFINAL, req);
+	*hres = req.res;
+
+	return SECLINK_OK;
+}
+
 int sl_get_hmac(sl_ctx hnd, hal_hmac_type mode, hal_data *input, uint32_t key_idx, _OUT_ hal_data *hmac, hal_result_e *hres)
 {
 	SLC_LOGI(TAG, "--> hnd(%p) mode(%d)\n", hnd, mode);
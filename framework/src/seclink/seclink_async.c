@@ -0,0 +1,387 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#include <tinyara/config.h>
+
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#ifndef LINUX
+#include <debug.h>
+#endif
+#include <sys/ioctl.h>
+#include <tinyara/seclink.h>
+#include <tinyara/seclink_drv.h>
+#include "seclink_log.h"
+
+#define TAG "[SLA]"
+
+#ifdef LINUX
+extern int sl_post_msg(int fd, int cmd, unsigned long arg);
+#define ioctl sl_post_msg
+#endif
+
+#define SL_ASYNC_DEPTH      CONFIG_SECURITY_LINK_ASYNC_DEPTH
+#define SL_ASYNC_BATCH      CONFIG_SECURITY_LINK_ASYNC_BATCH
+
+/*
+ * Structure
+ */
+struct _seclink_async_s_ {
+	int fd;
+	pthread_t worker;
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+	pthread_cond_t progress;	/* an operation is done or left the queue */
+	struct sl_async_op *head;
+	struct sl_async_op *tail;
+	uint32_t queued;
+	uint32_t inflight;
+	int stop;
+	struct seclink_batch_entry entries[SL_ASYNC_BATCH];
+};
+
+static uint32_t _sl_async_elapsed_us(struct timespec *from, struct timespec *to)
+{
+	return (uint32_t)((to->tv_sec - from->tv_sec) * 1000000 + (to->tv_nsec - from->tv_nsec) / 1000);
+}
+
+static void _sl_async_prep(struct sl_async_op *op, int cmd)
+{
+	memset(op, 0, sizeof(struct sl_async_op));
+	op->cmd = cmd;
+	op->hres = HAL_SUCCESS;
+}
+
+/*
+ * Send the operations of a batch to the driver, one ioctl for all of them.
+ * A single operation goes alone, the driver doesn't have to unpack it.
+ */
+static void _sl_async_run(struct _seclink_async_s_ *ctx, struct sl_async_op **ops, uint32_t count)
+{
+	struct timespec start;
+	struct timespec end;
+	uint32_t i;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	if (count == 1) {
+		int res = ioctl(ctx->fd, ops[0]->cmd, (unsigned long)((uintptr_t)&ops[0]->req));
+		ctx->entries[0].ret = res;
+	} else {
+		struct seclink_batch_info info = {count, ctx->entries};
+		struct seclink_req req = {.req_type.batch = &info, 0};
+
+		for (i = 0; i < count; i++) {
+			ctx->entries[i].cmd = ops[i]->cmd;
+			ctx->entries[i].ret = 0;
+			ctx->entries[i].req = &ops[i]->req;
+		}
+		int res = ioctl(ctx->fd, SECLINKIOC_BATCH, (unsigned long)((uintptr_t)&req));
+		if (res < 0) {
+			SLC_LOGE(TAG, "batch ret(%d) code(%s)\n", res, strerror(errno));
+			for (i = 0; i < count; i++) {
+				ctx->entries[i].ret = res;
+			}
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	for (i = 0; i < count; i++) {
+		struct sl_async_op *op = ops[i];
+
+		op->ret = ctx->entries[i].ret < 0 ? SECLINK_ERROR : SECLINK_OK;
+		op->hres = op->req.res;
+		op->queue_us = _sl_async_elapsed_us(&op->submit, &start);
+		op->exec_us = _sl_async_elapsed_us(&start, &end);
+		op->batch_len = count;
+		if (op->cb) {
+			op->cb(op, op->cb_arg);
+		}
+	}
+}
+
+static void *_sl_async_worker(void *arg)
+{
+	struct _seclink_async_s_ *ctx = (struct _seclink_async_s_ *)arg;
+	struct sl_async_op *ops[SL_ASYNC_BATCH];
+	uint32_t count;
+	uint32_t i;
+
+	pthread_mutex_lock(&ctx->lock);
+	while (1) {
+		while (!ctx->head && !ctx->stop) {
+			pthread_cond_wait(&ctx->not_empty, &ctx->lock);
+		}
+		if (!ctx->head) {
+			break;
+		}
+
+		/*  Take what is queued, up to a batch */
+		for (count = 0; count < SL_ASYNC_BATCH && ctx->head; count++) {
+			ops[count] = ctx->head;
+			ctx->head = ctx->head->flink;
+		}
+		if (!ctx->head) {
+			ctx->tail = NULL;
+		}
+		ctx->queued -= count;
+		ctx->inflight = count;
+		pthread_cond_broadcast(&ctx->progress);
+		pthread_mutex_unlock(&ctx->lock);
+
+		_sl_async_run(ctx, ops, count);
+
+		pthread_mutex_lock(&ctx->lock);
+		for (i = 0; i < count; i++) {
+			ops[i]->done = 1;
+		}
+		ctx->inflight = 0;
+		pthread_cond_broadcast(&ctx->progress);
+	}
+	pthread_mutex_unlock(&ctx->lock);
+
+	return NULL;
+}
+
+/*  Queue */
+int sl_async_init(sl_async_ctx *actx)
+{
+	SLC_LOGI(TAG, "-->\n");
+
+	if (!actx) {
+		return SECLINK_ERROR;
+	}
+
+	struct _seclink_async_s_ *ctx = (struct _seclink_async_s_ *)calloc(1, sizeof(struct _seclink_async_s_));
+	if (!ctx) {
+		SLC_LOGE(TAG, "out of memory\n");
+		return SECLINK_ERROR;
+	}
+
+	ctx->fd = open(SECLINK_PATH, O_RDWR);
+	if (ctx->fd < 0) {
+		SLC_LOGE(TAG, "open ret(%d) code(%s)\n", ctx->fd, strerror(errno));
+		free(ctx);
+		return SECLINK_ERROR;
+	}
+
+	pthread_mutex_init(&ctx->lock, NULL);
+	pthread_cond_init(&ctx->not_empty, NULL);
+	pthread_cond_init(&ctx->progress, NULL);
+
+	pthread_attr_t attr;
+	struct sched_param param;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, CONFIG_SECURITY_LINK_ASYNC_STACKSIZE);
+	param.sched_priority = CONFIG_SECURITY_LINK_ASYNC_PRIORITY;
+	pthread_attr_setschedparam(&attr, &param);
+
+	int res = pthread_create(&ctx->worker, &attr, _sl_async_worker, ctx);
+	pthread_attr_destroy(&attr);
+	if (res != 0) {
+		SLC_LOGE(TAG, "create worker ret(%d)\n", res);
+		pthread_cond_destroy(&ctx->progress);
+		pthread_cond_destroy(&ctx->not_empty);
+		pthread_mutex_destroy(&ctx->lock);
+		close(ctx->fd);
+		free(ctx);
+		return SECLINK_ERROR;
+	}
+#ifndef LINUX
+	pthread_setname_np(ctx->worker, "seclink_async");
+#endif
+
+	*actx = ctx;
+
+	return SECLINK_OK;
+}
+
+int sl_async_deinit(sl_async_ctx actx)
+{
+	SLC_LOGI(TAG, "-->\n");
+
+	if (!actx) {
+		return SECLINK_ERROR;
+	}
+	struct _seclink_async_s_ *ctx = (struct _seclink_async_s_ *)actx;
+
+	/*  The worker completes what is queued before it stops, submitters
+	 *  held back by a full queue give up */
+	pthread_mutex_lock(&ctx->lock);
+	ctx->stop = 1;
+	pthread_cond_signal(&ctx->not_empty);
+	pthread_cond_broadcast(&ctx->progress);
+	pthread_mutex_unlock(&ctx->lock);
+
+	pthread_join(ctx->worker, NULL);
+
+	pthread_cond_destroy(&ctx->progress);
+	pthread_cond_destroy(&ctx->not_empty);
+	pthread_mutex_destroy(&ctx->lock);
+	close(ctx->fd);
+	free(ctx);
+
+	return SECLINK_OK;
+}
+
+int sl_async_submit(sl_async_ctx actx, struct sl_async_op *op, sl_async_cb cb, void *cb_arg)
+{
+	SLC_LOGI(TAG, "--> op(%p) cmd(%x)\n", op, op ? op->cmd : 0);
+
+	if (!actx || !op) {
+		return SECLINK_ERROR;
+	}
+	struct _seclink_async_s_ *ctx = (struct _seclink_async_s_ *)actx;
+
+	op->cb = cb;
+	op->cb_arg = cb_arg;
+	op->ret = SECLINK_OK;
+	op->flink = NULL;
+	op->done = 0;
+
+	pthread_mutex_lock(&ctx->lock);
+
+	/*  A full queue holds the caller back until the worker takes a batch */
+	while (ctx->queued >= SL_ASYNC_DEPTH && !ctx->stop) {
+		pthread_cond_wait(&ctx->progress, &ctx->lock);
+	}
+
+	if (ctx->stop) {
+		pthread_mutex_unlock(&ctx->lock);
+		return SECLINK_ERROR;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &op->submit);
+	if (ctx->tail) {
+		ctx->tail->flink = op;
+	} else {
+		ctx->head = op;
+	}
+	ctx->tail = op;
+	ctx->queued++;
+	pthread_cond_signal(&ctx->not_empty);
+	pthread_mutex_unlock(&ctx->lock);
+
+	return SECLINK_OK;
+}
+
+int sl_async_wait(sl_async_ctx actx, struct sl_async_op *op)
+{
+	if (!actx || !op) {
+		return SECLINK_ERROR;
+	}
+	struct _seclink_async_s_ *ctx = (struct _seclink_async_s_ *)actx;
+
+	pthread_mutex_lock(&ctx->lock);
+	while (!op->done) {
+		pthread_cond_wait(&ctx->progress, &ctx->lock);
+	}
+	pthread_mutex_unlock(&ctx->lock);
+
+	return op->ret;
+}
+
+int sl_async_flush(sl_async_ctx actx)
+{
+	if (!actx) {
+		return SECLINK_ERROR;
+	}
+	struct _seclink_async_s_ *ctx = (struct _seclink_async_s_ *)actx;
+
+	pthread_mutex_lock(&ctx->lock);
+	while (ctx->head || ctx->inflight) {
+		pthread_cond_wait(&ctx->progress, &ctx->lock);
+	}
+	pthread_mutex_unlock(&ctx->lock);
+
+	return SECLINK_OK;
+}
+
+/*  Operations */
+void sl_async_prep_hash_init(struct sl_async_op *op, hal_hash_type mode, uint32_t hash_idx)
+{
+	_sl_async_prep(op, SECLINKIOC_HASHINIT);
+	op->info.auth.auth_type.hash_type = mode;
+	op->info.auth.key_idx = hash_idx;
+	op->req.req_type.auth = &op->info.auth;
+}
+
+void sl_async_prep_hash_update(struct sl_async_op *op, uint32_t hash_idx, hal_data *input)
+{
+	_sl_async_prep(op, SECLINKIOC_HASHUPDATE);
+	op->info.auth.auth_type.hash_type = HAL_HASH_UNKNOWN;
+	op->info.auth.key_idx = hash_idx;
+	op->info.auth.data = input;
+	op->req.req_type.auth = &op->info.auth;
+}
+
+void sl_async_prep_hash_final(struct sl_async_op *op, uint32_t hash_idx, _OUT_ hal_data *hash)
+{
+	_sl_async_prep(op, SECLINKIOC_HASHFINAL);
+	op->info.auth.auth_type.hash_type = HAL_HASH_UNKNOWN;
+	op->info.auth.key_idx = hash_idx;
+	op->info.auth.auth_data.data = hash;
+	op->req.req_type.auth = &op->info.auth;
+}
+
+void sl_async_prep_get_hash(struct sl_async_op *op, hal_hash_type mode, hal_data *input, _OUT_ hal_data *hash)
+{
+	_sl_async_prep(op, SECLINKIOC_GETHASH);
+	op->info.auth.auth_type.hash_type = mode;
+	op->info.auth.key_idx = -1;
+	op->info.auth.data = input;
+	op->info.auth.auth_data.data = hash;
+	op->req.req_type.auth = &op->info.auth;
+}
+
+void sl_async_prep_generate_random(struct sl_async_op *op, uint32_t len, _OUT_ hal_data *random)
+{
+	_sl_async_prep(op, SECLINKIOC_GENERATERANDOM);
+	op->info.auth.auth_type.random_len = len;
+	op->info.auth.key_idx = -1;
+	op->info.auth.data = random;
+	op->req.req_type.auth = &op->info.auth;
+}
+
+void sl_async_prep_ecdsa_sign_md(struct sl_async_op *op, hal_ecdsa_mode mode, hal_data *hash, uint32_t key_idx, _OUT_ hal_data *sign)
+{
+	_sl_async_prep(op, SECLINKIOC_ECDSASIGNMD);
+	op->info.auth.auth_type.ecdsa_type = mode;
+	op->info.auth.key_idx = key_idx;
+	op->info.auth.data = hash;
+	op->info.auth.auth_data.data = sign;
+	op->req.req_type.auth = &op->info.auth;
+}
+
+void sl_async_prep_ecdsa_verify_md(struct sl_async_op *op, hal_ecdsa_mode mode, hal_data *hash, hal_data *sign, uint32_t key_idx)
+{
+	_sl_async_prep(op, SECLINKIOC_ECDSAVERIFYMD);
+	op->info.auth.auth_type.ecdsa_type = mode;
+	op->info.auth.key_idx = key_idx;
+	op->info.auth.data = hash;
+	op->info.auth.auth_data.data = sign;
+	op->req.req_type.auth = &op->info.auth;
+}
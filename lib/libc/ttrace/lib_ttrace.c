@@ -23,6 +23,10 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <sched.h>
+#include <semaphore.h>
 #include <sys/ioctl.h>
 #include <sys/types.h>
 #include <tinyara/clock.h>
@@ -32,13 +36,43 @@
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
-#define TTRACE_EVENT_TYPE_BEGIN    'b'
-#define TTRACE_EVENT_TYPE_END      'e'
-#define TTRACE_EVENT_TYPE_SCHED    's'
+#ifdef CONFIG_TTRACE_USER_BUFFER
+#define TTRACE_UBUF_SIZE           CONFIG_TTRACE_USER_BUFSIZE
+
+/* Keeps the packet copy ahead of the head update that publishes it */
+
+#define TTRACE_BARRIER()           __asm__ __volatile__("" ::: "memory")
+#endif
 
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
+#ifdef CONFIG_TTRACE_USER_BUFFER
+/* Packets of one task. Only the owner adds packets, at head. Flushes, by
+ * the owner or trace_flush_all(), consume them from tail under g_ubuf_sem.
+ * A packet never wraps; the owner skips to the start of the buffer and
+ * leaves in wrap where the data before the end stopped.
+ */
+
+struct ttrace_ubuf_s {
+	bool used;
+	pid_t owner;
+	int calls;                 /* Trace points left before the tags are read again */
+	volatile uint32_t head;    /* Bytes added, ever */
+	volatile uint32_t tail;    /* Bytes flushed, ever */
+	volatile uint32_t wrap;
+	char data[TTRACE_UBUF_SIZE];
+};
+
+/* A task which found no buffer free, it writes directly and looks for a
+ * buffer again only after CONFIG_TTRACE_USER_TAG_REFRESH trace points.
+ */
+
+struct ttrace_nobuf_s {
+	pid_t pid;
+	int calls;
+};
+#endif
 
 /****************************************************************************
  * Private Function Prototypes
@@ -64,6 +98,12 @@ int fd = -1;
 /****************************************************************************
  * Private Data
  ****************************************************************************/
+#ifdef CONFIG_TTRACE_USER_BUFFER
+static struct ttrace_ubuf_s g_ubufs[CONFIG_TTRACE_USER_NBUFFERS];
+static struct ttrace_nobuf_s g_ubuf_nobuf[CONFIG_TTRACE_USER_NBUFFERS];
+static sem_t g_ubuf_sem = SEM_INITIALIZER(1);
+static int g_ubuf_tags;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -89,6 +129,159 @@ static bool is_tag_available(int tag)
 	return true;
 }
 
+#ifdef CONFIG_TTRACE_USER_BUFFER
+static struct ttrace_ubuf_s *ttrace_ubuf_find(pid_t pid)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_TTRACE_USER_NBUFFERS; i++) {
+		if (g_ubufs[i].used && g_ubufs[i].owner == pid) {
+			return &g_ubufs[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Find the buffer of the task, or take a free one or the one of a task
+ * that has exited. Its packets still left are flushed with the new owner's.
+ * Checking whether the owners are alive is costly, a task which found all
+ * of them alive is remembered and does not check again for a while.
+ */
+
+static struct ttrace_ubuf_s *ttrace_ubuf_get(pid_t pid)
+{
+	struct ttrace_ubuf_s *ubuf;
+	struct ttrace_nobuf_s *nobuf;
+	struct sched_param param;
+	int i;
+
+	ubuf = ttrace_ubuf_find(pid);
+	if (ubuf != NULL) {
+		return ubuf;
+	}
+
+	nobuf = &g_ubuf_nobuf[pid % CONFIG_TTRACE_USER_NBUFFERS];
+	if (nobuf->pid == pid && --nobuf->calls > 0) {
+		return NULL;
+	}
+
+	sched_lock();
+	for (i = 0; i < CONFIG_TTRACE_USER_NBUFFERS; i++) {
+		if (!g_ubufs[i].used || sched_getparam(g_ubufs[i].owner, &param) != OK) {
+			ubuf = &g_ubufs[i];
+			ubuf->owner = pid;
+			ubuf->calls = 0;
+			ubuf->used = true;
+			break;
+		}
+	}
+	sched_unlock();
+
+	if (ubuf == NULL) {
+		nobuf->pid = pid;
+		nobuf->calls = CONFIG_TTRACE_USER_TAG_REFRESH;
+	}
+
+	return ubuf;
+}
+
+static void ttrace_ubuf_flush(int ttrace_fd, struct ttrace_ubuf_s *ubuf)
+{
+	uint32_t head;
+	uint32_t tail;
+	uint32_t pos;
+	uint32_t end;
+	uint32_t next;
+
+	while (sem_wait(&g_ubuf_sem) != OK) {
+		ASSERT(get_errno() == EINTR);
+	}
+
+	/* Packets dropped by the driver are not kept, as without the buffer */
+
+	head = ubuf->head;
+	tail = ubuf->tail;
+	while (tail != head) {
+		pos = tail % TTRACE_UBUF_SIZE;
+		if (head - tail >= TTRACE_UBUF_SIZE - pos) {
+			end = ubuf->wrap;
+			next = tail + TTRACE_UBUF_SIZE - pos;
+		} else {
+			end = pos + (head - tail);
+			next = head;
+		}
+		if (end > pos) {
+			(void)write(ttrace_fd, &ubuf->data[pos], end - pos);
+		}
+		tail = next;
+	}
+	ubuf->tail = tail;
+
+	sem_post(&g_ubuf_sem);
+}
+
+static void ttrace_ubuf_put(struct ttrace_ubuf_s *ubuf, struct trace_packet *packet, uint32_t len)
+{
+	uint32_t head = ubuf->head;
+	uint32_t pos = head % TTRACE_UBUF_SIZE;
+	uint32_t skip = 0;
+
+	if (pos + len > TTRACE_UBUF_SIZE) {
+		skip = TTRACE_UBUF_SIZE - pos;
+	}
+
+	if (head + skip + len - ubuf->tail > TTRACE_UBUF_SIZE) {
+		ttrace_ubuf_flush(is_fd_available(), ubuf);
+	}
+
+	if (skip != 0) {
+		ubuf->wrap = pos;
+		head += skip;
+		pos = 0;
+	}
+
+	memcpy(&ubuf->data[pos], packet, len);
+	if (pos + len == TTRACE_UBUF_SIZE) {
+		ubuf->wrap = TTRACE_UBUF_SIZE;
+	}
+
+	TTRACE_BARRIER();
+	ubuf->head = head + len;
+}
+
+/* The tag mask is read from the driver every CONFIG_TTRACE_USER_TAG_REFRESH
+ * trace points of a task rather than on each of them.
+ */
+
+static bool ttrace_ubuf_tag(struct ttrace_ubuf_s *ubuf, int tag)
+{
+	if (--ubuf->calls <= 0) {
+		if (is_fd_available() < 0) {
+			g_ubuf_tags = TTRACE_TAG_OFF;
+		} else {
+			g_ubuf_tags = ioctl(fd, TTRACE_FUNC_TAG, tag);
+		}
+		ubuf->calls = CONFIG_TTRACE_USER_TAG_REFRESH;
+	}
+
+	return (g_ubuf_tags & tag) != 0;
+}
+#endif
+
+static bool is_traced(int tag)
+{
+#ifdef CONFIG_TTRACE_USER_BUFFER
+	struct ttrace_ubuf_s *ubuf = ttrace_ubuf_get(getpid());
+
+	if (ubuf != NULL) {
+		return ttrace_ubuf_tag(ubuf, tag);
+	}
+#endif
+
+	return is_fd_available() >= 0 && is_tag_available(tag);
+}
+
 #ifdef CONFIG_DEBUG_TTRACE
 static void show_packet(struct trace_packet *packet)
 {
@@ -179,13 +372,25 @@ static int create_packet_sched(struct trace_packet *packet, struct tcb_s *prev,
 static int send_packet(struct trace_packet *packet)
 {
 	int ret = 0;
+	size_t len = sizeof(struct trace_packet);
+#ifdef CONFIG_TTRACE_USER_BUFFER
+	struct ttrace_ubuf_s *ubuf;
+#endif
 
 	if (packet->codelen & TTRACE_CODE_UNIQUE) {
-		ret = write(fd, packet, sizeof(struct trace_packet) - TTRACE_MSG_BYTES);
-	} else {
-		ret = write(fd, packet, sizeof(struct trace_packet));
+		len -= TTRACE_MSG_BYTES;
 	}
 
+#ifdef CONFIG_TTRACE_USER_BUFFER
+	ubuf = ttrace_ubuf_find(packet->pid);
+	if (ubuf != NULL) {
+		ttrace_ubuf_put(ubuf, packet, len);
+		return TTRACE_VALID;
+	}
+#endif
+
+	ret = write(fd, packet, len);
+
 	return ret;
 }
 
@@ -263,7 +468,7 @@ int trace_begin(int tag, char *str, ...)
 	struct trace_packet packet;
 	va_list ap;
 
-	if (is_fd_available() < 0 || !is_tag_available(tag)) {
+	if (!is_traced(tag)) {
 		return TTRACE_INVALID;
 	}
 
@@ -288,7 +493,7 @@ int trace_begin_uid(int tag, int8_t uniqueid)
 	int ret = TTRACE_VALID;
 	struct trace_packet packet;
 
-	if (is_fd_available() < 0 || !is_tag_available(tag)) {
+	if (!is_traced(tag)) {
 		return TTRACE_INVALID;
 	}
 
@@ -321,7 +526,7 @@ int trace_end(int tag)
 	int ret = TTRACE_VALID;
 	struct trace_packet packet;
 
-	if (is_fd_available() < 0 || !is_tag_available(tag)) {
+	if (!is_traced(tag)) {
 		return TTRACE_INVALID;
 	}
 
@@ -344,3 +549,60 @@ int trace_end_uid(int tag)
 	return trace_end(tag);
 }
 
+/****************************************************************************
+ * Name: trace_flush
+ *
+ * Description:
+ *   Write the packets the calling task has buffered to the driver.
+ *
+ ****************************************************************************/
+
+int trace_flush(void)
+{
+#ifdef CONFIG_TTRACE_USER_BUFFER
+	struct ttrace_ubuf_s *ubuf = ttrace_ubuf_find(getpid());
+
+	if (ubuf != NULL && ubuf->head != ubuf->tail) {
+		if (is_fd_available() < 0) {
+			return TTRACE_INVALID;
+		}
+		ttrace_ubuf_flush(fd, ubuf);
+	}
+#endif
+
+	return TTRACE_VALID;
+}
+
+/****************************************************************************
+ * Name: trace_flush_all
+ *
+ * Description:
+ *   Write the packets buffered by all tasks to the driver, before the
+ *   trace is finished. The descriptor of the driver is opened here, as the
+ *   one kept by the library may belong to another task group.
+ *
+ ****************************************************************************/
+
+int trace_flush_all(void)
+{
+#ifdef CONFIG_TTRACE_USER_BUFFER
+	int ttrace_fd;
+	int i;
+
+	ttrace_fd = open("/dev/ttrace", O_WRONLY);
+	if (ttrace_fd < 0) {
+		return TTRACE_INVALID;
+	}
+
+	for (i = 0; i < CONFIG_TTRACE_USER_NBUFFERS; i++) {
+		if (g_ubufs[i].used && g_ubufs[i].head != g_ubufs[i].tail) {
+			ttrace_ubuf_flush(ttrace_fd, &g_ubufs[i]);
+		}
+	}
+
+	close(ttrace_fd);
+#endif
+
+	return TTRACE_VALID;
+}
+
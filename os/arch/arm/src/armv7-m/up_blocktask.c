@@ -61,6 +61,7 @@
 #include <debug.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "up_internal.h"
@@ -149,6 +150,9 @@ void up_block_task(struct tcb_s *tcb, tstate_t task_state)
 	/* Now, perform the context switch if one is needed */
 
 	if (switch_needed) {
+		sched_cpuload_switch(rtcb, rtcb == tcb);
+		ttrace_sched_switch(rtcb, this_task());
+
 		/* Are we in an interrupt handler? */
 
 		if (current_regs) {
@@ -0,0 +1,157 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <arch/irq.h>
+
+#include "up_arch.h"
+#include "nvic.h"
+#include "dwt.h"
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static bool g_perf_cyccnt;
+static uint32_t g_perf_last;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_perf_systick
+ *
+ * Description:
+ *   Count the core clock cycles from the system ticks and the SysTick
+ *   current value, for cores without the DWT cycle counter.
+ *
+ ****************************************************************************/
+
+static uint32_t up_perf_systick(void)
+{
+	irqstate_t flags;
+	uint32_t reload;
+	uint32_t current;
+	uint32_t now;
+
+	flags = irqsave();
+
+	reload = getreg32(NVIC_SYSTICK_RELOAD);
+	now = (uint32_t)clock_systimer();
+	current = getreg32(NVIC_SYSTICK_CURRENT);
+
+	/* SysTick wrapped around but its interrupt is not taken yet */
+
+	if ((getreg32(NVIC_INTCTRL) & NVIC_INTCTRL_PENDSTSET) != 0) {
+		current = getreg32(NVIC_SYSTICK_CURRENT);
+		now++;
+	}
+
+	now = now * (reload + 1) + (reload - current);
+
+	/* In the SysTick handler, before the tick is counted, the time falls
+	 * one tick behind.
+	 */
+
+	if (g_perf_last - now - 1 < reload + 1) {
+		now += reload + 1;
+	}
+	g_perf_last = now;
+
+	irqrestore(flags);
+	return now;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_perf_init
+ *
+ * Description:
+ *   Start the DWT cycle counter.  Without a debug unit, as under QEMU,
+ *   TRCENA reads back as zero and the cycles are counted from SysTick.
+ *
+ ****************************************************************************/
+
+void up_perf_init(void)
+{
+	modifyreg32(NVIC_DEMCR, 0, NVIC_DEMCR_TRCENA);
+	if ((getreg32(NVIC_DEMCR) & NVIC_DEMCR_TRCENA) == 0 || (getreg32(DWT_CTRL) & DWT_CTRL_NOCYCCNT_Msk) != 0) {
+		return;
+	}
+
+	putreg32(0, DWT_CYCCNT);
+	modifyreg32(DWT_CTRL, 0, DWT_CTRL_CYCCNTENA_Msk);
+	g_perf_cyccnt = true;
+}
+
+/****************************************************************************
+ * Name: up_perf_gettime
+ *
+ * Description:
+ *   Return the core clock cycles, it wraps around.
+ *
+ ****************************************************************************/
+
+uint32_t up_perf_gettime(void)
+{
+	if (g_perf_cyccnt) {
+		return getreg32(DWT_CYCCNT);
+	}
+
+	return up_perf_systick();
+}
+
+/****************************************************************************
+ * Name: up_perf_getfreq
+ *
+ * Description:
+ *   Return the core clock frequency.  It is taken from the SysTick reload
+ *   value, so SysTick must be the system timer and run from the core
+ *   clock, otherwise zero is returned.
+ *
+ ****************************************************************************/
+
+uint32_t up_perf_getfreq(void)
+{
+	uint32_t ctrl = getreg32(NVIC_SYSTICK_CTRL);
+
+	if ((ctrl & (NVIC_SYSTICK_CTRL_ENABLE | NVIC_SYSTICK_CTRL_CLKSOURCE)) != (NVIC_SYSTICK_CTRL_ENABLE | NVIC_SYSTICK_CTRL_CLKSOURCE)) {
+		return 0;
+	}
+
+	return (getreg32(NVIC_SYSTICK_RELOAD) + 1) * CLK_TCK;
+}
+
+#endif							/* CONFIG_ARCH_HAVE_PERF_COUNTER */
@@ -61,6 +61,7 @@
 #include <sched.h>
 #include <debug.h>
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "up_internal.h"
@@ -164,6 +165,9 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				sched_mergepending();
 			}
 
+			sched_cpuload_switch(rtcb, false);
+			ttrace_sched_switch(rtcb, this_task());
+
 			/* Are we in an interrupt handler? */
 
 			if (current_regs) {
@@ -30,6 +30,7 @@
 #endif
 
 #include <tinyara/sched.h>
+#include <tinyara/ttrace.h>
 #if CONFIG_RR_INTERVAL > 0
 #include <tinyara/clock.h>
 #endif
@@ -119,6 +120,8 @@ void up_schedyield(void)
 		/* Get new head of the list */
 
 		ntcb = this_task();
+		sched_cpuload_switch(rtcb, true);
+		ttrace_sched_switch(rtcb, ntcb);
 
 #if CONFIG_RR_INTERVAL > 0
 		ntcb->timeslice = MSEC2TICK(CONFIG_RR_INTERVAL);
@@ -59,6 +59,7 @@
 #include <sched.h>
 #include <debug.h>
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "clock/clock.h"
@@ -131,6 +132,9 @@ void up_unblock_task(struct tcb_s *tcb)
 	 */
 
 	if (sched_addreadytorun(tcb)) {
+		sched_cpuload_switch(rtcb, false);
+		ttrace_sched_switch(rtcb, this_task());
+
 		/* The currently active task has changed! We need to do
 		 * a context switch to the new task.
 		 *
@@ -61,6 +61,7 @@
 #include <debug.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 #include <tinyara/sched.h>
 
 #include "sched/sched.h"
@@ -128,6 +129,9 @@ void up_block_task(struct tcb_s *tcb, tstate_t task_state)
 	/* Now, perform the context switch if one is needed */
 
 	if (switch_needed) {
+		sched_cpuload_switch(rtcb, rtcb == tcb);
+		ttrace_sched_switch(rtcb, this_task());
+
 		/* Are we in an interrupt handler? */
 
 		if (current_regs) {
@@ -59,6 +59,7 @@
 #include <sched.h>
 #include <debug.h>
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 #include <tinyara/sched.h>
 
 #include "sched/sched.h"
@@ -93,6 +94,9 @@ void up_release_pending(void)
 
 	/* sched_lock(); */
 	if (sched_mergepending()) {
+		sched_cpuload_switch(rtcb, false);
+		ttrace_sched_switch(rtcb, this_task());
+
 		/* The currently active task has changed!  We will need to
 		 * switch contexts.
 		 */
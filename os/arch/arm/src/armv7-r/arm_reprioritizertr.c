@@ -61,6 +61,7 @@
 #include <sched.h>
 #include <debug.h>
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 #include <tinyara/sched.h>
 
 #include "sched/sched.h"
@@ -146,6 +147,9 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				sched_mergepending();
 			}
 
+			sched_cpuload_switch(rtcb, false);
+			ttrace_sched_switch(rtcb, this_task());
+
 			/* Are we in an interrupt handler? */
 
 			if (current_regs) {
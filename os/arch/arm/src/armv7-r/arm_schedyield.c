@@ -105,6 +105,8 @@ void up_schedyield(void)
 		/* Get new head of the list */
 
 		ntcb = this_task();
+		sched_cpuload_switch(rtcb, true);
+		ttrace_sched_switch(rtcb, ntcb);
 
 #if CONFIG_RR_INTERVAL > 0
 		ntcb->timeslice = MSEC2TICK(CONFIG_RR_INTERVAL);
@@ -129,7 +131,9 @@ void up_schedyield(void)
 			 * of the g_readytorun task list.
 			 */
 
+#ifndef CONFIG_TTRACE_KERNEL_EVENTS
 			trace_sched(NULL, ntcb);
+#endif
 
 	#ifdef CONFIG_TASK_SCHED_HISTORY
 			/* Save the task name which will be scheduled */
@@ -156,7 +160,9 @@ void up_schedyield(void)
 			 * of the g_readytorun task list.
 			 */
 
+#ifndef CONFIG_TTRACE_KERNEL_EVENTS
 			trace_sched(NULL, ntcb);
+#endif
 
 	#ifdef CONFIG_TASK_SCHED_HISTORY
 			/* Save the task name which will be scheduled */
@@ -120,6 +120,9 @@ void up_unblock_task(struct tcb_s *tcb)
 	 */
 
 	if (sched_addreadytorun(tcb)) {
+		sched_cpuload_switch(rtcb, false);
+		ttrace_sched_switch(rtcb, this_task());
+
 		/* The currently active task has changed! We need to do
 		 * a context switch to the new task.
 		 */
@@ -139,7 +142,9 @@ void up_unblock_task(struct tcb_s *tcb)
 
 			rtcb = this_task();
 
+#ifndef CONFIG_TTRACE_KERNEL_EVENTS
 			trace_sched(NULL, rtcb);
+#endif
 
 #ifdef CONFIG_TASK_SCHED_HISTORY
 			/* Save the task name which will be scheduled */
@@ -166,7 +171,9 @@ void up_unblock_task(struct tcb_s *tcb)
 			 */
 
 			rtcb = this_task();
+#ifndef CONFIG_TTRACE_KERNEL_EVENTS
 			trace_sched(NULL, rtcb);
+#endif
 
 #ifdef CONFIG_TASK_SCHED_HISTORY
 			/* Save the task name which will be scheduled */
@@ -61,6 +61,7 @@
 #include <debug.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "up_internal.h"
@@ -154,6 +155,9 @@ void up_block_task(struct tcb_s *tcb, tstate_t task_state)
 	/* Now, perform the context switch if one is needed */
 
 	if (switch_needed) {
+		sched_cpuload_switch(rtcb, rtcb == tcb);
+		ttrace_sched_switch(rtcb, this_task());
+
 #ifdef CONFIG_ARMV8M_TRUSTZONE
 		if (tcb->tz_context) {
 			TZ_StoreContext_S(tcb->tz_context);
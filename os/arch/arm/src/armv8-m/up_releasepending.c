@@ -59,6 +59,7 @@
 #include <sched.h>
 #include <debug.h>
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "up_internal.h"
@@ -114,6 +115,9 @@ void up_release_pending(void)
 
 	/* sched_lock(); */
 	if (sched_mergepending()) {
+		sched_cpuload_switch(rtcb, false);
+		ttrace_sched_switch(rtcb, this_task());
+
 		/* The currently active task has changed!  We will need to switch
 		 * contexts.  First check if we are operating in interrupt context.
 		 */
@@ -61,6 +61,7 @@
 #include <sched.h>
 #include <debug.h>
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "up_internal.h"
@@ -168,6 +169,9 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				sched_mergepending();
 			}
 
+			sched_cpuload_switch(rtcb, false);
+			ttrace_sched_switch(rtcb, this_task());
+
 #ifdef CONFIG_ARMV8M_TRUSTZONE
 			if (rtcb->tz_context) {
 				TZ_StoreContext_S(rtcb->tz_context);
@@ -59,6 +59,7 @@
 #include <sched.h>
 #include <debug.h>
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "clock/clock.h"
@@ -134,6 +135,9 @@ void up_unblock_task(struct tcb_s *tcb)
 	 */
 
 	if (sched_addreadytorun(tcb)) {
+		sched_cpuload_switch(rtcb, false);
+		ttrace_sched_switch(rtcb, this_task());
+
 #ifdef CONFIG_ARMV8M_TRUSTZONE
 		if (rtcb->tz_context) {
 			TZ_StoreContext_S(rtcb->tz_context);
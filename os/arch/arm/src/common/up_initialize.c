@@ -223,6 +223,12 @@ void up_initialize(void)
 #endif
 #endif
 
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	/* Start the cycle counter, after the timer it may get its rate from */
+
+	up_perf_init();
+#endif
+
 	/* Initialize pipe */
 
 #if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
@@ -85,3 +85,23 @@ bool up_interrupt_context(void)
 {
 	return current_regs != NULL;
 }
+
+#ifdef CONFIG_SCHED_PROFILE
+/****************************************************************************
+ * Name: up_interrupted_regs
+ *
+ * Description: Return the PC and LR of the context interrupted by the
+ * interrupt being handled.
+ ****************************************************************************/
+
+bool up_interrupted_regs(FAR uint32_t *pc, FAR uint32_t *lr)
+{
+	if (current_regs == NULL) {
+		return false;
+	}
+
+	*pc = current_regs[REG_PC];
+	*lr = current_regs[REG_LR];
+	return true;
+}
+#endif
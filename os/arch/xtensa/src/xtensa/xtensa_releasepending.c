@@ -60,6 +60,7 @@
 #include <debug.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 #include <tinyara/sched.h>
 #include <arch/chip/core-isa.h>
 
@@ -91,6 +92,9 @@ void up_release_pending(void)
 	/* Merge the g_pendingtasks list into the ready-to-run task list */
 
 	if (sched_mergepending()) {
+		sched_cpuload_switch(rtcb, false);
+		ttrace_sched_switch(rtcb, this_task());
+
 		/* The currently active task has changed!  We will need to
 		 * switch contexts.
 		 */
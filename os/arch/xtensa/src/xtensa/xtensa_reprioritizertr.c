@@ -59,6 +59,7 @@
 #include <debug.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 #include <tinyara/sched.h>
 #include <arch/chip/core-isa.h>
 
@@ -142,6 +143,9 @@ void up_reprioritize_rtr(struct tcb_s *tcb, uint8_t priority)
 				sched_mergepending();
 			}
 
+			sched_cpuload_switch(rtcb, false);
+			ttrace_sched_switch(rtcb, this_task());
+
 			/* Are we in an interrupt handler? */
 
 			if (CURRENT_REGS) {
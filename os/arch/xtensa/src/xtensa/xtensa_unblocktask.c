@@ -60,6 +60,7 @@
 #include <debug.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/ttrace.h>
 #include <tinyara/sched.h>
 #include <arch/chip/core-isa.h>
 
@@ -103,6 +104,9 @@ void up_unblock_task(struct tcb_s *tcb)
 	 */
 
 	if (sched_addreadytorun(tcb)) {
+		sched_cpuload_switch(rtcb, false);
+		ttrace_sched_switch(rtcb, this_task());
+
 		/* The currently active task has changed! We need to do
 		 * a context switch to the new task.
 		 */
@@ -0,0 +1,262 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/net/sgloop.c
+ *
+ * Ethernet loopback device for measuring the transmit path. Frames sent on
+ * it are received again on the same device.  With CONFIG_NETDEV_TX_SG the
+ * frames are taken through linkoutput_sg() and completed later from the
+ * work queue, the way a DMA capable MAC would do it.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+#include <net/if.h>
+#include <netinet/in.h>
+
+#include <arch/irq.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/wqueue.h>
+#include <tinyara/net/if/ethernet.h>
+#include <tinyara/netmgr/netdev_mgr.h>
+
+#ifdef CONFIG_NET_SGLOOP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TX_SG
+#ifdef CONFIG_SCHED_LPWORK
+#define SGLOOP_WORK LPWORK
+#else
+#define SGLOOP_WORK HPWORK
+#endif
+#endif
+
+/* Ethernet header and padding on top of the MTU */
+
+#define SGLOOP_BUFSIZE (CONFIG_NET_ETH_MTU + 14 + 4)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct sgloop_s {
+	struct netdev *dev;
+#ifdef CONFIG_NETDEV_TX_SG
+	struct work_s work;					/* Completes queued frames */
+	struct netdev_txframe *head;		/* Frames waiting for completion */
+	struct netdev_txframe *tail;
+	uint8_t *rxbuf;						/* Frame gathered for loopback */
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int sgloop_init(struct netdev *dev);
+static int sgloop_deinit(struct netdev *dev);
+static int sgloop_enable(struct netdev *dev);
+static int sgloop_disable(struct netdev *dev);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ethernet_ops g_sgloop_ops = {
+	sgloop_init,				/* init */
+	sgloop_deinit,				/* deinit */
+	sgloop_enable,				/* enable */
+	sgloop_disable,				/* disable */
+};
+
+static struct sgloop_s g_sgloop;
+static uint8_t g_sgloop_hwaddr[IFHWADDRLEN] = {0x0e, 0x04, 0x96, 0x5a, 0x10, 0x0b};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int sgloop_init(struct netdev *dev)
+{
+	return 0;
+}
+
+static int sgloop_deinit(struct netdev *dev)
+{
+	return 0;
+}
+
+static int sgloop_enable(struct netdev *dev)
+{
+	return 0;
+}
+
+static int sgloop_disable(struct netdev *dev)
+{
+	return 0;
+}
+
+/****************************************************************************
+ * Name: sgloop_linkoutput
+ *
+ * Description:
+ *   Linearized transmission, the frame is received again right away.
+ *
+ ****************************************************************************/
+
+static int sgloop_linkoutput(struct netdev *dev, void *data, uint16_t len)
+{
+	netdev_input(dev, data, len);
+	return 0;
+}
+
+#ifdef CONFIG_NETDEV_TX_SG
+/****************************************************************************
+ * Name: sgloop_txdone_work
+ *
+ * Description:
+ *   Emulate the DMA completion of the queued frames: gather each frame
+ *   into the receive buffer, release it and receive it again.
+ *
+ ****************************************************************************/
+
+static void sgloop_txdone_work(FAR void *arg)
+{
+	struct sgloop_s *priv = (struct sgloop_s *)arg;
+	struct netdev_txframe *frame;
+	irqstate_t flags;
+	uint16_t offset;
+	uint8_t i;
+
+	for (;;) {
+		flags = irqsave();
+		frame = priv->head;
+		if (frame) {
+			priv->head = frame->flink;
+			if (!priv->head) {
+				priv->tail = NULL;
+			}
+		}
+		irqrestore(flags);
+
+		if (!frame) {
+			break;
+		}
+
+		offset = 0;
+		for (i = 0; i < frame->iovcnt && offset + frame->iov[i].len <= SGLOOP_BUFSIZE; i++) {
+			memcpy(&priv->rxbuf[offset], frame->iov[i].base, frame->iov[i].len);
+			offset += frame->iov[i].len;
+		}
+
+		netdev_tx_done(priv->dev, frame);
+		netdev_input(priv->dev, priv->rxbuf, offset);
+	}
+}
+
+/****************************************************************************
+ * Name: sgloop_linkoutput_sg
+ *
+ * Description:
+ *   Scatter-gather transmission, the frame is queued and completed from the
+ *   work queue.
+ *
+ ****************************************************************************/
+
+static int sgloop_linkoutput_sg(struct netdev *dev, struct netdev_txframe *frame)
+{
+	struct sgloop_s *priv = &g_sgloop;
+	irqstate_t flags;
+
+	frame->flink = NULL;
+
+	flags = irqsave();
+	if (priv->tail) {
+		priv->tail->flink = frame;
+	} else {
+		priv->head = frame;
+	}
+	priv->tail = frame;
+	irqrestore(flags);
+
+	if (work_available(&priv->work)) {
+		work_queue(SGLOOP_WORK, &priv->work, sgloop_txdone_work, priv, 0);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NETDEV_TX_SG */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sgloop_start
+ *
+ * Description:
+ *   Register the loopback device with the network manager.
+ *
+ ****************************************************************************/
+
+void sgloop_start(void)
+{
+	struct nic_io_ops nops = {sgloop_linkoutput, NULL};
+	struct netdev_config nconfig;
+
+	memset(&nconfig, 0, sizeof(nconfig));
+
+#ifdef CONFIG_NETDEV_TX_SG
+	g_sgloop.rxbuf = (uint8_t *)kmm_malloc(SGLOOP_BUFSIZE);
+	if (!g_sgloop.rxbuf) {
+		ndbg("alloc rxbuf fail\n");
+		return;
+	}
+	nops.linkoutput_sg = sgloop_linkoutput_sg;
+#endif
+
+	nconfig.ops = &nops;
+	nconfig.flag = NM_FLAG_ETHARP | NM_FLAG_ETHERNET | NM_FLAG_BROADCAST;
+	nconfig.mtu = CONFIG_NET_ETH_MTU;
+	nconfig.hwaddr_len = IFHWADDRLEN;
+	nconfig.is_default = 0;
+	nconfig.type = NM_ETHERNET;
+	nconfig.t_ops.eth = &g_sgloop_ops;
+	nconfig.priv = &g_sgloop;
+
+	g_sgloop.dev = netdev_register(&nconfig);
+	if (!g_sgloop.dev) {
+		ndbg("register netdev fail\n");
+		return;
+	}
+
+	netdev_set_hwaddr(g_sgloop.dev, g_sgloop_hwaddr, IFHWADDRLEN);
+}
+
+#endif /* CONFIG_NET_SGLOOP */
@@ -0,0 +1,360 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/net/vnetpair.c
+ *
+ * Pair of ethernet devices wired back-to-back in memory: a frame sent on
+ * one end is received on the other one.  The link emulates a one-way
+ * latency, a frame loss rate and an MTU so the network stack can be
+ * measured without radio hardware, see examples/performance/vnetpair.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+#include <net/if.h>
+#include <netinet/in.h>
+
+#include <arch/irq.h>
+#include <tinyara/clock.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/wqueue.h>
+#include <tinyara/net/if/ethernet.h>
+#include <tinyara/netmgr/netdev_mgr.h>
+
+#ifdef CONFIG_NET_VNETPAIR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+#define VNETPAIR_WORK LPWORK
+#else
+#define VNETPAIR_WORK HPWORK
+#endif
+
+/* Ethernet header on top of the MTU */
+
+#define VNETPAIR_BUFSIZE (CONFIG_NET_VNETPAIR_MTU + 14)
+
+/* Frames handed to the network stack in one netdev_input_batch() */
+
+#define VNETPAIR_BATCH 8
+
+#define VNETPAIR_LATENCY MSEC2TICK(CONFIG_NET_VNETPAIR_LATENCY)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct vnetpair_frame_s {
+	struct vnetpair_frame_s *flink;
+	clock_t due;						/* Tick when the peer receives it */
+	uint16_t len;
+	uint8_t data[VNETPAIR_BUFSIZE];
+};
+
+struct vnetpair_end_s {
+	struct netdev *dev;
+	struct vnetpair_end_s *peer;
+	struct work_s work;					/* Delivers frames sent to this end */
+	struct vnetpair_frame_s *free;		/* Free frames of this end */
+	struct vnetpair_frame_s *head;		/* Frames in flight to this end */
+	struct vnetpair_frame_s *tail;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int vnetpair_init(struct netdev *dev);
+static int vnetpair_deinit(struct netdev *dev);
+static int vnetpair_enable(struct netdev *dev);
+static int vnetpair_disable(struct netdev *dev);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ethernet_ops g_vnetpair_ops = {
+	vnetpair_init,				/* init */
+	vnetpair_deinit,			/* deinit */
+	vnetpair_enable,			/* enable */
+	vnetpair_disable,			/* disable */
+};
+
+static struct vnetpair_end_s g_vnetpair[2];
+static uint8_t g_vnetpair_hwaddr[2][IFHWADDRLEN] = {
+	{0x0e, 0x04, 0x96, 0x5a, 0x20, 0x00},
+	{0x0e, 0x04, 0x96, 0x5a, 0x20, 0x01},
+};
+
+#if CONFIG_NET_VNETPAIR_LOSS > 0
+static uint32_t g_vnetpair_seed = 0x2545f491;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int vnetpair_init(struct netdev *dev)
+{
+	return 0;
+}
+
+static int vnetpair_deinit(struct netdev *dev)
+{
+	return 0;
+}
+
+static int vnetpair_enable(struct netdev *dev)
+{
+	return 0;
+}
+
+static int vnetpair_disable(struct netdev *dev)
+{
+	return 0;
+}
+
+#if CONFIG_NET_VNETPAIR_LOSS > 0
+/****************************************************************************
+ * Name: vnetpair_lost
+ *
+ * Description:
+ *   Decide whether the link loses the next frame, CONFIG_NET_VNETPAIR_LOSS
+ *   out of 1000 frames are lost.
+ *
+ ****************************************************************************/
+
+static bool vnetpair_lost(void)
+{
+	uint32_t x = g_vnetpair_seed;
+
+	/* xorshift32, only called from the network stack thread */
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	g_vnetpair_seed = x;
+
+	return (x % 1000) < CONFIG_NET_VNETPAIR_LOSS;
+}
+#endif
+
+/****************************************************************************
+ * Name: vnetpair_rx_work
+ *
+ * Description:
+ *   Pass the frames in flight whose latency has elapsed to the network
+ *   stack, then wait for the next one.
+ *
+ ****************************************************************************/
+
+static void vnetpair_rx_work(FAR void *arg)
+{
+	struct vnetpair_end_s *priv = (struct vnetpair_end_s *)arg;
+	struct vnetpair_frame_s *frames[VNETPAIR_BATCH];
+	void *data[VNETPAIR_BATCH];
+	uint16_t len[VNETPAIR_BATCH];
+	struct vnetpair_frame_s *frame;
+	irqstate_t flags;
+	clock_t now;
+	int32_t delay;
+	uint16_t num;
+	uint16_t i;
+
+	for (;;) {
+		now = clock_systimer();
+		num = 0;
+
+		flags = irqsave();
+		while (num < VNETPAIR_BATCH && priv->head && (int32_t)(now - priv->head->due) >= 0) {
+			frame = priv->head;
+			priv->head = frame->flink;
+			if (!priv->head) {
+				priv->tail = NULL;
+			}
+			frames[num] = frame;
+			data[num] = frame->data;
+			len[num] = frame->len;
+			num++;
+		}
+		irqrestore(flags);
+
+		if (num == 0) {
+			break;
+		}
+
+		/* The network stack copies the frames, they can be reused then */
+
+		netdev_input_batch(priv->dev, data, len, num);
+
+		flags = irqsave();
+		for (i = 0; i < num; i++) {
+			frames[i]->flink = priv->free;
+			priv->free = frames[i];
+		}
+		irqrestore(flags);
+	}
+
+	/* Wait for the latency of the next frame in flight */
+
+	flags = irqsave();
+	frame = priv->head;
+	delay = frame ? (int32_t)(frame->due - clock_systimer()) : 0;
+	irqrestore(flags);
+
+	if (frame && work_available(&priv->work)) {
+		work_queue(VNETPAIR_WORK, &priv->work, vnetpair_rx_work, priv, delay > 0 ? delay : 0);
+	}
+}
+
+/****************************************************************************
+ * Name: vnetpair_linkoutput
+ *
+ * Description:
+ *   Put the frame in flight to the peer. Frames larger than the MTU, frames
+ *   lost by the link and frames exceeding CONFIG_NET_VNETPAIR_QLEN in flight
+ *   are dropped like a real link would do.
+ *
+ ****************************************************************************/
+
+static int vnetpair_linkoutput(struct netdev *dev, void *data, uint16_t len)
+{
+	struct vnetpair_end_s *peer = ((struct vnetpair_end_s *)dev->priv)->peer;
+	struct vnetpair_frame_s *frame;
+	irqstate_t flags;
+
+	if (len > VNETPAIR_BUFSIZE) {
+		ndbg("frame too long %u\n", len);
+		return 0;
+	}
+
+#if CONFIG_NET_VNETPAIR_LOSS > 0
+	if (vnetpair_lost()) {
+		return 0;
+	}
+#endif
+
+	flags = irqsave();
+	frame = peer->free;
+	if (frame) {
+		peer->free = frame->flink;
+	}
+	irqrestore(flags);
+
+	if (!frame) {
+		return 0;
+	}
+
+	memcpy(frame->data, data, len);
+	frame->len = len;
+	frame->due = clock_systimer() + VNETPAIR_LATENCY;
+	frame->flink = NULL;
+
+	flags = irqsave();
+	if (peer->tail) {
+		peer->tail->flink = frame;
+	} else {
+		peer->head = frame;
+	}
+	peer->tail = frame;
+	irqrestore(flags);
+
+	if (work_available(&peer->work)) {
+		work_queue(VNETPAIR_WORK, &peer->work, vnetpair_rx_work, peer, VNETPAIR_LATENCY);
+	}
+
+	return 0;
+}
+
+static struct netdev *vnetpair_register(struct vnetpair_end_s *priv, uint8_t *hwaddr)
+{
+	struct nic_io_ops nops = {vnetpair_linkoutput, NULL};
+	struct netdev_config nconfig;
+	struct vnetpair_frame_s *frames;
+	int i;
+
+	frames = (struct vnetpair_frame_s *)kmm_malloc(sizeof(struct vnetpair_frame_s) * CONFIG_NET_VNETPAIR_QLEN);
+	if (!frames) {
+		ndbg("alloc frames fail\n");
+		return NULL;
+	}
+
+	for (i = 0; i < CONFIG_NET_VNETPAIR_QLEN; i++) {
+		frames[i].flink = priv->free;
+		priv->free = &frames[i];
+	}
+
+	memset(&nconfig, 0, sizeof(nconfig));
+	nconfig.ops = &nops;
+	nconfig.flag = NM_FLAG_ETHARP | NM_FLAG_ETHERNET | NM_FLAG_BROADCAST;
+	nconfig.mtu = CONFIG_NET_VNETPAIR_MTU;
+	nconfig.hwaddr_len = IFHWADDRLEN;
+	nconfig.is_default = 0;
+	nconfig.type = NM_ETHERNET;
+	nconfig.t_ops.eth = &g_vnetpair_ops;
+	nconfig.priv = priv;
+
+	priv->dev = netdev_register(&nconfig);
+	if (!priv->dev) {
+		ndbg("register netdev fail\n");
+		kmm_free(frames);
+		priv->free = NULL;
+		return NULL;
+	}
+
+	netdev_set_hwaddr(priv->dev, hwaddr, IFHWADDRLEN);
+	return priv->dev;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnetpair_start
+ *
+ * Description:
+ *   Register both ends of the pair with the network manager.
+ *
+ ****************************************************************************/
+
+void vnetpair_start(void)
+{
+	g_vnetpair[0].peer = &g_vnetpair[1];
+	g_vnetpair[1].peer = &g_vnetpair[0];
+
+	if (!vnetpair_register(&g_vnetpair[0], g_vnetpair_hwaddr[0])) {
+		return;
+	}
+
+	vnetpair_register(&g_vnetpair[1], g_vnetpair_hwaddr[1]);
+}
+
+#endif /* CONFIG_NET_VNETPAIR */
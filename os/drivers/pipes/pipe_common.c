@@ -96,6 +96,12 @@
 #define pipe_dumpbuffer(m, a, n)
 #endif
 
+/* While pipe_splice_read() hands the buffer to its sink with d_bfsem
+ * released, the other readers wait as if the pipe was empty.
+ */
+
+#define pipe_readable(dev) ((dev)->d_wrndx != (dev)->d_rdndx && !PIPE_IS_SPLICING((dev)->d_flags))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -418,7 +424,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
 	/* If the pipe is empty, then wait for something to be written to it */
 
-	while (dev->d_wrndx == dev->d_rdndx) {
+	while (!pipe_readable(dev)) {
 		/* If O_NONBLOCK was set, then return EGAIN */
 
 		if (filep->f_oflags & O_NONBLOCK) {
@@ -428,7 +434,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
 		/* If there are no writers on the pipe, then return end of file */
 
-		if (dev->d_nwriters <= 0) {
+		if (dev->d_nwriters <= 0 && dev->d_wrndx == dev->d_rdndx) {
 			sem_post(&dev->d_bfsem);
 			return 0;
 		}
@@ -580,6 +586,257 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 	}
 }
 
+#ifdef CONFIG_FS_SPLICE
+/****************************************************************************
+ * Name: pipe_splice_read
+ *
+ * Description:
+ *   Hand the data buffered in a pipe to 'sink' without copying it to an
+ *   intermediate buffer first.  'sink' is called with contiguous spans of
+ *   the ring buffer (at most two per call) and returns how many bytes it
+ *   consumed.  Blocks like read() while the pipe is empty.
+ *
+ * Returned Value:
+ *   The number of bytes consumed, 0 on end of file, -ENOSYS if 'filep' is
+ *   not a pipe, or a negated errno value on any other failure.
+ *
+ ****************************************************************************/
+
+ssize_t pipe_splice_read(FAR struct file *filep, pipe_splice_t sink, FAR void *arg, size_t len)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct pipe_dev_s *dev;
+	ssize_t nread = 0;
+	ssize_t ret;
+	size_t span;
+	int rdndx;
+	int ndx;
+	int sval;
+
+	if (inode == NULL || inode->u.i_ops == NULL || inode->u.i_ops->read != pipecommon_read) {
+		return -ENOSYS;
+	}
+
+	if ((filep->f_oflags & O_RDOK) == 0) {
+		return -EACCES;
+	}
+
+	dev = inode->i_private;
+	DEBUGASSERT(dev);
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if (sem_wait(&dev->d_bfsem) < 0) {
+		return -EINTR;
+	}
+
+	/* If the pipe is empty, then wait for something to be written to it */
+
+	while (!pipe_readable(dev)) {
+		if (filep->f_oflags & O_NONBLOCK) {
+			sem_post(&dev->d_bfsem);
+			return -EAGAIN;
+		}
+
+		if (dev->d_nwriters <= 0 && dev->d_wrndx == dev->d_rdndx) {
+			sem_post(&dev->d_bfsem);
+			return 0;
+		}
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		ret = sem_wait(&dev->d_rdsem);
+		sched_unlock();
+
+		if (ret < 0 || sem_wait(&dev->d_bfsem) < 0) {
+			return -EINTR;
+		}
+	}
+
+	/* Pass the ring buffer to the sink, the data wraps at most once.  The
+	 * sink may write to another pipe, so d_bfsem is released while it runs
+	 * or two splices in opposite directions would deadlock.  Writers only
+	 * fill the free space and the other readers wait for the splice, so
+	 * the span stays in place meanwhile.
+	 */
+
+	dev->d_flags |= PIPE_FLAG_SPLICING;
+	while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx) {
+		rdndx = dev->d_rdndx;
+		if (dev->d_wrndx > rdndx) {
+			span = dev->d_wrndx - rdndx;
+		} else {
+			span = CONFIG_DEV_PIPE_SIZE - rdndx;
+		}
+
+		if (span > len - nread) {
+			span = len - nread;
+		}
+
+		sem_post(&dev->d_bfsem);
+		pipe_dumpbuffer("From PIPE:", &dev->d_buffer[rdndx], span);
+		ret = sink(arg, &dev->d_buffer[rdndx], span);
+		pipecommon_semtake(&dev->d_bfsem);
+
+		if (ret <= 0) {
+			if (nread == 0) {
+				nread = ret;
+			}
+			break;
+		}
+
+		ndx = rdndx + ret;
+		dev->d_rdndx = ndx >= CONFIG_DEV_PIPE_SIZE ? 0 : ndx;
+		nread += ret;
+
+		if ((size_t)ret < span) {
+			break;
+		}
+	}
+	dev->d_flags &= ~PIPE_FLAG_SPLICING;
+
+	/* Let the readers which waited for the splice check the pipe again */
+
+	while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
+		sem_post(&dev->d_rdsem);
+	}
+
+	if (nread > 0) {
+		/* Notify all waiting writers that bytes have been removed from the buffer */
+
+		while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0) {
+			sem_post(&dev->d_wrsem);
+		}
+
+		pipecommon_pollnotify(dev, POLLOUT);
+	}
+
+	sem_post(&dev->d_bfsem);
+	return nread;
+}
+
+/****************************************************************************
+ * Name: pipe_splice_write
+ *
+ * Description:
+ *   Let 'source' fill the free space of a pipe's ring buffer directly.
+ *   'source' is called with contiguous free spans (at most two per call) and
+ *   returns how many bytes it produced.  Blocks like write() while the pipe
+ *   is full, but returns as soon as some data has been stored.
+ *
+ * Returned Value:
+ *   The number of bytes stored, 0 if 'source' reached end of file, -ENOSYS
+ *   if 'filep' is not a pipe, or a negated errno value on any other failure.
+ *
+ ****************************************************************************/
+
+ssize_t pipe_splice_write(FAR struct file *filep, pipe_splice_t source, FAR void *arg, size_t len)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct pipe_dev_s *dev;
+	ssize_t nwritten = 0;
+	ssize_t ret;
+	size_t span;
+	int ndx;
+	int sval;
+
+	if (inode == NULL || inode->u.i_ops == NULL || inode->u.i_ops->write != pipecommon_write) {
+		return -ENOSYS;
+	}
+
+	if ((filep->f_oflags & O_WROK) == 0) {
+		return -EACCES;
+	}
+
+	dev = inode->i_private;
+	DEBUGASSERT(dev);
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if (sem_wait(&dev->d_bfsem) < 0) {
+		return -EINTR;
+	}
+
+	/* Wait until there is room for at least one byte */
+
+	for (;;) {
+		ndx = dev->d_wrndx + 1;
+		if (ndx >= CONFIG_DEV_PIPE_SIZE) {
+			ndx = 0;
+		}
+
+		if (ndx != dev->d_rdndx) {
+			break;
+		}
+
+		if (filep->f_oflags & O_NONBLOCK) {
+			sem_post(&dev->d_bfsem);
+			return -EAGAIN;
+		}
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		pipecommon_semtake(&dev->d_wrsem);
+		sched_unlock();
+		pipecommon_semtake(&dev->d_bfsem);
+	}
+
+	/* Let the source fill the free space.  One slot always stays unused so
+	 * that a full buffer can be told from an empty one.
+	 */
+
+	while ((size_t)nwritten < len) {
+		if (dev->d_rdndx > dev->d_wrndx) {
+			span = dev->d_rdndx - dev->d_wrndx - 1;
+		} else {
+			span = CONFIG_DEV_PIPE_SIZE - dev->d_wrndx - (dev->d_rdndx == 0 ? 1 : 0);
+		}
+
+		if (span == 0) {
+			break;
+		}
+
+		if (span > len - nwritten) {
+			span = len - nwritten;
+		}
+
+		ret = source(arg, &dev->d_buffer[dev->d_wrndx], span);
+		if (ret <= 0) {
+			if (nwritten == 0) {
+				nwritten = ret;
+			}
+			break;
+		}
+
+		pipe_dumpbuffer("To PIPE:", &dev->d_buffer[dev->d_wrndx], ret);
+		ndx = dev->d_wrndx + ret;
+		dev->d_wrndx = ndx >= CONFIG_DEV_PIPE_SIZE ? 0 : ndx;
+		nwritten += ret;
+
+		if ((size_t)ret < span) {
+			break;
+		}
+	}
+
+	if (nwritten > 0) {
+		/* Notify all waiting readers that more data is available */
+
+		while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
+			sem_post(&dev->d_rdsem);
+		}
+
+		pipecommon_pollnotify(dev, POLLIN);
+	}
+
+	sem_post(&dev->d_bfsem);
+	return nwritten;
+}
+#endif /* CONFIG_FS_SPLICE */
+
 /****************************************************************************
  * Name: pipecommon_poll
  ****************************************************************************/
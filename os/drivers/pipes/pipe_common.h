@@ -88,6 +88,7 @@
 
 #define PIPE_FLAG_POLICY    (1 << 0)	/* Bit 0: Policy=Free buffer when empty */
 #define PIPE_FLAG_UNLINKED  (1 << 1)	/* Bit 1: The driver has been unlinked */
+#define PIPE_FLAG_SPLICING  (1 << 2)	/* Bit 2: A splice reads the buffer unlocked */
 
 #define PIPE_POLICY_0(f)    do { (f) &= ~PIPE_FLAG_POLICY; } while (0)
 #define PIPE_POLICY_1(f)    do { (f) |= PIPE_FLAG_POLICY; } while (0)
@@ -97,6 +98,8 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+#define PIPE_IS_SPLICING(f) (((f) & PIPE_FLAG_SPLICING) != 0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -35,12 +35,6 @@
 #include "seclink_drv_req.h"
 #include "seclink_drv_utils.h"
 
-#define SL_IS_COMMON_REQ(cmd)  ((cmd & 0xf0) == 0)
-#define SL_IS_CRYPTO_REQ(cmd)  ((cmd & 0xf0) & (SECLINKIOC_CRYPTO & 0xf0))
-#define SL_IS_AUTH_REQ(cmd)    ((cmd & 0xf0) & (SECLINKIOC_AUTH & 0xf0))
-#define SL_IS_SS_REQ(cmd)      ((cmd & 0xf0) & (SECLINKIOC_SS & 0xf0))
-#define SL_IS_KEYMGR_REQ(cmd)  ((cmd & 0xf0) & (SECLINKIOC_KEYMGR & 0xf0))
-
 #define SL_LOCK(lock)										\
 	do {													\
 		int sl_res = sem_wait(lock);						\
@@ -137,7 +131,9 @@ int seclink_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	 */
 	SL_LOCK(&upper->su_lock);
 	int res = 0;
-	if (SL_IS_AUTH_REQ(cmd)) {
+	if (cmd == SECLINKIOC_BATCH) {
+		res = hd_handle_batch_request(cmd, arg, (void *)upper->lower);
+	} else if (SL_IS_AUTH_REQ(cmd)) {
 		res = hd_handle_auth_request(cmd, arg, (void *)upper->lower);
 	} else if (SL_IS_KEYMGR_REQ(cmd)) {
 		res = hd_handle_key_request(cmd, arg, (void *)upper->lower);
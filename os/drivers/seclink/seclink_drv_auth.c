@@ -90,6 +90,15 @@ int hd_handle_auth_request(int cmd, unsigned long arg, void *lower)
 	case SECLINKIOC_REMOVECERTIFICATE:
 		SLDRV_CALL(res, req->res, remove_certificate, (info->key_idx));
 		break;
+	case SECLINKIOC_HASHINIT:
+		SLDRV_CALL(res, req->res, hash_init, (info->auth_type.hash_type, info->key_idx));
+		break;
+	case SECLINKIOC_HASHUPDATE:
+		SLDRV_CALL(res, req->res, hash_update, (info->key_idx, info->data));
+		break;
+	case SECLINKIOC_HASHFINAL:
+		SLDRV_CALL(res, req->res, hash_final, (info->key_idx, info->auth_data.data));
+		break;
 	default:
 		SLDRV_LOG("Invalid command error\n");
 		res = -ENOSYS;
@@ -62,3 +62,45 @@ int hd_handle_common_request(int cmd, unsigned long arg, void *lower)
 
 	return res;
 }
+
+/*
+ * Run the requests of a batch in order, so a caller pays one call and one
+ * lock for all of them. Each request gets its own result, a failed one
+ * doesn't stop the next ones.
+ */
+int hd_handle_batch_request(int cmd, unsigned long arg, void *lower)
+{
+	SLDRV_ENTER;
+
+	struct seclink_req *req = (struct seclink_req *)arg;
+	if (!req) {
+		return -EINVAL;
+	}
+
+	struct seclink_batch_info *batch = req->req_type.batch;
+	if (!batch || !batch->entries) {
+		return -EINVAL;
+	}
+
+	uint32_t i;
+	for (i = 0; i < batch->count; i++) {
+		struct seclink_batch_entry *entry = &batch->entries[i];
+		unsigned long entry_arg = (unsigned long)entry->req;
+
+		if (SL_IS_COMMON_REQ(entry->cmd)) {
+			entry->ret = -EINVAL;
+		} else if (SL_IS_AUTH_REQ(entry->cmd)) {
+			entry->ret = hd_handle_auth_request(entry->cmd, entry_arg, lower);
+		} else if (SL_IS_KEYMGR_REQ(entry->cmd)) {
+			entry->ret = hd_handle_key_request(entry->cmd, entry_arg, lower);
+		} else if (SL_IS_SS_REQ(entry->cmd)) {
+			entry->ret = hd_handle_ss_request(entry->cmd, entry_arg, lower);
+		} else if (SL_IS_CRYPTO_REQ(entry->cmd)) {
+			entry->ret = hd_handle_crypto_request(entry->cmd, entry_arg, lower);
+		} else {
+			entry->ret = -EINVAL;
+		}
+	}
+
+	return 0;
+}
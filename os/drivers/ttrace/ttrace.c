@@ -41,6 +41,13 @@
 #include <tinyara/fs/fs.h>
 #include <tinyara/arch.h>
 #include <tinyara/ringbuf.h>
+#ifdef CONFIG_TTRACE_KERNEL_EVENTS
+#include <sys/time.h>
+#include <unistd.h>
+#include <tinyara/clock.h>
+#include <tinyara/sched.h>
+#include <tinyara/ttrace.h>
+#endif
 
 #include <arch/irq.h>
 
@@ -110,6 +117,18 @@ static struct ringbuf g_ringbuf = {
 static uint32_t g_state = TTRACE_STATE_IDLE;
 static uint32_t g_selected_tag = 0;
 
+#if defined(CONFIG_TTRACE_KERNEL_EVENTS) && defined(CONFIG_ARCH_HAVE_PERF_COUNTER)
+/* Kernel events are stamped from the perf counter, relative to an anchor
+ * in the time of day so they sort with the packets stamped by the users.
+ * The scale converts counts to usec in 32.32 fixed point, 0 if the counter
+ * is unusable.
+ */
+
+static uint64_t g_ts_scale;
+static uint64_t g_ts_usec;
+static uint32_t g_ts_count;
+#endif
+
 /* This is the device structure for the T-trace function. It
  * must be statically initialized because the T-trace ttrace_putc function
  * could be called before the driver initialization logic executes.
@@ -125,6 +144,95 @@ static struct ttrace_dev_s g_sysdev = {
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_TTRACE_KERNEL_EVENTS
+/****************************************************************************
+ * Name: ttrace_packet_len
+ *
+ * Description:
+ *   Return the size of a packet written by the users, the uid packets
+ *   have no message.
+ *
+ ****************************************************************************/
+
+static size_t ttrace_packet_len(FAR const struct trace_packet *packet)
+{
+	if (packet->codelen & TTRACE_CODE_UNIQUE) {
+		return sizeof(struct trace_packet) - TTRACE_MSG_BYTES;
+	}
+
+	return sizeof(struct trace_packet);
+}
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+/****************************************************************************
+ * Name: ttrace_time_init
+ *
+ * Description:
+ *   Anchor the perf counter to the time of day at the start of a trace.
+ *   Counters slower than 1 MHz give nothing below a usec and would
+ *   overflow the scaled delta, the tick based time is kept for them.
+ *
+ ****************************************************************************/
+
+static void ttrace_time_init(void)
+{
+	struct timeval tv;
+	irqstate_t flags;
+	uint32_t freq;
+
+	freq = up_perf_getfreq();
+
+	flags = irqsave();
+	gettimeofday(&tv, NULL);
+	g_ts_usec = (uint64_t)tv.tv_sec * USEC_PER_SEC + tv.tv_usec;
+	g_ts_count = up_perf_gettime();
+	g_ts_scale = freq >= USEC_PER_SEC ? ((uint64_t)USEC_PER_SEC << 32) / freq : 0;
+	irqrestore(flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: ttrace_gettime
+ *
+ * Description:
+ *   Stamp a kernel event. gettimeofday() only moves once per tick, so the
+ *   time elapsed on the perf counter since the anchor is used instead. The
+ *   anchor is moved to the tick time whenever the result leaves the tick
+ *   that gettimeofday() reports, which also covers a counter wrap or a
+ *   change of the time of day. Must be called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void ttrace_gettime(FAR struct timeval *tv)
+{
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	uint64_t tick_usec;
+	uint64_t usec;
+	uint32_t count;
+#endif
+
+	gettimeofday(tv, NULL);
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	if (g_ts_scale == 0) {
+		return;
+	}
+
+	count = up_perf_gettime();
+	tick_usec = (uint64_t)tv->tv_sec * USEC_PER_SEC + tv->tv_usec;
+	usec = g_ts_usec + (((uint64_t)(count - g_ts_count) * g_ts_scale) >> 32);
+	if (usec < tick_usec || usec >= tick_usec + USEC_PER_TICK) {
+		g_ts_usec = tick_usec;
+		g_ts_count = count;
+		usec = tick_usec;
+	}
+
+	tv->tv_sec = (time_t)(usec / USEC_PER_SEC);
+	tv->tv_usec = (long)(usec % USEC_PER_SEC);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: ttrace_read
  ****************************************************************************/
@@ -160,18 +268,42 @@ static ssize_t ttrace_write(FAR struct file *filep, FAR const char *buffer, size
 {
 	struct inode *inode = filep->f_inode;
 	struct ttrace_dev_s *priv = inode->i_private;
+#ifdef CONFIG_TTRACE_KERNEL_EVENTS
+	irqstate_t flags;
+	size_t chunk;
+	size_t pos;
+#endif
 
 	if (TTRACE_STATE_RUNNING != g_state) {
 		return TTRACE_INVALID;
 	}
 
 	DEBUGASSERT(priv);
-	sched_lock();
 
+#ifdef CONFIG_TTRACE_KERNEL_EVENTS
+	/* Kernel events are written from interrupt handlers too. A batch of
+	 * a user buffer is copied one packet at a time, so interrupts are only
+	 * held off for one packet and kernel events land between packets.
+	 */
+
+	for (pos = 0; pos < len; pos += chunk) {
+		chunk = len - pos;
+		if (chunk >= sizeof(struct trace_packet) - TTRACE_MSG_BYTES &&
+			chunk > ttrace_packet_len((FAR const struct trace_packet *)(buffer + pos))) {
+			chunk = ttrace_packet_len((FAR const struct trace_packet *)(buffer + pos));
+		}
+
+		flags = irqsave();
+		ringbuf_write(buffer + pos, chunk, &g_ringbuf);
+		priv->ttrace_head = g_ringbuf.index;
+		irqrestore(flags);
+	}
+#else
+	sched_lock();
 	ringbuf_write(buffer, len, &g_ringbuf);
 	priv->ttrace_head = g_ringbuf.index;
-
 	sched_unlock();
+#endif
 	return (ssize_t)len;
 }
 
@@ -190,6 +322,9 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 	switch (cmd) {
 	case TTRACE_START:
+#if defined(CONFIG_TTRACE_KERNEL_EVENTS) && defined(CONFIG_ARCH_HAVE_PERF_COUNTER)
+		ttrace_time_init();
+#endif
 		g_state = TTRACE_STATE_RUNNING;
 		priv->ttrace_head = 0;
 		break;
@@ -201,7 +336,7 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 		g_state = TTRACE_STATE_IDLE;
 		break;
 	case TTRACE_INFO:
-		ttdbg("Available tags: apps libs lock ipc task\r\n");
+		ttdbg("Available tags: apps libs lock ipc task irq\r\n");
 		ttdbg("State: %d\r\n", g_state);
 		ttdbg("Selected tags: %d\r\n", g_selected_tag);
 		ttdbg("Buffer index: %d\r\n", g_ringbuf.index);
@@ -240,10 +375,130 @@ static int ttrace_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	return ret;
 }
 
+#ifdef CONFIG_TTRACE_KERNEL_EVENTS
+static bool ttrace_is_traced(int tag)
+{
+	return g_state == TTRACE_STATE_RUNNING && (g_selected_tag & tag) != 0;
+}
+
+static void ttrace_put_packet(FAR struct trace_packet *packet, char type, size_t len)
+{
+	irqstate_t flags;
+
+	packet->pid = getpid();
+	packet->event_type = type;
+
+	flags = irqsave();
+	ttrace_gettime(&packet->ts);
+	ringbuf_write((FAR const char *)packet, len, &g_ringbuf);
+	g_sysdev.ttrace_head = g_ringbuf.index;
+	irqrestore(flags);
+}
+
+static void ttrace_put_sched(char type, FAR struct tcb_s *prev, FAR struct tcb_s *next)
+{
+	struct trace_packet packet;
+	FAR struct sched_message *msg = &packet.msg.sched_msg;
+
+	memset(msg, 0, sizeof(struct sched_message));
+#if CONFIG_TASK_NAME_SIZE > 0
+	strncpy(msg->prev_comm, prev->name, TTRACE_COMM_BYTES - 1);
+	strncpy(msg->next_comm, next->name, TTRACE_COMM_BYTES - 1);
+#endif
+	msg->prev_pid = prev->pid;
+	msg->prev_prio = prev->sched_priority;
+	msg->prev_state = prev->task_state;
+	msg->next_pid = next->pid;
+	msg->next_prio = next->sched_priority;
+	msg->pad = -1;
+
+	packet.codelen = TTRACE_CODE_VARIABLE | sizeof(struct sched_message);
+	ttrace_put_packet(&packet, type, sizeof(struct trace_packet));
+}
+
+static void ttrace_put_arg(char type, uint32_t arg)
+{
+	struct trace_packet packet;
+
+	packet.msg.arg = arg;
+	packet.codelen = TTRACE_CODE_VARIABLE | TTRACE_ARG_BYTES;
+	ttrace_put_packet(&packet, type, sizeof(struct trace_packet) - TTRACE_MSG_BYTES + TTRACE_ARG_BYTES);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_TTRACE_KERNEL_EVENTS
+/****************************************************************************
+ * Name: ttrace_sched_switch
+ *
+ * Description:
+ *   Record that next is about to replace prev as the running task.
+ *
+ ****************************************************************************/
+
+void ttrace_sched_switch(FAR struct tcb_s *prev, FAR struct tcb_s *next)
+{
+	if (ttrace_is_traced(TTRACE_TAG_TASK)) {
+		ttrace_put_sched(TTRACE_EVENT_TYPE_SCHED, prev, next);
+	}
+}
+
+/****************************************************************************
+ * Name: ttrace_sched_wakeup
+ *
+ * Description:
+ *   Record that the running task made the blocked task tcb ready to run.
+ *
+ ****************************************************************************/
+
+void ttrace_sched_wakeup(FAR struct tcb_s *tcb)
+{
+	if (ttrace_is_traced(TTRACE_TAG_TASK)) {
+		ttrace_put_sched(TTRACE_EVENT_TYPE_WAKEUP, sched_self(), tcb);
+	}
+}
+
+void ttrace_irq_enter(int irq)
+{
+	if (ttrace_is_traced(TTRACE_TAG_IRQ)) {
+		ttrace_put_arg(TTRACE_EVENT_TYPE_IRQ_ENTER, (uint32_t)irq);
+	}
+}
+
+void ttrace_irq_exit(int irq)
+{
+	if (ttrace_is_traced(TTRACE_TAG_IRQ)) {
+		ttrace_put_arg(TTRACE_EVENT_TYPE_IRQ_EXIT, (uint32_t)irq);
+	}
+}
+
+/****************************************************************************
+ * Name: ttrace_sem_block, ttrace_sem_post
+ *
+ * Description:
+ *   Record that the running task waits for sem, or posts sem to a waiter.
+ *
+ ****************************************************************************/
+
+void ttrace_sem_block(FAR sem_t *sem)
+{
+	if (ttrace_is_traced(TTRACE_TAG_LOCK)) {
+		ttrace_put_arg(TTRACE_EVENT_TYPE_SEM_BLOCK, (uint32_t)(uintptr_t)sem);
+	}
+}
+
+void ttrace_sem_post(FAR sem_t *sem)
+{
+	if (ttrace_is_traced(TTRACE_TAG_LOCK)) {
+		ttrace_put_arg(TTRACE_EVENT_TYPE_SEM_POST, (uint32_t)(uintptr_t)sem);
+	}
+}
+#endif
+
+
 /****************************************************************************
  * Name: ttrace_init
  *
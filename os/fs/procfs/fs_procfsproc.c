@@ -121,6 +121,9 @@ enum proc_node_e {
 	PROC_CMDLINE,				/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	PROC_LOADAVG,				/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+	PROC_SCHEDSTAT,				/* Run time and context switches */
 #endif
 	PROC_STACK,					/* Task stack info */
 	PROC_GROUP,					/* Group directory */
@@ -168,6 +171,9 @@ static ssize_t proc_entry_cmdline(FAR struct proc_file_s *procfile, FAR struct t
 #ifdef CONFIG_SCHED_CPULOAD
 static ssize_t proc_entry_loadavg(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 #endif
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+static ssize_t proc_entry_schedstat(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
+#endif
 static ssize_t proc_entry_stack(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 static ssize_t proc_entry_groupstatus(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
 static ssize_t proc_entry_groupfd(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset);
@@ -240,6 +246,12 @@ static const struct proc_node_s g_loadavg = {
 };
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+static const struct proc_node_s g_schedstat = {
+	"schedstat", "schedstat", (uint8_t)PROC_SCHEDSTAT, DTYPE_FILE	/* Run time and context switches */
+};
+#endif
+
 static const struct proc_node_s g_stack = {
 	"stack", "stack", (uint8_t)PROC_STACK, DTYPE_FILE	/* Task stack info */
 };
@@ -264,6 +276,9 @@ static FAR const struct proc_node_s *const g_nodeinfo[] = {
 	&g_cmdline,					/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	&g_loadavg,					/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+	&g_schedstat,				/* Run time and context switches */
 #endif
 	&g_stack,					/* Task stack info */
 	&g_group,					/* Group directory */
@@ -281,6 +296,9 @@ static const struct proc_node_s *const g_level0info[] = {
 	&g_cmdline,					/* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
 	&g_loadavg,					/* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+	&g_schedstat,				/* Run time and context switches */
 #endif
 	&g_stack,					/* Task stack info */
 	&g_group,					/* Group directory */
@@ -695,6 +713,70 @@ static ssize_t proc_entry_loadavg(FAR struct proc_file_s *procfile, FAR struct t
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_schedstat
+ ****************************************************************************/
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+static ssize_t proc_entry_schedstat(FAR struct proc_file_s *procfile, FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen, off_t offset)
+{
+	struct cpuload_runtime_s runtime;
+	size_t remaining;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+
+	/* clock_cpuload_runtime should only fail if the thread exited after the
+	 * procfs entry was opened.
+	 */
+
+	if (clock_cpuload_runtime(procfile->pid, &runtime) != OK) {
+		return 0;
+	}
+
+	remaining = buflen;
+	totalsize = 0;
+
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu.%06lu s\n", "RunTime:", (unsigned long)(runtime.runtime / 1000000), (unsigned long)(runtime.runtime % 1000000));
+	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+	totalsize += copysize;
+	buffer += copysize;
+	remaining -= copysize;
+
+	if (totalsize >= buflen) {
+		return totalsize;
+	}
+
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu.%06lu s\n", "IrqTime:", (unsigned long)(runtime.irqtime / 1000000), (unsigned long)(runtime.irqtime % 1000000));
+	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+	totalsize += copysize;
+	buffer += copysize;
+	remaining -= copysize;
+
+	if (totalsize >= buflen) {
+		return totalsize;
+	}
+
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%u\n", "Voluntary:", (unsigned int)runtime.nvcsw);
+	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+	totalsize += copysize;
+	buffer += copysize;
+	remaining -= copysize;
+
+	if (totalsize >= buflen) {
+		return totalsize;
+	}
+
+	linesize = snprintf(procfile->line, STATUS_LINELEN, "%-12s%u\n", "Preempted:", (unsigned int)runtime.nivcsw);
+	copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+	totalsize += copysize;
+	return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_stack
  ****************************************************************************/
@@ -1120,6 +1202,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 	case PROC_LOADAVG:			/* Average CPU utilization */
 		ret = proc_entry_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
 		break;
+#endif
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+	case PROC_SCHEDSTAT:		/* Run time and context switches */
+		ret = proc_entry_schedstat(procfile, tcb, buffer, buflen, filep->f_pos);
+		break;
 #endif
 	case PROC_STACK:			/* Task stack info */
 		ret = proc_entry_stack(procfile, tcb, buffer, buflen, filep->f_pos);
@@ -0,0 +1,369 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfsprofile.c
+ *
+ *   Copyright (C) 2014 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/statfs.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/sched.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_SCHED_PROFILE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PROFILE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#if CONFIG_TASK_NAME_SIZE > 0
+#define PROFILE_LINELEN (CONFIG_TASK_NAME_SIZE + 32)
+#else
+#define PROFILE_LINELEN 40
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The samples are taken from
+ * the kernel at open, so each open returns the samples taken since the
+ * previous one.
+ */
+
+struct profile_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	uint32_t lost;				/* Samples overwritten before this open */
+	int nsamples;				/* Number of valid samples in samples[] */
+	int index;					/* Next line to format, 0 is the header */
+	unsigned int linesize;		/* Number of valid characters in line[] */
+	unsigned int lineoff;		/* Number of characters of line[] returned */
+	char line[PROFILE_LINELEN];	/* Pre-allocated buffer for formatted lines */
+	struct profile_sample_s samples[CONFIG_SCHED_PROFILE_NSAMPLES];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int profile_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int profile_close(FAR struct file *filep);
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static int profile_dup(FAR const struct file *oldp, FAR struct file *newp);
+static int profile_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations profile_operations = {
+	profile_open,				/* open */
+	profile_close,				/* close */
+	profile_read,				/* read */
+	NULL,						/* write */
+
+	profile_dup,				/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	profile_stat				/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_format
+ *
+ * Description:
+ *   Format the line at attr->index, "pid name pc lr" for a sample.
+ *
+ ****************************************************************************/
+
+static void profile_format(FAR struct profile_file_s *attr)
+{
+	FAR struct profile_sample_s *sample;
+	FAR const char *name = "-";
+#if CONFIG_TASK_NAME_SIZE > 0
+	FAR struct tcb_s *tcb;
+#endif
+
+	if (attr->index == 0) {
+		attr->linesize = snprintf(attr->line, PROFILE_LINELEN, "# samples %d lost %u\n", attr->nsamples, (unsigned int)attr->lost);
+		return;
+	}
+
+	sample = &attr->samples[attr->index - 1];
+
+#if CONFIG_TASK_NAME_SIZE > 0
+	/* The task may have exited since it was sampled */
+
+	tcb = sched_gettcb(sample->pid);
+	if (tcb != NULL && tcb->name[0] != '\0') {
+		name = tcb->name;
+	}
+#endif
+
+	attr->linesize = snprintf(attr->line, PROFILE_LINELEN, "%d %s %08x %08x\n", sample->pid, name, (unsigned int)sample->pc, (unsigned int)sample->lr);
+	if (attr->linesize >= PROFILE_LINELEN) {
+		attr->linesize = PROFILE_LINELEN - 1;
+	}
+}
+
+/****************************************************************************
+ * Name: profile_open
+ ****************************************************************************/
+
+static int profile_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct profile_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* "profile" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "profile") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct profile_file_s *)kmm_zalloc(sizeof(struct profile_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	attr->nsamples = sched_get_profile(attr->samples, &attr->lost);
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: profile_close
+ ****************************************************************************/
+
+static int profile_close(FAR struct file *filep)
+{
+	FAR struct profile_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct profile_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: profile_read
+ *
+ * Description:
+ *   Return the header and then one line per sample.  The lines are
+ *   formatted one at a time, so reads are sequential.
+ *
+ ****************************************************************************/
+
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct profile_file_s *attr;
+	size_t copysize;
+	ssize_t nread = 0;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct profile_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	while (buflen > 0) {
+		if (attr->lineoff >= attr->linesize) {
+			if (attr->index > attr->nsamples) {
+				break;
+			}
+
+			profile_format(attr);
+			attr->index++;
+			attr->lineoff = 0;
+		}
+
+		copysize = attr->linesize - attr->lineoff;
+		if (copysize > buflen) {
+			copysize = buflen;
+		}
+
+		memcpy(buffer, &attr->line[attr->lineoff], copysize);
+		attr->lineoff += copysize;
+		buffer += copysize;
+		buflen -= copysize;
+		nread += copysize;
+	}
+
+	/* Update the file offset */
+
+	filep->f_pos += nread;
+	return nread;
+}
+
+/****************************************************************************
+ * Name: profile_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int profile_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct profile_file_s *oldattr;
+	FAR struct profile_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct profile_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct profile_file_s *)kmm_malloc(sizeof(struct profile_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct profile_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: profile_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int profile_stat(const char *relpath, struct stat *buf)
+{
+	/* "profile" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "profile") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "profile" is the name for a read-only file */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_SCHED_PROFILE && !CONFIG_FS_PROCFS_EXCLUDE_PROFILE */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -0,0 +1,52 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_sendfile.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <sys/types.h>
+#include <sys/sendfile.h>
+#include <fcntl.h>
+
+#ifdef CONFIG_FS_SPLICE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile
+ *
+ * Description:
+ *   Kernel replacement of the libc sendfile(), see include/sys/sendfile.h.
+ *   The data does not pass through a user buffer; see splice() for how it
+ *   is moved for each kind of descriptor.
+ *
+ ****************************************************************************/
+
+ssize_t sendfile(int outfd, int infd, FAR off_t *offset, size_t count)
+{
+	return splice(infd, offset, outfd, NULL, count, 0);
+}
+
+#endif /* CONFIG_FS_SPLICE */
@@ -0,0 +1,463 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+
+#include <stdbool.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/cancelpt.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+#ifdef CONFIG_NET
+#include <tinyara/net/net.h>
+#endif
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_SPLICE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+#define SPLICE_HAVE_PIPES
+#endif
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+#define SPLICE_HAVE_SOCKETS
+#endif
+
+#ifndef CONFIG_FS_SPLICE_BUFSIZE
+#define CONFIG_FS_SPLICE_BUFSIZE 512
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One end of a transfer */
+
+struct splice_end_s {
+	int fd;
+	FAR struct file *filep;		/* NULL if 'fd' is a socket descriptor */
+	FAR off_t *offset;			/* Explicit file position or NULL to use f_pos */
+	unsigned int flags;			/* SPLICE_F_* flags of the transfer */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_getend
+ ****************************************************************************/
+
+static int splice_getend(int fd, FAR off_t *offset, unsigned int flags, FAR struct splice_end_s *end)
+{
+	end->fd = fd;
+	end->filep = NULL;
+	end->offset = offset;
+	end->flags = flags;
+
+	if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS) {
+#ifdef SPLICE_HAVE_SOCKETS
+		/* Sockets have no position */
+
+		return offset ? -ESPIPE : OK;
+#else
+		return -EBADF;
+#endif
+	}
+
+	return fs_getfilep(fd, &end->filep);
+}
+
+/****************************************************************************
+ * Name: splice_read
+ *
+ * Description:
+ *   Read up to 'len' bytes from one end.  Returns the number of bytes read,
+ *   0 on end of file or a negated errno value.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_read(FAR struct splice_end_s *end, FAR void *buf, size_t len)
+{
+	ssize_t ret;
+
+#ifdef SPLICE_HAVE_SOCKETS
+	if (end->filep == NULL) {
+		ret = recv(end->fd, buf, len, (end->flags & SPLICE_F_NONBLOCK) ? MSG_DONTWAIT : 0);
+		return ret < 0 ? -get_errno() : ret;
+	}
+#endif
+
+	if (end->offset) {
+		ret = file_pread(end->filep, buf, len, *end->offset);
+		if (ret < 0) {
+			return -get_errno();
+		}
+
+		*end->offset += ret;
+		return ret;
+	}
+
+	return file_read(end->filep, buf, len);
+}
+
+/****************************************************************************
+ * Name: splice_write
+ *
+ * Description:
+ *   Write 'len' bytes to one end, retrying partial writes.  Returns the
+ *   number of bytes written, which is less than 'len' only if an error
+ *   occurred after some data was written, or a negated errno value.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_write(FAR struct splice_end_s *end, FAR const uint8_t *buf, size_t len)
+{
+	size_t nwritten = 0;
+	ssize_t ret;
+
+	while (nwritten < len) {
+#ifdef SPLICE_HAVE_SOCKETS
+		if (end->filep == NULL) {
+			int flags = 0;
+
+			if (end->flags & SPLICE_F_NONBLOCK) {
+				flags |= MSG_DONTWAIT;
+			}
+
+			if (end->flags & SPLICE_F_MORE) {
+				flags |= MSG_MORE;
+			}
+
+			ret = send(end->fd, buf + nwritten, len - nwritten, flags);
+			if (ret < 0) {
+				ret = -get_errno();
+			}
+		} else
+#endif
+		if (end->offset) {
+			ret = file_pwrite(end->filep, buf + nwritten, len - nwritten, *end->offset);
+			if (ret > 0) {
+				*end->offset += ret;
+			}
+		} else {
+			ret = file_write(end->filep, buf + nwritten, len - nwritten);
+		}
+
+		if (ret <= 0) {
+			if (nwritten > 0) {
+				break;
+			}
+			return ret == 0 ? -EIO : ret;
+		}
+
+		nwritten += ret;
+	}
+
+	return nwritten;
+}
+
+#ifdef SPLICE_HAVE_PIPES
+/****************************************************************************
+ * Name: splice_pipe_sink / splice_pipe_source
+ *
+ * Description:
+ *   pipe_splice_t callbacks, the pipe's ring buffer is written to or read
+ *   from the other end directly.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_pipe_sink(FAR void *arg, FAR uint8_t *buf, size_t len)
+{
+	return splice_write((FAR struct splice_end_s *)arg, buf, len);
+}
+
+static ssize_t splice_pipe_source(FAR void *arg, FAR uint8_t *buf, size_t len)
+{
+	return splice_read((FAR struct splice_end_s *)arg, buf, len);
+}
+#endif
+
+/****************************************************************************
+ * Name: splice_map
+ *
+ * Description:
+ *   Return the address of the file's data if the file system lets it be
+ *   read in place (FIOC_MMAP), or NULL.  'persistent' is set if the data
+ *   lives on read-only XIP media (ROMFS) and so can be referenced after
+ *   the call returns, e.g. by queued TCP segments.
+ *
+ ****************************************************************************/
+
+static FAR const uint8_t *splice_map(FAR struct splice_end_s *end, FAR off_t *size, FAR bool *persistent)
+{
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+	FAR struct inode *inode = end->filep->f_inode;
+	FAR void *addr = NULL;
+	struct statfs sfs;
+	struct stat st;
+
+	if (inode == NULL || !INODE_IS_MOUNTPT(inode) || inode->u.i_mops == NULL || inode->u.i_mops->fstat == NULL) {
+		return NULL;
+	}
+
+	if (file_ioctl(end->filep, FIOC_MMAP, (unsigned long)((uintptr_t)&addr)) < 0 || addr == NULL) {
+		return NULL;
+	}
+
+	if (inode->u.i_mops->fstat(end->filep, &st) < 0) {
+		return NULL;
+	}
+
+	*size = st.st_size;
+	*persistent = inode->u.i_mops->statfs != NULL && inode->u.i_mops->statfs(inode, &sfs) == OK && sfs.f_type == ROMFS_MAGIC;
+	return (FAR const uint8_t *)addr;
+#else
+	return NULL;
+#endif
+}
+
+/****************************************************************************
+ * Name: splice_mapped
+ *
+ * Description:
+ *   Transfer from a file which can be read in place.  No intermediate copy
+ *   is made; sockets reference ROMFS data instead of copying it.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_mapped(FAR struct splice_end_s *in, FAR const uint8_t *addr, off_t size, bool persistent, FAR struct splice_end_s *out, size_t len)
+{
+	off_t pos = in->offset ? *in->offset : in->filep->f_pos;
+	ssize_t ret;
+
+	if (pos >= size) {
+		return 0;
+	}
+
+	if (len > size - pos) {
+		len = size - pos;
+	}
+
+#ifdef SPLICE_HAVE_SOCKETS
+	if (out->filep == NULL && persistent) {
+		size_t nsent = 0;
+
+		while (nsent < len) {
+			ret = net_sendref(out->fd, addr + pos + nsent, len - nsent, (out->flags & SPLICE_F_NONBLOCK) ? MSG_DONTWAIT : 0);
+			if (ret <= 0) {
+				if (nsent == 0) {
+					return ret < 0 ? -get_errno() : -EIO;
+				}
+				break;
+			}
+			nsent += ret;
+		}
+		ret = nsent;
+	} else
+#endif
+	{
+		ret = splice_write(out, addr + pos, len);
+	}
+
+	if (ret > 0) {
+		if (in->offset) {
+			*in->offset += ret;
+		} else {
+			in->filep->f_pos += ret;
+		}
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   Move up to 'len' bytes from 'fd_in' to 'fd_out' inside the kernel.
+ *   Either end may be a file, a pipe or a socket.  Depending on the ends,
+ *   the data goes:
+ *
+ *   - From a file readable in place (ROMFS XIP, tmpfs) straight to the
+ *     other end.  Sockets reference ROMFS data instead of copying it.
+ *   - From a pipe's ring buffer straight to the other end.
+ *   - From a file straight into a pipe's ring buffer.
+ *   - Otherwise through a CONFIG_FS_SPLICE_BUFSIZE kernel buffer.
+ *
+ * Input Parameters:
+ *   fd_in   - Descriptor to read from
+ *   off_in  - Position to read from, updated on return.  The file position
+ *             of 'fd_in' is not changed.  If NULL, the file position is
+ *             used and updated.  Must be NULL for pipes and sockets.
+ *   fd_out  - Descriptor to write to
+ *   off_out - Position to write at, same rules as 'off_in'
+ *   len     - Number of bytes to move
+ *   flags   - SPLICE_F_NONBLOCK: do not block on socket ends
+ *             SPLICE_F_MORE: more data follows, passed as MSG_MORE
+ *             SPLICE_F_MOVE: ignored
+ *
+ * Returned Value:
+ *   The number of bytes moved, which is less than 'len' only on end of
+ *   file or error.  0 on end of file, or -1 with errno set on failure.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out, size_t len, unsigned int flags)
+{
+	struct splice_end_s in;
+	struct splice_end_s out;
+	FAR const uint8_t *addr;
+	FAR uint8_t *iobuffer = NULL;
+	size_t ntransferred = 0;
+	ssize_t ret;
+	bool stream = false;
+	bool persistent = false;
+	off_t size;
+
+	/* splice() is a cancellation point */
+
+	(void)enter_cancellation_point();
+
+	ret = splice_getend(fd_in, off_in, flags, &in);
+	if (ret == OK) {
+		ret = splice_getend(fd_out, off_out, flags, &out);
+	}
+
+	if (ret < 0) {
+		goto errout;
+	}
+
+	if (in.filep != NULL && out.filep != NULL && in.filep->f_inode != NULL && in.filep->f_inode == out.filep->f_inode) {
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	/* Files which can be read in place need no buffer at all */
+
+	if (in.filep != NULL && (addr = splice_map(&in, &size, &persistent)) != NULL) {
+		ret = splice_mapped(&in, addr, size, persistent, &out, len);
+		if (ret < 0) {
+			goto errout;
+		}
+
+		leave_cancellation_point();
+		return ret;
+	}
+
+	while (ntransferred < len) {
+		ret = -ENOSYS;
+
+#ifdef SPLICE_HAVE_PIPES
+		/* Out of a pipe, or from a file into a pipe.  Socket sources are not
+		 * spliced into pipes: the pipe stays locked while the source runs,
+		 * which could block the pipe's readers for as long as recv() waits.
+		 */
+
+		if (in.filep != NULL) {
+			ret = pipe_splice_read(in.filep, splice_pipe_sink, &out, len - ntransferred);
+			stream = ret != -ENOSYS;
+			if (ret == -ENOSYS && out.filep != NULL) {
+				ret = pipe_splice_write(out.filep, splice_pipe_source, &in, len - ntransferred);
+			}
+		}
+#endif
+
+		if (ret == -ENOSYS) {
+			size_t nread = len - ntransferred;
+
+			if (iobuffer == NULL) {
+				iobuffer = (FAR uint8_t *)kmm_malloc(CONFIG_FS_SPLICE_BUFSIZE);
+				if (iobuffer == NULL) {
+					ret = -ENOMEM;
+					break;
+				}
+			}
+
+			if (nread > CONFIG_FS_SPLICE_BUFSIZE) {
+				nread = CONFIG_FS_SPLICE_BUFSIZE;
+			}
+
+			ret = splice_read(&in, iobuffer, nread);
+			if (ret > 0) {
+				nread = ret;
+				ret = splice_write(&out, iobuffer, nread);
+				if (ret > 0 && (size_t)ret < nread) {
+					/* The rest of the buffer is lost, stop here */
+
+					ntransferred += ret;
+					break;
+				}
+			}
+		}
+
+		if (ret <= 0) {
+			break;
+		}
+
+		ntransferred += ret;
+
+		/* Like read(), return what a pipe or socket had instead of waiting
+		 * until 'len' bytes have arrived.
+		 */
+
+		if (stream || in.filep == NULL) {
+			break;
+		}
+	}
+
+	if (iobuffer != NULL) {
+		kmm_free(iobuffer);
+	}
+
+	if (ntransferred > 0 || ret >= 0) {
+		leave_cancellation_point();
+		return ntransferred;
+	}
+
+errout:
+	leave_cancellation_point();
+	set_errno(-ret);
+	return ERROR;
+}
+
+#endif /* CONFIG_FS_SPLICE */
@@ -155,6 +155,12 @@
 #define DN_RENAME   4			/* A file was renamed */
 #define DN_ATTRIB   5			/* Attributes of a file were changed */
 
+/* splice() flags (linux) */
+
+#define SPLICE_F_MOVE     (1 << 0)	/* Hint only, ignored */
+#define SPLICE_F_NONBLOCK (1 << 1)	/* Do not block on socket ends */
+#define SPLICE_F_MORE     (1 << 2)	/* More data follows, MSG_MORE on sockets */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -211,6 +217,17 @@ int open(const char *path, int oflag, ...);
  * @since TizenRT v1.0
  */
 int fcntl(int fd, int cmd, ...);
+#ifdef CONFIG_FS_SPLICE
+/**
+ * @ingroup FCNTL_KERNEL
+ * @brief move data between two descriptors without a user buffer
+ * @details @b #include <fcntl.h> \n
+ * SYSTEM CALL API \n
+ * Linux-like API. Either end may be a file, a pipe or a socket.
+ * @since TizenRT v3.1 PRE
+ */
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out, size_t len, unsigned int flags);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -97,6 +97,10 @@ extern "C" {
  *   nothing in TinyAra but provide some Linux compatible (and adding
  *   another 'almost standard' interface).
  *
+ *   If CONFIG_FS_SPLICE is selected, sendfile() is provided by the kernel
+ *   instead and the data does not pass through a user buffer (see
+ *   splice() in fcntl.h).
+ *
  *   NOTE: This interface is *not* specified in POSIX.1-2001, or other
  *   standards.  The implementation here is very similar to the Linux
  *   sendfile interface.  Other UNIX systems implement sendfile() with
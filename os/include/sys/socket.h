@@ -152,6 +152,14 @@ struct msghdr {
 	int msg_flags;                 /* flags on received message */
 };
 
+#ifdef CONFIG_NET_RECVREF
+struct recvref {
+	FAR void *data;                /* received bytes, valid until recvref_release() */
+	size_t len;                    /* number of bytes at data */
+	FAR void *priv;                /* buffer owned by the network stack */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -288,6 +296,40 @@ ssize_t recv(int sockfd, FAR void *buf, size_t len, int flags);
 */
 ssize_t recvfrom(int sockfd, FAR void *buf, size_t len, int flags, FAR struct sockaddr *from, FAR socklen_t *fromlen);
 
+#ifdef CONFIG_NET_RECVREF
+/**
+* @brief   receive a message from a socket without copying it
+*
+* @details @b #include <sys/socket.h>\n
+* Like recvfrom(), but ref->data points into the network stack's receive
+* buffer instead of a copy. The buffer must be handed back with
+* recvref_release() once the data has been consumed.
+* A stream socket returns at most one contiguous buffer per call, so it can
+* return less than what is available; the remaining data is returned by the
+* next call.
+* @param[in] sockfd the file descriptor associated with the socket.
+* @param[out] ref  filled in with the received data and its buffer
+* @param[in] len the maximum number of bytes to receive
+* @param[in] flags the type of message reception
+* @param[inout] from  A null pointer, or pointer to  sockaddr structure in which the sending address is to be stored
+* @param[inout] fromlen  null or the length of the sockaddr structure
+* @return On success, returns the length of the message in bytes, On failure, -1 is returned.
+* @since TizenRT v2.1
+*/
+ssize_t recvref(int sockfd, FAR struct recvref *ref, size_t len, int flags, FAR struct sockaddr *from, FAR socklen_t *fromlen);
+
+/**
+* @brief   release a buffer returned by recvref()
+*
+* @details @b #include <sys/socket.h>\n
+* @param[in] sockfd the socket the buffer was received on, it may be closed already
+* @param[in] ref  the buffer filled in by recvref()
+* @return none
+* @since TizenRT v2.1
+*/
+void recvref_release(int sockfd, FAR struct recvref *ref);
+#endif
+
 /**
 * @brief   shut down socket send and receive operations
 *
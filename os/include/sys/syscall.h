@@ -353,9 +353,17 @@
 #define SYS_umount                     (__SYS_mountpoint + 5)
 #define SYS_unlink                     (__SYS_mountpoint + 6)
 #define SYS_ftruncate                  (__SYS_mountpoint + 7)
-#define __SYS_shm                      (__SYS_mountpoint + 8)
+#define __SYS_splice                   (__SYS_mountpoint + 8)
 #else
-#define __SYS_shm                      __SYS_mountpoint
+#define __SYS_splice                   __SYS_mountpoint
+#endif
+
+#if defined(CONFIG_FS_SPLICE)
+#define SYS_sendfile                   (__SYS_splice + 0)
+#define SYS_splice                     (__SYS_splice + 1)
+#define __SYS_shm                      (__SYS_splice + 2)
+#else
+#define __SYS_shm                      __SYS_splice
 #endif
 
 #else
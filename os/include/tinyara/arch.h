@@ -1359,6 +1359,19 @@ int up_shmdt(uintptr_t vaddr, unsigned int npages);
 
 bool up_interrupt_context(void);
 
+/****************************************************************************
+ * Name: up_interrupted_regs
+ *
+ * Description:
+ *   Return the PC and LR of the context interrupted by the interrupt being
+ *   handled.  False is returned outside of an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PROFILE
+bool up_interrupted_regs(FAR uint32_t *pc, FAR uint32_t *lr);
+#endif
+
 /****************************************************************************
  * Name: up_enable_irq
  *
@@ -1400,6 +1413,20 @@ void up_enable_irq(int irq);
 void up_disable_irq(int irq);
 #endif
 
+/****************************************************************************
+ * Name: up_trigger_irq
+ *
+ * Description:
+ *   Trigger the interrupt specified by 'irq' in software, as if its device
+ *   had raised it.  Provided by architectures that select
+ *   ARCH_HAVE_IRQTRIGGER.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_IRQTRIGGER
+void up_trigger_irq(int irq);
+#endif
+
 /****************************************************************************
  * Name: up_prioritize_irq
  *
@@ -1655,6 +1682,30 @@ int up_timer_cancel(FAR struct timespec *ts);
 int up_timer_start(FAR const struct timespec *ts);
 #endif
 
+/****************************************************************************
+ * Name: up_perf_init, up_perf_gettime and up_perf_getfreq
+ *
+ * Description:
+ *   Free-running cycle counter for fine grained time accounting.
+ *   up_perf_init() starts the counter, it is called by up_initialize()
+ *   after the system timer.  up_perf_gettime() returns the counter, which
+ *   wraps around at 32 bits, and up_perf_getfreq() its rate in Hz, or
+ *   zero if the rate is not known.
+ *
+ *   Provided by architecture-specific code that selects
+ *   ARCH_HAVE_PERF_COUNTER, the users fall back to clock_systimer().
+ *
+ * Assumptions:
+ *   up_perf_gettime() may be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+void up_perf_init(void);
+uint32_t up_perf_gettime(void);
+uint32_t up_perf_getfreq(void);
+#endif
+
 /****************************************************************************
  * Name: up_romgetc
  *
@@ -1817,6 +1868,28 @@ void sched_alarm_expiration(FAR const struct timespec *ts);
 void weak_function sched_process_cpuload(void);
 #endif
 
+/************************************************************************
+ * Name: sched_process_profile
+ *
+ * Description:
+ *   Sample the interrupted code and the running task for the profiler.
+ *
+ * Inputs:
+ *   None
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions/Limitations:
+ *   This function is called from a timer interrupt handler with all
+ *   interrupts disabled.
+ *
+ ************************************************************************/
+
+#if defined(CONFIG_SCHED_PROFILE) && defined(CONFIG_SCHED_PROFILE_EXTCLK)
+void weak_function sched_process_profile(void);
+#endif
+
 /****************************************************************************
  * Name: irq_dispatch
  *
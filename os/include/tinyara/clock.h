@@ -211,6 +211,17 @@ struct cpuload_s {
 #endif
 #endif
 
+/* This structure is used to report the run time of a particular thread */
+
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+struct cpuload_runtime_s {
+	uint64_t runtime;			/* Microseconds run, interrupts excluded */
+	uint64_t irqtime;			/* Microseconds in interrupts while running */
+	uint32_t nvcsw;				/* Number of voluntary context switches */
+	uint32_t nivcsw;			/* Number of involuntary context switches */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -370,6 +381,34 @@ int clock_cpuload(int pid, int index, FAR struct cpuload_s *cpuload);
  */
 #endif
 
+/****************************************************************************
+ * Function:  clock_cpuload_runtime
+ *
+ * Description:
+ *   Return the run time, the interrupt time and the context switch counts
+ *   of the select PID, accounted at context switches.
+ *
+ * Parameters:
+ *   pid - The task ID of the thread of interest.  pid == 0 is the IDLE thread.
+ *   runtime - The location to return the run time
+ *
+ * Return Value:
+ *   OK (0) on success; -ESRCH if 'pid' no longer refers to a valid thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+/**
+ * @cond
+ * @internal
+ */
+int clock_cpuload_runtime(int pid, FAR struct cpuload_runtime_s *runtime);
+uint64_t clock_cpuload_irqtime(void);
+/**
+ * @endcond
+ */
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
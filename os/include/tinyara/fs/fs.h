@@ -1164,6 +1164,29 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 
 void pipe_initialize(void);
 
+/* drivers/pipes/pipe_common.c **********************************************/
+/****************************************************************************
+ * Name: pipe_splice_read / pipe_splice_write
+ *
+ * Description:
+ *   Used by splice() and sendfile() to move data in or out of a pipe
+ *   without an intermediate buffer.  The callback is given a contiguous
+ *   span of the pipe's ring buffer and returns the number of bytes it
+ *   consumed (read) or produced (write), or a negated errno value.
+ *
+ * Returned Value:
+ *   The number of bytes transferred, 0 on end of file, -ENOSYS if 'filep'
+ *   is not a pipe, or a negated errno value on any other failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_SPLICE) && defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+typedef CODE ssize_t (*pipe_splice_t)(FAR void *arg, FAR uint8_t *buf, size_t len);
+
+ssize_t pipe_splice_read(FAR struct file *filep, pipe_splice_t sink, FAR void *arg, size_t len);
+ssize_t pipe_splice_write(FAR struct file *filep, pipe_splice_t source, FAR void *arg, size_t len);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -368,6 +368,12 @@ struct mm_heap_s {
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	size_t peak_alloc_size;
 	size_t total_alloc_size;
+	/* Number of reallocs resized without moving the contents, grown into
+	 * the preceding free chunk with memmove, and done with malloc+copy+free
+	 */
+	uint32_t realloc_inplace;
+	uint32_t realloc_moved;
+	uint32_t realloc_copied;
 #ifdef CONFIG_HEAPINFO_USER_GROUP
 	int max_group;
 	struct heapinfo_group_s group[HEAPINFO_USER_GROUP_NUM];
@@ -355,6 +355,24 @@ int net_close(int sockfd);
  ****************************************************************************/
 int net_poll(int sd, struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Function: net_sendref
+ *
+ * Description:
+ *   Like send(), but the network stack may keep a reference to 'data'
+ *   instead of copying it into its own buffers.  Only for data which stays
+ *   valid and unchanged for the life of the system, e.g. files on XIP
+ *   flash.  Used by sendfile() and splice().  Falls back to send() if the
+ *   stack has no reference path.
+ *
+ * Returned Value:
+ *   The number of bytes sent; -1 on error with errno set appropriately.
+ *
+ ****************************************************************************/
+#ifdef CONFIG_FS_SPLICE
+ssize_t net_sendref(int sd, FAR const void *data, size_t size, int flags);
+#endif
+
 /****************************************************************************
  * Function: net_dupsd
  *
@@ -67,6 +67,26 @@ struct netdev {
 	void *priv;
 };
 
+#ifdef CONFIG_NETDEV_TX_SG
+/* One fragment of a frame to transmit */
+struct netdev_iovec {
+	void *base;
+	uint16_t len;
+};
+
+/*
+ * A frame passed to linkoutput_sg. The fragments belong to the network
+ * stack and stay valid until the driver calls netdev_tx_done().
+ */
+struct netdev_txframe {
+	struct netdev_txframe *flink; /* free for the driver to queue frames */
+	uint16_t len;                 /* total length of the frame */
+	uint8_t iovcnt;               /* number of fragments in iov */
+	struct netdev_iovec iov[CONFIG_NETDEV_TX_SG_IOVMAX];
+	void *priv;                   /* network stack private */
+};
+#endif
+
 struct nic_io_ops {
 	/* DESC:
 	 * it is called when network stack has data to pass to wi-fi driver
@@ -81,6 +101,20 @@ struct nic_io_ops {
 	 */
 	int (*linkoutput)(struct netdev *dev, void *data, uint16_t len);
 	int (*igmp_mac_filter)(struct netdev *netif, const struct in_addr *group, netdev_mac_filter_action action);
+#ifdef CONFIG_NETDEV_TX_SG
+	/* DESC:
+	 * optional, it is called instead of linkoutput when network stack has data to pass.
+	 * the frame is described by a list of fragments so the driver can program its DMA
+	 * with them directly, the network stack doesn't copy the frame into tx_buf.
+	 * PARAMETER
+	 * dev: network device which sends data.
+	 * frame: frame to send, the driver owns it until it calls netdev_tx_done().
+	 * RETURN
+	 * On success: return 0, netdev_tx_done() must be called later.
+	 * On error: return -1, netdev_tx_done() must not be called.
+	 */
+	int (*linkoutput_sg)(struct netdev *dev, struct netdev_txframe *frame);
+#endif
 };
 
 struct netdev_config {
@@ -126,6 +160,35 @@ struct netdev *netdev_register(struct netdev_config *config);
  * On error: return -1;
  */
 int netdev_input(struct netdev *dev, void *data, uint16_t len);
+/*
+ * DESC:
+ * Pass several incoming frames to network stack at once. The frames are
+ * handed to the network stack thread in one message instead of one per
+ * frame, so a driver should use it when it receives a burst of frames.
+ * The frames are always consumed, frames which can't be delivered are dropped.
+ * PARAMETER
+ * dev: network device which send data to network stack
+ * data: array of num frames, if NET_NETMGR_ZEROCOPY is enabled then they're pbufs.
+ * len: array of num frame lengths, if NET_NETMGR_ZEROCOPY is enabled then it's ignored.
+ * num: number of frames
+ * RETURN
+ * On success: return the number of frames delivered to network stack
+ * On error: return -1, the frames are not consumed.
+ */
+int netdev_input_batch(struct netdev *dev, void **data, uint16_t *len, uint16_t num);
+#ifdef CONFIG_NETDEV_TX_SG
+/*
+ * DESC:
+ * NIC driver should call following function when the transmission of a frame
+ * passed to linkoutput_sg is finished, e.g. its DMA is completed.
+ * The network stack releases the frame's buffers then.
+ * It must not be called from interrupt context.
+ * PARAMETER
+ * dev: network device which sent the frame
+ * frame: frame passed to linkoutput_sg
+ */
+void netdev_tx_done(struct netdev *dev, struct netdev_txframe *frame);
+#endif
 /**
  * Configuration
  */
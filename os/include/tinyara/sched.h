@@ -859,6 +859,18 @@ void sched_clear_cpuload_snapshot(void);
 void sched_get_cpuload_snapshot(pid_t *result_addr);
 #endif
 
+#ifdef CONFIG_SCHED_PROFILE
+/* One sample of the statistical profiler */
+
+struct profile_sample_s {
+	uint32_t pc;				/* PC of the interrupted code */
+	uint32_t lr;				/* LR of the interrupted code */
+	pid_t pid;					/* Task running when sampled */
+};
+
+int sched_get_profile(FAR struct profile_sample_s *samples, FAR uint32_t *lost);
+#endif
+
 /********************************************************************************
  * Name: task_starthook
  *
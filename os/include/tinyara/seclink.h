@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <sys/ioctl.h>
+#include <time.h>
 #include <tinyara/security_hal.h>
 
 #define SECLINK_OK                               0
@@ -15,6 +16,7 @@
 #define SECLINKIOC_COMMON                       _SECLINKIOC(0x00)
 #define SECLINKIOC_INIT                         _SECLINKIOC((SECLINKIOC_COMMON | 0x00))
 #define SECLINKIOC_DEINIT                       _SECLINKIOC((SECLINKIOC_COMMON | 0x01))
+#define SECLINKIOC_BATCH                        _SECLINKIOC((SECLINKIOC_COMMON | 0x02))
 
 /*  Crypto */
 #define SECLINKIOC_CRYPTO                       _SECLINKIOC(0x10)
@@ -41,6 +43,10 @@
 #define SECLINKIOC_GETFACTORY_KEY               _SECLINKIOC((SECLINKIOC_AUTH | 0x0d))
 #define SECLINKIOC_GETFACTORY_CERT              _SECLINKIOC((SECLINKIOC_AUTH | 0x0e))
 #define SECLINKIOC_GETFACTORY_DATA              _SECLINKIOC((SECLINKIOC_AUTH | 0x0f))
+/*  The next ones overlap the crypto bit, auth requests are dispatched first */
+#define SECLINKIOC_HASHINIT                     _SECLINKIOC((SECLINKIOC_AUTH | 0x10))
+#define SECLINKIOC_HASHUPDATE                   _SECLINKIOC((SECLINKIOC_AUTH | 0x11))
+#define SECLINKIOC_HASHFINAL                    _SECLINKIOC((SECLINKIOC_AUTH | 0x12))
 
 /*  Secure Storage */
 #define SECLINKIOC_SS                           _SECLINKIOC(0x40)
@@ -108,6 +114,20 @@ struct seclink_ss_info {
 struct seclink_comm_info {
 	uint8_t *priv;
 };
+
+struct seclink_req;
+struct seclink_batch_entry {
+	int cmd;
+	int32_t ret;
+	struct seclink_req *req;
+};
+
+/*  Requests run in order by one SECLINKIOC_BATCH, each one sets its ret */
+struct seclink_batch_info {
+	uint32_t count;
+	struct seclink_batch_entry *entries;
+};
+
 struct seclink_req {
 	union {
 		struct seclink_key_info *key;
@@ -115,6 +135,7 @@ struct seclink_req {
 		struct seclink_crypto_info *crypto;
 		struct seclink_ss_info *ss;
 		struct seclink_comm_info *comm;
+		struct seclink_batch_info *batch;
 	} req_type;
 	struct seclink_init_param *params;
 	int32_t res;
@@ -140,6 +161,12 @@ int sl_generate_random(sl_ctx hnd, uint32_t len, _OUT_ hal_data *random, hal_res
 
 int sl_get_hash(sl_ctx hnd, hal_hash_type mode, hal_data *input, _OUT_ hal_data *hash, hal_result_e *hres);
 
+int sl_hash_init(sl_ctx hnd, hal_hash_type mode, uint32_t hash_idx, hal_result_e *hres);
+
+int sl_hash_update(sl_ctx hnd, uint32_t hash_idx, hal_data *input, hal_result_e *hres);
+
+int sl_hash_final(sl_ctx hnd, uint32_t hash_idx, _OUT_ hal_data *hash, hal_result_e *hres);
+
 int sl_get_hmac(sl_ctx hnd, hal_hmac_type mode, hal_data *input, uint32_t key_idx, _OUT_ hal_data *hmac, hal_result_e *hres);
 
 int sl_rsa_sign_md(sl_ctx hnd, hal_rsa_mode mode, hal_data *hash, uint32_t key_idx, _OUT_ hal_data *sign, hal_result_e *hres);
@@ -186,4 +213,71 @@ int sl_read_storage(sl_ctx hnd, uint32_t ss_idx, _OUT_ hal_data *data, hal_resul
 
 int sl_delete_storage(sl_ctx hnd, uint32_t ss_idx, hal_result_e *hres);
 
+#ifdef CONFIG_SECURITY_LINK_ASYNC
+/*
+ * Asynchronous requests
+ *
+ * Requests are queued by sl_async_submit() and run in submission order by
+ * a worker task, which sends the ones queued meanwhile to the driver in a
+ * single SECLINKIOC_BATCH. An operation is prepared by one of the
+ * sl_async_prep_*() functions and must stay valid until it is completed.
+ * Its callback, if any, runs on the worker once it is done and must not
+ * free it.
+ */
+struct _seclink_async_s_;
+typedef struct _seclink_async_s_ *sl_async_ctx;
+
+struct sl_async_op;
+typedef void (*sl_async_cb)(struct sl_async_op *op, void *arg);
+
+struct sl_async_op {
+	int cmd;
+	union {
+		struct seclink_key_info key;
+		struct seclink_auth_info auth;
+		struct seclink_crypto_info crypto;
+		struct seclink_ss_info ss;
+	} info;
+	struct seclink_req req;
+	sl_async_cb cb;
+	void *cb_arg;
+
+	/*  Set when the operation is completed */
+	int ret;                 /* SECLINK_OK or SECLINK_ERROR */
+	hal_result_e hres;
+	uint32_t queue_us;       /* from submission to the start of its batch */
+	uint32_t exec_us;        /* duration of its batch in the driver */
+	uint32_t batch_len;      /* number of requests in its batch */
+
+	/*  Private */
+	struct sl_async_op *flink;
+	struct timespec submit;
+	int done;
+};
+
+int sl_async_init(sl_async_ctx *actx);
+
+int sl_async_deinit(sl_async_ctx actx);
+
+int sl_async_submit(sl_async_ctx actx, struct sl_async_op *op, sl_async_cb cb, void *cb_arg);
+
+int sl_async_wait(sl_async_ctx actx, struct sl_async_op *op);
+
+int sl_async_flush(sl_async_ctx actx);
+
+void sl_async_prep_hash_init(struct sl_async_op *op, hal_hash_type mode, uint32_t hash_idx);
+
+void sl_async_prep_hash_update(struct sl_async_op *op, uint32_t hash_idx, hal_data *input);
+
+void sl_async_prep_hash_final(struct sl_async_op *op, uint32_t hash_idx, _OUT_ hal_data *hash);
+
+void sl_async_prep_get_hash(struct sl_async_op *op, hal_hash_type mode, hal_data *input, _OUT_ hal_data *hash);
+
+void sl_async_prep_generate_random(struct sl_async_op *op, uint32_t len, _OUT_ hal_data *random);
+
+void sl_async_prep_ecdsa_sign_md(struct sl_async_op *op, hal_ecdsa_mode mode, hal_data *hash, uint32_t key_idx, _OUT_ hal_data *sign);
+
+void sl_async_prep_ecdsa_verify_md(struct sl_async_op *op, hal_ecdsa_mode mode, hal_data *hash, hal_data *sign, uint32_t key_idx);
+#endif
+
 #endif // __SECLINK_H__
@@ -329,6 +329,29 @@ typedef int (*hal_generate_random)(_IN_ uint32_t len, _OUT_ hal_data *random);
  */
 typedef int (*hal_get_hash)(_IN_ hal_hash_type mode, _IN_ hal_data *input, _OUT_ hal_data *hash);
 
+/*
+ * Reference
+ * Desc: Start a HASH computed over several inputs in the hash slot hash_idx
+ * Return value: hal_result_e
+ * NOTE: Optional, a HAL without it leaves hash_init, hash_update and
+ *       hash_final NULL. Starting a slot in use restarts it.
+ */
+typedef int (*hal_hash_init)(_IN_ hal_hash_type mode, _IN_ uint32_t hash_idx);
+
+/*
+ * Reference
+ * Desc: Add input to the HASH of hash_idx
+ * Return value: hal_result_e
+ */
+typedef int (*hal_hash_update)(_IN_ uint32_t hash_idx, _IN_ hal_data *input);
+
+/*
+ * Reference
+ * Desc: Get the HASH of hash_idx and release the slot
+ * Return value: hal_result_e
+ */
+typedef int (*hal_hash_final)(_IN_ uint32_t hash_idx, _OUT_ hal_data *hash);
+
 /*
  * Reference
  * Desc: Get HMAC
@@ -525,6 +548,9 @@ struct sec_ops_s {
 	hal_write_storage write_storage;
 	hal_read_storage read_storage;
 	hal_delete_storage delete_storage;
+	hal_hash_init hash_init;
+	hal_hash_update hash_update;
+	hal_hash_final hash_final;
 };
 
 int se_initialize(void);
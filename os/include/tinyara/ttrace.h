@@ -40,6 +40,7 @@
 #include <stdbool.h>
 #include <debug.h>
 #include <time.h>
+#include <semaphore.h>
 #include <sys/types.h>
 
 /****************************************************************************
@@ -61,6 +62,7 @@
 #define TTRACE_CODE_UNIQUE         (1 << 7)
 
 #define TTRACE_MSG_BYTES            32
+#define TTRACE_ARG_BYTES            4
 #define TTRACE_COMM_BYTES           12
 #define TTRACE_BYTE_ALIGN           4
 
@@ -75,6 +77,25 @@
 #define TTRACE_TAG_LOCK            (1 << 2)
 #define TTRACE_TAG_TASK            (1 << 3)
 #define TTRACE_TAG_IPC             (1 << 4)
+#define TTRACE_TAG_IRQ             (1 << 5)
+
+#define TTRACE_EVENT_TYPE_BEGIN    'b'
+#define TTRACE_EVENT_TYPE_END      'e'
+#define TTRACE_EVENT_TYPE_SCHED    's'
+#define TTRACE_EVENT_TYPE_WAKEUP   'w'
+#define TTRACE_EVENT_TYPE_IRQ_ENTER 'i'
+#define TTRACE_EVENT_TYPE_IRQ_EXIT 'x'
+#define TTRACE_EVENT_TYPE_SEM_BLOCK 'k'
+#define TTRACE_EVENT_TYPE_SEM_POST 'p'
+
+/* Kernel events other than the scheduler ones carry a single argument,
+ * the irq number or the semaphore address.
+ */
+
+#define TTRACE_IS_ARG_EVENT(t)     ((t) == TTRACE_EVENT_TYPE_IRQ_ENTER || \
+					(t) == TTRACE_EVENT_TYPE_IRQ_EXIT || \
+					(t) == TTRACE_EVENT_TYPE_SEM_BLOCK || \
+					(t) == TTRACE_EVENT_TYPE_SEM_POST)
 
 /****************************************************************************
  * Public Variables
@@ -93,6 +114,7 @@ struct sched_message {          // total 32B
 union trace_message {              // total 32B
 	char message[TTRACE_MSG_BYTES];  // 32B, message(256b)
 	struct sched_message sched_msg;  // 32B
+	uint32_t arg;                    // 4B, irq or semaphore of kernel events
 };
 
 struct trace_packet {        // total 44 byte(message), 12byte(uid)
@@ -162,12 +184,60 @@ int trace_end_uid(int tag);
  * @since TizenRT v1.1
  */
 int trace_sched(struct tcb_s *prev, struct tcb_s *next);
+
+/**
+ * @ingroup TTRACE_LIBC
+ * @brief writes the trace logs buffered by the calling task to the trace buffer
+ * @details @b #include <tinyara/ttrace.h>
+ * Trace logs are buffered per task only with CONFIG_TTRACE_USER_BUFFER.
+ * @return On success, TTRACE_VALID is returned. On failure, TTRACE_INVALID is returned.
+ * @since TizenRT v2.1
+ */
+int trace_flush(void);
+
+/**
+ * @ingroup TTRACE_LIBC
+ * @brief writes the trace logs buffered by all tasks to the trace buffer
+ * @details @b #include <tinyara/ttrace.h>
+ * Trace logs are buffered per task only with CONFIG_TTRACE_USER_BUFFER.
+ * @return On success, TTRACE_VALID is returned. On failure, TTRACE_INVALID is returned.
+ * @since TizenRT v2.1
+ */
+int trace_flush_all(void);
+
+#ifdef CONFIG_TTRACE_KERNEL_EVENTS
+/* Kernel instrumentation points, recorded straight into the trace buffer.
+ * They may be called from interrupt handlers.
+ */
+
+void ttrace_sched_switch(FAR struct tcb_s *prev, FAR struct tcb_s *next);
+void ttrace_sched_wakeup(FAR struct tcb_s *tcb);
+void ttrace_irq_enter(int irq);
+void ttrace_irq_exit(int irq);
+void ttrace_sem_block(FAR sem_t *sem);
+void ttrace_sem_post(FAR sem_t *sem);
+#else
+#define ttrace_sched_switch(a, b)
+#define ttrace_sched_wakeup(a)
+#define ttrace_irq_enter(a)
+#define ttrace_irq_exit(a)
+#define ttrace_sem_block(a)
+#define ttrace_sem_post(a)
+#endif
 #else
 #define trace_begin(a, b, ...)
 #define trace_begin_uid(a, b)
 #define trace_end(a)
 #define trace_end_uid(a)
 #define trace_sched(a, b)
+#define trace_flush()
+#define trace_flush_all()
+#define ttrace_sched_switch(a, b)
+#define ttrace_sched_wakeup(a)
+#define ttrace_irq_enter(a)
+#define ttrace_irq_exit(a)
+#define ttrace_sem_block(a)
+#define ttrace_sem_post(a)
 
 #if defined(__cplusplus)
 }
@@ -59,8 +59,10 @@
 #include <debug.h>
 #include <tinyara/arch.h>
 #include <tinyara/irq.h>
+#include <tinyara/ttrace.h>
 
 #include "irq/irq.h"
+#include "sched/sched.h"
 
 #ifdef CONFIG_IRQ_SCHED_HISTORY
 #include <tinyara/debug/sysdbg.h>
@@ -128,5 +130,9 @@ void irq_dispatch(int irq, FAR void *context)
 
 	/* Then dispatch to the interrupt handler */
 
+	sched_cpuload_irqenter();
+	ttrace_irq_enter(irq);
 	vector(irq, context, arg);
+	ttrace_irq_exit(irq);
+	sched_cpuload_irqexit();
 }
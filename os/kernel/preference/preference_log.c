@@ -0,0 +1,846 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <debug.h>
+#include <crc32.h>
+#include <sys/stat.h>
+#include <tinyara/preference.h>
+
+#include "preference.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* All the keys are kept in one file, as a log of records appended on each
+ * write or removal. The last record of a key wins. A hash index in RAM
+ * gives the offset of the live record of each key, and the log is rewritten
+ * with the live records only once the stale ones take too much of it.
+ * Keys are the paths the file per key store uses, relative to PREF_PATH.
+ */
+#define PREF_LOG_PATH          PREF_PATH"/pref.log"
+#define PREF_LOG_TMP_PATH      PREF_PATH"/pref.tmp"
+#define PREF_LOG_BAD_PATH      PREF_PATH"/pref.bad"
+#define PREF_LOG_MAGIC         0x474c5250	/* "PRLG" */
+#define PREF_LOG_VERSION       1
+#define PREF_LOG_REMOVED       0x0001
+#define PREF_LOG_KEY_MAX       0xffff
+#define PREF_LOG_BUCKETS       CONFIG_PREFERENCE_LOG_BUCKETS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+struct pref_log_head_s {
+	uint32_t magic;
+	uint32_t version;
+};
+
+/* A record is this header, the key without terminator and the value */
+struct pref_log_rec_s {
+	uint32_t crc;				/* of the rest of the header, the key and the value */
+	uint16_t key_len;
+	uint16_t flags;
+	int type;
+	int len;
+};
+
+struct pref_log_entry_s {
+	struct pref_log_entry_s *flink;
+	uint32_t hash;
+	off_t offset;
+	uint32_t size;				/* of the whole record */
+	int type;
+	char key[1];				/* allocated to its length */
+};
+
+struct pref_log_s {
+	bool loaded;
+	off_t size;					/* end of the last valid record */
+	off_t stale;				/* bytes of replaced and removal records */
+	struct pref_log_entry_s *bucket[PREF_LOG_BUCKETS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+static struct pref_log_s g_pref_log;
+static sem_t g_pref_log_sem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static const char *preference_log_key(const char *path)
+{
+	size_t len = strlen(PREF_PATH);
+
+	if (strncmp(path, PREF_PATH, len) != 0 || path[len] != '/' || path[len + 1] == '\0') {
+		prefdbg("Invalid key path %s\n", path);
+		return NULL;
+	}
+
+	return path + len + 1;
+}
+
+static uint32_t preference_log_crc(struct pref_log_rec_s *rec, const char *key, const void *value)
+{
+	uint32_t crc;
+
+	crc = crc32((uint8_t *)&rec->key_len, sizeof(struct pref_log_rec_s) - sizeof(uint32_t));
+	crc = crc32part((uint8_t *)key, rec->key_len, crc);
+
+	return crc32part((uint8_t *)value, rec->len, crc);
+}
+
+static struct pref_log_entry_s **preference_log_find(const char *key, size_t key_len, uint32_t hash)
+{
+	struct pref_log_entry_s **entry;
+
+	entry = &g_pref_log.bucket[hash % PREF_LOG_BUCKETS];
+	while (*entry != NULL) {
+		if ((*entry)->hash == hash && strncmp((*entry)->key, key, key_len) == 0 && (*entry)->key[key_len] == '\0') {
+			break;
+		}
+		entry = &(*entry)->flink;
+	}
+
+	return entry;
+}
+
+/* Drop the live record of key from the index, it becomes stale */
+static void preference_log_unindex(const char *key, size_t key_len, uint32_t hash)
+{
+	struct pref_log_entry_s **link;
+	struct pref_log_entry_s *entry;
+
+	link = preference_log_find(key, key_len, hash);
+	entry = *link;
+	if (entry != NULL) {
+		*link = entry->flink;
+		g_pref_log.stale += entry->size;
+		PREFERENCE_FREE(entry);
+	}
+}
+
+static int preference_log_index(const char *key, size_t key_len, int type, off_t offset, uint32_t size)
+{
+	uint32_t hash;
+	struct pref_log_entry_s *entry;
+
+	hash = crc32((uint8_t *)key, key_len);
+	preference_log_unindex(key, key_len, hash);
+
+	entry = (struct pref_log_entry_s *)PREFERENCE_ALLOC(sizeof(struct pref_log_entry_s) + key_len);
+	if (entry == NULL) {
+		return PREFERENCE_OUT_OF_MEMORY;
+	}
+	memcpy(entry->key, key, key_len);
+	entry->key[key_len] = '\0';
+	entry->hash = hash;
+	entry->offset = offset;
+	entry->size = size;
+	entry->type = type;
+	entry->flink = g_pref_log.bucket[hash % PREF_LOG_BUCKETS];
+	g_pref_log.bucket[hash % PREF_LOG_BUCKETS] = entry;
+
+	return OK;
+}
+
+static void preference_log_clear(void)
+{
+	int i;
+	struct pref_log_entry_s *entry;
+
+	for (i = 0; i < PREF_LOG_BUCKETS; i++) {
+		while ((entry = g_pref_log.bucket[i]) != NULL) {
+			g_pref_log.bucket[i] = entry->flink;
+			PREFERENCE_FREE(entry);
+		}
+	}
+	g_pref_log.size = 0;
+	g_pref_log.stale = 0;
+	g_pref_log.loaded = false;
+}
+
+static int preference_log_read_at(int fd, off_t offset, void *buf, size_t len)
+{
+	if (lseek(fd, offset, SEEK_SET) != offset) {
+		return PREFERENCE_IO_ERROR;
+	}
+	if (read(fd, buf, len) != len) {
+		return PREFERENCE_IO_ERROR;
+	}
+
+	return OK;
+}
+
+/* Read the record at offset, which ends before end, and verify its crc.
+ * The caller frees *buf.
+ */
+static int preference_log_read_rec(int fd, off_t offset, off_t end, struct pref_log_rec_s **buf)
+{
+	struct pref_log_rec_s rec;
+	struct pref_log_rec_s *full;
+	char *key;
+
+	if (preference_log_read_at(fd, offset, &rec, sizeof(struct pref_log_rec_s)) != OK) {
+		return PREFERENCE_IO_ERROR;
+	}
+	if (rec.key_len == 0 || rec.len < 0 || rec.type < 0 || offset + (off_t)sizeof(struct pref_log_rec_s) + rec.key_len + rec.len > end) {
+		return PREFERENCE_INVALID_DATA;
+	}
+
+	full = (struct pref_log_rec_s *)PREFERENCE_ALLOC(sizeof(struct pref_log_rec_s) + rec.key_len + rec.len);
+	if (full == NULL) {
+		return PREFERENCE_OUT_OF_MEMORY;
+	}
+	*full = rec;
+	key = (char *)(full + 1);
+	if (read(fd, key, rec.key_len + rec.len) != rec.key_len + rec.len) {
+		PREFERENCE_FREE(full);
+		return PREFERENCE_IO_ERROR;
+	}
+	if (preference_log_crc(full, key, key + rec.key_len) != rec.crc) {
+		prefdbg("Invalid checksum of record at %d\n", (int)offset);
+		PREFERENCE_FREE(full);
+		return PREFERENCE_INVALID_DATA;
+	}
+	*buf = full;
+
+	return OK;
+}
+
+/* Whether the invalid record at offset is the last write, cut by a reset:
+ * it claims to reach the end of the log, or its header is not written and
+ * the rest of the log is blank.
+ */
+static bool preference_log_torn(int fd, off_t offset, off_t end)
+{
+	struct pref_log_rec_s rec;
+	uint8_t buf[16];
+	uint8_t blank;
+	ssize_t nread;
+	ssize_t i;
+
+	if (preference_log_read_at(fd, offset, &rec, sizeof(struct pref_log_rec_s)) != OK) {
+		return false;
+	}
+	if (rec.key_len != 0 && rec.len >= 0 && rec.type >= 0) {
+		return offset + (off_t)sizeof(struct pref_log_rec_s) + rec.key_len + rec.len >= end;
+	}
+
+	if (lseek(fd, offset, SEEK_SET) != offset) {
+		return false;
+	}
+	blank = ((uint8_t *)&rec)[0];
+	if (blank != 0x00 && blank != 0xff) {
+		return false;
+	}
+	while ((nread = read(fd, buf, sizeof(buf))) > 0) {
+		for (i = 0; i < nread; i++) {
+			if (buf[i] != blank) {
+				return false;
+			}
+		}
+	}
+
+	return nread == 0;
+}
+
+static int preference_log_create(const char *path)
+{
+	int fd;
+	struct pref_log_head_s head = { PREF_LOG_MAGIC, PREF_LOG_VERSION };
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0) {
+		prefdbg("open fail %d\n", errno);
+		return PREFERENCE_IO_ERROR;
+	}
+	if (write(fd, &head, sizeof(head)) != sizeof(head)) {
+		prefdbg("Failed to write log head, errno %d\n", errno);
+		close(fd);
+		unlink(path);
+		return PREFERENCE_IO_ERROR;
+	}
+
+	return fd;
+}
+
+/* Write the live records, read from the log at path, to a new log which
+ * then replaces the current one
+ */
+static int preference_log_compact(const char *path)
+{
+	int i;
+	int ret;
+	int in_fd;
+	int out_fd;
+	off_t offset;
+	struct pref_log_entry_s *entry;
+	struct pref_log_rec_s *rec;
+
+	prefvdbg("Compact log, size %d stale %d\n", (int)g_pref_log.size, (int)g_pref_log.stale);
+
+	in_fd = open(path, O_RDONLY);
+	if (in_fd < 0) {
+		prefdbg("open fail %d\n", errno);
+		return PREFERENCE_IO_ERROR;
+	}
+	out_fd = preference_log_create(PREF_LOG_TMP_PATH);
+	if (out_fd < 0) {
+		close(in_fd);
+		return out_fd;
+	}
+
+	ret = OK;
+	for (i = 0; i < PREF_LOG_BUCKETS && ret == OK; i++) {
+		for (entry = g_pref_log.bucket[i]; entry != NULL && ret == OK; entry = entry->flink) {
+			ret = preference_log_read_rec(in_fd, entry->offset, g_pref_log.size, &rec);
+			if (ret != OK) {
+				break;
+			}
+			if (write(out_fd, rec, entry->size) != entry->size) {
+				prefdbg("Failed to write record, errno %d\n", errno);
+				ret = PREFERENCE_IO_ERROR;
+			}
+			PREFERENCE_FREE(rec);
+		}
+	}
+	close(in_fd);
+	close(out_fd);
+
+	if (ret != OK) {
+		unlink(PREF_LOG_TMP_PATH);
+		return ret;
+	}
+
+	/* The temporary log is complete, a reboot from here on recovers it */
+	if ((unlink(PREF_LOG_PATH) < 0 && errno != ENOENT) || rename(PREF_LOG_TMP_PATH, PREF_LOG_PATH) < 0) {
+		prefdbg("Failed to replace log, errno %d\n", errno);
+		return PREFERENCE_IO_ERROR;
+	}
+
+	/* Same order as the copy above */
+	offset = sizeof(struct pref_log_head_s);
+	for (i = 0; i < PREF_LOG_BUCKETS; i++) {
+		for (entry = g_pref_log.bucket[i]; entry != NULL; entry = entry->flink) {
+			entry->offset = offset;
+			offset += entry->size;
+		}
+	}
+	g_pref_log.size = offset;
+	g_pref_log.stale = 0;
+
+	return OK;
+}
+
+static int preference_log_append(const char *key, int flags, int type, const void *value, int len)
+{
+	int fd;
+	int ret;
+	size_t size;
+	uint32_t hash;
+	struct pref_log_rec_s *rec;
+	size_t key_len = strlen(key);
+
+	if (key_len > PREF_LOG_KEY_MAX) {
+		return PREFERENCE_INVALID_PARAMETER;
+	}
+
+	/* Build the whole record, so an update costs one write */
+	size = sizeof(struct pref_log_rec_s) + key_len + len;
+	rec = (struct pref_log_rec_s *)PREFERENCE_ALLOC(size);
+	if (rec == NULL) {
+		return PREFERENCE_OUT_OF_MEMORY;
+	}
+	rec->key_len = key_len;
+	rec->flags = flags;
+	rec->type = type;
+	rec->len = len;
+	memcpy(rec + 1, key, key_len);
+	if (len > 0) {
+		memcpy((char *)(rec + 1) + key_len, value, len);
+	}
+	rec->crc = preference_log_crc(rec, key, value);
+
+	fd = open(PREF_LOG_PATH, O_WRONLY);
+	if (fd < 0) {
+		prefdbg("open fail %d\n", errno);
+		PREFERENCE_FREE(rec);
+		return PREFERENCE_IO_ERROR;
+	}
+	if (lseek(fd, g_pref_log.size, SEEK_SET) != g_pref_log.size || write(fd, rec, size) != size) {
+		prefdbg("Failed to write record, errno %d\n", errno);
+		close(fd);
+		PREFERENCE_FREE(rec);
+
+		/* The tail of the log is unknown, load it again on the next access */
+		preference_log_clear();
+		return PREFERENCE_IO_ERROR;
+	}
+	close(fd);
+	PREFERENCE_FREE(rec);
+
+	if (flags & PREF_LOG_REMOVED) {
+		hash = crc32((uint8_t *)key, key_len);
+		preference_log_unindex(key, key_len, hash);
+		g_pref_log.stale += size;
+		ret = OK;
+	} else {
+		ret = preference_log_index(key, key_len, type, g_pref_log.size, size);
+	}
+	g_pref_log.size += size;
+
+	if (g_pref_log.size >= CONFIG_PREFERENCE_LOG_COMPACT_SIZE && g_pref_log.stale * 100 >= g_pref_log.size * CONFIG_PREFERENCE_LOG_COMPACT_RATIO) {
+		/* A failed compaction leaves the log as it was */
+		(void)preference_log_compact(PREF_LOG_PATH);
+	}
+
+	return ret;
+}
+
+/* Move a damaged log out of the way, to PREF_LOG_BAD_PATH if possible */
+static int preference_log_set_aside(void)
+{
+	unlink(PREF_LOG_BAD_PATH);
+	if (rename(PREF_LOG_PATH, PREF_LOG_BAD_PATH) == OK) {
+		prefdbg("Damaged log moved to %s\n", PREF_LOG_BAD_PATH);
+		return OK;
+	}
+	if (unlink(PREF_LOG_PATH) == OK) {
+		prefdbg("Damaged log removed\n");
+		return OK;
+	}
+	prefdbg("Failed to set the damaged log aside, errno %d\n", errno);
+
+	return PREFERENCE_IO_ERROR;
+}
+
+#ifdef CONFIG_PREFERENCE_LOG_MIGRATE
+/* Move a key file of the file per key store into the log. A key already in
+ * the log was imported before a reboot interrupted the migration.
+ */
+static void preference_log_import_file(const char *path)
+{
+	int fd;
+	int ret;
+	void *value;
+	value_attr_t attr;
+	uint32_t check_crc;
+	const char *key;
+
+	key = preference_log_key(path);
+	if (key == NULL) {
+		return;
+	}
+	if (*preference_log_find(key, strlen(key), crc32((uint8_t *)key, strlen(key))) != NULL) {
+		unlink(path);
+		return;
+	}
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+	value = NULL;
+	ret = PREFERENCE_INVALID_DATA;
+	if (read(fd, &attr, sizeof(value_attr_t)) == sizeof(value_attr_t) && attr.type >= 0 && attr.len >= 0) {
+		value = PREFERENCE_ALLOC(attr.len);
+		if (value != NULL && read(fd, value, attr.len) == attr.len) {
+			check_crc = crc32((uint8_t *)&attr.type, sizeof(value_attr_t) - sizeof(uint32_t));
+			check_crc = crc32part((uint8_t *)value, attr.len, check_crc);
+			if (check_crc == attr.crc) {
+				ret = preference_log_append(key, 0, attr.type, value, attr.len);
+			}
+		}
+	}
+	close(fd);
+	if (value != NULL) {
+		PREFERENCE_FREE(value);
+	}
+
+	if (ret == OK) {
+		unlink(path);
+	} else {
+		prefdbg("Failed to import %s, %d\n", path, ret);
+	}
+}
+
+static void preference_log_import_dir(const char *dir_path)
+{
+	DIR *dir;
+	char *path;
+	struct dirent *entry;
+
+	dir = opendir(dir_path);
+	if (dir == NULL) {
+		return;
+	}
+	while ((entry = readdir(dir)) != NULL) {
+		if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) {
+			continue;
+		}
+		if (PREFERENCE_ASPRINTF(&path, "%s/%s", dir_path, entry->d_name) < 0) {
+			break;
+		}
+		if (DIRENT_ISDIRECTORY(entry->d_type)) {
+			preference_log_import_dir(path);
+			rmdir(path);
+		} else {
+			preference_log_import_file(path);
+		}
+		PREFERENCE_FREE(path);
+	}
+	closedir(dir);
+}
+#endif
+
+static int preference_log_load(void)
+{
+	int fd;
+	int ret;
+	off_t end;
+	bool damaged;
+	bool salvage;
+	struct stat st;
+	struct pref_log_head_s head;
+	struct pref_log_rec_s rec_head;
+	struct pref_log_rec_s *rec;
+
+	/* Finish or drop a compaction a reboot interrupted */
+	if (stat(PREF_LOG_TMP_PATH, &st) == OK) {
+		if (stat(PREF_LOG_PATH, &st) < 0 && errno == ENOENT) {
+			rename(PREF_LOG_TMP_PATH, PREF_LOG_PATH);
+		} else {
+			unlink(PREF_LOG_TMP_PATH);
+		}
+	}
+
+	fd = open(PREF_LOG_PATH, O_RDONLY);
+	if (fd < 0) {
+		if (errno != ENOENT) {
+			prefdbg("open fail %d\n", errno);
+			return PREFERENCE_IO_ERROR;
+		}
+		goto create;
+	}
+
+	end = lseek(fd, 0, SEEK_END);
+	if (preference_log_read_at(fd, 0, &head, sizeof(head)) != OK || head.magic != PREF_LOG_MAGIC || head.version != PREF_LOG_VERSION) {
+		prefdbg("Invalid log head\n");
+		close(fd);
+		ret = preference_log_set_aside();
+		if (ret != OK) {
+			return ret;
+		}
+		goto create;
+	}
+
+	/* Replay the records. The last one may be invalid, a write a reset cut.
+	 * An invalid record before it is skipped if its lengths still lead to
+	 * the next record. Otherwise the records after it can't be found, the
+	 * ones before it are kept and the damaged log is set aside.
+	 */
+	damaged = false;
+	salvage = false;
+	g_pref_log.size = sizeof(struct pref_log_head_s);
+	while (g_pref_log.size + (off_t)sizeof(struct pref_log_rec_s) <= end) {
+		ret = preference_log_read_rec(fd, g_pref_log.size, end, &rec);
+		if (ret == PREFERENCE_INVALID_DATA && preference_log_torn(fd, g_pref_log.size, end)) {
+			break;
+		} else if (ret == PREFERENCE_INVALID_DATA) {
+			prefdbg("Damaged record at %d\n", (int)g_pref_log.size);
+			if (preference_log_read_at(fd, g_pref_log.size, &rec_head, sizeof(struct pref_log_rec_s)) != OK || rec_head.key_len == 0 || rec_head.len < 0 || rec_head.type < 0 || g_pref_log.size + (off_t)sizeof(struct pref_log_rec_s) + rec_head.key_len + rec_head.len > end) {
+				salvage = true;
+				break;
+			}
+			g_pref_log.size += sizeof(struct pref_log_rec_s) + rec_head.key_len + rec_head.len;
+			g_pref_log.stale += sizeof(struct pref_log_rec_s) + rec_head.key_len + rec_head.len;
+			damaged = true;
+			continue;
+		} else if (ret != OK) {
+			prefdbg("Invalid record at %d, %d\n", (int)g_pref_log.size, ret);
+			close(fd);
+			preference_log_clear();
+			return ret;
+		}
+		if (rec->flags & PREF_LOG_REMOVED) {
+			preference_log_unindex((char *)(rec + 1), rec->key_len, crc32((uint8_t *)(rec + 1), rec->key_len));
+			g_pref_log.stale += sizeof(struct pref_log_rec_s) + rec->key_len;
+			ret = OK;
+		} else {
+			ret = preference_log_index((char *)(rec + 1), rec->key_len, rec->type, g_pref_log.size, sizeof(struct pref_log_rec_s) + rec->key_len + rec->len);
+		}
+		g_pref_log.size += sizeof(struct pref_log_rec_s) + rec->key_len + rec->len;
+		PREFERENCE_FREE(rec);
+		if (ret != OK) {
+			close(fd);
+			preference_log_clear();
+			return ret;
+		}
+	}
+	close(fd);
+
+	if (salvage) {
+		/* Rebuild the log from the records replayed so far */
+		prefdbg("Drop %d bytes after the damaged record\n", (int)(end - g_pref_log.size));
+		ret = preference_log_set_aside();
+		if (ret == OK) {
+			ret = preference_log_compact(PREF_LOG_BAD_PATH);
+		}
+		if (ret != OK) {
+			/* The damaged log is gone or the next load sets it aside again */
+			preference_log_clear();
+			return ret;
+		}
+	} else if (g_pref_log.size != end) {
+		/* A write was cut, rewrite the log without its tail */
+		prefdbg("Drop %d bytes at the end of the log\n", (int)(end - g_pref_log.size));
+		ret = preference_log_compact(PREF_LOG_PATH);
+		if (ret != OK) {
+			preference_log_clear();
+			return ret;
+		}
+	} else if (damaged) {
+		/* The skipped records are stale, a failure only keeps them longer */
+		(void)preference_log_compact(PREF_LOG_PATH);
+	}
+	g_pref_log.loaded = true;
+	goto migrate;
+
+create:
+	fd = preference_log_create(PREF_LOG_PATH);
+	if (fd < 0) {
+		return fd;
+	}
+	close(fd);
+	g_pref_log.size = sizeof(struct pref_log_head_s);
+	g_pref_log.loaded = true;
+
+migrate:
+#ifdef CONFIG_PREFERENCE_LOG_MIGRATE
+	preference_log_import_dir(PREF_SHARED_PATH);
+#if CONFIG_TASK_NAME_SIZE > 0
+	preference_log_import_dir(PREF_PRIVATE_PATH);
+#endif
+#endif
+
+	return OK;
+}
+
+static int preference_log_lock(void)
+{
+	int ret;
+
+	while (sem_wait(&g_pref_log_sem) != OK) {
+		DEBUGASSERT(get_errno() == EINTR);
+	}
+
+	if (!g_pref_log.loaded) {
+		ret = preference_log_load();
+		if (ret != OK) {
+			sem_post(&g_pref_log_sem);
+			return ret;
+		}
+	}
+
+	return OK;
+}
+
+static void preference_log_unlock(void)
+{
+	sem_post(&g_pref_log_sem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+int preference_log_write(const char *path, preference_data_t *data)
+{
+	int ret;
+	const char *key;
+
+	key = preference_log_key(path);
+	if (key == NULL || data->attr.len < 0 || (data->attr.len > 0 && data->value == NULL)) {
+		return PREFERENCE_INVALID_PARAMETER;
+	}
+
+	ret = preference_log_lock();
+	if (ret != OK) {
+		return ret;
+	}
+	ret = preference_log_append(key, 0, data->attr.type, data->value, data->attr.len);
+	preference_log_unlock();
+
+	prefvdbg("Write key %s, len = %d, ret = %d\n", key, data->attr.len, ret);
+
+	return ret;
+}
+
+int preference_log_read(const char *path, preference_data_t *data)
+{
+	int fd;
+	int ret;
+	const char *key;
+	struct pref_log_entry_s *entry;
+	struct pref_log_rec_s *rec;
+
+	key = preference_log_key(path);
+	if (key == NULL) {
+		return PREFERENCE_INVALID_PARAMETER;
+	}
+
+	ret = preference_log_lock();
+	if (ret != OK) {
+		return ret;
+	}
+
+	entry = *preference_log_find(key, strlen(key), crc32((uint8_t *)key, strlen(key)));
+	if (entry == NULL) {
+		ret = PREFERENCE_KEY_NOT_EXIST;
+		goto errout;
+	} else if (entry->type != data->attr.type) {
+		prefdbg("Invalid type. request type:%d, read type:%d\n", data->attr.type, entry->type);
+		ret = PREFERENCE_INVALID_PARAMETER;
+		goto errout;
+	}
+
+	fd = open(PREF_LOG_PATH, O_RDONLY);
+	if (fd < 0) {
+		ret = PREFERENCE_IO_ERROR;
+		goto errout;
+	}
+	ret = preference_log_read_rec(fd, entry->offset, g_pref_log.size, &rec);
+	close(fd);
+	if (ret != OK) {
+		goto errout;
+	}
+
+	data->value = PREFERENCE_ALLOC(rec->len);
+	if (data->value == NULL) {
+		ret = PREFERENCE_OUT_OF_MEMORY;
+	} else {
+		memcpy(data->value, (char *)(rec + 1) + rec->key_len, rec->len);
+		data->attr.len = rec->len;
+	}
+	PREFERENCE_FREE(rec);
+
+errout:
+	preference_log_unlock();
+
+	return ret;
+}
+
+int preference_log_remove(const char *path)
+{
+	int ret;
+	const char *key;
+
+	key = preference_log_key(path);
+	if (key == NULL) {
+		return PREFERENCE_INVALID_PARAMETER;
+	}
+
+	ret = preference_log_lock();
+	if (ret != OK) {
+		return ret;
+	}
+	if (*preference_log_find(key, strlen(key), crc32((uint8_t *)key, strlen(key))) == NULL) {
+		ret = PREFERENCE_KEY_NOT_EXIST;
+	} else {
+		ret = preference_log_append(key, PREF_LOG_REMOVED, 0, NULL, 0);
+	}
+	preference_log_unlock();
+
+	return ret;
+}
+
+/* Remove the keys below dir_path, as if it was a directory */
+int preference_log_remove_all(const char *dir_path)
+{
+	int i;
+	int ret;
+	int found;
+	size_t len;
+	const char *prefix;
+	struct pref_log_entry_s *entry;
+	struct pref_log_entry_s *next;
+
+	prefix = preference_log_key(dir_path);
+	if (prefix == NULL) {
+		return PREFERENCE_INVALID_PARAMETER;
+	}
+	len = strlen(prefix);
+
+	ret = preference_log_lock();
+	if (ret != OK) {
+		return ret;
+	}
+
+	found = 0;
+	for (i = 0; i < PREF_LOG_BUCKETS && ret == OK; i++) {
+		for (entry = g_pref_log.bucket[i]; entry != NULL && ret == OK; entry = next) {
+			/* Removal frees the entry, and compaction doesn't reorder the buckets */
+			next = entry->flink;
+			if (strncmp(entry->key, prefix, len) == 0 && entry->key[len] == '/') {
+				prefvdbg("Remove key : %s\n", entry->key);
+				ret = preference_log_append(entry->key, PREF_LOG_REMOVED, 0, NULL, 0);
+				found++;
+			}
+		}
+	}
+	preference_log_unlock();
+
+	if (ret == OK && found == 0) {
+		ret = PREFERENCE_PATH_NOT_FOUND;
+	}
+
+	return ret;
+}
+
+int preference_log_check(const char *path, bool *existing)
+{
+	int ret;
+	const char *key;
+
+	key = preference_log_key(path);
+	if (key == NULL) {
+		return PREFERENCE_INVALID_PARAMETER;
+	}
+
+	ret = preference_log_lock();
+	if (ret != OK) {
+		return ret;
+	}
+	*existing = (*preference_log_find(key, strlen(key), crc32((uint8_t *)key, strlen(key))) != NULL);
+	preference_log_unlock();
+
+	return OK;
+}
@@ -31,10 +31,12 @@
 
 #include "sched/sched.h"
 #endif
+#include "preference.h"
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
+#ifndef CONFIG_PREFERENCE_LOG_STORE
 static int preference_remove_fs_key(char *path)
 {
 	int ret;
@@ -62,6 +64,7 @@ static int preference_remove_fs_key(char *path)
 
 	return ret;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -90,16 +93,25 @@ int preference_remove_key(int type, const char *key)
 		}
 	}
 
+#ifdef CONFIG_PREFERENCE_LOG_STORE
+	ret = preference_log_remove(path);
+	PREFERENCE_FREE(path);
+
+	return ret;
+#else
 	return preference_remove_fs_key(path);
+#endif
 }
 
 int preference_remove_all_key(int type, const char *path)
 {
 	int ret;
-	DIR *dir;
 	char *dir_path;
+#ifndef CONFIG_PREFERENCE_LOG_STORE
+	DIR *dir;
 	char *key_path;
 	struct dirent *entry;
+#endif
 #if CONFIG_TASK_NAME_SIZE > 0
 	struct tcb_s *tcb;
 #endif
@@ -134,6 +146,12 @@ int preference_remove_all_key(int type, const char *path)
 
 	prefvdbg("preference dir path = %s\n", dir_path);
 
+#ifdef CONFIG_PREFERENCE_LOG_STORE
+	ret = preference_log_remove_all(dir_path);
+	PREFERENCE_FREE(dir_path);
+
+	return ret;
+#else
 	dir = (DIR *)opendir(dir_path);
 	if (!dir) {
 		prefdbg("Failed to open dir %s, %d\n", dir_path, errno);
@@ -175,4 +193,5 @@ errout_with_free:
 	PREFERENCE_FREE(dir_path);
 
 	return ret;
+#endif
 }
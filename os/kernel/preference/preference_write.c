@@ -33,10 +33,12 @@
 
 #include "sched/sched.h"
 #endif
+#include "preference.h"
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
+#ifndef CONFIG_PREFERENCE_LOG_STORE
 #if CONFIG_TASK_NAME_SIZE > 0
 static int preference_private_setup(void)
 {
@@ -149,6 +151,7 @@ errout_with_close:
 
 	return PREFERENCE_IO_ERROR;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -165,11 +168,13 @@ int preference_write_key(preference_data_t *data)
 
 	if (data->type == PRIVATE_PREFERENCE) {
 #if CONFIG_TASK_NAME_SIZE > 0
+#ifndef CONFIG_PREFERENCE_LOG_STORE
 		ret = preference_private_setup();
 		if (ret < 0) {
 			prefdbg("Failed to set up preference\n");
 			return ret;
 		}
+#endif
 		ret = preference_get_private_keypath(data->key, &path);
 		if (ret < 0) {
 			prefdbg("Failed to get preference path\n");
@@ -180,11 +185,13 @@ int preference_write_key(preference_data_t *data)
 		return PREFERENCE_NOT_SUPPORTED;
 #endif
 	} else {
+#ifndef CONFIG_PREFERENCE_LOG_STORE
 		ret = preference_shared_setup(data->key);
 		if (ret < 0) {
 			prefdbg("Failed to set up preference\n");
 			return ret;
 		}
+#endif
 		ret = PREFERENCE_ASPRINTF(&path, "%s/%s", PREF_SHARED_PATH, data->key);
 		if (ret < 0) {
 			prefdbg("Failed to allocate path\n");
@@ -193,7 +200,12 @@ int preference_write_key(preference_data_t *data)
 	}
 	prefvdbg("Preference key path = %s\n", path);
 
+#ifdef CONFIG_PREFERENCE_LOG_STORE
+	ret = preference_log_write(path, data);
+	PREFERENCE_FREE(path);
+#else
 	ret = preference_write_fs_key(path, data);
+#endif
 #if !defined(CONFIG_DISABLE_MQUEUE) && !defined(CONFIG_DISABLE_SIGNAL)
 	if (ret == OK) {
 		/* Execute callback if registered cb is existing */
@@ -113,6 +113,12 @@ struct pidhash_s {
 #ifdef CONFIG_SCHED_CPULOAD
 	uint32_t ticks[SCHED_NCPULOAD];				/* Number of ticks on this thread */
 #endif
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+	uint64_t runtime;			/* Microseconds run, interrupts excluded */
+	uint64_t irqtime;			/* Microseconds in interrupts while running */
+	uint32_t nvcsw;				/* Number of voluntary context switches */
+	uint32_t nivcsw;			/* Number of involuntary context switches */
+#endif
 };
 
 /* This structure defines an element of the g_tasklisttable[].
@@ -268,6 +274,20 @@ void weak_function sched_process_cpuload(void);
 void sched_clear_cpuload(pid_t pid);
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+void sched_cpuload_switch(FAR struct tcb_s *rtcb, bool voluntary);
+void sched_cpuload_irqenter(void);
+void sched_cpuload_irqexit(void);
+#else
+#define sched_cpuload_switch(rtcb, voluntary)
+#define sched_cpuload_irqenter()
+#define sched_cpuload_irqexit()
+#endif
+
+#if defined(CONFIG_SCHED_PROFILE) && !defined(CONFIG_SCHED_PROFILE_EXTCLK)
+void weak_function sched_process_profile(void);
+#endif
+
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
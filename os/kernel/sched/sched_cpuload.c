@@ -59,8 +59,10 @@
 #include <errno.h>
 #include <assert.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #include <sys/types.h>
+#include <tinyara/arch.h>
 #include <tinyara/clock.h>
 #include <tinyara/sched.h>
 #include <tinyara/kmalloc.h>
@@ -82,6 +84,10 @@
 #error CONFIG_SCHED_CPULOAD_TICKSPERSEC is not defined
 #endif
 #define CPULOAD_TICKSPERSEC CONFIG_SCHED_CPULOAD_TICKSPERSEC
+#elif defined(CONFIG_SCHED_CPULOAD_HIRES)
+/* The load is accounted in microseconds at context switches */
+
+#define CPULOAD_TICKSPERSEC 1000000
 #else
 #define CPULOAD_TICKSPERSEC CLOCKS_PER_SEC
 #endif
@@ -117,10 +123,171 @@ static int16_t g_cpusnap_head;
 static int16_t g_cpusnap_arr_size;
 static pid_t *g_cpusnap_arr;
 
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+/* The counter value at the last accounting and the part of a microsecond
+ * left over from it.  Counts are converted with a 32.32 fixed point scale.
+ */
+
+static bool g_cpuload_perf;
+static uint32_t g_cpuload_stamp;
+static uint32_t g_cpuload_frac;
+static uint64_t g_cpuload_scale;
+
+static uint8_t g_cpuload_irqnest;
+static uint64_t g_cpuload_irqtime;
+
+/* The share of the total that was spent in interrupts */
+
+static uint32_t g_cpuload_irqticks[SCHED_NCPULOAD];
+
+/* The task with the longest slice since the last tick, for the snapshot */
+
+static pid_t g_cpusnap_pid;
+static uint32_t g_cpusnap_slice;
+#endif
+
 /************************************************************************
  * Private Functions
  ************************************************************************/
 
+/************************************************************************
+ * Name: sched_cpuload_add
+ *
+ * Description:
+ *   Add ticks to the total and to the thread at hash_index, or to the
+ *   interrupts if it is negative, and halve all counts past the time
+ *   constants.
+ *
+ ************************************************************************/
+
+static void sched_cpuload_add(int hash_index, uint32_t ticks)
+{
+	int i;
+	int cpuload_idx;
+
+	for (cpuload_idx = 0; cpuload_idx < SCHED_NCPULOAD; cpuload_idx++) {
+		if (hash_index >= 0) {
+			g_pidhash[hash_index].ticks[cpuload_idx] += ticks;
+		}
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+		if (hash_index < 0) {
+			g_cpuload_irqticks[cpuload_idx] += ticks;
+		}
+#endif
+
+		/* Increment tick count.  If the accumulated tick value exceed a time
+		 * constant, then shift the accumulators.
+		 */
+
+		g_cpuload_total[cpuload_idx] += ticks;
+		if (g_cpuload_total[cpuload_idx] > (g_cpuload_timeconstant[cpuload_idx] * CPULOAD_TICKSPERSEC)) {
+			uint32_t total = 0;
+
+			/* Divide the tick count for every task by two and recalculate the
+			 * total.
+			 */
+			for (i = 0; i < CONFIG_MAX_TASKS; i++) {
+				g_pidhash[i].ticks[cpuload_idx] >>= 1;
+				total += g_pidhash[i].ticks[cpuload_idx];
+			}
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+			g_cpuload_irqticks[cpuload_idx] >>= 1;
+			total += g_cpuload_irqticks[cpuload_idx];
+#endif
+
+			/* Save the new total. */
+
+			g_cpuload_total[cpuload_idx] = total;
+		}
+	}
+}
+
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+/************************************************************************
+ * Name: sched_cpuload_elapsed
+ *
+ * Description:
+ *   Return the microseconds elapsed since the previous call.  The cycle
+ *   counter is used if the architecture has one of a known rate,
+ *   clock_systimer() otherwise.
+ *
+ ************************************************************************/
+
+static uint32_t sched_cpuload_elapsed(void)
+{
+	uint32_t now;
+	uint32_t freq = 0;
+	uint64_t elapsed;
+	bool first = false;
+
+	if (g_cpuload_scale == 0) {
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+		freq = up_perf_getfreq();
+#endif
+		g_cpuload_perf = (freq != 0);
+		if (!g_cpuload_perf) {
+			freq = CLOCKS_PER_SEC;
+		}
+
+		g_cpuload_scale = ((uint64_t)1000000 << 32) / freq;
+		first = true;
+	}
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTER
+	if (g_cpuload_perf) {
+		now = up_perf_gettime();
+	} else
+#endif
+	{
+		now = (uint32_t)clock_systimer();
+	}
+
+	/* Nothing is charged before the first accounting */
+
+	if (first) {
+		g_cpuload_stamp = now;
+	}
+
+	elapsed = (uint64_t)(now - g_cpuload_stamp) * g_cpuload_scale + g_cpuload_frac;
+	g_cpuload_stamp = now;
+	g_cpuload_frac = (uint32_t)elapsed;
+
+	return (uint32_t)(elapsed >> 32);
+}
+
+/************************************************************************
+ * Name: sched_cpuload_charge
+ *
+ * Description:
+ *   Charge the time since the last accounting to the running thread, or
+ *   to the interrupts taken while it was running.  Interrupt time counts
+ *   in the total load only.
+ *
+ ************************************************************************/
+
+static void sched_cpuload_charge(FAR struct tcb_s *rtcb)
+{
+	int hash_index = PIDHASH(rtcb->pid);
+	uint32_t elapsed;
+
+	elapsed = sched_cpuload_elapsed();
+
+	if (g_cpuload_irqnest > 0) {
+		g_pidhash[hash_index].irqtime += elapsed;
+		g_cpuload_irqtime += elapsed;
+		sched_cpuload_add(-1, elapsed);
+	} else {
+		g_pidhash[hash_index].runtime += elapsed;
+		sched_cpuload_add(hash_index, elapsed);
+
+		if (elapsed >= g_cpusnap_slice) {
+			g_cpusnap_slice = elapsed;
+			g_cpusnap_pid = rtcb->pid;
+		}
+	}
+}
+#endif
+
 /************************************************************************
  * Public Functions
  ************************************************************************/
@@ -195,9 +362,82 @@ void sched_clear_cpuload(pid_t pid)
 		g_cpuload_total[cpuload_idx] -= g_pidhash[hash_ndx].ticks[cpuload_idx];
 		g_pidhash[hash_ndx].ticks[cpuload_idx] = 0;
 	}
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+	g_pidhash[hash_ndx].runtime = 0;
+	g_pidhash[hash_ndx].irqtime = 0;
+	g_pidhash[hash_ndx].nvcsw = 0;
+	g_pidhash[hash_ndx].nivcsw = 0;
+#endif
+	irqrestore(flags);
+}
+
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+/************************************************************************
+ * Name: sched_cpuload_switch
+ *
+ * Description:
+ *   Charge the running thread at a context switch. It is called by the
+ *   architecture code and task_exit() once a switch is certain, not by the
+ *   ready-to-run list functions: up_reprioritize_rtr() removes and adds
+ *   back the running task, which may stay at the head.
+ *
+ * Inputs:
+ *   rtcb - The thread giving up the CPU
+ *   voluntary - True if it blocked, yielded or exited, false if it was
+ *     preempted
+ *
+ * Assumptions:
+ *   Called with interrupts disabled, before the switch.
+ *
+ ************************************************************************/
+
+void sched_cpuload_switch(FAR struct tcb_s *rtcb, bool voluntary)
+{
+	int hash_index = PIDHASH(rtcb->pid);
+
+	sched_cpuload_charge(rtcb);
+
+	if (voluntary) {
+		g_pidhash[hash_index].nvcsw++;
+	} else {
+		g_pidhash[hash_index].nivcsw++;
+	}
+}
+
+/************************************************************************
+ * Name: sched_cpuload_irqenter and sched_cpuload_irqexit
+ *
+ * Description:
+ *   Charge the running thread on entry to the outermost interrupt and
+ *   the interrupt time on exit from it.
+ *
+ ************************************************************************/
+
+void sched_cpuload_irqenter(void)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	if (g_cpuload_irqnest == 0) {
+		sched_cpuload_charge(this_task());
+	}
+	g_cpuload_irqnest++;
 	irqrestore(flags);
 }
 
+void sched_cpuload_irqexit(void)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	if (g_cpuload_irqnest == 1) {
+		sched_cpuload_charge(this_task());
+	}
+	g_cpuload_irqnest--;
+	irqrestore(flags);
+}
+#endif
+
 #ifndef CONFIG_SCHED_CPULOAD_EXTCLK
 /************************************************************************
  * Name: sched_process_cpuload
@@ -220,9 +460,9 @@ void sched_clear_cpuload(pid_t pid)
 void weak_function sched_process_cpuload(void)
 {
 	FAR struct tcb_s *rtcb = this_task();
+#ifndef CONFIG_SCHED_CPULOAD_HIRES
 	int hash_index;
-	int i;
-	int cpuload_idx;
+#endif
 
 	/* Increment the count on the currently executing thread
 	 *
@@ -233,6 +473,20 @@ void weak_function sched_process_cpuload(void)
 	 * do this too, but this would require a little more overhead.
 	 */
 
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+	/* The load is accounted at context switches and interrupts.  The
+	 * snapshot gets the thread with the longest slice in this tick, the
+	 * interrupted one has just been charged on entry to this interrupt.
+	 */
+
+	if (g_cpusnap_arr) {
+		g_cpusnap_arr[g_cpusnap_head] = g_cpusnap_slice > 0 ? g_cpusnap_pid : rtcb->pid;
+		if (++g_cpusnap_head >= g_cpusnap_arr_size) {
+			g_cpusnap_head = 0;
+		}
+	}
+	g_cpusnap_slice = 0;
+#else
 	if (g_cpusnap_arr) {
 		g_cpusnap_arr[g_cpusnap_head] = rtcb->pid;
 		if (++g_cpusnap_head >= g_cpusnap_arr_size) {
@@ -241,29 +495,8 @@ void weak_function sched_process_cpuload(void)
 	}
 	hash_index = PIDHASH(rtcb->pid);
 
-	for (cpuload_idx = 0; cpuload_idx < SCHED_NCPULOAD; cpuload_idx++) {
-		g_pidhash[hash_index].ticks[cpuload_idx]++;
-
-		/* Increment tick count.  If the accumulated tick value exceed a time
-		 * constant, then shift the accumulators.
-		 */
-
-		if (++g_cpuload_total[cpuload_idx] > (g_cpuload_timeconstant[cpuload_idx] * CPULOAD_TICKSPERSEC)) {
-			uint32_t total = 0;
-
-			/* Divide the tick count for every task by two and recalculate the
-			 * total.
-			 */
-			for (i = 0; i < CONFIG_MAX_TASKS; i++) {
-				g_pidhash[i].ticks[cpuload_idx] >>= 1;
-				total += g_pidhash[i].ticks[cpuload_idx];
-			}
-
-			/* Save the new total. */
-
-			g_cpuload_total[cpuload_idx] = total;
-		}
-	}
+	sched_cpuload_add(hash_index, 1);
+#endif
 }
 #endif
 
@@ -323,4 +556,69 @@ int clock_cpuload(int pid, int index, FAR struct cpuload_s *cpuload)
 	irqrestore(flags);
 	return ret;
 }
+
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+/****************************************************************************
+ * Function:  clock_cpuload_runtime
+ *
+ * Description:
+ *   Return the run time and context switch counts of the select PID.
+ *
+ * Parameters:
+ *   pid - The task ID of the thread of interest.  pid == 0 is the IDLE thread.
+ *   runtime - The location to return the run time
+ *
+ * Return Value:
+ *   OK (0) on success; -ESRCH if 'pid' no longer refers to a valid thread.
+ *
+ ****************************************************************************/
+
+int clock_cpuload_runtime(int pid, FAR struct cpuload_runtime_s *runtime)
+{
+	irqstate_t flags;
+	int hash_index = PIDHASH(pid);
+	int ret = -ESRCH;
+
+	DEBUGASSERT(runtime);
+
+	flags = irqsave();
+
+	if (g_pidhash[hash_index].tcb && g_pidhash[hash_index].pid == pid) {
+		/* Bring the running thread up to date */
+
+		if (g_pidhash[hash_index].tcb == this_task()) {
+			sched_cpuload_charge(this_task());
+		}
+
+		runtime->runtime = g_pidhash[hash_index].runtime;
+		runtime->irqtime = g_pidhash[hash_index].irqtime;
+		runtime->nvcsw = g_pidhash[hash_index].nvcsw;
+		runtime->nivcsw = g_pidhash[hash_index].nivcsw;
+		ret = OK;
+	}
+
+	irqrestore(flags);
+	return ret;
+}
+
+/****************************************************************************
+ * Function:  clock_cpuload_irqtime
+ *
+ * Description:
+ *   Return the microseconds spent in interrupt handlers since boot.
+ *
+ ****************************************************************************/
+
+uint64_t clock_cpuload_irqtime(void)
+{
+	irqstate_t flags;
+	uint64_t irqtime;
+
+	flags = irqsave();
+	irqtime = g_cpuload_irqtime;
+	irqrestore(flags);
+
+	return irqtime;
+}
+#endif
 #endif							/* CONFIG_SCHED_CPULOAD */
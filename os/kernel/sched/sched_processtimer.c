@@ -216,6 +216,16 @@ void sched_process_timer(void)
 		sched_process_cpuload();
 	}
 #endif
+#if defined(CONFIG_SCHED_PROFILE) && !defined(CONFIG_SCHED_PROFILE_EXTCLK)
+	/* Sample the interrupted code for the profiler */
+
+#ifdef CONFIG_HAVE_WEAKFUNCTIONS
+	if (sched_process_profile != NULL)
+#endif
+	{
+		sched_process_profile();
+	}
+#endif
 
 	/* Check if the currently executing task has exceeded its
 	 * timeslice.
@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/sched.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PROFILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Samples moved per section with interrupts disabled */
+
+#define PROFILE_COPY_SAMPLES 8
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Ring of the latest samples, oldest at g_profile_tail */
+
+static struct profile_sample_s g_profile[CONFIG_SCHED_PROFILE_NSAMPLES];
+static uint16_t g_profile_tail;
+static uint16_t g_profile_count;
+static uint32_t g_profile_lost;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_process_profile
+ *
+ * Description:
+ *   Sample the code interrupted by the timer and the running task. The
+ *   oldest sample is overwritten when the ring is full.
+ *
+ * Assumptions/Limitations:
+ *   This function is called from a timer interrupt handler with all
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+void weak_function sched_process_profile(void)
+{
+	FAR struct profile_sample_s *sample;
+	uint16_t head;
+
+	head = (g_profile_tail + g_profile_count) % CONFIG_SCHED_PROFILE_NSAMPLES;
+	sample = &g_profile[head];
+	if (!up_interrupted_regs(&sample->pc, &sample->lr)) {
+		return;
+	}
+	sample->pid = this_task()->pid;
+
+	if (g_profile_count < CONFIG_SCHED_PROFILE_NSAMPLES) {
+		g_profile_count++;
+	} else {
+		g_profile_tail = (g_profile_tail + 1) % CONFIG_SCHED_PROFILE_NSAMPLES;
+		g_profile_lost++;
+	}
+}
+
+/****************************************************************************
+ * Name: sched_get_profile
+ *
+ * Description:
+ *   Move the samples taken since the last call, oldest first, to samples.
+ *   They are moved a few at a time so the timer interrupt is not held off
+ *   for the copy of the whole ring.
+ *
+ * Inputs:
+ *   samples - Room for CONFIG_SCHED_PROFILE_NSAMPLES samples
+ *   lost - Returns the number of samples overwritten before being read
+ *
+ * Return Value:
+ *   The number of samples
+ *
+ ****************************************************************************/
+
+int sched_get_profile(FAR struct profile_sample_s *samples, FAR uint32_t *lost)
+{
+	irqstate_t flags;
+	int count = 0;
+	int n;
+
+	*lost = 0;
+
+	do {
+		flags = irqsave();
+
+		n = g_profile_count;
+		if (n > PROFILE_COPY_SAMPLES) {
+			n = PROFILE_COPY_SAMPLES;
+		}
+		if (n > CONFIG_SCHED_PROFILE_NSAMPLES - count) {
+			n = CONFIG_SCHED_PROFILE_NSAMPLES - count;
+		}
+
+		g_profile_count -= n;
+		while (n-- > 0) {
+			samples[count++] = g_profile[g_profile_tail];
+			g_profile_tail = (g_profile_tail + 1) % CONFIG_SCHED_PROFILE_NSAMPLES;
+		}
+		*lost += g_profile_lost;
+		g_profile_lost = 0;
+
+		irqrestore(flags);
+	} while (g_profile_count > 0 && count < CONFIG_SCHED_PROFILE_NSAMPLES);
+
+	return count;
+}
+
+#endif							/* CONFIG_SCHED_PROFILE */
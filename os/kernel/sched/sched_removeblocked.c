@@ -58,6 +58,7 @@
 
 #include <queue.h>
 #include <assert.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 
@@ -112,6 +113,8 @@ void sched_removeblocked(FAR struct tcb_s *btcb)
 
 	ASSERT(task_state >= FIRST_BLOCKED_STATE && task_state <= LAST_BLOCKED_STATE);
 
+	ttrace_sched_wakeup(btcb);
+
 	/* Remove the TCB from the blocked task list associated
 	 * with this state
 	 */
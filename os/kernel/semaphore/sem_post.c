@@ -62,6 +62,7 @@
 #include <sched.h>
 #include <tinyara/arch.h>
 #include <tinyara/sched.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -137,6 +138,8 @@ void sem_unblock_task(sem_t *sem, struct tcb_s *htcb)
 #ifdef CONFIG_SEMAPHORE_HISTORY
 			save_semaphore_history(sem, (void *)stcb, SEM_ACQUIRE);
 #endif
+			ttrace_sem_post(sem);
+
 			/* Restart the waiting task. */
 
 			up_unblock_task(stcb);
@@ -62,6 +62,7 @@
 #include <assert.h>
 #include <tinyara/arch.h>
 #include <tinyara/cancelpt.h>
+#include <tinyara/ttrace.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -191,6 +192,7 @@ int sem_wait(FAR sem_t *sem)
 #ifdef CONFIG_SEMAPHORE_HISTORY
 			save_semaphore_history(sem, (void *)rtcb, SEM_WAITING);
 #endif
+			ttrace_sem_block(sem);
 
 			/* If priority inheritance is enabled, then check the priority of
 			 * the holder of the semaphore.
@@ -141,6 +141,7 @@ int task_exit(void)
 {
 	FAR struct tcb_s *dtcb = this_task();
 	FAR struct tcb_s *rtcb;
+	FAR struct tcb_s *ntcb;
 	int ret;
 
 	trace_begin(TTRACE_TAG_TASK, "task_exit");
@@ -159,6 +160,19 @@ int task_exit(void)
 	(void)sched_removereadytorun(dtcb);
 	rtcb = this_task();
 
+	/* Record the switch here, task_terminate() frees dtcb before the pending
+	 * tasks are merged below.  A pending task runs next only if it outranks
+	 * rtcb.
+	 */
+
+	ntcb = (FAR struct tcb_s *)g_pendingtasks.head;
+	if (ntcb == NULL || ntcb->sched_priority <= rtcb->sched_priority) {
+		ntcb = rtcb;
+	}
+
+	sched_cpuload_switch(dtcb, true);
+	ttrace_sched_switch(dtcb, ntcb);
+
 	/* We are now in a bad state -- the head of the ready to run task list
 	 * does not correspond to the thread that is running.  Disabling pre-
 	 * emption on this TCB and marking the new ready-to-run task as not
@@ -177,6 +177,12 @@ static int task_assignpid(FAR struct tcb_s *tcb)
 			for (cpuload_idx = 0; cpuload_idx < SCHED_NCPULOAD; cpuload_idx++) {
 				g_pidhash[hash_ndx].ticks[cpuload_idx] = 0;
 			}
+#endif
+#ifdef CONFIG_SCHED_CPULOAD_HIRES
+			g_pidhash[hash_ndx].runtime = 0;
+			g_pidhash[hash_ndx].irqtime = 0;
+			g_pidhash[hash_ndx].nvcsw = 0;
+			g_pidhash[hash_ndx].nivcsw = 0;
 #endif
 			tcb->pid = next_pid;
 
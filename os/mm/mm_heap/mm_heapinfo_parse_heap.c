@@ -199,6 +199,8 @@ void heapinfo_parse_heap(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 		heap->peak_alloc_size,  (size_t)((uint64_t)(heap->peak_alloc_size) * 100 / heap_size));
 	printf("  - Free (Current)              : %u (%d%%)\n", fordblks, (size_t)((uint64_t)fordblks * 100 / heap_size));
 	printf("  - Reserved                    : %u\n", SIZEOF_MM_ALLOCNODE * 2);
+	printf("  - Realloc (In-place / Moved / Copied) : %u / %u / %u\n",\
+		heap->realloc_inplace, heap->realloc_moved, heap->realloc_copied);
 
 	printf("\n****************************************************************\n");
 	printf("     Details of Heap Usages (Size in Bytes)\n");
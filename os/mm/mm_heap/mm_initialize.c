@@ -261,6 +261,7 @@ int mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart, size_t heapsi
 		heap->alloc_list[i].pid = HEAPINFO_INIT_INFO;
 	}
 	heap->total_alloc_size = heap->peak_alloc_size = 0;
+	heap->realloc_inplace = heap->realloc_moved = heap->realloc_copied = 0;
 #ifdef CONFIG_HEAPINFO_USER_GROUP
 	heapinfo_update_group_info(INVALID_PROCESS_ID, HEAPINFO_INVALID_GROUPID, HEAPINFO_INIT_INFO);
 #endif
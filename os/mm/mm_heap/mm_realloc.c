@@ -91,9 +91,12 @@
  *  If the request is for more space and the current allocation can be
  *  extended, it will be extended by:
  *
- *     (1) Taking the additional space from the following free chunk, or
- *     (2) Taking the additional space from the preceding free chunk.
- *     (3) Or both
+ *     (1) Taking the additional space from the following free chunk.  The
+ *         contents stay where they are, so this is preferred whenever the
+ *         following chunk alone is large enough.
+ *     (2) Otherwise, taking the whole following free chunk (if any) and the
+ *         rest from the preceding free chunk.  The contents are moved down
+ *         with memmove() inside the same region, no second buffer is needed.
  *
  *  If the request is for more space but the current chunk cannot be
  *  extended, then malloc a new buffer, copy the data into the new buffer,
@@ -109,10 +112,11 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 	FAR struct mm_allocnode_s *oldnode;
 #ifndef CONFIG_REALLOC_DISABLE_NEIGHBOR_EXTENSION
 	FAR struct mm_freenode_s  *prev;
-	FAR struct mm_freenode_s  *next;
 #endif
+	FAR struct mm_freenode_s  *next;
 	size_t newsize;
 	size_t oldsize;
+	size_t copysize;
 #ifndef CONFIG_REALLOC_DISABLE_NEIGHBOR_EXTENSION
 	size_t prevsize = 0;
 	size_t nextsize = 0;
@@ -160,13 +164,17 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 	/* Check if this is a request to reduce the size of the allocation. */
 
 	oldsize = oldnode->size;
+	copysize = oldsize - SIZEOF_MM_ALLOCNODE;
+	next = (FAR struct mm_freenode_s *)((FAR char *)oldnode + oldsize);
 
 	if (newsize <= oldsize) {
 		/* Handle the special case where we are not going to change the size
-		 * of the allocation.
+		 * of the allocation.  mm_shrinkchunk() cannot release the tail either
+		 * when it is too small to become a free node and the next chunk is
+		 * in use, so skip the node update in that case as well.
 		 */
 
-		if (newsize < oldsize) {
+		if (newsize < oldsize && ((next->preceding & MM_ALLOC_BIT) == 0 || oldsize - newsize >= SIZEOF_MM_FREENODE)) {
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 			/* modify the current allocated size of old node */
 			heapinfo_subtract_size(heap, oldnode->pid, oldsize);
@@ -182,6 +190,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 			heapinfo_update_total_size(heap, oldnode->size, oldnode->pid);
 #endif
 		}
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+		heap->realloc_inplace++;
+#endif
 
 		/* Then return the original address */
 
@@ -195,7 +206,6 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 	 * best decision
 	 */
 
-	next = (FAR struct mm_freenode_s *)((FAR char *)oldnode + oldnode->size);
 	if ((next->preceding & MM_ALLOC_BIT) == 0) {
 		nextsize = next->size;
 	}
@@ -218,50 +228,17 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 		heapinfo_update_total_size(heap, (-1) * oldsize, oldnode->pid);
 #endif
 
-		/* Check if we can extend into the previous chunk and if the
-		 * previous chunk is smaller than the next chunk.
-		 */
-
-		if (prevsize > 0 && (nextsize >= prevsize || nextsize < 1)) {
-			/* Can we get everything we need from the previous chunk? */
-
-			if (needed > prevsize) {
-				/* No, take the whole previous chunk and get the
-				 * rest that we need from the next chunk.
-				 */
-
-				takeprev = prevsize;
-				takenext = needed - prevsize;
-			} else {
-				/* Yes, take what we need from the previous chunk */
-
-				takeprev = needed;
-				takenext = 0;
-			}
-
-			needed = 0;
-		}
-
-		/* Check if we can extend into the next chunk and if we still need
-		 * more memory.
+		/* Prefer the next chunk, extending into it keeps the contents in
+		 * place.  Fall back to the previous chunk only for what the next
+		 * chunk cannot provide.
 		 */
 
-		if (nextsize > 0 && needed) {
-			/* Can we get everything we need from the next chunk? */
-
-			if (needed > nextsize) {
-				/* No, take the whole next chunk and get the rest that we
-				 * need from the previous chunk.
-				 */
-
-				takeprev = needed - nextsize;
-				takenext = nextsize;
-			} else {
-				/* Yes, take what we need from the previous chunk */
-
-				takeprev = 0;
-				takenext = needed;
-			}
+		if (needed > nextsize) {
+			takeprev = needed - nextsize;
+			takenext = nextsize;
+		} else {
+			takeprev = 0;
+			takenext = needed;
 		}
 
 		/* Extend into the previous free chunk */
@@ -304,12 +281,13 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 			oldnode = newnode;
 			oldsize = newnode->size;
 
-			/* Now we have to move the user contents 'down' in memory.  memcpy should
-			 * should be save for this.
+			/* Now we have to move the user contents 'down' in memory.  The
+			 * source and the destination overlap whenever takeprev is smaller
+			 * than the old chunk, so memcpy is not safe here.
 			 */
 
 			newmem = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
-			memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+			memmove(newmem, oldmem, copysize);
 		}
 
 		/* Extend into the next free chunk */
@@ -359,6 +337,12 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 
 		heapinfo_add_size(heap, oldnode->pid, oldnode->size);
 		heapinfo_update_total_size(heap, oldnode->size, oldnode->pid);
+
+		if (takeprev) {
+			heap->realloc_moved++;
+		} else {
+			heap->realloc_inplace++;
+		}
 #endif
 
 		mm_givesemaphore(heap);
@@ -380,8 +364,13 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 		newmem = (FAR void *)mm_malloc(heap, size);
 #endif
 		if (newmem) {
-			memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+			memcpy(newmem, oldmem, copysize);
 			mm_free(heap, oldmem);
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+			mm_takesemaphore(heap);
+			heap->realloc_copied++;
+			mm_givesemaphore(heap);
+#endif
 		}
 
 		return newmem;
@@ -123,6 +123,37 @@ enum local_state_s {
 	LOCAL_STATE_DISCONNECTED /* Peer disconnected */
 };
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+/* One direction of a connected stream.  The sender copies the data into the
+ * ring and the receiver copies it out, each of them wakes up the other one
+ * directly instead of going through a FIFO.
+ */
+
+struct local_ring_s {
+	uint32_t lr_head;			/* Number of bytes written to the ring */
+	uint32_t lr_tail;			/* Number of bytes read from the ring */
+	uint8_t lr_nrecv;			/* Number of receivers waiting for data */
+	uint8_t lr_nsend;			/* Number of senders waiting for space */
+	bool lr_eof;				/* The sending side is closed */
+	bool lr_epipe;				/* The receiving side is closed */
+	sem_t lr_recvsem;			/* Receivers wait here for data */
+	sem_t lr_sendsem;			/* Senders wait here for space */
+#ifdef HAVE_LOCAL_POLL
+	struct pollfd *lr_recvfds[LOCAL_NPOLLWAITERS];
+	struct pollfd *lr_sendfds[LOCAL_NPOLLWAITERS];
+#endif
+	uint8_t lr_buffer[CONFIG_NET_LOCAL_RING_SIZE];
+};
+
+/* The two rings of a connection, shared by the client and the server */
+
+struct local_rings_s {
+	uint8_t lr_crefs;			/* Number of connections using the rings */
+	struct local_ring_s lr_cs;	/* Client to server */
+	struct local_ring_s lr_sc;	/* Server to client */
+};
+#endif
+
 /* Representation of a local connection.  There are four types of
  * connection structures:
  *
@@ -205,6 +236,14 @@ struct local_conn_s {
 			uint16_t lc_remaining; /* Bytes remaining in the incoming stream */
 		} peer;
 	} u;
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	/* Rings replacing the FIFOs of a connected peer */
+
+	FAR struct local_rings_s *lc_rings;
+	FAR struct local_ring_s *lc_rxring;	/* Incoming data */
+	FAR struct local_ring_s *lc_txring;	/* Outgoing data */
+#endif
 #endif /* CONFIG_NET_LOCAL_STREAM */
 };
 
@@ -666,6 +705,77 @@ int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
  * Name: local_accept_pollnotify
  ****************************************************************************/
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+/****************************************************************************
+ * Name: local_ring_create
+ *
+ * Description:
+ *   Allocate the rings of a new connection for the connecting client.
+ *
+ ****************************************************************************/
+
+int local_ring_create(FAR struct local_conn_s *client);
+
+/****************************************************************************
+ * Name: local_ring_attach
+ *
+ * Description:
+ *   Share the rings of the connecting client with the accepted connection.
+ *
+ ****************************************************************************/
+
+void local_ring_attach(FAR struct local_conn_s *server,
+					   FAR struct local_conn_s *client);
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Detach the connection from its rings, the peer then sees end of file
+ *   when receiving and EPIPE when sending.  The rings are freed with the
+ *   last connection using them.
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn);
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Copy the data into the outgoing ring, waiting for space unless
+ *   'nonblock' is set.
+ *
+ * Returned Value:
+ *   The number of bytes sent or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn, FAR const void *buf,
+						size_t len, bool nonblock);
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Copy what is available in the incoming ring, up to 'len' bytes, waiting
+ *   for data unless 'nonblock' is set.
+ *
+ * Returned Value:
+ *   The number of bytes received, zero at end of file or a negated errno
+ *   value.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+						size_t len, bool nonblock);
+
+#ifdef HAVE_LOCAL_POLL
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+						 FAR struct pollfd *fds, bool setup);
+#endif
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
+
 #ifdef HAVE_LOCAL_POLL
 void local_accept_pollnotify(FAR struct local_conn_s *conn,
 							 pollevent_t eventset);
@@ -191,6 +191,12 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 				conn->lc_path[UNIX_PATH_MAX - 1] = '\0';
 				conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+				/* Share the rings created by the client */
+
+				local_ring_attach(conn, client);
+				ret = OK;
+#else
 				/* Open the server-side write-only FIFO.  This should not
 				 * block.
 				 */
@@ -201,8 +207,10 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 					ndbg("ERROR: Failed to open write-only FIFOs for %s: %d\n",
 						 conn->lc_path, ret);
 				}
+#endif
 			}
 
+#ifndef CONFIG_NET_LOCAL_STREAM_RING
 			/* Do we have a connection?  Is the write-side FIFO opened? */
 
 			if (ret == OK) {
@@ -225,7 +233,10 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
 			if (ret == OK) {
 				DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+			}
+#endif
 
+			if (ret == OK) {
 				/* Return the address family */
 
 				if (addr != NULL) {
@@ -240,6 +251,11 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 				newsock->s_type = SOCK_STREAM;
 				newsock->s_sockif = psock->s_sockif;
 				newsock->s_conn = (FAR void *)conn;
+			} else if (conn) {
+				/* Close what was opened for the failed connection */
+
+				conn->lc_crefs = 0;
+				local_free(conn);
 			}
 
 			/* Signal the client with the result of the connection */
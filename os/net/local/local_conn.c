@@ -156,9 +156,15 @@ void local_free(FAR struct local_conn_s *conn)
 	}
 
 #ifdef CONFIG_NET_LOCAL_STREAM
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	/* Hang up the rings, the peer may still be using them */
+
+	local_ring_release(conn);
+#else
 	/* Destroy all FIFOs associted with the connection */
 
 	local_release_fifos(conn);
+#endif
 	sem_destroy(&conn->lc_waitsem);
 #endif
 
@@ -157,6 +157,18 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 	server->u.server.lc_pending++;
 	DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	/* Create the rings needed for the connection, the server shares them
+	 * when it accepts the connection.
+	 */
+
+	ret = local_ring_create(client);
+	if (ret < 0) {
+		server->u.server.lc_pending--;
+		net_unlock();
+		return ret;
+	}
+#else
 	/* Create the FIFOs needed for the connection */
 
 	ret = local_create_fifos(client);
@@ -182,6 +194,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 	}
 
 	DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+#endif
 
 	/* Set the busy "result" before giving the semaphore. */
 
@@ -213,6 +226,15 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 		goto errout_with_outfd;
 	}
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	client->lc_state = LOCAL_STATE_CONNECTED;
+	return OK;
+
+errout_with_outfd:
+	local_ring_release(client);
+	client->lc_state = LOCAL_STATE_BOUND;
+	return ret;
+#else
 	/* Yes.. open the read-only FIFO */
 
 	ret = local_open_client_rx(client, nonblock);
@@ -234,6 +256,7 @@ errout_with_fifos:
 	local_release_fifos(client);
 	client->lc_state = LOCAL_STATE_BOUND;
 	return ret;
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
 }
 
 /****************************************************************************
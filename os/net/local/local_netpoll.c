@@ -202,6 +202,12 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 		goto pollerr;
 	}
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	if (conn->lc_rxring != NULL) {
+		return local_ring_pollsetup(conn, fds, true);
+	}
+#endif
+
 	switch (fds->events & (POLLIN | POLLOUT)) {
 	case (POLLIN | POLLOUT): {
 		FAR struct pollfd *shadowfds;
@@ -331,6 +337,12 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
 		return OK;
 	}
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	if (conn->lc_rxring != NULL) {
+		return local_ring_pollsetup(conn, fds, false);
+	}
+#endif
+
 	switch (fds->events & (POLLIN | POLLOUT)) {
 	case (POLLIN | POLLOUT): {
 		FAR struct pollfd *shadowfds = fds->priv;
@@ -90,6 +90,7 @@
  *
  ****************************************************************************/
 
+#if !defined(CONFIG_NET_LOCAL_STREAM_RING) || defined(CONFIG_NET_LOCAL_DGRAM)
 static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
 						   FAR size_t *readlen)
 {
@@ -130,6 +131,7 @@ static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
 
 	return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: psock_stream_recvfrom
@@ -170,6 +172,14 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 		return -ENOTCONN;
 	}
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	ret = local_ring_recv(conn, buf, len, _SS_ISNONBLOCK(psock->s_flags));
+	if (ret < 0) {
+		return ret;
+	}
+
+	readlen = ret;
+#else
 	/* The incoming FIFO should be open */
 
 	DEBUGASSERT(conn->lc_infile.f_inode != NULL);
@@ -205,6 +215,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
 	DEBUGASSERT(readlen <= conn->u.peer.lc_remaining);
 	conn->u.peer.lc_remaining -= readlen;
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
 
 	/* Return the address family */
 
@@ -0,0 +1,461 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ * Transport of connected Unix domain stream sockets through a pair of
+ * in-kernel rings instead of named FIFOs: send() copies the data once into
+ * the ring, recv() copies it once out of it and each side wakes up the
+ * other one only when it is actually waiting.
+ *
+ * The ring state is protected with sched_lock(), the rings are never
+ * touched from interrupt handlers.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_STREAM_RING)
+
+#include <sys/types.h>
+#include <string.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
+
+#include "local/local.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LOCAL_RING_SIZE CONFIG_NET_LOCAL_RING_SIZE
+#define LOCAL_RING_MASK (LOCAL_RING_SIZE - 1)
+
+/* The free running head and tail wrap at 2^32, the offset stays right only
+ * if the ring size divides it.
+ */
+#if (LOCAL_RING_SIZE & (LOCAL_RING_SIZE - 1)) != 0
+#error "CONFIG_NET_LOCAL_RING_SIZE must be a power of two"
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void local_ring_init(FAR struct local_ring_s *ring)
+{
+	/* These semaphores are used for signaling and, hence, should not have
+	 * priority inheritance enabled.
+	 */
+
+	sem_init(&ring->lr_recvsem, 0, 0);
+	sem_setprotocol(&ring->lr_recvsem, SEM_PRIO_NONE);
+	sem_init(&ring->lr_sendsem, 0, 0);
+	sem_setprotocol(&ring->lr_sendsem, SEM_PRIO_NONE);
+}
+
+/****************************************************************************
+ * Name: local_ring_wait
+ *
+ * Description:
+ *   Wait on 'sem' until local_ring_wakeup() is called on it.  Called and
+ *   returns with the scheduler locked.
+ *
+ ****************************************************************************/
+
+static int local_ring_wait(FAR sem_t *sem, FAR uint8_t *nwaiters)
+{
+	int ret;
+
+	(*nwaiters)++;
+	sched_unlock();
+
+	ret = sem_wait(sem);
+	if (ret < 0) {
+		ret = -get_errno();
+	}
+
+	sched_lock();
+	if (ret < 0 && *nwaiters > 0) {
+		/* Nobody woke us up, a later wakeup posts once more than needed,
+		 * which only costs a spurious check.
+		 */
+
+		(*nwaiters)--;
+	}
+
+	return ret;
+}
+
+static void local_ring_wakeup(FAR sem_t *sem, FAR uint8_t *nwaiters)
+{
+	while (*nwaiters > 0) {
+		(*nwaiters)--;
+		sem_post(sem);
+	}
+}
+
+#ifdef HAVE_LOCAL_POLL
+static void local_ring_pollnotify(FAR struct pollfd **slots, pollevent_t eventset)
+{
+	FAR struct pollfd *fds;
+	int i;
+
+	for (i = 0; i < LOCAL_NPOLLWAITERS; i++) {
+		fds = slots[i];
+		if (fds) {
+			fds->revents |= (fds->events & eventset) | (eventset & (POLLERR | POLLHUP));
+			if (fds->revents != 0) {
+				nvdbg("Report events: %02x\n", fds->revents);
+				sem_post(fds->sem);
+			}
+		}
+	}
+}
+
+static int local_ring_pollslot(FAR struct pollfd **slots, FAR struct pollfd *fds)
+{
+	int i;
+
+	for (i = 0; i < LOCAL_NPOLLWAITERS; i++) {
+		if (!slots[i]) {
+			slots[i] = fds;
+			return OK;
+		}
+	}
+
+	return -EBUSY;
+}
+
+static void local_ring_pollunslot(FAR struct pollfd **slots, FAR struct pollfd *fds)
+{
+	int i;
+
+	for (i = 0; i < LOCAL_NPOLLWAITERS; i++) {
+		if (slots[i] == fds) {
+			slots[i] = NULL;
+		}
+	}
+}
+#else
+#define local_ring_pollnotify(slots, eventset)
+#endif
+
+/****************************************************************************
+ * Name: local_ring_shutdown
+ *
+ * Description:
+ *   One side of the ring is gone, wake up everybody waiting on the other
+ *   side.
+ *
+ ****************************************************************************/
+
+static void local_ring_shutdown(FAR struct local_ring_s *ring)
+{
+	local_ring_wakeup(&ring->lr_recvsem, &ring->lr_nrecv);
+	local_ring_wakeup(&ring->lr_sendsem, &ring->lr_nsend);
+	if (ring->lr_eof) {
+		local_ring_pollnotify(ring->lr_recvfds, POLLIN | POLLHUP);
+	}
+	if (ring->lr_epipe) {
+		local_ring_pollnotify(ring->lr_sendfds, POLLERR);
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_create
+ ****************************************************************************/
+
+int local_ring_create(FAR struct local_conn_s *client)
+{
+	FAR struct local_rings_s *rings;
+
+	DEBUGASSERT(client->lc_rings == NULL);
+
+	rings = (FAR struct local_rings_s *)kmm_zalloc(sizeof(struct local_rings_s));
+	if (!rings) {
+		ndbg("ERROR: Failed to allocate rings\n");
+		return -ENOMEM;
+	}
+
+	local_ring_init(&rings->lr_cs);
+	local_ring_init(&rings->lr_sc);
+	rings->lr_crefs = 1;
+
+	client->lc_rings = rings;
+	client->lc_rxring = &rings->lr_sc;
+	client->lc_txring = &rings->lr_cs;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_attach
+ ****************************************************************************/
+
+void local_ring_attach(FAR struct local_conn_s *server,
+					   FAR struct local_conn_s *client)
+{
+	FAR struct local_rings_s *rings = client->lc_rings;
+
+	DEBUGASSERT(rings != NULL && server->lc_rings == NULL);
+
+	sched_lock();
+	rings->lr_crefs++;
+	server->lc_rings = rings;
+	server->lc_rxring = &rings->lr_cs;
+	server->lc_txring = &rings->lr_sc;
+	sched_unlock();
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn)
+{
+	FAR struct local_rings_s *rings = conn->lc_rings;
+
+	if (!rings) {
+		return;
+	}
+
+	sched_lock();
+	conn->lc_txring->lr_eof = true;
+	conn->lc_rxring->lr_epipe = true;
+	local_ring_shutdown(conn->lc_txring);
+	local_ring_shutdown(conn->lc_rxring);
+
+	conn->lc_rings = NULL;
+	conn->lc_rxring = NULL;
+	conn->lc_txring = NULL;
+
+	DEBUGASSERT(rings->lr_crefs > 0);
+	if (--rings->lr_crefs > 0) {
+		sched_unlock();
+		return;
+	}
+	sched_unlock();
+
+	sem_destroy(&rings->lr_cs.lr_recvsem);
+	sem_destroy(&rings->lr_cs.lr_sendsem);
+	sem_destroy(&rings->lr_sc.lr_recvsem);
+	sem_destroy(&rings->lr_sc.lr_sendsem);
+	kmm_free(rings);
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn, FAR const void *buf,
+						size_t len, bool nonblock)
+{
+	FAR struct local_ring_s *ring = conn->lc_txring;
+	FAR const uint8_t *src = (FAR const uint8_t *)buf;
+	size_t sent = 0;
+	uint32_t space;
+	uint32_t off;
+	uint32_t n;
+	int ret = OK;
+
+	DEBUGASSERT(ring != NULL);
+
+	sched_lock();
+	while (sent < len) {
+		if (ring->lr_epipe) {
+			ret = -EPIPE;
+			break;
+		}
+
+		space = LOCAL_RING_SIZE - (ring->lr_head - ring->lr_tail);
+		if (space == 0) {
+			if (nonblock) {
+				ret = -EAGAIN;
+				break;
+			}
+
+			ret = local_ring_wait(&ring->lr_sendsem, &ring->lr_nsend);
+			if (ret < 0) {
+				break;
+			}
+			continue;
+		}
+
+		/* Copy up to the end of the buffer, then from its start */
+
+		n = MIN(space, len - sent);
+		off = ring->lr_head & LOCAL_RING_MASK;
+		if (n > LOCAL_RING_SIZE - off) {
+			memcpy(&ring->lr_buffer[off], src + sent, LOCAL_RING_SIZE - off);
+			memcpy(ring->lr_buffer, src + sent + LOCAL_RING_SIZE - off, n - (LOCAL_RING_SIZE - off));
+		} else {
+			memcpy(&ring->lr_buffer[off], src + sent, n);
+		}
+
+		ring->lr_head += n;
+		sent += n;
+
+		local_ring_wakeup(&ring->lr_recvsem, &ring->lr_nrecv);
+		local_ring_pollnotify(ring->lr_recvfds, POLLIN);
+	}
+	sched_unlock();
+
+	return sent > 0 ? (ssize_t)sent : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+						size_t len, bool nonblock)
+{
+	FAR struct local_ring_s *ring = conn->lc_rxring;
+	FAR uint8_t *dst = (FAR uint8_t *)buf;
+	uint32_t avail;
+	uint32_t off;
+	uint32_t n;
+	int ret;
+
+	DEBUGASSERT(ring != NULL);
+
+	sched_lock();
+	while ((avail = ring->lr_head - ring->lr_tail) == 0) {
+		if (ring->lr_eof) {
+			sched_unlock();
+			return 0;
+		}
+
+		if (nonblock) {
+			sched_unlock();
+			return -EAGAIN;
+		}
+
+		ret = local_ring_wait(&ring->lr_recvsem, &ring->lr_nrecv);
+		if (ret < 0) {
+			sched_unlock();
+			return ret;
+		}
+	}
+
+	n = MIN(avail, len);
+	off = ring->lr_tail & LOCAL_RING_MASK;
+	if (n > LOCAL_RING_SIZE - off) {
+		memcpy(dst, &ring->lr_buffer[off], LOCAL_RING_SIZE - off);
+		memcpy(dst + LOCAL_RING_SIZE - off, ring->lr_buffer, n - (LOCAL_RING_SIZE - off));
+	} else {
+		memcpy(dst, &ring->lr_buffer[off], n);
+	}
+
+	ring->lr_tail += n;
+
+	local_ring_wakeup(&ring->lr_sendsem, &ring->lr_nsend);
+	local_ring_pollnotify(ring->lr_sendfds, POLLOUT);
+	sched_unlock();
+
+	return n;
+}
+
+#ifdef HAVE_LOCAL_POLL
+/****************************************************************************
+ * Name: local_ring_pollsetup
+ *
+ * Description:
+ *   Setup or teardown the monitoring of a connection using rings: POLLIN
+ *   waiters are kept in the incoming ring and POLLOUT waiters in the
+ *   outgoing one.
+ *
+ ****************************************************************************/
+
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+						 FAR struct pollfd *fds, bool setup)
+{
+	FAR struct local_ring_s *rx = conn->lc_rxring;
+	FAR struct local_ring_s *tx = conn->lc_txring;
+	pollevent_t eventset = 0;
+	int ret = OK;
+
+	DEBUGASSERT(rx != NULL && tx != NULL);
+
+	sched_lock();
+	if (!setup) {
+		local_ring_pollunslot(rx->lr_recvfds, fds);
+		local_ring_pollunslot(tx->lr_sendfds, fds);
+		fds->priv = NULL;
+		goto out;
+	}
+
+	/* The incoming ring always reports the hangup of the peer */
+
+	ret = local_ring_pollslot(rx->lr_recvfds, fds);
+	if (ret == OK && (fds->events & POLLOUT)) {
+		ret = local_ring_pollslot(tx->lr_sendfds, fds);
+		if (ret < 0) {
+			local_ring_pollunslot(rx->lr_recvfds, fds);
+		}
+	}
+
+	if (ret < 0) {
+		fds->priv = NULL;
+		goto out;
+	}
+
+	fds->priv = conn;
+
+	if (rx->lr_head != rx->lr_tail) {
+		eventset |= POLLIN;
+	}
+	if (rx->lr_eof) {
+		eventset |= POLLIN | POLLHUP;
+	}
+	if (tx->lr_head - tx->lr_tail < LOCAL_RING_SIZE) {
+		eventset |= POLLOUT;
+	}
+	if (tx->lr_epipe) {
+		eventset |= POLLERR;
+	}
+
+	fds->revents |= (fds->events & eventset) | (eventset & (POLLERR | POLLHUP));
+	if (fds->revents != 0) {
+		sem_post(fds->sem);
+	}
+
+out:
+	sched_unlock();
+	return ret;
+}
+#endif /* HAVE_LOCAL_POLL */
+
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL_STREAM_RING */
@@ -63,6 +63,7 @@
 
 #include <tinyara/net/net.h>
 
+#include "socket/socket.h"
 #include "local/local.h"
 
 #ifdef CONFIG_NET_LOCAL_STREAM
@@ -99,6 +100,17 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
 	DEBUGASSERT(psock && psock->s_conn && buf);
 	peer = (FAR struct local_conn_s *)psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	if (peer->lc_state != LOCAL_STATE_CONNECTED || peer->lc_txring == NULL) {
+		ndbg("ERROR: not connected\n");
+		return -ENOTCONN;
+	}
+
+	/* Copy the data into the ring of the peer */
+
+	ret = local_ring_send(peer, buf, len, _SS_ISNONBLOCK(psock->s_flags));
+	return ret;
+#else
 	/* Verify that this is a connected peer socket and that it has opened the
 	 * outgoing FIFO for write-only access.
 	 */
@@ -116,6 +128,7 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
 	/* If the send was successful, then the full packet will have been sent */
 
 	return ret < 0 ? ret : len;
+#endif
 }
 
 #endif /* CONFIG_NET_LOCAL_STREAM */
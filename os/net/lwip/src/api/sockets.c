@@ -822,6 +822,82 @@ int lwip_listen(int s, int backlog)
 	return 0;
 }
 
+/**
+ * Get the buffer to receive from: the one left from the last recv operation
+ * or the next one from the network, a pbuf for TCP and a netbuf otherwise.
+ * The buffer is kept in sock->lastdata until it is consumed.
+ *
+ * @return ERR_WOULDBLOCK if a non-blocking call has nothing to receive
+ */
+static err_t lwip_recv_getbuf(struct lwip_sock *sock, int flags, void **buf)
+{
+	err_t err;
+
+	/* Check if there is data left from the last recv operation. */
+	if (sock->lastdata) {
+		*buf = sock->lastdata;
+		return ERR_OK;
+	}
+
+	/* If this is non-blocking call, then check first */
+	if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) && (sock->rcvevent <= 0)) {
+		return ERR_WOULDBLOCK;
+	}
+
+	/* No data was left from the previous operation, so we try to get
+	   some from the network. */
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		err = netconn_recv_tcp_pbuf(sock->conn, (struct pbuf **)buf);
+	} else {
+		err = netconn_recv(sock->conn, (struct netbuf **)buf);
+	}
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recv_getbuf: netconn_recv err=%d, netbuf=%p\n", err, *buf));
+
+	if (err == ERR_OK) {
+		LWIP_ASSERT("buf != NULL", *buf != NULL);
+		sock->lastdata = *buf;
+	}
+	return err;
+}
+
+/** Fill in the address the data in 'buf' was received from */
+static void lwip_recv_fromaddr(struct lwip_sock *sock, void *buf, struct sockaddr *from, socklen_t *fromlen)
+{
+	u16_t port;
+	ip_addr_t tmpaddr;
+	ip_addr_t *fromaddr;
+	union sockaddr_aligned saddr;
+
+	if (!from || !fromlen) {
+		return;
+	}
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		fromaddr = &tmpaddr;
+		netconn_getaddr(sock->conn, fromaddr, &port, 0);
+	} else {
+		port = netbuf_fromport((struct netbuf *)buf);
+		fromaddr = netbuf_fromaddr((struct netbuf *)buf);
+	}
+
+#if LWIP_IPV4 && LWIP_IPV6
+	/* Dual-stack: Map IPv4 addresses to IPv4 mapped IPv6 */
+	if (NETCONNTYPE_ISIPV6(netconn_type(sock->conn)) && IP_IS_V4(fromaddr)) {
+		ip4_2_ipv4_mapped_ipv6(ip_2_ip6(fromaddr), ip_2_ip4(fromaddr));
+		IP_SET_TYPE(fromaddr, IPADDR_TYPE_V6);
+	}
+#endif							/* LWIP_IPV4 && LWIP_IPV6 */
+
+	IPADDR_PORT_TO_SOCKADDR(&saddr, fromaddr, port);
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recv_fromaddr: addr="));
+	ip_addr_debug_print(SOCKETS_DEBUG, fromaddr);
+	LWIP_DEBUGF(SOCKETS_DEBUG, (" port=%" U16_F "\n", port));
+	if (*fromlen > saddr.sa.sa_len) {
+		*fromlen = saddr.sa.sa_len;
+	}
+	MEMCPY(from, &saddr, *fromlen);
+}
+
 int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen)
 {
 	struct lwip_sock *sock;
@@ -840,55 +916,39 @@ int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from
 
 	do {
 		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom: top while sock->lastdata=%p\n", sock->lastdata));
-		/* Check if there is data left from the last recv operation. */
-		if (sock->lastdata) {
-			buf = sock->lastdata;
-		} else {
-			/* If this is non-blocking call, then check first */
-			if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) && (sock->rcvevent <= 0)) {
-				if (off > 0) {
-					/* already received data, return that */
-					sock_set_errno(sock, 0);
-					return off;
-				}
-				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom(%d): returning EWOULDBLOCK\n", s));
-				set_errno(EWOULDBLOCK);
-				return -1;
+		err = lwip_recv_getbuf(sock, flags, &buf);
+		if (err == ERR_WOULDBLOCK) {
+			if (off > 0) {
+				/* already received data, return that */
+				sock_set_errno(sock, 0);
+				return off;
 			}
+			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom(%d): returning EWOULDBLOCK\n", s));
+			set_errno(EWOULDBLOCK);
+			return -1;
+		}
 
-			/* No data was left from the previous operation, so we try to get
-			   some from the network. */
-			if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
-				err = netconn_recv_tcp_pbuf(sock->conn, (struct pbuf **)&buf);
-			} else {
-				err = netconn_recv(sock->conn, (struct netbuf **)&buf);
-			}
-			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom: netconn_recv err=%d, netbuf=%p\n", err, buf));
-
-			if (err != ERR_OK) {
-				if (off > 0) {
-					if (err == ERR_CLSD) {
-						/* closed but already received data, ensure select gets the FIN, too */
-						event_callback(sock->conn, NETCONN_EVT_RCVPLUS, 0);
-					}
-					/* already received data, return that */
-					sock_set_errno(sock, 0);
-					return off;
-				}
-				/* We should really do some error checking here. */
-				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom(%d): buf == NULL, error is \"%s\"!\n", s, lwip_strerr(err)));
-				sock_set_errno(sock, err_to_errno(err));
+		if (err != ERR_OK) {
+			if (off > 0) {
 				if (err == ERR_CLSD) {
-					// Normal operation, peer ended
-					// TODO: should call lwip_shutdown(s, SHUT_RD)?
-					sock->conn->last_err = ERR_OK;
-					return 0;
-				} else {
-					return -1;
+					/* closed but already received data, ensure select gets the FIN, too */
+					event_callback(sock->conn, NETCONN_EVT_RCVPLUS, 0);
 				}
+				/* already received data, return that */
+				sock_set_errno(sock, 0);
+				return off;
+			}
+			/* We should really do some error checking here. */
+			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom(%d): buf == NULL, error is \"%s\"!\n", s, lwip_strerr(err)));
+			sock_set_errno(sock, err_to_errno(err));
+			if (err == ERR_CLSD) {
+				// Normal operation, peer ended
+				// TODO: should call lwip_shutdown(s, SHUT_RD)?
+				sock->conn->last_err = ERR_OK;
+				return 0;
+			} else {
+				return -1;
 			}
-			LWIP_ASSERT("buf != NULL", buf != NULL);
-			sock->lastdata = buf;
 		}
 
 		if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
@@ -925,36 +985,7 @@ int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from
 
 		/* Check to see from where the data was. */
 		if (done) {
-			if (from && fromlen) {
-				u16_t port;
-				ip_addr_t tmpaddr;
-				ip_addr_t *fromaddr;
-				union sockaddr_aligned saddr;
-				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom(%d): addr=", s));
-				if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
-					fromaddr = &tmpaddr;
-					netconn_getaddr(sock->conn, fromaddr, &port, 0);
-				} else {
-					port = netbuf_fromport((struct netbuf *)buf);
-					fromaddr = netbuf_fromaddr((struct netbuf *)buf);
-				}
-
-#if LWIP_IPV4 && LWIP_IPV6
-				/* Dual-stack: Map IPv4 addresses to IPv4 mapped IPv6 */
-				if (NETCONNTYPE_ISIPV6(netconn_type(sock->conn)) && IP_IS_V4(fromaddr)) {
-					ip4_2_ipv4_mapped_ipv6(ip_2_ip6(fromaddr), ip_2_ip4(fromaddr));
-					IP_SET_TYPE(fromaddr, IPADDR_TYPE_V6);
-				}
-#endif							/* LWIP_IPV4 && LWIP_IPV6 */
-
-				IPADDR_PORT_TO_SOCKADDR(&saddr, fromaddr, port);
-				ip_addr_debug_print(SOCKETS_DEBUG, fromaddr);
-				LWIP_DEBUGF(SOCKETS_DEBUG, (" port=%" U16_F " len=%d\n", port, off));
-				if (*fromlen > saddr.sa.sa_len) {
-					*fromlen = saddr.sa.sa_len;
-				}
-				MEMCPY(from, &saddr, *fromlen);
-			}
+			lwip_recv_fromaddr(sock, buf, from, fromlen);
 		}
 
 		/* If we don't peek the incoming message... */
@@ -985,6 +1016,109 @@ int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from
 	return off;
 }
 
+/* Like lwip_recvfrom(), but instead of copying the data hands out a pointer
+ * into the received pbuf together with a reference on it in '*ref', which
+ * the caller drops with lwip_recv_ref_release() once it is done with the
+ * data. At most one pbuf of a TCP stream is returned per call; a datagram
+ * received in several pbufs is linearized first.
+ */
+int lwip_recv_ref(int s, void **dataptr, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen, void **ref)
+{
+	struct lwip_sock *sock;
+	void *buf = NULL;
+	struct pbuf *p;
+	struct pbuf *q;
+	u16_t offset;
+	u16_t copylen;
+	u8_t is_tcp;
+	err_t err;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recv_ref(%d, %" SZT_F ", 0x%x, ..)\n", s, len, flags));
+	sock = get_socket(s, getpid());
+	if (!sock) {
+		return -1;
+	}
+
+	if (dataptr == NULL || ref == NULL || len == 0) {
+		sock_set_errno(sock, EINVAL);
+		return -1;
+	}
+
+	err = lwip_recv_getbuf(sock, flags, &buf);
+	if (err == ERR_WOULDBLOCK) {
+		set_errno(EWOULDBLOCK);
+		return -1;
+	}
+	if (err != ERR_OK) {
+		sock_set_errno(sock, err_to_errno(err));
+		if (err == ERR_CLSD) {
+			sock->conn->last_err = ERR_OK;
+			return 0;
+		}
+		return -1;
+	}
+
+	is_tcp = (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP);
+	if (is_tcp) {
+		p = (struct pbuf *)buf;
+		offset = sock->lastoffset;
+	} else {
+		p = ((struct netbuf *)buf)->p;
+		offset = 0;
+		if (p->next != NULL) {
+			q = pbuf_coalesce(p, PBUF_RAW);
+			if (q->next != NULL) {
+				/* keep the datagram for a later attempt */
+				sock_set_errno(sock, ENOMEM);
+				return -1;
+			}
+			((struct netbuf *)buf)->p = ((struct netbuf *)buf)->ptr = p = q;
+		}
+	}
+
+	/* Find the pbuf holding the first byte not received yet */
+	for (q = p; offset >= q->len; q = q->next) {
+		offset -= q->len;
+	}
+
+	copylen = q->len - offset;
+	if (len < copylen) {
+		copylen = (u16_t)len;
+	}
+
+	pbuf_ref(q);
+	*ref = q;
+	*dataptr = (u8_t *)q->payload + offset;
+
+	lwip_recv_fromaddr(sock, buf, from, fromlen);
+
+	if ((flags & MSG_PEEK) == 0) {
+		/* The rest of a datagram is discarded like lwip_recvfrom() does */
+		if (is_tcp && (sock->lastoffset + copylen < p->tot_len)) {
+			sock->lastoffset += copylen;
+		} else {
+			sock->lastdata = NULL;
+			sock->lastoffset = 0;
+			if (is_tcp) {
+				pbuf_free(p);
+			} else {
+				netbuf_delete((struct netbuf *)buf);
+			}
+		}
+	}
+
+	sock_set_errno(sock, 0);
+	return copylen;
+}
+
+/* Drop the reference handed out by lwip_recv_ref() */
+void lwip_recv_ref_release(void *ref)
+{
+	if (ref != NULL) {
+		pbuf_free((struct pbuf *)ref);
+	}
+}
+
 int lwip_read(int s, void *mem, size_t len)
 {
 	return lwip_recvfrom(s, mem, len, 0, NULL, NULL);
@@ -995,7 +1129,8 @@ int lwip_recv(int s, void *mem, size_t len, int flags)
 	return lwip_recvfrom(s, mem, len, flags, NULL, NULL);
 }
 
-int lwip_send(int s, const void *data, size_t size, int flags)
+/* copy is NETCONN_COPY, or 0 to let TCP reference 'data' until it is acked */
+static int lwip_send_common(int s, const void *data, size_t size, int flags, u8_t copy)
 {
 	struct lwip_sock *sock;
 	err_t err;
@@ -1018,7 +1153,7 @@ int lwip_send(int s, const void *data, size_t size, int flags)
 #endif							/* (LWIP_UDP || LWIP_RAW) */
 	}
 
-	write_flags = NETCONN_COPY | ((flags & MSG_MORE) ? NETCONN_MORE : 0) | ((flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0);
+	write_flags = copy | ((flags & MSG_MORE) ? NETCONN_MORE : 0) | ((flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0);
 	written = 0;
 	err = netconn_write_partly(sock->conn, data, size, write_flags, &written);
 
@@ -1027,6 +1162,19 @@ int lwip_send(int s, const void *data, size_t size, int flags)
 	return (err == ERR_OK ? (int)written : -1);
 }
 
+int lwip_send(int s, const void *data, size_t size, int flags)
+{
+	return lwip_send_common(s, data, size, flags, NETCONN_COPY);
+}
+
+/* Like lwip_send(), but TCP segments reference 'data' (PBUF_ROM) instead of
+ * copying it, so 'data' must never change or go away, e.g. XIP flash.
+ */
+int lwip_send_ref(int s, const void *data, size_t size, int flags)
+{
+	return lwip_send_common(s, data, size, flags, 0);
+}
+
 int lwip_sendmsg(int s, const struct msghdr *msg, int flags)
 {
 	struct lwip_sock *sock;
@@ -1114,15 +1262,23 @@ int lwip_sendmsg(int s, const struct msghdr *msg, int flags)
 		} else {
 			/* flatten the IO vectors */
 			size_t offset = 0;
+#if LWIP_CHECKSUM_ON_COPY
+			/* sum each IO vector while copying it, a vector starting at an
+			   odd offset has its bytes swapped in the total */
+			u32_t acc = 0;
 			for (i = 0; i < msg->msg_iovlen; i++) {
-				MEMCPY(&((u8_t *) chain_buf->p->payload)[offset], msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+				u16_t chksum = LWIP_CHKSUM_COPY(&((u8_t *) chain_buf->p->payload)[offset], msg->msg_iov[i].iov_base, (u16_t) msg->msg_iov[i].iov_len);
+				if (offset & 1) {
+					chksum = SWAP_BYTES_IN_WORD(chksum);
+				}
+				acc = FOLD_U32T(acc + chksum);
 				offset += msg->msg_iov[i].iov_len;
 			}
-#if LWIP_CHECKSUM_ON_COPY
-			{
-				/* This can be improved by using LWIP_CHKSUM_COPY() and aggregating the checksum for each IO vector */
-				u16_t chksum = ~inet_chksum_pbuf(chain_buf->p);
-				netbuf_set_chksum(chain_buf, chksum);
+			netbuf_set_chksum(chain_buf, (u16_t) FOLD_U32T(acc));
+#else							/* LWIP_CHECKSUM_ON_COPY */
+			for (i = 0; i < msg->msg_iovlen; i++) {
+				MEMCPY(&((u8_t *) chain_buf->p->payload)[offset], msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+				offset += msg->msg_iov[i].iov_len;
 			}
 #endif							/* LWIP_CHECKSUM_ON_COPY */
 			err = ERR_OK;
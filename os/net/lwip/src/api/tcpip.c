@@ -70,6 +70,8 @@
 #include "lwip/api.h"
 #include "lwip/priv/api_msg.h"
 
+#include <string.h>
+
 #define TCPIP_MSG_VAR_REF(name)     API_VAR_REF(name)
 #define TCPIP_MSG_VAR_DECLARE(name) API_VAR_DECLARE(struct tcpip_msg, name)
 #define TCPIP_MSG_VAR_ALLOC(name)   API_VAR_ALLOC(struct tcpip_msg, MEMP_TCPIP_MSG_API, name, ERR_MEM)
@@ -146,6 +148,20 @@ static void tcpip_thread(void *arg)
 			msg->msg.inp.input_fn(msg->msg.inp.p, msg->msg.inp.netif);
 			memp_free(MEMP_TCPIP_MSG_INPKT, msg);
 			break;
+
+		case TCPIP_MSG_INPKT_BATCH: {
+			struct tcpip_inpkt_batch *batch = (struct tcpip_inpkt_batch *)msg;
+			u16_t i;
+
+			LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: PACKET BATCH %p (%u)\n", (void *)msg, batch->num));
+			for (i = 0; i < batch->num; i++) {
+				if (msg->msg.inp.input_fn(batch->p[i], msg->msg.inp.netif) != ERR_OK) {
+					pbuf_free(batch->p[i]);
+				}
+			}
+			memp_free(MEMP_TCPIP_MSG_INPKT_BATCH, batch);
+			break;
+		}
 #endif							/* !LWIP_TCPIP_CORE_LOCKING_INPUT */
 
 #if LWIP_TCPIP_TIMEOUT			// && LWIP_TIMERS
@@ -240,6 +256,78 @@ err_t tcpip_input(struct pbuf *p, struct netif *inp)
 		return tcpip_inpkt(p, inp, ip_input);
 }
 
+/**
+ * Pass several received packets to tcpip_thread for input processing.
+ * The packets are posted as one message (or one per TCPIP_INPKT_BATCH_MAX
+ * packets) and processed in one go, so the thread is woken and the core
+ * is locked once per batch instead of once per packet.
+ *
+ * @param p array of received packets, see tcpip_inpkt()
+ * @param num number of packets in p
+ * @param inp the network interface on which the packets were received
+ * @param input_fn the function processing each packet
+ * @return the number of packets handed over. Packets from p[return value]
+ *         on could not be queued and still belong to the caller.
+ */
+u16_t tcpip_inpkt_batch(struct pbuf **p, u16_t num, struct netif *inp, netif_input_fn input_fn)
+{
+	u16_t done = 0;
+#if LWIP_TCPIP_CORE_LOCKING_INPUT
+	LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_inpkt_batch: %u PACKETS/%p\n", num, (void *)inp));
+	LOCK_TCPIP_CORE();
+	for (; done < num; done++) {
+		if (input_fn(p[done], inp) != ERR_OK) {
+			pbuf_free(p[done]);
+		}
+	}
+	UNLOCK_TCPIP_CORE();
+#else							/* LWIP_TCPIP_CORE_LOCKING_INPUT */
+	struct tcpip_inpkt_batch *batch;
+	u16_t n;
+
+	LWIP_ASSERT("Invalid mbox", sys_mbox_valid_val(mbox));
+
+	while (done < num) {
+		batch = (struct tcpip_inpkt_batch *)memp_malloc(MEMP_TCPIP_MSG_INPKT_BATCH);
+		if (batch == NULL) {
+			break;
+		}
+
+		n = LWIP_MIN(num - done, TCPIP_INPKT_BATCH_MAX);
+		batch->msg.type = TCPIP_MSG_INPKT_BATCH;
+		batch->msg.msg.inp.p = NULL;
+		batch->msg.msg.inp.netif = inp;
+		batch->msg.msg.inp.input_fn = input_fn;
+		batch->num = n;
+		MEMCPY(batch->p, &p[done], n * sizeof(struct pbuf *));
+		if (sys_mbox_trypost(&mbox, &batch->msg) != ERR_OK) {
+			memp_free(MEMP_TCPIP_MSG_INPKT_BATCH, batch);
+			break;
+		}
+		done += n;
+	}
+#endif							/* LWIP_TCPIP_CORE_LOCKING_INPUT */
+	return done;
+}
+
+/**
+ * Batched version of tcpip_input(), see tcpip_inpkt_batch().
+ *
+ * @param p array of received packets
+ * @param num number of packets in p
+ * @param inp the network interface on which the packets were received
+ * @return the number of packets handed over
+ */
+u16_t tcpip_input_batch(struct pbuf **p, u16_t num, struct netif *inp)
+{
+#if LWIP_ETHERNET
+	if (inp->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET)) {
+		return tcpip_inpkt_batch(p, num, inp, ethernet_input);
+	} else
+#endif							/* LWIP_ETHERNET */
+		return tcpip_inpkt_batch(p, num, inp, ip_input);
+}
+
 /**
  * Call a specific function in the thread context of
  * tcpip_thread for easy access synchronization.
@@ -27,7 +27,7 @@
  * \#define LWIP_CHKSUM your_checksum_routine
  *
  * Or you can select from the implementations below by defining
- * LWIP_CHKSUM_ALGORITHM to 1, 2 or 3.
+ * LWIP_CHKSUM_ALGORITHM to 1, 2, 3 or 4.
  */
 
 /*
@@ -269,6 +269,129 @@ u16_t lwip_standard_chksum(const void *dataptr, int len)
 }
 #endif
 
+#if (LWIP_CHKSUM_ALGORITHM == 4)	/* Alternative version #4 */
+/* Add a 32-bit word to a one's complement sum, folding the carry back in */
+#define CHKSUM_ADD32(sum, w) do { \
+	u32_t add_w = (w); \
+	(sum) += add_w; \
+	(sum) += ((sum) < add_w); \
+} while (0)
+
+#if defined(__GNUC__) && defined(__arm__) && (defined(__thumb2__) || !defined(__thumb__))
+/* Sum nblocks blocks of 16 bytes, the carry is chained with adcs */
+static u32_t lwip_chksum_blocks(u32_t sum, const u32_t *pl, int nblocks)
+{
+	u32_t a, b, c, d;
+
+	__asm__ __volatile__(
+		"1:	ldr	%[a], [%[pl]], #4\n"
+		"	ldr	%[b], [%[pl]], #4\n"
+		"	ldr	%[c], [%[pl]], #4\n"
+		"	ldr	%[d], [%[pl]], #4\n"
+		"	adds	%[sum], %[sum], %[a]\n"
+		"	adcs	%[sum], %[sum], %[b]\n"
+		"	adcs	%[sum], %[sum], %[c]\n"
+		"	adcs	%[sum], %[sum], %[d]\n"
+		"	adc	%[sum], %[sum], #0\n"
+		"	subs	%[n], %[n], #1\n"
+		"	bne	1b\n"
+		: [sum] "+r"(sum), [pl] "+r"(pl), [n] "+r"(nblocks), [a] "=&r"(a), [b] "=&r"(b), [c] "=&r"(c), [d] "=&r"(d)
+		:
+		: "cc", "memory");
+
+	return sum;
+}
+#else
+/* The carries pile up in the upper half of a 64-bit accumulator, which
+   compiles to an add with carry pair on 32-bit targets */
+static u32_t lwip_chksum_blocks(u32_t sum, const u32_t *pl, int nblocks)
+{
+	uint64_t acc = sum;
+
+	while (nblocks-- > 0) {
+		acc += pl[0];
+		acc += pl[1];
+		acc += pl[2];
+		acc += pl[3];
+		pl += 4;
+	}
+
+	acc = (acc >> 32) + (u32_t)acc;
+	acc = (acc >> 32) + (u32_t)acc;
+	return (u32_t)acc;
+}
+#endif
+
+/**
+ * Same as version #3, but the inner loop sums 16 bytes at a time. On ARM it
+ * is written in assembly and chains the carry through the flags, elsewhere
+ * the carries are collected in a 64-bit accumulator and folded once.
+ *
+ * @arg start of buffer to be checksummed. May be an odd byte address.
+ * @len number of bytes in the buffer to be checksummed.
+ * @return host order (!) lwip checksum (non-inverted Internet sum)
+ */
+u16_t lwip_standard_chksum(const void *dataptr, int len)
+{
+	const u8_t *pb = (const u8_t *)dataptr;
+	const u16_t *ps;
+	const u32_t *pl;
+	u16_t t = 0;
+	u32_t sum = 0;
+	int odd = ((mem_ptr_t) pb & 1);
+
+	if (odd && len > 0) {
+		((u8_t *)&t)[1] = *pb++;
+		len--;
+	}
+
+	ps = (const u16_t *)(const void *)pb;
+
+	if (((mem_ptr_t) ps & 3) && len > 1) {
+		sum += *ps++;
+		len -= 2;
+	}
+
+	pl = (const u32_t *)(const void *)ps;
+
+	if (len > 15) {
+		sum = lwip_chksum_blocks(sum, pl, len >> 4);
+		pl += (len >> 4) << 2;
+		len &= 15;
+	}
+
+	while (len > 3) {
+		CHKSUM_ADD32(sum, *pl++);
+		len -= 4;
+	}
+
+	/* make room in upper bits */
+	sum = FOLD_U32T(sum);
+
+	ps = (const u16_t *)(const void *)pl;
+
+	if (len > 1) {
+		sum += *ps++;
+		len -= 2;
+	}
+
+	if (len > 0) {
+		((u8_t *)&t)[0] = *(const u8_t *)ps;
+	}
+
+	sum += t;
+
+	sum = FOLD_U32T(sum);
+	sum = FOLD_U32T(sum);
+
+	if (odd) {
+		sum = SWAP_BYTES_IN_WORD(sum);
+	}
+
+	return (u16_t) sum;
+}
+#endif
+
 /** Parts of the pseudo checksum which are common to IPv4 and IPv6 */
 static u16_t inet_cksum_pseudo_base(struct pbuf *p, u8_t proto, u16_t proto_len, u32_t acc)
 {
@@ -601,3 +724,102 @@ u16_t lwip_chksum_copy(void *dst, const void *src, u16_t len)
 	return LWIP_CHKSUM(dst, len);
 }
 #endif							/* (LWIP_CHKSUM_COPY_ALGORITHM == 1) */
+
+#if (LWIP_CHKSUM_COPY_ALGORITHM == 2)	/* Version #2 */
+/** Copy and sum in a single pass, so every byte is loaded only once.
+ * The source is read in aligned words, the destination is written with
+ * word stores when it has the same alignment and with unaligned copies
+ * otherwise. Returns the same value as LWIP_CHKSUM(dst, len).
+ */
+u16_t lwip_chksum_copy(void *dst, const void *src, u16_t len)
+{
+	const u8_t *pb = (const u8_t *)src;
+	u8_t *pd = (u8_t *)dst;
+	const u32_t *pl;
+	u16_t t = 0;
+	u16_t h;
+	u32_t sum = 0;
+	u32_t w;
+	uint64_t acc = 0;
+	int odd = ((mem_ptr_t) pb & 1);
+
+	if (odd && len > 0) {
+		((u8_t *)&t)[1] = *pd++ = *pb++;
+		len--;
+	}
+
+	if (((mem_ptr_t) pb & 3) && len > 1) {
+		h = *(const u16_t *)(const void *)pb;
+		MEMCPY(pd, &h, 2);
+		sum += h;
+		pb += 2;
+		pd += 2;
+		len -= 2;
+	}
+
+	pl = (const u32_t *)(const void *)pb;
+
+	if (((mem_ptr_t) pd & 3) == 0) {
+		u32_t *dl = (u32_t *)(void *)pd;
+
+		while (len > 15) {
+			w = pl[0];
+			dl[0] = w;
+			acc += w;
+			w = pl[1];
+			dl[1] = w;
+			acc += w;
+			w = pl[2];
+			dl[2] = w;
+			acc += w;
+			w = pl[3];
+			dl[3] = w;
+			acc += w;
+			pl += 4;
+			dl += 4;
+			len -= 16;
+		}
+		pd = (u8_t *)dl;
+	}
+
+	while (len > 3) {
+		w = *pl++;
+		MEMCPY(pd, &w, 4);
+		acc += w;
+		pd += 4;
+		len -= 4;
+	}
+
+	/* fold the carries back in, then make room in upper bits */
+	acc = (acc >> 32) + (u32_t)acc;
+	acc = (acc >> 32) + (u32_t)acc;
+	sum = FOLD_U32T((u32_t)acc) + FOLD_U32T(sum);
+	sum = FOLD_U32T(sum);
+
+	pb = (const u8_t *)pl;
+
+	if (len > 1) {
+		h = *(const u16_t *)(const void *)pb;
+		MEMCPY(pd, &h, 2);
+		sum += h;
+		pb += 2;
+		pd += 2;
+		len -= 2;
+	}
+
+	if (len > 0) {
+		((u8_t *)&t)[0] = *pd = *pb;
+	}
+
+	sum += t;
+
+	sum = FOLD_U32T(sum);
+	sum = FOLD_U32T(sum);
+
+	if (odd) {
+		sum = SWAP_BYTES_IN_WORD(sum);
+	}
+
+	return (u16_t) sum;
+}
+#endif							/* (LWIP_CHKSUM_COPY_ALGORITHM == 2) */
@@ -159,6 +159,33 @@ struct netif *ip4_route_src(const ip4_addr_t *dest, const ip4_addr_t *src)
 }
 #endif							/* LWIP_HOOK_IP4_ROUTE_SRC */
 
+#ifdef CONFIG_NET_IP_ROUTE_BY_SOURCE
+/**
+ * LWIP_HOOK_IP4_ROUTE_SRC() implementation: use the netif owning the
+ * source address if dest is on its subnet.
+ *
+ * @param dest the destination IP address
+ * @param src the source IP address, may be NULL
+ * @return the netif owning src, or NULL to fall back to ip4_route()
+ */
+struct netif *ip4_route_by_src(const ip4_addr_t *dest, const ip4_addr_t *src)
+{
+	struct netif *netif;
+
+	if (src == NULL || ip4_addr_isany(src) || ip4_addr_ismulticast(dest)) {
+		return NULL;
+	}
+
+	for (netif = netif_list; netif != NULL; netif = netif->next) {
+		if (netif_is_up(netif) && netif_is_link_up(netif) && ip4_addr_cmp(src, netif_ip4_addr(netif)) && ip4_addr_netcmp(dest, netif_ip4_addr(netif), netif_ip4_netmask(netif))) {
+			return netif;
+		}
+	}
+
+	return NULL;
+}
+#endif							/* CONFIG_NET_IP_ROUTE_BY_SOURCE */
+
 /**
  * Finds the appropriate network interface for a given IP address. It
  * searches the list of network interfaces linearly. A match is found
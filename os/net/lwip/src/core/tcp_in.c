@@ -99,6 +99,13 @@ static u8_t flags;
 static u8_t recv_flags;
 static struct pbuf *recv_data;
 
+#if LWIP_TCP_SACK
+/* SACK blocks of the incoming segment (host byte order), set by tcp_parseopt() */
+static u32_t tcp_sack_left[LWIP_TCP_MAX_SACK_NUM];
+static u32_t tcp_sack_right[LWIP_TCP_MAX_SACK_NUM];
+static u8_t tcp_sack_num;
+#endif
+
 struct tcp_pcb *tcp_input_pcb;
 
 /* Forward declarations. */
@@ -108,6 +115,9 @@ static void tcp_parseopt(struct tcp_pcb *pcb);
 
 static void tcp_listen_input(struct tcp_pcb_listen *pcb);
 static void tcp_timewait_input(struct tcp_pcb *pcb);
+#if LWIP_TCP_SACK
+static void tcp_sack_mark(struct tcp_pcb *pcb);
+#endif
 
 /**
  * The initial input processing of TCP. It verifies the TCP header, demultiplexes
@@ -977,6 +987,36 @@ static void tcp_oos_insert_segment(struct tcp_seg *cseg, struct tcp_seg *next)
  *
  * Called from tcp_process().
  */
+#if LWIP_TCP_SACK
+/**
+ * Update the SACK scoreboard: mark the unacked segments covered by one of
+ * the SACK blocks of the incoming segment.
+ *
+ * @param pcb the tcp_pcb for which a segment arrived
+ */
+static void tcp_sack_mark(struct tcp_pcb *pcb)
+{
+	struct tcp_seg *seg;
+	u32_t left;
+	u32_t right;
+	u8_t i;
+
+	for (i = 0; i < tcp_sack_num; i++) {
+		for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+			left = lwip_ntohl(seg->tcphdr->seqno);
+			right = left + TCP_TCPLEN(seg);
+			if (TCP_SEQ_GEQ(left, tcp_sack_right[i])) {
+				/* unacked is sorted, the next ones are right of the block */
+				break;
+			}
+			if (TCP_SEQ_GEQ(left, tcp_sack_left[i]) && TCP_SEQ_LEQ(right, tcp_sack_right[i])) {
+				seg->flags |= TF_SEG_SACKED;
+			}
+		}
+	}
+}
+#endif							/* LWIP_TCP_SACK */
+
 static void tcp_receive(struct tcp_pcb *pcb)
 {
 	struct tcp_seg *next;
@@ -988,6 +1028,9 @@ static void tcp_receive(struct tcp_pcb *pcb)
 	u32_t right_wnd_edge;
 	u16_t new_tot_len;
 	int found_dupack = 0;
+#if LWIP_TCP_SACK
+	int sack_partial = 0;
+#endif
 #if TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS
 	u32_t ooseq_blen;
 	u16_t ooseq_qlen;
@@ -997,6 +1040,9 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 	if (flags & TCP_ACK) {
 		right_wnd_edge = pcb->snd_wnd + pcb->snd_wl2;
+#if LWIP_TCP_SACK
+		tcp_sack_mark(pcb);
+#endif
 
 		/* Update window. */
 		if (TCP_SEQ_LT(pcb->snd_wl1, seqno) || (pcb->snd_wl1 == seqno && TCP_SEQ_LT(pcb->snd_wl2, ackno)) || (pcb->snd_wl2 == ackno && (u32_t) SND_WND_SCALE(pcb, tcphdr->wnd) > pcb->snd_wnd)) {
@@ -1071,6 +1117,12 @@ static void tcp_receive(struct tcp_pcb *pcb)
 								/* Do fast retransmit */
 								tcp_rexmit_fast(pcb);
 							}
+#if LWIP_TCP_SACK
+							if (pcb->dupacks > 3 && (pcb->flags & (TF_SACK | TF_INFR)) == (TF_SACK | TF_INFR)) {
+								/* Retransmit the next hole reported by the receiver */
+								tcp_rexmit_sack(pcb);
+							}
+#endif
 						}
 					}
 				}
@@ -1087,8 +1139,17 @@ static void tcp_receive(struct tcp_pcb *pcb)
 			   in fast retransmit. Also reset the congestion window to the
 			   slow start threshold. */
 			if (pcb->flags & TF_INFR) {
-				pcb->flags &= ~TF_INFR;
-				pcb->cwnd = pcb->ssthresh;
+#if LWIP_TCP_SACK
+				if ((pcb->flags & TF_SACK) && TCP_SEQ_LT(ackno, pcb->sack_recover)) {
+					/* Partial ACK: stay in fast recovery, the segment at ackno
+					   was lost as well (RFC 6675) */
+					sack_partial = 1;
+				} else
+#endif
+				{
+					pcb->flags &= ~TF_INFR;
+					pcb->cwnd = pcb->ssthresh;
+				}
 			}
 
 			/* Reset the number of retransmissions. */
@@ -1103,6 +1164,11 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			/* Update the congestion control variables (cwnd and
 			   ssthresh). */
+#if LWIP_TCP_SACK
+			if (sack_partial) {
+				/* no cwnd growth during fast recovery */
+			} else
+#endif
 			if (pcb->state >= ESTABLISHED) {
 				if (pcb->cwnd < pcb->ssthresh) {
 					if ((tcpwnd_size_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
@@ -1140,6 +1206,17 @@ static void tcp_receive(struct tcp_pcb *pcb)
 				}
 			}
 
+#if LWIP_TCP_SACK
+			if (sack_partial && pcb->unacked != NULL) {
+				if (!(pcb->unacked->flags & (TF_SEG_SACKED | TF_SEG_SACK_REXMIT))) {
+					pcb->unacked->flags |= TF_SEG_SACK_REXMIT;
+					tcp_rexmit(pcb);
+				} else {
+					tcp_rexmit_sack(pcb);
+				}
+			}
+#endif
+
 			/* If there's nothing left to acknowledge, stop the retransmit
 			   timer, otherwise reset it to start again */
 			if (pcb->unacked == NULL) {
@@ -1453,6 +1530,12 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 				/* Acknowledge the segment(s). */
 				tcp_ack(pcb);
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+				if ((pcb->flags & TF_SACK) && pcb->ooseq != NULL) {
+					/* A hole is left: report the out of sequence data at once */
+					tcp_ack_now(pcb);
+				}
+#endif
 
 #if LWIP_IPV6 && LWIP_ND6_TCP_REACHABILITY_HINTS
 				if (ip_current_is_v6()) {
@@ -1463,7 +1546,9 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			} else {
 				/* We get here if the incoming segment is out-of-sequence. */
+#if !(LWIP_TCP_SACK && TCP_QUEUE_OOSEQ)
 				tcp_send_empty_ack(pcb);
+#endif
 #if TCP_QUEUE_OOSEQ
 				/* We queue the segment on the ->ooseq queue. */
 				if (pcb->ooseq == NULL) {
@@ -1604,6 +1689,11 @@ static void tcp_receive(struct tcp_pcb *pcb)
 					}
 				}
 #endif							/* TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS */
+#if LWIP_TCP_SACK
+				/* The duplicate ACK reports the segment now queued first */
+				pcb->sack_last = seqno;
+				tcp_send_empty_ack(pcb);
+#endif
 #endif							/* TCP_QUEUE_OOSEQ */
 			}
 		} else {
@@ -1645,6 +1735,13 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 #if LWIP_TCP_TIMESTAMPS
 	u32_t tsval;
 #endif
+#if LWIP_TCP_SACK
+	u32_t left;
+	u32_t right;
+	u8_t i;
+
+	tcp_sack_num = 0;
+#endif
 
 	/* Parse the TCP MSS option, if present. */
 	if (tcphdr_optlen != 0) {
@@ -1722,6 +1819,45 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 				/* Advance to next option (6 bytes already read) */
 				tcp_optidx += LWIP_TCP_OPT_LEN_TS - 6;
 				break;
+#endif
+#if LWIP_TCP_SACK
+			case LWIP_TCP_OPT_SACK_PERM:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK_PERM\n"));
+				if (tcp_getoptbyte() != LWIP_TCP_OPT_LEN_SACK_PERM || (tcp_optidx - 2 + LWIP_TCP_OPT_LEN_SACK_PERM) > tcphdr_optlen) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				if (flags & TCP_SYN) {
+					/* The remote host accepts SACK blocks, send them from now on. */
+					pcb->flags |= TF_SACK;
+				}
+				break;
+			case LWIP_TCP_OPT_SACK:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK\n"));
+				data = tcp_getoptbyte();
+				if (data < 10 || ((data - 2) % 8) != 0 || (tcp_optidx - 2 + data) > tcphdr_optlen) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				for (i = 0; i < (data - 2) / 8; i++) {
+					left = (u32_t)tcp_getoptbyte() << 24;
+					left |= (u32_t)tcp_getoptbyte() << 16;
+					left |= (u32_t)tcp_getoptbyte() << 8;
+					left |= tcp_getoptbyte();
+					right = (u32_t)tcp_getoptbyte() << 24;
+					right |= (u32_t)tcp_getoptbyte() << 16;
+					right |= (u32_t)tcp_getoptbyte() << 8;
+					right |= tcp_getoptbyte();
+					/* Only keep blocks of data sent and not cumulatively acknowledged yet */
+					if ((pcb->flags & TF_SACK) && !(flags & TCP_SYN) && tcp_sack_num < LWIP_TCP_MAX_SACK_NUM && TCP_SEQ_LT(left, right) && TCP_SEQ_GT(left, ackno) && TCP_SEQ_LEQ(right, pcb->snd_nxt)) {
+						tcp_sack_left[tcp_sack_num] = left;
+						tcp_sack_right[tcp_sack_num] = right;
+						tcp_sack_num++;
+					}
+				}
+				break;
 #endif
 			default:
 				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: other\n"));
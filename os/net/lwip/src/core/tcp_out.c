@@ -781,6 +781,12 @@ err_t tcp_enqueue_flags(struct tcp_pcb *pcb, u8_t flags)
 			optflags |= TF_SEG_OPTS_WND_SCALE;
 		}
 #endif							/* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+		if ((pcb->state != SYN_RCVD) || (pcb->flags & TF_SACK)) {
+			/* Same for SACK permitted, only reply with it if the remote host sent it. */
+			optflags |= TF_SEG_OPTS_SACK_PERM;
+		}
+#endif							/* LWIP_TCP_SACK */
 	}
 #if LWIP_TCP_TIMESTAMPS
 	if ((pcb->flags & TF_TIMESTAMP)) {
@@ -869,6 +875,70 @@ static void tcp_build_wnd_scale_option(u32_t *opts)
 }
 #endif
 
+#if LWIP_TCP_SACK
+/** Build a SACK permitted option (2 bytes long) at the specified options pointer)
+ *
+ * @param opts option pointer where to store the SACK permitted option
+ */
+static void tcp_build_sack_perm_option(u32_t *opts)
+{
+	/* Pad with two NOP options to make everything nicely aligned */
+	opts[0] = PP_HTONL(0x01010402);
+}
+
+#if TCP_QUEUE_OOSEQ
+/** Build a SACK option reporting the out of sequence data of the pcb
+ *
+ * The block holding the most recently queued segment goes first (RFC 2018,
+ * section 4), the other ones follow in sequence order. Contiguous segments
+ * on ooseq are reported as one block.
+ *
+ * @param pcb tcp_pcb
+ * @param opts option pointer where to store the SACK option, NULL to only
+ *        count the blocks
+ * @return number of blocks
+ */
+static u8_t tcp_build_sack_option(struct tcp_pcb *pcb, u32_t *opts)
+{
+	struct tcp_seg *seg;
+	u32_t left;
+	u32_t right;
+	u8_t max = LWIP_TCP_SACK_NUM_OUT(pcb);
+	u8_t num = 0;
+	u8_t pass;
+
+	for (pass = 0; pass < 2; pass++) {
+		seg = pcb->ooseq;
+		while (seg != NULL && num < max) {
+			/* ooseq segments keep their header in host byte order */
+			left = seg->tcphdr->seqno;
+			right = left + TCP_TCPLEN(seg);
+			for (seg = seg->next; seg != NULL && seg->tcphdr->seqno == right; seg = seg->next) {
+				right += TCP_TCPLEN(seg);
+			}
+			if ((TCP_SEQ_GEQ(pcb->sack_last, left) && TCP_SEQ_LT(pcb->sack_last, right)) != (pass == 0)) {
+				continue;
+			}
+			if (opts != NULL) {
+				opts[1 + 2 * num] = lwip_htonl(left);
+				opts[2 + 2 * num] = lwip_htonl(right);
+			}
+			num++;
+			if (pass == 0) {
+				break;
+			}
+		}
+	}
+
+	if (opts != NULL && num > 0) {
+		/* Pad with two NOP options to make everything nicely aligned */
+		opts[0] = lwip_htonl(0x01010500 | (2 + 8 * num));
+	}
+	return num;
+}
+#endif							/* TCP_QUEUE_OOSEQ */
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Send an ACK without data.
  *
@@ -880,15 +950,26 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 	struct pbuf *p;
 	u8_t optlen = 0;
 	struct netif *netif;
-#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP
+#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || (LWIP_TCP_SACK && TCP_QUEUE_OOSEQ)
 	struct tcp_hdr *tcphdr;
-#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP */
+#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || (LWIP_TCP_SACK && TCP_QUEUE_OOSEQ) */
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	u8_t sack_num = 0;
+#endif
 
 #if LWIP_TCP_TIMESTAMPS
 	if (pcb->flags & TF_TIMESTAMP) {
 		optlen = LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS);
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	if ((pcb->flags & TF_SACK) && pcb->ooseq != NULL) {
+		sack_num = tcp_build_sack_option(pcb, NULL);
+		if (sack_num > 0) {
+			optlen += LWIP_TCP_OPT_LEN_SACK_OUT(sack_num);
+		}
+	}
+#endif
 
 	p = tcp_output_alloc_header(pcb, optlen, 0, lwip_htonl(pcb->snd_nxt));
 	if (p == NULL) {
@@ -897,9 +978,9 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output: (ACK) could not allocate pbuf\n"));
 		return ERR_BUF;
 	}
-#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP
+#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || (LWIP_TCP_SACK && TCP_QUEUE_OOSEQ)
 	tcphdr = (struct tcp_hdr *)p->payload;
-#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP */
+#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || (LWIP_TCP_SACK && TCP_QUEUE_OOSEQ) */
 	LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output: sending ACK for %" U32_F "\n", pcb->rcv_nxt));
 
 	/* NB. MSS option is only sent on SYNs, so ignore it here */
@@ -910,6 +991,12 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		tcp_build_timestamp_option(pcb, (u32_t *)(tcphdr + 1));
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	if (sack_num > 0) {
+		/* the SACK option follows the timestamp option, if any */
+		tcp_build_sack_option(pcb, (u32_t *)(void *)((u8_t *)(tcphdr + 1) + optlen - LWIP_TCP_OPT_LEN_SACK_OUT(sack_num)));
+	}
+#endif
 
 	netif = ip_route(&pcb->local_ip, &pcb->remote_ip);
 	if (netif == NULL) {
@@ -1173,6 +1260,12 @@ static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct
 		opts += 1;
 	}
 #endif
+#if LWIP_TCP_SACK
+	if (seg->flags & TF_SEG_OPTS_SACK_PERM) {
+		tcp_build_sack_perm_option(opts);
+		opts += 1;
+	}
+#endif
 
 	/* Set retransmission timer running if it is not currently enabled
 	   This must be set before checking the route. */
@@ -1319,7 +1412,15 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 	}
 
 	/* Move all unacked segments to the head of the unsent queue */
-	for (seg = pcb->unacked; seg->next != NULL; seg = seg->next) ;
+	for (seg = pcb->unacked; seg->next != NULL; seg = seg->next) {
+#if LWIP_TCP_SACK
+		/* the receiver may discard data it has SACKed (RFC 2018, section 8) */
+		seg->flags &= ~(TF_SEG_SACKED | TF_SEG_SACK_REXMIT);
+#endif
+	}
+#if LWIP_TCP_SACK
+	seg->flags &= ~(TF_SEG_SACKED | TF_SEG_SACK_REXMIT);
+#endif
 	/* concatenate unsent queue after unacked queue */
 	seg->next = pcb->unsent;
 #if TCP_OVERSIZE_DBGCHECK
@@ -1346,26 +1447,16 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 }
 
 /**
- * Requeue the first unacked segment for retransmission
+ * Requeue a segment taken off the unacked queue for retransmission
  *
- * Called by tcp_receive() for fast retramsmit.
- *
- * @param pcb the tcp_pcb for which to retransmit the first unacked segment
+ * @param pcb the tcp_pcb the segment belongs to
+ * @param seg the segment, already removed from pcb->unacked
  */
-void tcp_rexmit(struct tcp_pcb *pcb)
+void tcp_rexmit_seg(struct tcp_pcb *pcb, struct tcp_seg *seg)
 {
-	struct tcp_seg *seg;
 	struct tcp_seg **cur_seg;
 
-	if (pcb->unacked == NULL) {
-		return;
-	}
-
-	/* Move the first unacked segment to the unsent queue */
 	/* Keep the unsent queue sorted. */
-	seg = pcb->unacked;
-	pcb->unacked = seg->next;
-
 	cur_seg = &(pcb->unsent);
 	while (*cur_seg && TCP_SEQ_LT(lwip_ntohl((*cur_seg)->tcphdr->seqno), lwip_ntohl(seg->tcphdr->seqno))) {
 		cur_seg = &((*cur_seg)->next);
@@ -1392,6 +1483,67 @@ void tcp_rexmit(struct tcp_pcb *pcb)
 	   and thus tcp_output directly returns. */
 }
 
+/**
+ * Requeue the first unacked segment for retransmission
+ *
+ * Called by tcp_receive() for fast retramsmit.
+ *
+ * @param pcb the tcp_pcb for which to retransmit the first unacked segment
+ */
+void tcp_rexmit(struct tcp_pcb *pcb)
+{
+	struct tcp_seg *seg;
+
+	if (pcb->unacked == NULL) {
+		return;
+	}
+
+	/* Move the first unacked segment to the unsent queue */
+	seg = pcb->unacked;
+	pcb->unacked = seg->next;
+	tcp_rexmit_seg(pcb, seg);
+}
+
+#if LWIP_TCP_SACK
+/**
+ * Requeue the first hole reported by the SACK scoreboard for retransmission
+ *
+ * A hole is an unacked segment that is neither SACKed nor retransmitted in
+ * this fast recovery yet, and that is followed by a SACKed segment.
+ *
+ * Called by tcp_receive() during fast recovery.
+ *
+ * @param pcb the tcp_pcb for which to retransmit a hole
+ * @return ERR_OK if a segment was requeued, ERR_VAL if there is no hole
+ */
+err_t tcp_rexmit_sack(struct tcp_pcb *pcb)
+{
+	struct tcp_seg **hole = NULL;
+	struct tcp_seg **cur_seg;
+	struct tcp_seg *seg;
+
+	for (cur_seg = &(pcb->unacked); *cur_seg != NULL; cur_seg = &((*cur_seg)->next)) {
+		if ((*cur_seg)->flags & TF_SEG_SACKED) {
+			if (hole != NULL) {
+				break;
+			}
+		} else if (hole == NULL && !((*cur_seg)->flags & TF_SEG_SACK_REXMIT)) {
+			hole = cur_seg;
+		}
+	}
+	if (hole == NULL || *cur_seg == NULL) {
+		return ERR_VAL;
+	}
+
+	seg = *hole;
+	*hole = seg->next;
+	seg->flags |= TF_SEG_SACK_REXMIT;
+	LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_rexmit_sack: retransmit %" U32_F "\n", lwip_ntohl(seg->tcphdr->seqno)));
+	tcp_rexmit_seg(pcb, seg);
+	return ERR_OK;
+}
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Handle retransmission after three dupacks received
  *
@@ -1402,6 +1554,11 @@ void tcp_rexmit_fast(struct tcp_pcb *pcb)
 	if (pcb->unacked != NULL && !(pcb->flags & TF_INFR)) {
 		/* This is fast retransmit. Retransmit the first unacked segment. */
 		LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_receive: dupacks %" U16_F " (%" U32_F "), fast retransmit %" U32_F "\n", (u16_t) pcb->dupacks, pcb->lastack, lwip_ntohl(pcb->unacked->tcphdr->seqno)));
+#if LWIP_TCP_SACK
+		/* Recovery ends once everything sent so far is acknowledged */
+		pcb->sack_recover = pcb->snd_nxt;
+		pcb->unacked->flags |= TF_SEG_SACK_REXMIT;
+#endif
 		tcp_rexmit(pcb);
 
 		/* Set ssthresh to half of the minimum of the current
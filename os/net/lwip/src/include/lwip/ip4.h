@@ -82,6 +82,9 @@ extern "C" {
 struct netif *ip4_route(const ip4_addr_t * dest);
 #if LWIP_IPV4_SRC_ROUTING
 struct netif *ip4_route_src(const ip4_addr_t * dest, const ip4_addr_t * src);
+#ifdef CONFIG_NET_IP_ROUTE_BY_SOURCE
+struct netif *ip4_route_by_src(const ip4_addr_t * dest, const ip4_addr_t * src);
+#endif
 #else							/* LWIP_IPV4_SRC_ROUTING */
 #define ip4_route_src(dest, src) ip4_route(dest)
 #endif							/* LWIP_IPV4_SRC_ROUTING */
@@ -244,6 +244,10 @@
 #define IP_FORWARD                      0
 #endif
 
+#ifdef CONFIG_NET_IP_ROUTE_BY_SOURCE
+#define LWIP_HOOK_IP4_ROUTE_SRC(dest, src) ip4_route_by_src(dest, src)
+#endif
+
 #ifdef CONFIG_NET_IP_OPTIONS_ALLOWED
 #define IP_OPTIONS_ALLOWED              1
 #else
@@ -279,6 +283,17 @@
 
 /* ---------- IP options ---------- */
 
+/* ---------- Checksum options ---------- */
+#ifdef CONFIG_NET_LWIP_CHKSUM_OPTIMIZED
+#define LWIP_CHKSUM_ALGORITHM          4
+#endif
+
+#ifdef CONFIG_NET_LWIP_CHECKSUM_ON_COPY
+#define LWIP_CHECKSUM_ON_COPY          1
+#define LWIP_CHKSUM_COPY_ALGORITHM     2
+#endif
+/* ---------- Checksum options ---------- */
+
 /* ---------- IPv6 options ---------- */
 #ifdef CONFIG_NET_IPv6
 #define LWIP_IPV6			CONFIG_NET_IPv6
@@ -432,6 +447,16 @@
 #define TCP_TIMESTAMPS	CONFIG_NET_TCP_TIMESTAMPS
 #endif
 
+#ifdef CONFIG_NET_TCP_WND_SCALE
+#define LWIP_WND_SCALE	1
+#define TCP_RCV_SCALE	CONFIG_NET_TCP_RCV_SCALE
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+#define LWIP_TCP_SACK	1
+#define LWIP_TCP_MAX_SACK_NUM	CONFIG_NET_TCP_MAX_SACK_NUM
+#endif
+
 #ifdef CONFIG_NET_TCP_KEEPALIVE
 #define LWIP_TCP_KEEPALIVE              CONFIG_NET_TCP_KEEPALIVE
 #endif
@@ -593,6 +618,10 @@
 #define MEMP_NUM_TCPIP_MSG_INPKT	CONFIG_NET_MEMP_NUM_TCPIP_MSG_INPKT
 #endif
 
+#ifdef CONFIG_NET_MEMP_NUM_TCPIP_MSG_INPKT_BATCH
+#define MEMP_NUM_TCPIP_MSG_INPKT_BATCH	CONFIG_NET_MEMP_NUM_TCPIP_MSG_INPKT_BATCH
+#endif
+
 #ifdef CONFIG_NET_MEMP_NUM_SNMP_NODE
 #define MEMP_NUM_SNMP_NODE	CONFIG_NET_MEMP_NUM_SNMP_NODE
 #endif
@@ -831,6 +860,10 @@
 #define TCPIP_MBOX_SIZE	CONFIG_NET_TCPIP_MBOX_SIZE
 #endif
 
+#ifdef CONFIG_NET_TCPIP_INPKT_BATCH_MAX
+#define TCPIP_INPKT_BATCH_MAX	CONFIG_NET_TCPIP_INPKT_BATCH_MAX
+#endif
+
 /* ---------- Mailbox options ---------- */
 
 /* ---------- Debug options ---------- */
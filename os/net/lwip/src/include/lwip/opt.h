@@ -464,6 +464,15 @@
 #define MEMP_NUM_TCPIP_MSG_INPKT        8
 #endif
 
+/**
+ * MEMP_NUM_TCPIP_MSG_INPKT_BATCH: the number of struct tcpip_inpkt_batch,
+ * which are used for batches of incoming packets.
+ * (only needed if you use tcpip.c)
+ */
+#ifndef MEMP_NUM_TCPIP_MSG_INPKT_BATCH
+#define MEMP_NUM_TCPIP_MSG_INPKT_BATCH  2
+#endif
+
 /**
  * MEMP_NUM_NETDB: the number of concurrently running lwip_addrinfo() calls
  * (before freeing the corresponding memory using lwip_freeaddrinfo()).
@@ -1316,6 +1325,22 @@
 #define LWIP_WND_SCALE                  0
 #define TCP_RCV_SCALE                   0
 #endif
+
+/**
+ * LWIP_TCP_SACK==1: Support the TCP selective acknowledgement option
+ * (RFC 2018). Needs TCP_QUEUE_OOSEQ to report out-of-sequence data.
+ */
+#ifndef LWIP_TCP_SACK
+#define LWIP_TCP_SACK                   0
+#endif
+
+/**
+ * LWIP_TCP_MAX_SACK_NUM: The maximum number of SACK blocks sent in an
+ * ACK and kept from a received one (1..4, 3 with timestamps).
+ */
+#ifndef LWIP_TCP_MAX_SACK_NUM
+#define LWIP_TCP_MAX_SACK_NUM           4
+#endif
 /**
  * @}
  */
@@ -1553,6 +1578,14 @@
 #define TCPIP_MBOX_SIZE                 0
 #endif
 
+/**
+ * TCPIP_INPKT_BATCH_MAX: The maximum number of received packets carried
+ * by one tcpip_inpkt_batch() message.
+ */
+#ifndef TCPIP_INPKT_BATCH_MAX
+#define TCPIP_INPKT_BATCH_MAX           8
+#endif
+
 /**
  * Define this to something that triggers a watchdog. This is called from
  * tcpip_thread after processing a message.
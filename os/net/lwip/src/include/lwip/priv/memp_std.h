@@ -91,6 +91,7 @@ LWIP_MEMPOOL(RAW_PCB, MEMP_NUM_RAW_PCB, sizeof(struct raw_pcb), "RAW_PCB")
 #endif							/* LWIP_MPU_COMPATIBLE */
 #if !LWIP_TCPIP_CORE_LOCKING_INPUT
 	LWIP_MEMPOOL(TCPIP_MSG_INPKT, MEMP_NUM_TCPIP_MSG_INPKT, sizeof(struct tcpip_msg), "TCPIP_MSG_INPKT")
+	LWIP_MEMPOOL(TCPIP_MSG_INPKT_BATCH, MEMP_NUM_TCPIP_MSG_INPKT_BATCH, sizeof(struct tcpip_inpkt_batch), "TCPIP_MSG_INPKT_BATCH")
 #endif							/* !LWIP_TCPIP_CORE_LOCKING_INPUT */
 #endif							/* NO_SYS==0 */
 #if LWIP_IPV4 && LWIP_ARP && ARP_QUEUEING
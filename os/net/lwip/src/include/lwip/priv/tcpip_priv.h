@@ -129,6 +129,7 @@ enum tcpip_msg_type {
 	TCPIP_MSG_API,
 	TCPIP_MSG_API_CALL,
 	TCPIP_MSG_INPKT,
+	TCPIP_MSG_INPKT_BATCH,
 #if LWIP_TCPIP_TIMEOUT && LWIP_TIMERS
 	TCPIP_MSG_TIMEOUT,
 	TCPIP_MSG_UNTIMEOUT,
@@ -168,6 +169,14 @@ struct tcpip_msg {
 	} msg;
 };
 
+/** Several received packets posted to tcpip_thread as one message.
+ * msg.msg.inp holds the netif and input function shared by all packets. */
+struct tcpip_inpkt_batch {
+	struct tcpip_msg msg;
+	u16_t num;
+	struct pbuf *p[TCPIP_INPKT_BATCH_MAX];
+};
+
 #ifdef __cplusplus
 }
 #endif
@@ -517,7 +517,10 @@ int lwip_listen(int s, int backlog);
 int lwip_recv(int s, void *mem, size_t len, int flags);
 int lwip_read(int s, void *mem, size_t len);
 int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t * fromlen);
+int lwip_recv_ref(int s, void **dataptr, size_t len, int flags, struct sockaddr *from, socklen_t * fromlen, void **ref);
+void lwip_recv_ref_release(void *ref);
 int lwip_send(int s, const void *dataptr, size_t size, int flags);
+int lwip_send_ref(int s, const void *dataptr, size_t size, int flags);
 int lwip_sendmsg(int s, const struct msghdr *message, int flags);
 int lwip_sendto(int s, const void *dataptr, size_t size, int flags, const struct sockaddr *to, socklen_t tolen);
 int lwip_socket(int domain, int type, int protocol);
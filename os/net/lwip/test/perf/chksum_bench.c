@@ -0,0 +1,134 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/*
+ * Host micro-benchmark of the Internet checksum and of checksum-on-copy.
+ *
+ * It takes the lwipopts.h of test/unit, which selects LWIP_CHKSUM_ALGORITHM 4
+ * and LWIP_CHKSUM_COPY_ALGORITHM 2, through lwip/lwipopts.h here, and the
+ * host port in lwip/arch/cc.h. It is linked with src/core/inet_chksum.c and
+ * src/core/def.c only. From this directory:
+ *
+ *   make run
+ *
+ * Algorithm 2, the previous default, is copied below as the baseline.
+ */
+
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include "lwip/inet_chksum.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_LEN     1460
+#define BENCH_ROUNDS  200000
+#define BENCH_BUFSIZE 1600
+
+u16_t lwip_standard_chksum(const void *dataptr, int len);
+
+static u8_t g_src[BENCH_BUFSIZE];
+static u8_t g_dst[BENCH_BUFSIZE];
+static volatile u32_t g_sink;
+
+/* LWIP_CHKSUM_ALGORITHM 2 */
+static u16_t chksum_alg2(const void *dataptr, int len)
+{
+	const u8_t *pb = (const u8_t *)dataptr;
+	const u16_t *ps;
+	u16_t t = 0;
+	u32_t sum = 0;
+	int odd = ((mem_ptr_t)pb & 1);
+
+	if (odd && len > 0) {
+		((u8_t *)&t)[1] = *pb++;
+		len--;
+	}
+
+	ps = (const u16_t *)(const void *)pb;
+	while (len > 1) {
+		sum += *ps++;
+		len -= 2;
+	}
+
+	if (len > 0) {
+		((u8_t *)&t)[0] = *(const u8_t *)ps;
+	}
+
+	sum += t;
+	sum = FOLD_U32T(sum);
+	sum = FOLD_U32T(sum);
+	if (odd) {
+		sum = SWAP_BYTES_IN_WORD(sum);
+	}
+
+	return (u16_t)sum;
+}
+
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void bench_report(const char *name, double elapsed)
+{
+	printf("%-22s: %8.1f MB/s\n", name, (double)BENCH_ROUNDS * BENCH_LEN / elapsed / 1e6);
+}
+
+int main(void)
+{
+	double t;
+	int i;
+
+	for (i = 0; i < BENCH_BUFSIZE; i++) {
+		g_src[i] = (u8_t)(i * 7);
+	}
+
+	/* Alternate the source alignment between 0 and 2 */
+
+	t = bench_now();
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		g_sink += chksum_alg2(g_src + (i & 2), BENCH_LEN);
+	}
+	bench_report("algorithm 2 checksum", bench_now() - t);
+
+	t = bench_now();
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		g_sink += lwip_standard_chksum(g_src + (i & 2), BENCH_LEN);
+	}
+	bench_report("algorithm 4 checksum", bench_now() - t);
+
+	t = bench_now();
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		memcpy(g_dst + 2, g_src + (i & 2), BENCH_LEN);
+		g_sink += chksum_alg2(g_dst + 2, BENCH_LEN);
+	}
+	bench_report("memcpy + algorithm 2", bench_now() - t);
+
+	t = bench_now();
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		g_sink += lwip_chksum_copy(g_dst + 2, g_src + (i & 2), BENCH_LEN);
+	}
+	bench_report("lwip_chksum_copy", bench_now() - t);
+
+	return 0;
+}
@@ -0,0 +1,176 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_chksum.h"
+
+#include "lwip/inet_chksum.h"
+#include "lwip/pbuf.h"
+
+#include <string.h>
+
+#define CHKSUM_BUFSIZE   1600
+#define CHKSUM_MAXALIGN  8
+#define CHKSUM_GUARD     0xa5
+
+static u8_t g_src[CHKSUM_BUFSIZE + CHKSUM_MAXALIGN];
+static u8_t g_dst[CHKSUM_BUFSIZE + 2 * CHKSUM_MAXALIGN];
+
+/* Setups/teardown functions */
+
+static void chksum_setup(void)
+{
+	size_t i;
+	u32_t seed = 0x12345678;
+
+	for (i = 0; i < sizeof(g_src); i++) {
+		seed = seed * 1103515245 + 12345;
+		g_src[i] = (u8_t)(seed >> 16);
+	}
+}
+
+static void chksum_teardown(void)
+{
+}
+
+/* RFC 1071 in network byte order, one octet at a time */
+static u16_t chksum_reference(const u8_t *data, int len)
+{
+	u32_t acc = 0;
+
+	while (len > 1) {
+		acc += ((u32_t)data[0] << 8) | data[1];
+		data += 2;
+		len -= 2;
+	}
+	if (len > 0) {
+		acc += (u32_t)data[0] << 8;
+	}
+	while (acc >> 16) {
+		acc = (acc >> 16) + (acc & 0xffff);
+	}
+	return (u16_t) ~lwip_htons((u16_t) acc);
+}
+
+/* Test functions */
+
+/** inet_chksum matches the reference at every alignment and length */
+START_TEST(test_chksum_alignment)
+{
+	int align;
+	int len;
+	LWIP_UNUSED_ARG(_i);
+
+	for (align = 0; align < CHKSUM_MAXALIGN; align++) {
+		for (len = 0; len <= 300; len++) {
+			EXPECT_RET(inet_chksum(g_src + align, (u16_t) len) == chksum_reference(g_src + align, len));
+		}
+		EXPECT_RET(inet_chksum(g_src + align, CHKSUM_BUFSIZE) == chksum_reference(g_src + align, CHKSUM_BUFSIZE));
+	}
+}
+
+END_TEST
+/** Words of all ones must carry into the sum, not wrap */
+START_TEST(test_chksum_carry)
+{
+	u8_t buf[CHKSUM_BUFSIZE + 1];
+	int len;
+	LWIP_UNUSED_ARG(_i);
+
+	memset(buf, 0xff, sizeof(buf));
+	for (len = 0; len <= 64; len++) {
+		EXPECT_RET(inet_chksum(buf, (u16_t) len) == chksum_reference(buf, len));
+		EXPECT_RET(inet_chksum(buf + 1, (u16_t) len) == chksum_reference(buf + 1, len));
+	}
+	EXPECT(inet_chksum(buf, CHKSUM_BUFSIZE) == chksum_reference(buf, CHKSUM_BUFSIZE));
+
+	memset(buf, 0, sizeof(buf));
+	EXPECT(inet_chksum(buf, CHKSUM_BUFSIZE) == 0xffff);
+}
+
+END_TEST
+/** A pbuf chain with odd sized parts sums like the flat buffer */
+START_TEST(test_chksum_pbuf_chain)
+{
+	struct pbuf *p;
+	struct pbuf *q;
+	u16_t lens[] = { 1, 14, 7, 3, 256, 33 };
+	u16_t total = 0;
+	size_t i;
+	LWIP_UNUSED_ARG(_i);
+
+	for (i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+		total += lens[i];
+	}
+
+	p = pbuf_alloc(PBUF_RAW, lens[0], PBUF_RAM);
+	EXPECT_RET(p != NULL);
+	for (i = 1; i < sizeof(lens) / sizeof(lens[0]); i++) {
+		q = pbuf_alloc(PBUF_RAW, lens[i], PBUF_RAM);
+		EXPECT_RET(q != NULL);
+		pbuf_cat(p, q);
+	}
+	EXPECT_RET(pbuf_take(p, g_src, total) == ERR_OK);
+
+	EXPECT(inet_chksum_pbuf(p) == chksum_reference(g_src, total));
+	pbuf_free(p);
+}
+
+END_TEST
+#if LWIP_CHKSUM_COPY_ALGORITHM
+/** lwip_chksum_copy copies exactly len bytes and returns their sum,
+ * whatever the alignment of the source and of the destination */
+START_TEST(test_chksum_copy)
+{
+	int salign;
+	int dalign;
+	int len;
+	u16_t sum;
+	LWIP_UNUSED_ARG(_i);
+
+	for (salign = 0; salign < CHKSUM_MAXALIGN; salign++) {
+		for (dalign = 0; dalign < CHKSUM_MAXALIGN; dalign++) {
+			for (len = 0; len <= 80; len += (len < 40) ? 1 : 7) {
+				memset(g_dst, CHKSUM_GUARD, sizeof(g_dst));
+				sum = lwip_chksum_copy(g_dst + dalign, g_src + salign, (u16_t) len);
+				EXPECT_RET(memcmp(g_dst + dalign, g_src + salign, len) == 0);
+				EXPECT_RET(dalign == 0 || g_dst[dalign - 1] == CHKSUM_GUARD);
+				EXPECT_RET(g_dst[dalign + len] == CHKSUM_GUARD);
+				EXPECT_RET((u16_t) ~sum == chksum_reference(g_src + salign, len));
+			}
+			sum = lwip_chksum_copy(g_dst + dalign, g_src + salign, CHKSUM_BUFSIZE);
+			EXPECT_RET(memcmp(g_dst + dalign, g_src + salign, CHKSUM_BUFSIZE) == 0);
+			EXPECT_RET((u16_t) ~sum == chksum_reference(g_src + salign, CHKSUM_BUFSIZE));
+		}
+	}
+}
+
+END_TEST
+#endif							/* LWIP_CHKSUM_COPY_ALGORITHM */
+/** Create the suite including all tests for this module */
+Suite *chksum_suite(void)
+{
+	TFun tests[] = {
+		test_chksum_alignment,
+		test_chksum_carry,
+		test_chksum_pbuf_chain,
+#if LWIP_CHKSUM_COPY_ALGORITHM
+		test_chksum_copy,
+#endif
+	};
+	return create_suite("CHKSUM", tests, sizeof(tests) / sizeof(TFun), chksum_setup, chksum_teardown);
+}
@@ -0,0 +1,429 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_tcp_sack.h"
+
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/stats.h"
+#include "tcp_helper.h"
+
+#if !LWIP_STATS || !TCP_STATS || !MEMP_STATS
+#error "This tests needs TCP- and MEMP-statistics enabled"
+#endif
+#if !LWIP_TCP_SACK || !TCP_QUEUE_OOSEQ || !LWIP_WND_SCALE
+#error "This tests needs LWIP_TCP_SACK, TCP_QUEUE_OOSEQ and LWIP_WND_SCALE enabled"
+#endif
+#if TCP_WND < (6 * TCP_MSS)
+#error "This tests needs TCP_WND to hold at least 6 segments"
+#endif
+
+#define TEST_SACK_MAX_BLOCKS 4
+
+static u8_t tx_data[6 * TCP_MSS];
+
+/* Setups/teardown functions */
+
+static void tcp_sack_setup(void)
+{
+	tcp_remove_all();
+}
+
+static void tcp_sack_teardown(void)
+{
+	netif_list = NULL;
+	tcp_remove_all();
+}
+
+/* Helper functions */
+
+static void test_tcp_sack_reset_tx(struct test_tcp_txcounters *txcounters)
+{
+	if (txcounters->tx_packets != NULL) {
+		pbuf_free(txcounters->tx_packets);
+		txcounters->tx_packets = NULL;
+	}
+	txcounters->num_tx_calls = 0;
+	txcounters->num_tx_bytes = 0;
+}
+
+/** Get the TCP header of the n-th packet sent on the test netif */
+static struct tcp_hdr *test_tcp_sack_tx_hdr(struct test_tcp_txcounters *txcounters, u32_t n)
+{
+	struct pbuf *p = txcounters->tx_packets;
+	struct ip_hdr *iphdr;
+
+	for (; p != NULL && n > 0; n--) {
+		p = p->next;
+	}
+	if (p == NULL) {
+		return NULL;
+	}
+	iphdr = (struct ip_hdr *)p->payload;
+	return (struct tcp_hdr *)((u8_t *)iphdr + IPH_HL(iphdr) * 4);
+}
+
+/** Find a TCP option in a header, returns a pointer to its kind byte */
+static u8_t *test_tcp_sack_find_opt(struct tcp_hdr *tcphdr, u8_t kind)
+{
+	u8_t *opts = (u8_t *)(tcphdr + 1);
+	u16_t optlen = TCPH_HDRLEN(tcphdr) * 4 - TCP_HLEN;
+	u16_t i = 0;
+
+	while (i < optlen) {
+		if (opts[i] == LWIP_TCP_OPT_EOL) {
+			break;
+		}
+		if (opts[i] == LWIP_TCP_OPT_NOP) {
+			i++;
+			continue;
+		}
+		if (opts[i] == kind) {
+			return &opts[i];
+		}
+		if (i + 1 >= optlen || opts[i + 1] < 2) {
+			break;
+		}
+		i += opts[i + 1];
+	}
+	return NULL;
+}
+
+/** Get the SACK blocks (host byte order) of a header, returns their number */
+static u8_t test_tcp_sack_blocks(struct tcp_hdr *tcphdr, u32_t *edges)
+{
+	u8_t *opt = test_tcp_sack_find_opt(tcphdr, LWIP_TCP_OPT_SACK);
+	u8_t num;
+	u8_t i;
+
+	if (opt == NULL) {
+		return 0;
+	}
+	num = (u8_t)((opt[1] - 2) / 8);
+	for (i = 0; i < 2 * num && i < 2 * TEST_SACK_MAX_BLOCKS; i++) {
+		edges[i] = ((u32_t)opt[2 + 4 * i] << 24) | ((u32_t)opt[3 + 4 * i] << 16) | ((u32_t)opt[4 + 4 * i] << 8) | opt[5 + 4 * i];
+	}
+	return num;
+}
+
+/** Build a SACK option from host byte order edges, returns the option length */
+static u8_t test_tcp_sack_build(u8_t *opts, const u32_t *edges, u8_t num)
+{
+	u8_t i;
+
+	opts[0] = LWIP_TCP_OPT_NOP;
+	opts[1] = LWIP_TCP_OPT_NOP;
+	opts[2] = LWIP_TCP_OPT_SACK;
+	opts[3] = (u8_t)(2 + 8 * num);
+	for (i = 0; i < 2 * num; i++) {
+		opts[4 + 4 * i] = (u8_t)(edges[i] >> 24);
+		opts[5 + 4 * i] = (u8_t)(edges[i] >> 16);
+		opts[6 + 4 * i] = (u8_t)(edges[i] >> 8);
+		opts[7 + 4 * i] = (u8_t)edges[i];
+	}
+	return (u8_t)(4 + 8 * num);
+}
+
+static struct tcp_pcb *test_tcp_sack_established(struct test_tcp_counters *counters, struct netif *netif, struct test_tcp_txcounters *txcounters)
+{
+	ip_addr_t remote_ip, local_ip, netmask;
+	u16_t remote_port = 0x100, local_port = 0x101;
+	struct tcp_pcb *pcb;
+
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(netif, txcounters, &local_ip, &netmask);
+	txcounters->copy_tx_packets = 1;
+	memset(counters, 0, sizeof(struct test_tcp_counters));
+
+	pcb = test_tcp_new_counters_pcb(counters);
+	if (pcb != NULL) {
+		tcp_set_state(pcb, ESTABLISHED, &local_ip, &remote_ip, local_port, remote_port);
+		pcb->mss = TCP_MSS;
+		/* disable initial congestion window (we don't send a SYN here...) */
+		pcb->cwnd = pcb->snd_wnd;
+		/* as negotiated by a SYN carrying SACK permitted */
+		pcb->flags |= TF_SACK;
+	}
+	return pcb;
+}
+
+/* Test functions */
+
+/** SACK permitted and window scale are answered only if the SYN carries them */
+START_TEST(test_tcp_sack_syn_options)
+{
+	struct netif netif;
+	struct test_tcp_txcounters txcounters;
+	struct tcp_pcb *pcb, *npcb;
+	struct tcp_pcb_listen *lpcb;
+	struct tcp_hdr *tcphdr;
+	struct pbuf *p;
+	ip_addr_t remote_ip, local_ip, netmask;
+	u16_t local_port = 0x101;
+	/* MSS 1460, SACK permitted, window scale 2 */
+	u8_t opts[] = { 2, 4, 0x05, 0xb4, 1, 1, 4, 2, 1, 3, 3, 2 };
+	u8_t *opt;
+	err_t err;
+	LWIP_UNUSED_ARG(_i);
+
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+	txcounters.copy_tx_packets = 1;
+
+	pcb = tcp_new();
+	EXPECT_RET(pcb != NULL);
+	err = tcp_bind(pcb, &local_ip, local_port);
+	EXPECT_RET(err == ERR_OK);
+	lpcb = (struct tcp_pcb_listen *)tcp_listen(pcb);
+	EXPECT_RET(lpcb != NULL);
+
+	/* SYN with both options */
+	p = tcp_create_segment_opts(&remote_ip, &local_ip, 0x100, local_port, NULL, 0, 1000, 0, TCP_SYN, opts, sizeof(opts));
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	npcb = tcp_active_pcbs;
+	EXPECT_RET(npcb != NULL && npcb->state == SYN_RCVD);
+	EXPECT(npcb->flags & TF_SACK);
+	EXPECT(npcb->flags & TF_WND_SCALE);
+	EXPECT(npcb->snd_scale == 2);
+	EXPECT(npcb->rcv_wnd == TCP_WND);
+	tcphdr = test_tcp_sack_tx_hdr(&txcounters, 0);
+	EXPECT_RET(tcphdr != NULL);
+	opt = test_tcp_sack_find_opt(tcphdr, LWIP_TCP_OPT_SACK_PERM);
+	EXPECT(opt != NULL && opt[1] == LWIP_TCP_OPT_LEN_SACK_PERM);
+	opt = test_tcp_sack_find_opt(tcphdr, LWIP_TCP_OPT_WS);
+	EXPECT(opt != NULL && opt[1] == LWIP_TCP_OPT_LEN_WS && opt[2] == TCP_RCV_SCALE);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	/* SYN with the MSS option only */
+	p = tcp_create_segment_opts(&remote_ip, &local_ip, 0x102, local_port, NULL, 0, 2000, 0, TCP_SYN, opts, 4);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	npcb = tcp_active_pcbs;
+	EXPECT_RET(npcb != NULL && npcb->remote_port == 0x102);
+	EXPECT(!(npcb->flags & TF_SACK));
+	EXPECT(!(npcb->flags & TF_WND_SCALE));
+	tcphdr = test_tcp_sack_tx_hdr(&txcounters, 0);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT(test_tcp_sack_find_opt(tcphdr, LWIP_TCP_OPT_SACK_PERM) == NULL);
+	EXPECT(test_tcp_sack_find_opt(tcphdr, LWIP_TCP_OPT_WS) == NULL);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	tcp_close((struct tcp_pcb *)lpcb);
+}
+
+END_TEST
+/** Out of sequence data is reported in SACK blocks, the newest block first */
+START_TEST(test_tcp_sack_rx_ooseq)
+{
+	struct netif netif;
+	struct test_tcp_txcounters txcounters;
+	struct test_tcp_counters counters;
+	struct tcp_pcb *pcb;
+	struct tcp_hdr *tcphdr;
+	struct pbuf *p;
+	char data[] = { 1, 2, 3, 4 };
+	u32_t edges[2 * TEST_SACK_MAX_BLOCKS];
+	u32_t base;
+	LWIP_UNUSED_ARG(_i);
+
+	pcb = test_tcp_sack_established(&counters, &netif, &txcounters);
+	EXPECT_RET(pcb != NULL);
+	base = pcb->rcv_nxt;
+
+	/* [8..12) arrives, [0..8) is missing: the duplicate ACK reports it */
+	p = tcp_create_rx_segment(pcb, data, 4, 8, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	tcphdr = test_tcp_sack_tx_hdr(&txcounters, 0);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT(lwip_ntohl(tcphdr->ackno) == base);
+	EXPECT_RET(test_tcp_sack_blocks(tcphdr, edges) == 1);
+	EXPECT(edges[0] == base + 8 && edges[1] == base + 12);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	/* [16..20) arrives: its block comes first */
+	p = tcp_create_rx_segment(pcb, data, 4, 16, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	tcphdr = test_tcp_sack_tx_hdr(&txcounters, 0);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT_RET(test_tcp_sack_blocks(tcphdr, edges) == 2);
+	EXPECT(edges[0] == base + 16 && edges[1] == base + 20);
+	EXPECT(edges[2] == base + 8 && edges[3] == base + 12);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	/* [12..16) fills the gap between both blocks */
+	p = tcp_create_rx_segment(pcb, data, 4, 12, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	tcphdr = test_tcp_sack_tx_hdr(&txcounters, 0);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT_RET(test_tcp_sack_blocks(tcphdr, edges) == 1);
+	EXPECT(edges[0] == base + 8 && edges[1] == base + 20);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	/* [0..4) arrives in sequence, [4..8) is still missing: ACK at once */
+	p = tcp_create_rx_segment(pcb, data, 4, 0, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(counters.recved_bytes == 4);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	tcphdr = test_tcp_sack_tx_hdr(&txcounters, 0);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT(lwip_ntohl(tcphdr->ackno) == base + 4);
+	EXPECT_RET(test_tcp_sack_blocks(tcphdr, edges) == 1);
+	EXPECT(edges[0] == base + 8 && edges[1] == base + 20);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	/* [4..8) closes the hole, everything is passed up */
+	p = tcp_create_rx_segment(pcb, data, 4, 0, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(counters.recved_bytes == 20);
+	EXPECT(pcb->ooseq == NULL);
+	EXPECT(pcb->rcv_nxt == base + 20);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	tcp_abort(pcb);
+}
+
+END_TEST
+/** Only the holes reported by SACK blocks are retransmitted in fast recovery */
+START_TEST(test_tcp_sack_tx_scoreboard)
+{
+	struct netif netif;
+	struct test_tcp_txcounters txcounters;
+	struct test_tcp_counters counters;
+	struct tcp_pcb *pcb;
+	struct tcp_hdr *tcphdr;
+	struct pbuf *p;
+	u8_t opts[4 + 8 * TEST_SACK_MAX_BLOCKS];
+	u32_t edges[4];
+	u8_t optlen;
+	u32_t base;
+	err_t err;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	pcb = test_tcp_sack_established(&counters, &netif, &txcounters);
+	EXPECT_RET(pcb != NULL);
+	base = pcb->snd_nxt;
+
+	/* send 6 segments */
+	err = tcp_write(pcb, tx_data, sizeof(tx_data), TCP_WRITE_FLAG_COPY);
+	EXPECT_RET(err == ERR_OK);
+	err = tcp_output(pcb);
+	EXPECT_RET(err == ERR_OK);
+	EXPECT_RET(txcounters.num_tx_calls == 6);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	/* segments 0, 1 and 4 are lost */
+	edges[0] = base + 2 * TCP_MSS;
+	edges[1] = base + 4 * TCP_MSS;
+	edges[2] = base + 5 * TCP_MSS;
+	edges[3] = base + 6 * TCP_MSS;
+
+	optlen = test_tcp_sack_build(opts, edges, 1);
+	p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(pcb->dupacks == 1);
+	EXPECT(txcounters.num_tx_calls == 0);
+
+	optlen = test_tcp_sack_build(opts, edges, 2);
+	for (i = 0; i < 2; i++) {
+		p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+		EXPECT_RET(p != NULL);
+		test_tcp_input(p, &netif);
+	}
+	/* fast retransmit of segment 0 */
+	EXPECT_RET(pcb->dupacks == 3);
+	EXPECT_RET(pcb->flags & TF_INFR);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	tcphdr = test_tcp_sack_tx_hdr(&txcounters, 0);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT(lwip_ntohl(tcphdr->seqno) == base);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	/* each further duplicate ACK retransmits the next hole */
+	p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	tcphdr = test_tcp_sack_tx_hdr(&txcounters, 0);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT(lwip_ntohl(tcphdr->seqno) == base + TCP_MSS);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT_RET(txcounters.num_tx_calls == 1);
+	tcphdr = test_tcp_sack_tx_hdr(&txcounters, 0);
+	EXPECT_RET(tcphdr != NULL);
+	EXPECT(lwip_ntohl(tcphdr->seqno) == base + 4 * TCP_MSS);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	/* no hole left: SACKed segments are not sent again */
+	p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(txcounters.num_tx_calls == 0);
+
+	/* partial ACK up to segment 4 keeps the connection in fast recovery */
+	p = tcp_create_rx_segment(pcb, NULL, 0, 0, 4 * TCP_MSS, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(pcb->flags & TF_INFR);
+	EXPECT(pcb->lastack == base + 4 * TCP_MSS);
+	EXPECT(txcounters.num_tx_calls == 0);
+
+	/* full ACK ends it */
+	p = tcp_create_rx_segment(pcb, NULL, 0, 0, 2 * TCP_MSS, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(!(pcb->flags & TF_INFR));
+	/* cwnd restarts from ssthresh, plus this ACK's congestion avoidance step */
+	EXPECT(pcb->cwnd >= pcb->ssthresh && pcb->cwnd <= pcb->ssthresh + pcb->mss);
+	EXPECT(pcb->unacked == NULL);
+	EXPECT(pcb->unsent == NULL);
+	test_tcp_sack_reset_tx(&txcounters);
+
+	tcp_abort(pcb);
+}
+
+END_TEST
+/** Create the suite including all tests for this module */
+Suite *tcp_sack_suite(void)
+{
+	TFun tests[] = {
+		test_tcp_sack_syn_options,
+		test_tcp_sack_rx_ooseq,
+		test_tcp_sack_tx_scoreboard
+	};
+	return create_suite("TCP_SACK", tests, sizeof(tests) / sizeof(TFun), tcp_sack_setup, tcp_sack_teardown);
+}
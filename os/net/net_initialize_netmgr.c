@@ -38,6 +38,12 @@ extern int netdev_mgr_start(void);
 #ifdef CONFIG_VIRTUAL_WLAN
 extern void vwifi_start(void);
 #endif
+#ifdef CONFIG_NET_SGLOOP
+extern void sgloop_start(void);
+#endif
+#ifdef CONFIG_NET_VNETPAIR
+extern void vnetpair_start(void);
+#endif
 /****************************************************************************
  * Name: netmgr_setup
  *
@@ -113,6 +119,14 @@ void net_initialize(void)
 	vwifi_start();
 #endif
 
+#ifdef CONFIG_NET_SGLOOP
+	sgloop_start();
+#endif
+
+#ifdef CONFIG_NET_VNETPAIR
+	vnetpair_start();
+#endif
+
 	/*  start network stack */
 	struct netstack *stk = get_netstack(TR_SOCKET);
 	int res = -1;
@@ -122,6 +122,34 @@ ssize_t recvfrom(int sockfd, void *mem, size_t len, int flags, struct sockaddr *
 	return res;
 }
 
+#ifdef CONFIG_NET_RECVREF
+ssize_t recvref(int sockfd, struct recvref *ref, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int res = -1;
+	NETSTACK_CALL_BYFD_RET(sockfd, recvref, (sockfd, ref, len, flags, from, fromlen), res);
+	if (res > 0) {
+		NETMGR_STATS_ADD(g_app_recv_byte, res);
+		NETMGR_STATS_INC(g_app_recv_cnt);
+	}
+	leave_cancellation_point();
+	return res;
+}
+
+void recvref_release(int sockfd, struct recvref *ref)
+{
+	struct netstack *stk = get_netstack_byfd(sockfd);
+
+	if (stk && stk->ops->recvref_release && ref && ref->priv) {
+		stk->ops->recvref_release(ref);
+		ref->priv = NULL;
+		ref->data = NULL;
+		ref->len = 0;
+	}
+}
+#endif
+
 /****************************************************************************
  * Function: recvmsg
  *
@@ -130,6 +130,29 @@ int net_poll(int sd, struct pollfd *fds, bool setup)
 	NETSTACK_CALL_BYFD(sd, poll, (sd, fds, setup));
 }
 
+/****************************************************************************
+ * Function: net_sendref
+ *
+ * Description:
+ *   send() which lets the stack reference 'data' instead of copying it.
+ *   'data' must stay valid and unchanged for the life of the system.
+ *
+ * Returned Value:
+ *   The number of bytes sent; -1 on error with errno set appropriately.
+ *
+ ****************************************************************************/
+#ifdef CONFIG_FS_SPLICE
+ssize_t net_sendref(int sd, FAR const void *data, size_t size, int flags)
+{
+	struct netstack *stk = get_netstack_byfd(sd);
+
+	if (stk && stk->ops->sendref) {
+		return stk->ops->sendref(sd, data, size, flags);
+	}
+	NETSTACK_CALL(stk, send, (sd, data, size, flags));
+}
+#endif
+
 /****************************************************************************
  * Name: net_ioctl
  *
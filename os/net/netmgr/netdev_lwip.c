@@ -18,6 +18,7 @@
 #include <tinyara/config.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <net/if.h>
@@ -35,7 +36,9 @@
 #include "lwip/netifapi.h"
 #include "lwip/snmp.h"
 #include "lwip/igmp.h"
+#include "lwip/tcpip.h"
 #include "netdev_mgr_internal.h"
+#include "netdev_stats.h"
 #include <tinyara/net/netlog.h>
 
 /* This is really kind of bogus.. When asked for an IP address, this is
@@ -273,11 +276,96 @@ static inline void _free_ifaddrs(struct ifaddrs *addrs)
 	}
 }
 
+#ifdef CONFIG_NETDEV_TX_SG
+/*
+ * Map the pbuf chain onto the fragments of a frame without copying it.
+ * The chain is referenced until the driver calls netdev_tx_done().
+ * Only PBUF_RAM and PBUF_POOL segments own their payload, PBUF_REF and
+ * PBUF_ROM point at memory of the caller (e.g. the user buffer of a
+ * netbuf_ref()) which is reused once linkoutput returns.
+ */
+static err_t _lwip_linkoutput_sg(struct netdev *dev, struct pbuf *buf)
+{
+	struct netdev_txframe *frame;
+	struct pbuf *p = buf;
+	struct pbuf *q;
+	uint8_t cnt = 0;
+	bool borrowed = false;
+
+	for (q = buf; q != NULL; q = q->next) {
+		if (q->len > 0) {
+			cnt++;
+		}
+		if (q->type == PBUF_REF || q->type == PBUF_ROM) {
+			borrowed = true;
+		}
+	}
+
+	if (borrowed || cnt > CONFIG_NETDEV_TX_SG_IOVMAX) {
+		/* borrowed payload or too many fragments, linearize the frame first */
+		p = pbuf_alloc(PBUF_RAW, buf->tot_len, PBUF_RAM);
+		if (!p) {
+			LINK_STATS_INC(link.memerr);
+			return ERR_MEM;
+		}
+		pbuf_copy(p, buf);
+	}
+
+	frame = (struct netdev_txframe *)kmm_malloc(sizeof(struct netdev_txframe));
+	if (!frame) {
+		if (p != buf) {
+			pbuf_free(p);
+		}
+		LINK_STATS_INC(link.memerr);
+		return ERR_MEM;
+	}
+
+	frame->flink = NULL;
+	frame->len = p->tot_len;
+	frame->iovcnt = 0;
+	for (q = p; q != NULL; q = q->next) {
+		if (q->len > 0) {
+			frame->iov[frame->iovcnt].base = q->payload;
+			frame->iov[frame->iovcnt].len = q->len;
+			frame->iovcnt++;
+		}
+	}
+
+	/* lwIP frees its own reference when linkoutput returns */
+	if (p == buf) {
+		pbuf_ref(p);
+	}
+	frame->priv = (void *)p;
+
+	if (ND_NETOPS(dev, linkoutput_sg)(dev, frame) < 0) {
+		NET_LOGE(TAG, "linkoutput_sg fail\n");
+		pbuf_free(p);
+		kmm_free(frame);
+		return ERR_IF;
+	}
+
+	return ERR_OK;
+}
+
+static void lwip_tx_done(struct netdev *dev, struct netdev_txframe *frame)
+{
+	(void)dev;
+	pbuf_free((struct pbuf *)frame->priv);
+	kmm_free(frame);
+}
+#endif /* CONFIG_NETDEV_TX_SG */
+
 #ifdef CONFIG_NET_NETMGR_ZEROCOPY
 static err_t lwip_linkoutput(struct netif *nic, struct pbuf *buf)
 {
 	struct netdev *dev = LW_GETND(nic);
 
+#ifdef CONFIG_NETDEV_TX_SG
+	if (ND_NETOPS(dev, linkoutput_sg)) {
+		return _lwip_linkoutput_sg(dev, buf);
+	}
+#endif
+
 	int res = ND_NETOPS(dev, linkoutput)(dev, (void *)buf, 0);
 	if (res < 0) {
 		NET_LOGE(TAG, "linkoutput fail\n");
@@ -333,6 +421,13 @@ static err_t lwip_linkoutput(struct netif *nic, struct pbuf *buf)
 	struct netdev *dev = LW_GETND(nic);
 	int offset = 0;
 	struct pbuf *tbuf = buf;
+
+#ifdef CONFIG_NETDEV_TX_SG
+	if (ND_NETOPS(dev, linkoutput_sg)) {
+		return _lwip_linkoutput_sg(dev, buf);
+	}
+#endif
+
 	while (tbuf) {
 		memcpy((void *)&dev->tx_buf[offset], (void *)tbuf->payload, tbuf->len);
 		offset += tbuf->len;
@@ -410,6 +505,107 @@ static int lwip_input(struct netdev *dev, void *frame_ptr, uint16_t len)
 }
 #endif /*  CONFIG_NET_NETMGR_ZEROCOPY */
 
+static inline int _lwip_input_supported(struct pbuf *p)
+{
+	struct eth_hdr *ethhdr = p->payload;
+
+	switch (htons(ethhdr->type)) {
+	case ETHTYPE_IP:
+#if LWIP_IPV6
+	case ETHTYPE_IPV6:
+#endif
+	case ETHTYPE_ARP:
+#if PPPOE_SUPPORT
+	case ETHTYPE_PPPOEDISC:
+	case ETHTYPE_PPPOE:
+#endif
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Hand a batch of packets to the stack, packets which can't be queued are
+ * freed. Return the number of packets queued.
+ */
+static uint16_t _lwip_input_flush(struct netif *netif, struct pbuf **pkts, uint16_t npkts)
+{
+	uint16_t queued = 0;
+	uint16_t i;
+
+	if (netif->input == tcpip_input) {
+		/* one mailbox message for the whole batch */
+		queued = tcpip_input_batch(pkts, npkts, netif);
+	}
+
+	for (i = queued; i < npkts; i++) {
+		if (netif->input != tcpip_input && netif->input(pkts[i], netif) == ERR_OK) {
+			queued++;
+			continue;
+		}
+		NET_LOGE(TAG, "input processing\n");
+		LINK_STATS_INC(link.err);
+		pbuf_free(pkts[i]);
+	}
+
+#if LINK_STATS
+	for (i = 0; i < queued; i++) {
+		LINK_STATS_INC(link.recv);
+	}
+#endif
+	return queued;
+}
+
+static int lwip_input_batch(struct netdev *dev, void **frames, uint16_t *lens, uint16_t num)
+{
+	struct netif *netif = GET_NETIF_FROM_NETDEV(dev);
+	struct pbuf *pkts[TCPIP_INPKT_BATCH_MAX];
+	struct pbuf *p;
+	uint16_t npkts = 0;
+	uint16_t delivered = 0;
+	uint16_t i;
+
+	for (i = 0; i < num; i++) {
+#ifdef CONFIG_NET_NETMGR_ZEROCOPY
+		(void)lens;
+		p = (struct pbuf *)frames[i];
+		if (!p) {
+			continue;
+		}
+#else
+		if (lens[i] == 0) {
+			continue;
+		}
+		p = pbuf_alloc(PBUF_RAW, lens[i], PBUF_POOL);
+		if (!p) {
+			NET_LOGE(TAG, "pbuf alloc\n");
+			LINK_STATS_INC(link.memerr);
+			LINK_STATS_INC(link.drop);
+			continue;
+		}
+		pbuf_take(p, frames[i], lens[i]);
+#endif
+		if (!_lwip_input_supported(p)) {
+			pbuf_free(p);
+			continue;
+		}
+
+		pkts[npkts++] = p;
+		if (npkts == TCPIP_INPKT_BATCH_MAX) {
+			delivered += _lwip_input_flush(netif, pkts, npkts);
+			npkts = 0;
+		}
+	}
+
+	if (npkts > 0) {
+		delivered += _lwip_input_flush(netif, pkts, npkts);
+	}
+
+	NETMGR_STATS_RX_BATCH(num, num - delivered);
+	return delivered;
+}
+
 static err_t lwip_set_multicast_list(struct netif *nic, const ip4_addr_t *group, enum netif_mac_filter_action action)
 {
 	struct netdev *dev = LW_GETND(nic);
@@ -789,9 +985,12 @@ static int lwip_init_nic(struct netdev *dev, struct nic_config *config)
 		return 0;
 	}
 	((struct netdev_ops *)dev->ops)->linkoutput = config->io_ops.linkoutput;
+#ifdef CONFIG_NETDEV_TX_SG
+	((struct netdev_ops *)dev->ops)->linkoutput_sg = config->io_ops.linkoutput_sg;
+#endif
 	((struct netdev_ops *)dev->ops)->igmp_mac_filter = config->io_ops.igmp_mac_filter;
 
-	nic->mtu = CONFIG_NET_ETH_MTU;
+	nic->mtu = (config->mtu > 0 && config->mtu < CONFIG_NET_ETH_MTU) ? config->mtu : CONFIG_NET_ETH_MTU;
 	nic->hwaddr_len = config->hwaddr_len;
 #if LWIP_IPV6
 	nic->output_ip6 = ethip6_output;
@@ -904,6 +1103,11 @@ struct netdev_ops *get_netdev_ops_lwip(void)
 	netdev_ops->leavegroup = lwip_leavegroup;
 
 	netdev_ops->input = lwip_input;
+	netdev_ops->input_batch = lwip_input_batch;
+#ifdef CONFIG_NETDEV_TX_SG
+	netdev_ops->linkoutput_sg = NULL;
+	netdev_ops->tx_done = lwip_tx_done;
+#endif
 #ifdef CONFIG_NET_NETMON
 	netdev_ops->get_stats = lwip_get_stats;
 #endif
@@ -76,6 +76,40 @@ int netdev_input(struct netdev *dev, void *data, uint16_t len)
 	return ND_NETOPS(dev, input)(dev, data, len);
 }
 
+int netdev_input_batch(struct netdev *dev, void **data, uint16_t *len, uint16_t num)
+{
+#ifndef CONFIG_NET_NETMGR_ZEROCOPY
+	uint16_t i;
+
+	if (!len) {
+		return -1;
+	}
+#endif
+	if (!dev || !data || !ND_NETOPS(dev, input_batch)) {
+		return -1;
+	}
+
+#ifndef CONFIG_NET_NETMGR_ZEROCOPY
+	for (i = 0; i < num; i++) {
+		NETMGR_STATS_ADD(g_link_recv_byte, len[i]);
+	}
+#endif
+	NETMGR_STATS_ADD(g_link_recv_cnt, num);
+
+	return ND_NETOPS(dev, input_batch)(dev, data, len, num);
+}
+
+#ifdef CONFIG_NETDEV_TX_SG
+void netdev_tx_done(struct netdev *dev, struct netdev_txframe *frame)
+{
+	if (!dev || !frame) {
+		NET_LOGE(TAG, "invalid parameter\n");
+		return;
+	}
+	ND_NETOPS(dev, tx_done)(dev, frame);
+}
+#endif
+
 int netdev_get_mtu(struct netdev *dev, int *mtu)
 {
 	return ND_NETOPS(dev, get_mtu)(dev, mtu);
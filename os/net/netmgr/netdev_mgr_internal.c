@@ -146,9 +146,9 @@ struct netdev *nm_register(struct netdev_config *config)
 	}
 
 	// to do calculate exact size of tx_buf
-	dev->tx_buf = (uint8_t *)kmm_malloc(config->mtu + 12); // 12 is padding.
+	dev->tx_buf = (uint8_t *)kmm_malloc(config->mtu + 14 + 12); // 14 is ethernet header, 12 is padding.
 	if (!dev->tx_buf) {
-		NET_LOGE(TAG, "create txbuf fail(%d)\n", config->mtu + 12);
+		NET_LOGE(TAG, "create txbuf fail(%d)\n", config->mtu + 14 + 12);
 		return NULL;
 	}
 	struct nic_config nconfig;
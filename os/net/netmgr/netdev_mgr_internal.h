@@ -76,7 +76,12 @@ struct netdev_ops {
 	int (*leavegroup)(struct netdev *dev, struct in_addr *addr);
 
 	int (*input)(struct netdev *dev, void *data, uint16_t len);
+	int (*input_batch)(struct netdev *dev, void **data, uint16_t *len, uint16_t num);
 	int (*linkoutput)(struct netdev *dev, void *data, uint16_t len);
+#ifdef CONFIG_NETDEV_TX_SG
+	int (*linkoutput_sg)(struct netdev *dev, struct netdev_txframe *frame);
+	void (*tx_done)(struct netdev *dev, struct netdev_txframe *frame);
+#endif
 	int (*igmp_mac_filter)(struct netdev *dev, const struct in_addr *group, netdev_mac_filter_action action);
 
 	/* statistics
@@ -19,6 +19,7 @@
 #include <tinyara/config.h>
 #include <debug.h>
 #include <tinyara/net/netlog.h>
+#include "netdev_stats.h"
 #define TAG "[NETMGR]"
 
 uint32_t g_link_recv_byte = 0;
@@ -28,9 +29,37 @@ uint32_t g_link_recv_err = 0;
 uint32_t g_app_recv_byte = 0;
 uint32_t g_app_recv_cnt = 0;
 
+uint32_t g_link_batch_cnt = 0;
+uint32_t g_link_batch_max = 0;
+uint32_t g_link_batch_drop = 0;
+uint32_t g_link_batch_hist[NETMGR_RX_BATCH_BUCKETS] = {0, };
+
+void netstats_rx_batch(uint16_t num, uint16_t drop)
+{
+	int bucket = 0;
+
+	if (num == 0) {
+		return;
+	}
+
+	while (bucket < NETMGR_RX_BATCH_BUCKETS - 1 && (num >> (bucket + 1)) != 0) {
+		bucket++;
+	}
+
+	g_link_batch_cnt++;
+	g_link_batch_drop += drop;
+	g_link_batch_hist[bucket]++;
+	if (num > g_link_batch_max) {
+		g_link_batch_max = num;
+	}
+}
+
 void netstats_display(void)
 {
 	NET_LOG(TAG, "[driver] total recv %u\t%u\n", g_link_recv_byte, g_link_recv_cnt);
 	NET_LOG(TAG, "[driver] mbox err %u\n", g_link_recv_err);
+	NET_LOG(TAG, "[driver] rx batch %u\tmax %u\tdrop %u\n", g_link_batch_cnt, g_link_batch_max, g_link_batch_drop);
+	NET_LOG(TAG, "[driver] rx batch size 1/2-3/4-7/8+ %u/%u/%u/%u\n",
+			g_link_batch_hist[0], g_link_batch_hist[1], g_link_batch_hist[2], g_link_batch_hist[3]);
 	NET_LOG(TAG, "[app] total recv %u\t%u\n", g_app_recv_byte, g_app_recv_cnt);
 }
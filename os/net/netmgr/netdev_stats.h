@@ -27,15 +27,25 @@ extern uint32_t g_link_recv_err;
 extern uint32_t g_app_recv_byte;
 extern uint32_t g_app_recv_cnt;
 
+/* batched input: histogram of batch sizes 1, 2-3, 4-7 and 8 or more */
+#define NETMGR_RX_BATCH_BUCKETS 4
+extern uint32_t g_link_batch_cnt;
+extern uint32_t g_link_batch_max;
+extern uint32_t g_link_batch_drop;
+extern uint32_t g_link_batch_hist[NETMGR_RX_BATCH_BUCKETS];
+
 #define NETMGR_STATS_ADD(x, y) \
 	do {\
 		x += y;\
 	} while (0)
 
 #define NETMGR_STATS_INC(x) x++;
+#define NETMGR_STATS_RX_BATCH(num, drop) netstats_rx_batch(num, drop)
+void netstats_rx_batch(uint16_t num, uint16_t drop);
 void netstats_display(void);
 #else
 #define NETMGR_STATS_ADD(x, y)
 #define NETMGR_STATS_INC(x)
+#define NETMGR_STATS_RX_BATCH(num, drop)
 #endif
 #endif // __NETMGR_STATS_H__
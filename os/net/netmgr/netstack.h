@@ -94,6 +94,17 @@ struct netstack_ops {
 
 	void (*initlist)(struct socketlist *list);
 	void (*releaselist)(struct socketlist *list);
+
+#ifdef CONFIG_FS_SPLICE
+	// send() referencing data which never changes (XIP) instead of copying it
+	ssize_t (*sendref)(int s, const void *data, size_t size, int flags);
+#endif
+
+#ifdef CONFIG_NET_RECVREF
+	// recvfrom() referencing the stack's buffer instead of copying it
+	ssize_t (*recvref)(int s, struct recvref *ref, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen);
+	void (*recvref_release)(struct recvref *ref);
+#endif
 };
 
 struct netstack {
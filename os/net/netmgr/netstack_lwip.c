@@ -272,6 +272,32 @@ static ssize_t lwip_ns_send(int s, const void *data, size_t size, int flags)
 	return lwip_send(s, data, size, flags);
 }
 
+#ifdef CONFIG_FS_SPLICE
+static ssize_t lwip_ns_sendref(int s, const void *data, size_t size, int flags)
+{
+	return lwip_send_ref(s, data, size, flags);
+}
+#endif
+
+#ifdef CONFIG_NET_RECVREF
+static ssize_t lwip_ns_recvref(int s, struct recvref *ref, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen)
+{
+	int res = lwip_recv_ref(s, &ref->data, len, flags, from, fromlen, &ref->priv);
+
+	ref->len = res > 0 ? res : 0;
+	if (res <= 0) {
+		ref->data = NULL;
+		ref->priv = NULL;
+	}
+	return res;
+}
+
+static void lwip_ns_recvref_release(struct recvref *ref)
+{
+	lwip_recv_ref_release(ref->priv);
+}
+#endif
+
 static ssize_t lwip_ns_sendto(int s, const void *data, size_t size, int flags, const struct sockaddr *to, socklen_t tolen)
 {
 	return lwip_sendto(s, data, size, flags, to, tolen);
@@ -553,7 +579,14 @@ struct netstack_ops g_lwip_stack_ops = {
 	lwip_ns_getstats,
 #endif
 	lwip_ns_initlist,
-	lwip_ns_releaselist
+	lwip_ns_releaselist,
+#ifdef CONFIG_FS_SPLICE
+	lwip_ns_sendref,
+#endif
+#ifdef CONFIG_NET_RECVREF
+	lwip_ns_recvref,
+	lwip_ns_recvref_release,
+#endif
 };
 
 struct netstack g_lwip_stack = {&g_lwip_stack_ops, NULL};
@@ -24,6 +24,7 @@
 #include <tinyara/seclink_drv.h>
 #include <tinyara/security_hal.h>
 #include <tinyara/kmalloc.h>
+#include <crc32.h>
 
 #define _IN_
 #define _OUT_
@@ -230,10 +231,99 @@ int virtual_hal_generate_random(_IN_ uint32_t len, _OUT_ hal_data *random)
 	return 0;
 }
 
+/*
+ * The virtual hash is the CRC32 of the input repeated to the length of the
+ * requested hash, so a streamed hash can be checked against get_hash.
+ */
+#define VIRTUAL_HASH_SLOTS 4
+
+struct virtual_hash_s {
+	int used;
+	hal_hash_type mode;
+	uint32_t crc;
+};
+
+static struct virtual_hash_s g_virtual_hash[VIRTUAL_HASH_SLOTS];
+
+static const uint32_t g_virtual_hash_len[] = {16, 20, 28, 32, 48, 64};
+
+static int _virtual_hash_output(hal_hash_type mode, uint32_t crc, hal_data *hash)
+{
+	uint32_t i;
+
+	if (mode >= HAL_HASH_UNKNOWN || !hash || !hash->data) {
+		return HAL_INVALID_ARGS;
+	}
+	if (hash->data_len < g_virtual_hash_len[mode]) {
+		return HAL_NOT_ENOUGH_MEMORY;
+	}
+	for (i = 0; i < g_virtual_hash_len[mode]; i++) {
+		((uint8_t *)hash->data)[i] = (uint8_t)(crc >> (8 * (i % 4)));
+	}
+	hash->data_len = g_virtual_hash_len[mode];
+
+	return HAL_SUCCESS;
+}
+
 int virtual_hal_get_hash(_IN_ hal_hash_type mode, _IN_ hal_data *input, _OUT_ hal_data *hash)
 {
 	VH_ENTER;
-	return 0;
+
+	if (!input || !input->data) {
+		return HAL_INVALID_ARGS;
+	}
+
+	return _virtual_hash_output(mode, crc32part(input->data, input->data_len, 0), hash);
+}
+
+int virtual_hal_hash_init(_IN_ hal_hash_type mode, _IN_ uint32_t hash_idx)
+{
+	VH_ENTER;
+
+	if (hash_idx >= VIRTUAL_HASH_SLOTS) {
+		return HAL_INVALID_SLOT_RANGE;
+	}
+	if (mode >= HAL_HASH_UNKNOWN) {
+		return HAL_INVALID_ARGS;
+	}
+	g_virtual_hash[hash_idx].used = 1;
+	g_virtual_hash[hash_idx].mode = mode;
+	g_virtual_hash[hash_idx].crc = 0;
+
+	return HAL_SUCCESS;
+}
+
+int virtual_hal_hash_update(_IN_ uint32_t hash_idx, _IN_ hal_data *input)
+{
+	VH_ENTER;
+
+	if (hash_idx >= VIRTUAL_HASH_SLOTS) {
+		return HAL_INVALID_SLOT_RANGE;
+	}
+	if (!g_virtual_hash[hash_idx].used) {
+		return HAL_EMPTY_SLOT;
+	}
+	if (!input || !input->data) {
+		return HAL_INVALID_ARGS;
+	}
+	g_virtual_hash[hash_idx].crc = crc32part(input->data, input->data_len, g_virtual_hash[hash_idx].crc);
+
+	return HAL_SUCCESS;
+}
+
+int virtual_hal_hash_final(_IN_ uint32_t hash_idx, _OUT_ hal_data *hash)
+{
+	VH_ENTER;
+
+	if (hash_idx >= VIRTUAL_HASH_SLOTS) {
+		return HAL_INVALID_SLOT_RANGE;
+	}
+	if (!g_virtual_hash[hash_idx].used) {
+		return HAL_EMPTY_SLOT;
+	}
+	g_virtual_hash[hash_idx].used = 0;
+
+	return _virtual_hash_output(g_virtual_hash[hash_idx].mode, g_virtual_hash[hash_idx].crc, hash);
 }
 
 int virtual_hal_get_hmac(_IN_ hal_hmac_type mode, _IN_ hal_data *input, _IN_ uint32_t key_idx, _OUT_ hal_data *hmac)
@@ -462,6 +552,9 @@ static struct sec_ops_s g_virtual_ops = {
 	virtual_hal_write_storage,
 	virtual_hal_read_storage,
 	virtual_hal_delete_storage,
+	virtual_hal_hash_init,
+	virtual_hal_hash_update,
+	virtual_hal_hash_final,
 };
 
 static struct sec_lowerhalf_s g_virtual_lower = {&g_virtual_ops, NULL};
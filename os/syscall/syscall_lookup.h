@@ -253,6 +253,11 @@ SYSCALL_LOOKUP(umount,                  1, STUB_umount)
 SYSCALL_LOOKUP(unlink,                  1, STUB_unlink)
 SYSCALL_LOOKUP(ftruncate,               2, STUB_ftruncate)
 #  endif
+
+#  if defined(CONFIG_FS_SPLICE)
+SYSCALL_LOOKUP(sendfile,                4, STUB_sendfile)
+SYSCALL_LOOKUP(splice,                  6, STUB_splice)
+#  endif
 #endif
 
 /* Shared memory interfaces */
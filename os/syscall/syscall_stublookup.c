@@ -250,6 +250,12 @@ uintptr_t STUB_rmdir(int nbr, uintptr_t parm1);
 uintptr_t STUB_umount(int nbr, uintptr_t parm1);
 uintptr_t STUB_unlink(int nbr, uintptr_t parm1);
 
+uintptr_t STUB_sendfile(int nbr, uintptr_t parm1, uintptr_t parm2,
+						uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_splice(int nbr, uintptr_t parm1, uintptr_t parm2,
+					  uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
+					  uintptr_t parm6);
+
 /* Shared memory interfaces */
 
 uintptr_t STUB_shmget(int nbr, uintptr_t parm1, uintptr_t parm2,
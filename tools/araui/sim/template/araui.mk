@@ -29,10 +29,12 @@ LDFLAGS = -lpthread -lSDL2 -lSDL2_image -lm
 CSRCS = $(UIFW_DIR)/core/ui_core.c
 CSRCS += $(UIFW_DIR)/core/ui_request_callback.c
 CSRCS += $(UIFW_DIR)/core/ui_window.c
+CSRCS += $(UIFW_DIR)/core/ui_tile.c
 CSRCS += $(UIFW_DIR)/core/ui_quick_panel.c
 CSRCS += $(UIFW_DIR)/core/ui_commons.c
 CSRCS += $(UIFW_DIR)/assets/ui_asset.c
 CSRCS += $(UIFW_DIR)/assets/ui_font_asset.c
+CSRCS += $(UIFW_DIR)/assets/ui_glyph_atlas.c
 CSRCS += $(UIFW_DIR)/assets/ui_image_asset.c
 CSRCS += $(UIFW_DIR)/widgets/ui_button_widget.c
 CSRCS += $(UIFW_DIR)/widgets/ui_paginator_widget.c
@@ -9,6 +9,7 @@
 #define CONFIG_UI_DISPLAY_RGB888
 #define CONFIG_UI_ENABLE_TOUCH
 #define CONFIG_UI_ENABLE_EMOJI
+#define CONFIG_UI_GLYPH_ATLAS
 
 //!< Values
 #define CONFIG_UI_TOUCH_THRESHOLD     (10)
@@ -18,5 +19,7 @@
 #define CONFIG_UI_UPDATE_MEMPOOL_SIZE (128)
 #define CONFIG_UI_MAXIMUM_FPS         (30)
 #define CONFIG_UI_DISPLAY_SCALE       (1)
+#define CONFIG_UI_GLYPH_ATLAS_SLOT_SIZE (64)
+#define CONFIG_UI_GLYPH_ATLAS_SLOT_NUM  (64)
 
 #endif
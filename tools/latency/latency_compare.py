@@ -0,0 +1,104 @@
+#!/usr/bin/python
+###########################################################################
+#
+# Copyright 2019 Samsung Electronics All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific
+# language governing permissions and limitations under the License.
+#
+###########################################################################
+#
+# This script compares two outputs of the latency_perf example, taken
+# before and after a kernel change, and fails when the average or the
+# maximum latency of a test grew by more than the tolerance.
+#
+###########################################################################
+
+from __future__ import print_function
+import optparse
+import re
+import sys
+
+RESULT_RE = re.compile(r'^(\S+)\s*: min ([\d.]+) avg ([\d.]+) max ([\d.]+) us')
+
+
+def read_results(filename):
+    results = {}
+    with open(filename, "r") as logs:
+        for line in logs:
+            m = RESULT_RE.match(line.strip())
+            if m is None:
+                continue
+            results[m.group(1)] = (float(m.group(2)), float(m.group(3)),
+                                   float(m.group(4)))
+    return results
+
+
+def grew(before, after, tolerance, slack):
+    return after > before * (1.0 + tolerance / 100.0) + slack
+
+
+def main():
+    usage = "Usage: %prog [options]"
+    desc = "Example: %prog -b before.txt -a after.txt -t 20"
+    parser = optparse.OptionParser(usage=usage, description=desc)
+    parser.add_option('-b', '--before', dest='beforeFile',
+            default=None,
+            metavar='FILENAME',
+            help="Output of latency_perf before the change")
+    parser.add_option('-a', '--after', dest='afterFile',
+            default=None,
+            metavar='FILENAME',
+            help="Output of latency_perf after the change")
+    parser.add_option('-t', '--tolerance', dest='tolerance',
+            default=20.0, type='float',
+            metavar='PERCENT',
+            help="Allowed growth of avg and max in percent, "
+            "[default:%default]")
+    parser.add_option('-s', '--slack', dest='slack',
+            default=1.0, type='float',
+            metavar='US',
+            help="Allowed growth in us on top of the tolerance, "
+            "[default:%default]")
+    options, arg = parser.parse_args()
+
+    if options.beforeFile is None or options.afterFile is None:
+        print("Please specify both outputs with -b and -a")
+        return 1
+
+    before = read_results(options.beforeFile)
+    after = read_results(options.afterFile)
+    if not before:
+        print("No results in %s" % options.beforeFile)
+        return 1
+
+    failed = 0
+    print("%-10s %10s %10s %10s %10s" % ("test", "avg before", "avg after",
+                                         "max before", "max after"))
+    for (name, (bmin, bavg, bmax)) in sorted(before.items()):
+        if name not in after:
+            print("%-10s missing after the change" % name)
+            failed += 1
+            continue
+        (amin, aavg, amax) = after[name]
+        mark = ""
+        if grew(bavg, aavg, options.tolerance, options.slack) or \
+                grew(bmax, amax, options.tolerance, options.slack):
+            mark = "  REGRESSION"
+            failed += 1
+        print("%-10s %10.3f %10.3f %10.3f %10.3f%s" % (name, bavg, aavg,
+                                                       bmax, amax, mark))
+    return failed and 1 or 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
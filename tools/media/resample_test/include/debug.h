@@ -0,0 +1,12 @@
+/*
+ * Host build stub of <debug.h>
+ */
+#ifndef __INCLUDE_DEBUG_H
+#define __INCLUDE_DEBUG_H
+
+#include <stdio.h>
+
+#define meddbg(format, ...) fprintf(stderr, format, ##__VA_ARGS__)
+#define medvdbg(format, ...)
+
+#endif
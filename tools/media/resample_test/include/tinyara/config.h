@@ -0,0 +1,8 @@
+/*
+ * Host build stub of the generated configuration header.
+ * Media options are given on the command line by the Makefile.
+ */
+#ifndef __INCLUDE_TINYARA_CONFIG_H
+#define __INCLUDE_TINYARA_CONFIG_H
+
+#endif
@@ -0,0 +1,406 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/*
+ * Host test and benchmark of the media resampler (samplerate.c) and channel
+ * remixer (remix.cpp, remix_kernels.c).
+ *
+ *   resample_test             run checks
+ *   resample_test -o <file>   run checks and dump every generated sample to <file>
+ *   resample_test -b          run benchmark
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../../../framework/src/media/audio/resample/samplerate.h"
+#include "../../../framework/src/media/utils/remix.h"
+
+#define TEST_SECONDS     2
+#define TEST_TONE_HZ     1000
+#define TEST_AMPLITUDE   12000
+#define MAX_CH           6
+#define BENCH_ROUNDS     20
+
+// Minimum SNR of polyphase resampling, linear interpolation has no requirement
+#define SRC_MIN_SNR_DB   40.0
+
+static FILE *g_dump;
+static int g_fails;
+
+#define CHECK(cond, ...) \
+	do { \
+		if (!(cond)) { \
+			printf("FAIL: " __VA_ARGS__); \
+			printf("\n"); \
+			g_fails++; \
+		} \
+	} while (0)
+
+/****************************************************************************
+ * Reference remix, the original per-sample formulas of rechannel()
+ ****************************************************************************/
+static int16_t ref_clip(int32_t x)
+{
+	if (x < INT16_MIN) {
+		return INT16_MIN;
+	} else if (x > INT16_MAX) {
+		return INT16_MAX;
+	}
+	return x;
+}
+
+static void ref_rechannel(int in_ch, int out_ch, const int16_t *in, int frames, int16_t *out)
+{
+	int i;
+	for (i = 0; i < frames; i++) {
+		const int16_t *f = &in[i * in_ch];
+		int16_t l, r;
+		switch (in_ch) {
+		case 1:
+			l = r = f[0];
+			break;
+		case 2:
+			l = f[0];
+			r = f[1];
+			break;
+		case 3:
+			l = ref_clip((int32_t)f[0] + f[2] / 2);
+			r = ref_clip((int32_t)f[1] + f[2] / 2);
+			break;
+		case 4:
+			l = ((int32_t)f[0] + f[2]) / 2;
+			r = ((int32_t)f[1] + f[3]) / 2;
+			break;
+		case 5:
+			l = ref_clip(f[0] + ((int32_t)f[2] + f[3]) * 7071 / 1000);
+			r = ref_clip(f[1] + ((int32_t)f[2] + f[4]) * 7071 / 1000);
+			break;
+		default:
+			l = ref_clip(f[0] + ((int32_t)f[2] + f[4]) * 7071 / 1000);
+			r = ref_clip(f[1] + ((int32_t)f[2] + f[5]) * 7071 / 1000);
+			break;
+		}
+		if (out_ch == 2) {
+			out[i * 2] = l;
+			out[i * 2 + 1] = r;
+		} else if (in_ch == 1) {
+			out[i] = f[0];
+		} else {
+			out[i] = ((int32_t)l + r) / 2;
+		}
+	}
+}
+
+static int16_t random_sample(void)
+{
+	// Extremes are frequent on purpose, they exercise saturation and rounding
+	switch (rand() % 8) {
+	case 0:
+		return INT16_MAX;
+	case 1:
+		return INT16_MIN;
+	case 2:
+		return (int16_t)(rand() % 5 - 2);
+	default:
+		return (int16_t)(rand() & 0xffff);
+	}
+}
+
+static void test_rechannel(void)
+{
+	static int16_t in[1027 * MAX_CH];
+	static int16_t out[1027 * MAX_CH];
+	static int16_t ref[1027 * MAX_CH];
+	int frames = sizeof(in) / sizeof(in[0]) / MAX_CH;
+	int in_ch, out_ch, i;
+
+	for (in_ch = 1; in_ch <= MAX_CH; in_ch++) {
+		for (out_ch = 1; out_ch <= 2; out_ch++) {
+			for (i = 0; i < frames * in_ch; i++) {
+				in[i] = random_sample();
+			}
+			ref_rechannel(in_ch, out_ch, in, frames, ref);
+
+			// Separate buffers
+			int ret = rechannel(ch2layout(in_ch), ch2layout(out_ch), in, frames, out, frames);
+			CHECK(ret == frames, "rechannel %d -> %d returns %d", in_ch, out_ch, ret);
+			CHECK(memcmp(out, ref, frames * out_ch * sizeof(int16_t)) == 0, "rechannel %d -> %d differs from reference", in_ch, out_ch);
+			if (g_dump) {
+				fwrite(out, sizeof(int16_t), frames * out_ch, g_dump);
+			}
+
+			// In place
+			memcpy(out, in, frames * in_ch * sizeof(int16_t));
+			ret = rechannel(ch2layout(in_ch), ch2layout(out_ch), out, frames, out, frames);
+			CHECK(ret == frames, "in-place rechannel %d -> %d returns %d", in_ch, out_ch, ret);
+			CHECK(memcmp(out, ref, frames * out_ch * sizeof(int16_t)) == 0, "in-place rechannel %d -> %d differs from reference", in_ch, out_ch);
+		}
+	}
+}
+
+/****************************************************************************
+ * Resampler
+ ****************************************************************************/
+struct rate_case_s {
+	int in_rate;
+	int out_rate;
+};
+
+static const struct rate_case_s g_rates[] = {
+	{ 44100, 16000 },
+	{ 48000, 16000 },
+	{ 44100, 22050 },
+	{ 44100, 32000 },
+	{ 48000, 44100 },
+	{ 16000, 44100 },
+	{ 8000, 16000 },
+	{ 22050, 44100 },
+};
+
+static int16_t *make_tone(int rate, int ch, int frames)
+{
+	int16_t *buf = (int16_t *)malloc(frames * ch * sizeof(int16_t));
+	int i, j;
+	for (i = 0; i < frames; i++) {
+		int16_t s = (int16_t)lrint(TEST_AMPLITUDE * sin(2.0 * M_PI * TEST_TONE_HZ * i / rate));
+		for (j = 0; j < ch; j++) {
+			buf[i * ch + j] = s;
+		}
+	}
+	return buf;
+}
+
+/*
+ * Resample 'in' feeding chunks of at most 'chunk' frames (random sizes if chunk is 0).
+ * Returns number of output frames.
+ */
+static int run_src(const struct rate_case_s *rc, int in_ch, int out_ch, const int16_t *in, int in_frames, int16_t *out, int out_frames, int chunk)
+{
+	src_handle_t handle = src_init(4096);
+	src_data_t data;
+	int used = 0;
+	int gen = 0;
+
+	memset(&data, 0, sizeof(data));
+	data.origin_sample_rate = rc->in_rate;
+	data.origin_channel_num = in_ch;
+	data.origin_sample_width = SAMPLE_WIDTH_16BITS;
+	data.desired_sample_rate = rc->out_rate;
+	data.desired_channel_num = out_ch;
+	data.desired_sample_width = SAMPLE_WIDTH_16BITS;
+
+	while (used < in_frames && gen < out_frames) {
+		int n = chunk ? chunk : 1 + rand() % 700;
+		data.data_in = in + used * in_ch;
+		data.input_frames = (in_frames - used < n) ? in_frames - used : n;
+		data.data_out = out + gen * out_ch;
+		data.out_buf_length = (out_frames - gen) * out_ch * sizeof(int16_t);
+		if (src_simple(handle, &data) != SRC_ERR_NO_ERROR) {
+			break;
+		}
+		if (data.input_frames_used == 0 && data.output_frames_gen == 0) {
+			break;
+		}
+		used += data.input_frames_used;
+		gen += data.output_frames_gen;
+	}
+
+	src_destroy(handle);
+	return gen;
+}
+
+/*
+ * Least squares fit of the output to a sine of the test tone frequency with
+ * free amplitude and phase, so filter delay does not matter. Returns SNR of
+ * the fitted sine with the expected amplitude against the residual.
+ */
+// Whether the resampler uses a polyphase filter bank for the conversion
+static int is_polyphase(const struct rate_case_s *rc)
+{
+#ifdef CONFIG_AUDIO_RESAMPLER_POLYPHASE
+	int a = rc->in_rate;
+	int b = rc->out_rate;
+	while (b != 0) {
+		int t = a % b;
+		a = b;
+		b = t;
+	}
+	return (rc->out_rate / a) <= CONFIG_AUDIO_RESAMPLER_POLYPHASE_MAX_PHASES;
+#else
+	return 0;
+#endif
+}
+
+static double tone_snr(const struct rate_case_s *rc, const int16_t *out, int frames, int ch)
+{
+	double ss = 0, cc = 0, sc = 0, ys = 0, yc = 0;
+	double a, b, det, sig = 0, err = 0;
+	int i;
+
+	// Skip the start up transient and the tail
+	for (i = 64; i < frames - 64; i++) {
+		double w = 2.0 * M_PI * TEST_TONE_HZ * i / rc->out_rate;
+		ss += sin(w) * sin(w);
+		cc += cos(w) * cos(w);
+		sc += sin(w) * cos(w);
+		ys += out[i * ch] * sin(w);
+		yc += out[i * ch] * cos(w);
+	}
+	det = ss * cc - sc * sc;
+	a = (ys * cc - yc * sc) / det;
+	b = (yc * ss - ys * sc) / det;
+	// Keep amplitude error as noise: rescale fitted sine to the input amplitude
+	det = TEST_AMPLITUDE / sqrt(a * a + b * b);
+	a *= det;
+	b *= det;
+
+	for (i = 64; i < frames - 64; i++) {
+		double w = 2.0 * M_PI * TEST_TONE_HZ * i / rc->out_rate;
+		double expect = a * sin(w) + b * cos(w);
+		double d = out[i * ch] - expect;
+		sig += expect * expect;
+		err += d * d;
+	}
+	return 10.0 * log10(sig / (err + 1e-9));
+}
+
+static void test_resampler(void)
+{
+	unsigned int k;
+	int in_ch, out_ch;
+
+	for (k = 0; k < sizeof(g_rates) / sizeof(g_rates[0]); k++) {
+		const struct rate_case_s *rc = &g_rates[k];
+		for (in_ch = 1; in_ch <= 2; in_ch++) {
+			for (out_ch = 1; out_ch <= 2; out_ch++) {
+				int in_frames = rc->in_rate * TEST_SECONDS;
+				int out_frames = rc->out_rate * TEST_SECONDS;
+				int16_t *in = make_tone(rc->in_rate, in_ch, in_frames);
+				int16_t *out1 = (int16_t *)calloc(out_frames * out_ch, sizeof(int16_t));
+				int16_t *out2 = (int16_t *)calloc(out_frames * out_ch, sizeof(int16_t));
+
+				int gen1 = run_src(rc, in_ch, out_ch, in, in_frames, out1, out_frames, 1024);
+				int gen2 = run_src(rc, in_ch, out_ch, in, in_frames, out2, out_frames, 0);
+				int samples = ((gen1 < gen2) ? gen1 : gen2) * out_ch;
+				int same;
+				double snr = tone_snr(rc, out1, gen1, out_ch);
+
+				printf("%5d -> %5d, %d -> %d ch: %6d frames, SNR %5.1f dB (%s)\n", rc->in_rate, rc->out_rate, in_ch, out_ch, gen1, snr, is_polyphase(rc) ? "polyphase" : "linear");
+				CHECK(gen1 > out_frames * 9 / 10, "too few frames generated %d/%d", gen1, out_frames);
+				CHECK(!is_polyphase(rc) || snr >= SRC_MIN_SNR_DB, "SNR %.1f dB below %.1f dB", snr, SRC_MIN_SNR_DB);
+				for (same = 0; same < samples; same++) {
+					if (out1[same] != out2[same]) {
+						break;
+					}
+				}
+				// Output must not depend on how the input stream is chunked (not guaranteed by linear interpolation)
+				CHECK(!is_polyphase(rc) || same == samples, "output depends on input chunk size at sample %d", same);
+
+				if (g_dump) {
+					fwrite(out1, sizeof(int16_t), gen1 * out_ch, g_dump);
+				}
+				free(in);
+				free(out1);
+				free(out2);
+			}
+		}
+	}
+}
+
+/****************************************************************************
+ * Benchmark
+ ****************************************************************************/
+static double now_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void bench(void)
+{
+	const struct rate_case_s voice = { 44100, 16000 };
+	int in_frames = voice.in_rate * TEST_SECONDS;
+	int out_frames = voice.out_rate * TEST_SECONDS;
+	int16_t *in = make_tone(voice.in_rate, 2, in_frames);
+	int16_t *out = (int16_t *)malloc(in_frames * 2 * sizeof(int16_t));
+	double start;
+	int i;
+
+#ifdef CONFIG_AUDIO_RESAMPLER_POLYPHASE
+	printf("resampler: polyphase, %d taps, ", CONFIG_AUDIO_RESAMPLER_POLYPHASE_TAPS);
+#else
+	printf("resampler: linear, ");
+#endif
+#ifdef CONFIG_MEDIA_AUDIO_SIMD
+	printf("SIMD kernels\n");
+#else
+	printf("portable kernels\n");
+#endif
+
+	start = now_us();
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		run_src(&voice, 1, 1, in, in_frames, out, out_frames, 1024);
+	}
+	printf("  44100 -> 16000 mono  : %8.1f us per second of audio\n", (now_us() - start) / BENCH_ROUNDS / TEST_SECONDS);
+
+	start = now_us();
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		run_src(&voice, 2, 1, in, in_frames, out, out_frames, 1024);
+	}
+	printf("  44100 -> 16000 2->1ch: %8.1f us per second of audio\n", (now_us() - start) / BENCH_ROUNDS / TEST_SECONDS);
+
+	start = now_us();
+	for (i = 0; i < BENCH_ROUNDS * 10; i++) {
+		rechannel(ch2layout(2), ch2layout(1), in, in_frames, out, in_frames);
+	}
+	printf("  rechannel 2 -> 1 ch  : %8.1f us per second of audio\n", (now_us() - start) / (BENCH_ROUNDS * 10) / TEST_SECONDS);
+
+	free(in);
+	free(out);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1 && strcmp(argv[1], "-b") == 0) {
+		bench();
+		return 0;
+	}
+
+	if (argc > 2 && strcmp(argv[1], "-o") == 0) {
+		g_dump = fopen(argv[2], "wb");
+		if (g_dump == NULL) {
+			perror(argv[2]);
+			return 1;
+		}
+	}
+
+	srand(1);
+	test_rechannel();
+	test_resampler();
+
+	if (g_dump) {
+		fclose(g_dump);
+	}
+	printf("%s: %d failure(s)\n", g_fails ? "FAILED" : "PASSED", g_fails);
+	return g_fails ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+#!/usr/bin/python
+###########################################################################
+#
+# Copyright 2019 Samsung Electronics All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific
+# language governing permissions and limitations under the License.
+#
+###########################################################################
+#
+# This script symbolizes the samples of the statistical profiler, as read
+# from /proc/profile, against the built ELF and prints a flat profile, or
+# a folded profile for flamegraph.pl and speedscope.
+#
+# Each sample is "pid name pc lr". The function holding the PC is charged
+# with the sample and the function holding the LR is taken as its caller,
+# which is wrong once the function has saved LR and called another one.
+#
+###########################################################################
+
+from __future__ import print_function
+import bisect
+import optparse
+import re
+import subprocess
+import sys
+
+# Task names may contain spaces, e.g. "Idle Task"
+SAMPLE_RE = re.compile(r'^(-?\d+)\s+(.*\S)\s+([0-9a-fA-F]+)\s+([0-9a-fA-F]+)$')
+LOST_RE = re.compile(r'^#\s*samples\s+(\d+)\s+lost\s+(\d+)')
+NM_RE = re.compile(r'^([0-9a-fA-F]+)\s+([tTwW])\s+(\S+)$')
+
+# EXC_RETURN values and anything above the code are not return addresses
+EXC_RETURN_MIN = 0xf0000000
+
+
+class Sample:
+    def __init__(self, pid, name, pc, lr):
+        self.pid = pid
+        self.name = name
+        self.pc = pc
+        self.lr = lr
+
+
+def read_samples(filename):
+    samples = []
+    lost = 0
+    with open(filename, "r") as logs:
+        for line in logs:
+            line = line.strip()
+            m = LOST_RE.match(line)
+            if m is not None:
+                lost += int(m.group(2))
+                continue
+            m = SAMPLE_RE.match(line)
+            if m is None:
+                continue
+            samples.append(Sample(int(m.group(1)), m.group(2),
+                                  int(m.group(3), 16), int(m.group(4), 16)))
+    return (samples, lost)
+
+
+class Symbols:
+    def __init__(self, elf, nm):
+        self.addrs = []
+        self.names = []
+        output = subprocess.check_output([nm, "-n", "--defined-only", elf])
+        for line in output.decode("utf-8", "replace").splitlines():
+            m = NM_RE.match(line.strip())
+            if m is None:
+                continue
+            addr = int(m.group(1), 16)
+            # Keep one name per address, nm -n sorts them
+            if self.addrs and self.addrs[-1] == addr:
+                continue
+            self.addrs.append(addr)
+            self.names.append(m.group(3))
+
+    def lookup(self, addr):
+        # Clear the thumb bit
+        addr &= ~1
+        i = bisect.bisect_right(self.addrs, addr) - 1
+        if i < 0:
+            return "0x%08x" % addr
+        return self.names[i]
+
+    def caller(self, lr):
+        if lr == 0 or lr >= EXC_RETURN_MIN:
+            return None
+        # LR points after the call, step back into the calling instruction
+        return self.lookup((lr & ~1) - 1)
+
+
+def task_name(sample):
+    if sample.name == "-":
+        return "pid %d" % sample.pid
+    return "%s (%d)" % (sample.name, sample.pid)
+
+
+def flat_profile(samples, symbols, output):
+    counts = {}
+    for s in samples:
+        key = symbols.lookup(s.pc)
+        counts[key] = counts.get(key, 0) + 1
+    total = len(samples)
+    print("%8s %7s  %s" % ("samples", "%", "function"), file=output)
+    for (func, count) in sorted(counts.items(),
+                                key=lambda item: (-item[1], item[0])):
+        print("%8d %6.2f%%  %s" % (count, 100.0 * count / total, func),
+              file=output)
+
+
+def folded_profile(samples, symbols, output):
+    counts = {}
+    for s in samples:
+        stack = [task_name(s)]
+        func = symbols.lookup(s.pc)
+        caller = symbols.caller(s.lr)
+        if caller is not None and caller != func:
+            stack.append(caller)
+        stack.append(func)
+        key = ";".join(frame.replace(";", ":") for frame in stack)
+        counts[key] = counts.get(key, 0) + 1
+    for (stack, count) in sorted(counts.items()):
+        print("%s %d" % (stack, count), file=output)
+
+
+def main():
+    usage = "Usage: %prog [options]"
+    desc = "Example: %prog -i profile.txt -f folded -o out.folded"
+    parser = optparse.OptionParser(usage=usage, description=desc)
+    parser.add_option('-i', '--input', dest='inputFile',
+            default=None,
+            metavar='FILENAME',
+            help="Samples read from /proc/profile, "
+            "[default:%default]")
+    parser.add_option('-e', '--elf', dest='elfFile',
+            default="../../build/output/bin/tinyara",
+            metavar='FILENAME',
+            help="ELF of the profiled binary, "
+            "[default:%default]")
+    parser.add_option('-n', '--nm', dest='nm',
+            default="arm-none-eabi-nm",
+            metavar='PROGRAM',
+            help="nm of the toolchain, "
+            "[default:%default]")
+    parser.add_option('-f', '--format', dest='format',
+            default="flat",
+            choices=["flat", "folded"],
+            help="flat or folded, "
+            "[default:%default]")
+    parser.add_option('-o', '--output', dest='outputFile',
+            default=None,
+            metavar='FILENAME',
+            help="Output file, standard output if not given")
+    options, arg = parser.parse_args()
+
+    if options.inputFile is None:
+        print("Please specify the samples with -i")
+        return 1
+
+    (samples, lost) = read_samples(options.inputFile)
+    if not samples:
+        print("No samples in %s" % options.inputFile)
+        return 1
+    symbols = Symbols(options.elfFile, options.nm)
+
+    output = sys.stdout
+    if options.outputFile is not None:
+        output = open(options.outputFile, "w")
+    if options.format == "flat":
+        flat_profile(samples, symbols, output)
+    else:
+        folded_profile(samples, symbols, output)
+    if output is not sys.stdout:
+        output.close()
+    if lost:
+        print("%d samples were lost, read /proc/profile more often" % lost,
+              file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -28,6 +28,7 @@
 #define MSG_BYTES            32
 #define COMM_BYTES           12
 #define BYTE_ALIGN           4
+#define ARG_BYTES            4
 
 #define INVALID -1
 #define VALID 0
@@ -50,6 +51,7 @@ struct sched_message {
 union trace_message {
 	char message[MSG_BYTES];	// 24B, message(192b)
 	struct sched_message sched_msg;
+	unsigned int arg;
 };
 
 struct trace_packet {			// total 40 byte(message), 16byte(uid)
@@ -81,13 +83,26 @@ static int print_sched_packet(struct trace_packet *packet)
 	return sizeof(struct trace_packet);
 }
 
+static int print_arg_packet(struct trace_packet *packet)
+{
+	if (packet->event_type == 'i' || packet->event_type == 'x') {
+		printf("[%06d:%06d] %03u: %c|%u\r\n", packet->tv_sec, packet->tv_nsec / 1000, (unsigned int)packet->pid, packet->event_type, packet->msg.arg);
+	} else {
+		printf("[%06d:%06d] %03u: %c|0x%08x\r\n", packet->tv_sec, packet->tv_nsec / 1000, (unsigned int)packet->pid, packet->event_type, packet->msg.arg);
+	}
+	return sizeof(struct trace_packet) - MSG_BYTES + ARG_BYTES;
+}
+
 static int print_packet(struct trace_packet *packet)
 {
-	int isSched = (packet->event_type == 's') ? 1 : 0;
+	int isSched = (packet->event_type == 's' || packet->event_type == 'w') ? 1 : 0;
+	int isArg = (packet->event_type == 'i' || packet->event_type == 'x' || packet->event_type == 'k' || packet->event_type == 'p') ? 1 : 0;
 	int isUnique = (packet->codelen & CODE_UNIQUE);
 
 	if (isSched) {
 		return print_sched_packet(packet);
+	} else if (isArg) {
+		return print_arg_packet(packet);
 	} else if (isUnique) {
 		return print_uid_packet(packet);
 	} else {
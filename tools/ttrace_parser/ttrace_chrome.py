@@ -0,0 +1,201 @@
+#!/usr/bin/python
+###########################################################################
+#
+# Copyright 2019 Samsung Electronics All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific
+# language governing permissions and limitations under the License.
+#
+###########################################################################
+#
+# This script converts T-trace logs, as printed by "ttrace -p" or by
+# scripts/parse_dump from a dumped trace buffer, into the Chrome trace
+# event format. The result opens in chrome://tracing and in the Perfetto
+# UI (ui.perfetto.dev).
+#
+# Each task gets its own track with the trace_begin/trace_end slices, the
+# time it was running and its semaphore waits and posts. Wakeups are drawn
+# as flows from the waking task to the first run of the woken one, which
+# also carries the wakeup latency. Interrupts get one track per irq.
+#
+###########################################################################
+
+from __future__ import print_function
+import json
+import optparse
+import re
+import sys
+
+TASKS_PID = 1
+IRQS_PID = 2
+
+LINE_RE = re.compile(r'^\[(\d+):(\d+)\]\s+(-?\d+):\s+(\w)\|(.*)$')
+SCHED_RE = re.compile(r'prev_comm=(.*) prev_pid=(\d+) prev_prio=(\d+) '
+                      r'prev_state=(\d+) ==> next_comm=(.*) next_pid=(\d+) '
+                      r'next_prio=(\d+)')
+
+
+class Record:
+    def __init__(self, ts, pid, event_type, payload):
+        self.ts = ts
+        self.pid = pid
+        self.event_type = event_type
+        self.payload = payload
+
+
+def read_records(filename):
+    records = []
+    with open(filename, "r") as logs:
+        for line in logs:
+            m = LINE_RE.match(line.strip())
+            if m is None:
+                continue
+            ts = int(m.group(1)) * 1000000 + int(m.group(2))
+            records.append(Record(ts, int(m.group(3)), m.group(4),
+                                  m.group(5)))
+    # Packets buffered per task reach the trace buffer out of order
+    records.sort(key=lambda r: r.ts)
+    return records
+
+
+class Converter:
+    def __init__(self):
+        self.events = []
+        self.names = {}
+        self.irqs = set()
+        self.running = None
+        self.wakeups = {}
+        self.flow_id = 0
+        self.first_ts = 0
+        self.last_ts = 0
+
+    def add(self, **event):
+        self.events.append(event)
+
+    def name_task(self, pid, comm):
+        if comm:
+            self.names[pid] = comm
+
+    def start_running(self, pid, ts):
+        args = {}
+        if pid in self.wakeups:
+            (flow_id, wakeup_ts) = self.wakeups.pop(pid)
+            args["wakeup_latency_us"] = ts - wakeup_ts
+            self.add(ph="f", bp="e", id=flow_id, name="wakeup", cat="sched",
+                     pid=TASKS_PID, tid=pid, ts=ts)
+        self.running = (pid, ts, args)
+
+    def stop_running(self, ts):
+        if self.running is None:
+            return
+        (pid, start, args) = self.running
+        self.add(ph="X", name="Running", cat="sched", pid=TASKS_PID, tid=pid,
+                 ts=start, dur=ts - start, args=args)
+        self.running = None
+
+    def sched(self, r):
+        m = SCHED_RE.match(r.payload)
+        if m is None:
+            return
+        (prev_pid, next_pid) = (int(m.group(2)), int(m.group(6)))
+        self.name_task(prev_pid, m.group(1))
+        self.name_task(next_pid, m.group(5))
+        if r.event_type == 's':
+            if self.running is None:
+                self.start_running(prev_pid, self.first_ts)
+            self.stop_running(r.ts)
+            self.start_running(next_pid, r.ts)
+        else:
+            self.flow_id += 1
+            self.wakeups[next_pid] = (self.flow_id, r.ts)
+            self.add(ph="i", s="t", name="wakeup " + m.group(5), cat="sched",
+                     pid=TASKS_PID, tid=prev_pid, ts=r.ts,
+                     args={"pid": next_pid})
+            self.add(ph="s", id=self.flow_id, name="wakeup", cat="sched",
+                     pid=TASKS_PID, tid=prev_pid, ts=r.ts)
+
+    def irq(self, r):
+        irq = int(r.payload, 0)
+        self.irqs.add(irq)
+        self.add(ph=(r.event_type == 'i') and "B" or "E",
+                 name="irq %d" % irq, cat="irq", pid=IRQS_PID, tid=irq,
+                 ts=r.ts)
+
+    def sem(self, r):
+        name = (r.event_type == 'k') and "sem wait" or "sem post"
+        self.add(ph="i", s="t", name=name, cat="lock", pid=TASKS_PID,
+                 tid=r.pid, ts=r.ts, args={"sem": r.payload})
+
+    def mark(self, r):
+        if r.event_type == 'b':
+            self.add(ph="B", name=r.payload, cat="ttrace", pid=TASKS_PID,
+                     tid=r.pid, ts=r.ts)
+        else:
+            self.add(ph="E", pid=TASKS_PID, tid=r.pid, ts=r.ts)
+
+    def convert(self, records):
+        handlers = {'s': self.sched, 'w': self.sched, 'i': self.irq,
+                    'x': self.irq, 'k': self.sem, 'p': self.sem,
+                    'b': self.mark, 'e': self.mark}
+        if records:
+            self.first_ts = records[0].ts
+        for r in records:
+            if r.event_type in handlers:
+                handlers[r.event_type](r)
+            self.last_ts = r.ts
+        self.stop_running(self.last_ts)
+
+        meta = [dict(ph="M", name="process_name", pid=TASKS_PID,
+                     args={"name": "Tasks"})]
+        if self.irqs:
+            meta.append(dict(ph="M", name="process_name", pid=IRQS_PID,
+                             args={"name": "Interrupts"}))
+        for (pid, comm) in sorted(self.names.items()):
+            meta.append(dict(ph="M", name="thread_name", pid=TASKS_PID,
+                             tid=pid, args={"name": "%s (%d)" % (comm, pid)}))
+        for irq in sorted(self.irqs):
+            meta.append(dict(ph="M", name="thread_name", pid=IRQS_PID,
+                             tid=irq, args={"name": "irq %d" % irq}))
+        return {"traceEvents": meta + self.events,
+                "displayTimeUnit": "ms"}
+
+
+def main():
+    usage = "Usage: %prog [options]"
+    desc = "Example: %prog -i dump.trace -o trace.json"
+    parser = optparse.OptionParser(usage=usage, description=desc)
+    parser.add_option('-i', '--input', dest='inputFile',
+            default=None,
+            metavar='FILENAME',
+            help="T-trace logs printed by ttrace -p or parse_dump, "
+            "[default:%default]")
+    parser.add_option('-o', '--output', dest='outputFile',
+            default="trace.json",
+            metavar='FILENAME',
+            help="Chrome trace event JSON file, "
+            "[default:%default]")
+    options, arg = parser.parse_args()
+
+    if options.inputFile is None:
+        print("Please specify the T-trace logs with -i")
+        return 1
+
+    trace = Converter().convert(read_records(options.inputFile))
+    with open(options.outputFile, "w") as output:
+        json.dump(trace, output)
+    print("%d events saved at %s" % (len(trace["traceEvents"]),
+                                     options.outputFile))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -111,6 +111,10 @@ def translateTinyaraLogs(options):
             time = item.extractTime(lineList[0])
             pid = item.extractPid(lineList[1])
             pair_type = item.extractPairType(lineList[2])
+            # Kernel events other than context switches are only
+            # converted by ttrace_chrome.py
+            if pair_type not in ('B', 'E', 'S'):
+                continue
             msg = item.extractMsg(lineList[2])
             translatedLine = item.composeLine()
             if (options.verbose == True):